@@ -31,7 +31,9 @@
 #include "src/version_info.h"   // FEAT-V0: Sistema de control de versiones centralizado
 #include "src/FeatureFlags.h"   // FEAT-V1: Sistema de feature flags
 #include "src/CycleTiming.h"    // FEAT-V2: Sistema de timing de ciclos
+#include "src/StateScheduler.h" // FEAT-V19: Planificador de estados por tabla
 #include "src/DebugConfig.h"
+#include "src/DeferredLog.h"    // FEAT-V27: DLOG (texto inmediato si el flag está apagado)
 
 // ============ [FEAT-V3 START] Include Crash Diagnostics ============
 #if ENABLE_FEAT_V3_CRASH_DIAGNOSTICS
@@ -69,6 +71,31 @@
 #include "src/data_sensors/I2CSensorModule.h"
 #include "src/data_sensors/RS485Module.h"
 #include "src/data_sensors/config_data_sensors.h"
+#if ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+#include "src/data_sensors/SensorSampler.h"  // FEAT-V13
+#endif
+#if ENABLE_FEAT_V15_POWER_RAILS
+#include "src/data_sensors/PowerRails.h"     // FEAT-V15
+#endif
+#if ENABLE_FEAT_V16_PROBE_REGISTRY
+#include "src/data_sensors/ProbeRegistry.h"  // FEAT-V16
+#endif
+#if ENABLE_FEAT_V17_ROBUST_STATS
+#include "src/data_sensors/SampleStats.h"    // FEAT-V17
+#endif
+#if ENABLE_FEAT_V22_PERSIST_CACHE
+#include "src/data_buffer/PersistState.h"    // FEAT-V22
+#endif
+#if ENABLE_FEAT_V23_TRACE_SPANS
+#include "src/TraceSpan.h"                  // FEAT-V23
+#endif
+#include "src/data_diagnostics/FlashWear.h"  // FEAT-V29 (macros vacías si está apagado)
+#if ENABLE_FEAT_V30_TELEMETRY_FRAME
+#include "src/data_format/TelemetryFrame.h"     // FEAT-V30
+#endif
+#if ENABLE_FEAT_V33_MICRO_BENCH
+#include "src/data_diagnostics/MicroBench.h"    // FEAT-V33
+#endif
 
 // ============ [DEBUG-EMI] Declaración externa de funciones de diagnóstico ============
 #if DEBUG_EMI_DIAGNOSTIC_ENABLED
@@ -82,6 +109,12 @@ extern void resetEMIDiagnosticStats();
 #include "src/data_time/RTCModule.h"
 #include "src/data_time/config_data_time.h"
 
+#if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+#include <freertos/FreeRTOS.h>        // FEAT-V12
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+#endif
+
 // ============ [FIX-V3 START] Variables persistentes en RTC ============
 #if ENABLE_FIX_V3_LOW_BATTERY_MODE
 /** @brief Flag que indica si estamos en modo reposo por batería baja */
@@ -92,6 +125,10 @@ RTC_DATA_ATTR static uint8_t g_stableCycleCounter = 0;
 
 /** @brief Última lectura de vBat filtrada (para debug) */
 RTC_DATA_ATTR static float g_lastVBatFiltered = 0.0f;
+
+/** @brief Resultado de FIX-V3 de este ciclo (se evalúa una sola vez) */
+static bool g_batteryEvaluated = false;
+static bool g_batteryOk = true;
 #endif
 // ============ [FIX-V3 END] ============
 
@@ -126,9 +163,87 @@ static uint32_t g_stress_heap_start = 0;
 
 /** @brief Timestamp millis() al inicio del ciclo (para calcular tiempo real) */
 static uint32_t g_stress_cycle_start_ms = 0;
+
+// ============ [FEAT-V21 START] Heap de la ruta de datos ============
+/** @brief Heap libre y mayor bloque al entrar a Cycle_ReadSensors */
+static uint32_t g_stress_path_heap = 0;
+static uint32_t g_stress_path_block = 0;
+
+/** @brief Marca el inicio de la ruta sensores -> trama -> buffer */
+static void stressPathBegin() {
+  g_stress_path_heap = ESP.getFreeHeap();
+  g_stress_path_block = ESP.getMaxAllocHeap();
+}
+
+/**
+ * @brief Reporta heap al terminar Cycle_BufferWrite
+ * 
+ * Con la muestra tipada ambas diferencias deben ser 0: un delta negativo es
+ * una fuga y un mayor bloque menor es fragmentación por String temporales.
+ */
+static void stressPathEnd() {
+  int32_t heapDelta = (int32_t)ESP.getFreeHeap() - (int32_t)g_stress_path_heap;
+  int32_t blockDelta = (int32_t)ESP.getMaxAllocHeap() - (int32_t)g_stress_path_block;
+  Serial.printf("[STRESS][FEAT-V21] Ruta de datos: heap %+ld bytes, mayor bloque %+ld bytes, min historico %lu%s\n",
+                (long)heapDelta, (long)blockDelta, (unsigned long)ESP.getMinFreeHeap(),
+                (heapDelta != 0 || blockDelta < 0) ? " <- revisar" : "");
+}
+// ============ [FEAT-V21 END] ============
 #endif
 // ============ [FEAT-V5 END] ============
 
+// ============ [FEAT-V10 START] Variables persistentes report-by-exception ============
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+/** @brief Valores (enteros de trama) de la última muestra reportada */
+RTC_DATA_ATTR static int32_t g_rbeLastSent[VAR_COUNT] = {0};
+
+/** @brief Epoch de la última muestra reportada (base del heartbeat) */
+RTC_DATA_ATTR static uint32_t g_rbeLastSentEpoch = 0;
+
+/** @brief true cuando g_rbeLastSent contiene una referencia válida */
+RTC_DATA_ATTR static bool g_rbeHasReference = false;
+
+/** @brief Muestras suprimidas desde la última trama reportada */
+RTC_DATA_ATTR static uint16_t g_rbeSuppressed = 0;
+#endif
+// ============ [FEAT-V10 END] ============
+
+// ============ [FEAT-V11 START] Variables persistentes wakeup alineado ============
+#if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+/** @brief Epoch RTC leído justo antes de entrar a deep sleep (0 = inválido) */
+RTC_DATA_ATTR static uint32_t g_alignSleepEpoch = 0;
+
+/** @brief µs programados en el timer para el último sleep */
+RTC_DATA_ATTR static uint64_t g_alignTimerUs = 0;
+
+/** @brief Deriva estimada del timer de sleep en ppm (+ = duerme de más) */
+RTC_DATA_ATTR static int32_t g_alignDriftPpm = 0;
+
+/** @brief Desfase por dispositivo (s) derivado del ICCID */
+RTC_DATA_ATTR static uint32_t g_alignOffsetS = 0;
+#endif
+// ============ [FEAT-V11 END] ============
+
+// ============ [FEAT-V18 START] Agregados de ventana en RTC ============
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+/** @brief Agregado de una variable (unidades de trama) */
+struct WindowAgg {
+  int32_t minV;
+  int32_t maxV;
+  int64_t sum;
+};
+
+/** @brief Agregados de var5..var7 desde la última trama guardada */
+RTC_DATA_ATTR static WindowAgg g_window[AGG_VAR_COUNT];
+
+/** @brief Muestras acumuladas en la ventana (0 = vacía) */
+RTC_DATA_ATTR static uint16_t g_windowCount = 0;
+
+/** @brief µs consumidos por el sub-muestreo en el Cycle_Sleep actual */
+static uint64_t g_windowElapsedUs = 0;
+#endif
+// ============ [FEAT-V18 END] ============
+
 // ============ [DEBUG-EMI START] Variables para diagnóstico EMI ============
 #if DEBUG_EMI_DIAGNOSTIC_ENABLED
 /** @brief Contador de ciclos para diagnóstico EMI (persiste en deep sleep) */
@@ -187,19 +302,23 @@ static Preferences preferences;
  * 1. Boot: Inicialización (estado transitorio)
  * 2. BleOnly: Modo configuración BLE (solo en arranque desde apagado)
  * 3. Cycle_ReadSensors: Lectura de sensores ADC, I2C y RS485
- * 4. Cycle_Gps: Adquisición GPS (solo primer ciclo post-boot)
- * 5. Cycle_GetICCID: Lectura de ICCID del SIM
- * 6. Cycle_BuildFrame: Construcción de trama de datos (Base64)
- * 7. Cycle_BufferWrite: Escritura persistente en buffer
- * 8. Cycle_SendLTE: Transmisión por red celular
- * 9. Cycle_CompactBuffer: Eliminación de tramas enviadas
- * 10. Cycle_Sleep: Deep sleep con timer wakeup
- * 11. Error: Estado de error (detiene el sistema)
+ * 4. Cycle_GpsNvs: Coordenadas guardadas en NVS (ciclos subsecuentes)
+ * 5. Cycle_Gps: Adquisición GPS (solo primer ciclo post-boot)
+ * 6. Cycle_GetICCID: Lectura de ICCID del SIM
+ * 7. Cycle_BuildFrame: Construcción de trama de datos (Base64)
+ * 8. Cycle_BufferWrite: Escritura persistente en buffer
+ * 9. Cycle_SendLTE: Transmisión por red celular
+ * 10. Cycle_CompactBuffer: Eliminación de tramas enviadas
+ * 11. Cycle_Sleep: Deep sleep con timer wakeup
+ * 12. Error: Estado de error (detiene el sistema)
+ *
+ * El valor numérico es el índice en g_stateTable (FEAT-V19).
  */
 enum class AppState : uint8_t {
   Boot = 0,              ///< Inicialización del sistema
   BleOnly,               ///< Modo configuración BLE exclusivo
   Cycle_ReadSensors,     ///< Lectura de todos los sensores
+  Cycle_GpsNvs,          ///< Recuperación de coordenadas desde NVS
   Cycle_Gps,             ///< Adquisición de coordenadas GPS
   Cycle_GetICCID,        ///< Obtención del ICCID de la tarjeta SIM
   Cycle_BuildFrame,      ///< Construcción de trama de datos
@@ -222,11 +341,8 @@ static esp_sleep_wakeup_cause_t g_wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
 /** @brief Flag para ejecutar GPS solo en el primer ciclo después del boot */
 static bool g_firstCycleAfterBoot = false;
 
-/** @brief ICCID de la tarjeta SIM (identificador único) */
-static String g_iccid;
-
-/** @brief Timestamp Unix epoch en formato string */
-static String g_epoch;
+/** @brief Muestra tipada del ciclo: ICCID, epoch y var1..var7 (FEAT-V21, sin String) */
+static Sample g_sample;
 
 /** @brief Timestamp Unix epoch numérico para diagnósticos (FEAT-V7) */
 static uint32_t g_lastEpoch = 0;
@@ -240,9 +356,6 @@ static char g_lng[COORD_LEN + 1];
 /** @brief Altitud en metros en formato string */
 static char g_alt[ALT_LEN + 1];
 
-/** @brief Array de valores de sensores en formato string (7 variables) */
-static String g_varStr[VAR_COUNT];
-
 /** @brief Buffer para trama completa codificada en Base64 */
 static char g_frame[FRAME_BASE64_MAX_LEN];
 
@@ -259,9 +372,17 @@ static int g_lastCSQ = 99;
 /** @brief Flag indicando si el ciclo LTE fue exitoso */
 static bool g_lteCycleSuccess = false;
 
-#if ENABLE_FEAT_V2_CYCLE_TIMING
-/** @brief Estructura global para timing de ciclo (FEAT-V2) */
+/**
+ * @brief Estructura global para timing de ciclo (FEAT-V2)
+ * @note Se declara siempre: FEAT-V19 (duración por estado), FEAT-V28
+ *       (memoria por fase) y las latencias de V12/V13/V15/V20 la escriben
+ *       aunque FEAT-V2 no imprima el resumen.
+ */
 static CycleTiming g_timing;
+
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+/** @brief Marcas de memoria de AppInit (FEAT-V28; BleOnly reinicia g_timing) */
+static PhaseMem g_initMem;
 #endif
 
 // ============ CYCLE SUMMARY: Resumen de datos del ciclo ============
@@ -279,49 +400,37 @@ static void printCycleSummary() {
     
     // Sensores RS485 (Modbus)
     Serial.print(F("\xE2\x95\x91  RS485[0]:       "));  // ║  RS485[0]:       
-    Serial.print(g_varStr[0]);
-    for (int i = g_varStr[0].length(); i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15ld", (long)g_sample.var[0]);
     Serial.println(F("\xE2\x95\x91"));  // ║
     
     Serial.print(F("\xE2\x95\x91  RS485[1]:       "));
-    Serial.print(g_varStr[1]);
-    for (int i = g_varStr[1].length(); i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15ld", (long)g_sample.var[1]);
     Serial.println(F("\xE2\x95\x91"));
     
     Serial.print(F("\xE2\x95\x91  RS485[2]:       "));
-    Serial.print(g_varStr[2]);
-    for (int i = g_varStr[2].length(); i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15ld", (long)g_sample.var[2]);
     Serial.println(F("\xE2\x95\x91"));
     
     Serial.print(F("\xE2\x95\x91  RS485[3]:       "));
-    Serial.print(g_varStr[3]);
-    for (int i = g_varStr[3].length(); i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15ld", (long)g_sample.var[3]);
     Serial.println(F("\xE2\x95\x91"));
     
     // Sensores I2C (Temp/Hum) - Valores almacenados como x100
-    float tempVal = g_varStr[4].toFloat() / 100.0f;
+    char cell[16];
+    snprintf(cell, sizeof(cell), "%.2f C", g_sample.var[SAMPLE_TEMP] / 100.0f);
     Serial.print(F("\xE2\x95\x91  Temp (I2C):     "));
-    Serial.print(tempVal, 2);
-    Serial.print(F(" C"));
-    int tempLen = String(tempVal, 2).length() + 2;
-    for (int i = tempLen; i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15s", cell);
     Serial.println(F("\xE2\x95\x91"));
     
-    float humVal = g_varStr[5].toFloat() / 100.0f;
+    snprintf(cell, sizeof(cell), "%.2f %%", g_sample.var[SAMPLE_HUM] / 100.0f);
     Serial.print(F("\xE2\x95\x91  Hum (I2C):      "));
-    Serial.print(humVal, 2);
-    Serial.print(F(" %"));
-    int humLen = String(humVal, 2).length() + 2;
-    for (int i = humLen; i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15s", cell);
     Serial.println(F("\xE2\x95\x91"));
     
     // Batería - Valor almacenado como x100
-    float batVal = g_varStr[6].toFloat() / 100.0f;
+    snprintf(cell, sizeof(cell), "%.2f V", g_sample.var[SAMPLE_VBAT] / 100.0f);
     Serial.print(F("\xE2\x95\x91  Battery (ADC):  "));
-    Serial.print(batVal, 2);
-    Serial.print(F(" V"));
-    int batLen = String(batVal, 2).length() + 2;
-    for (int i = batLen; i < 15; i++) Serial.print(' ');
+    Serial.printf("%-15s", cell);
     Serial.println(F("\xE2\x95\x91"));
     
     Serial.println(F("\xE2\x95\xA0\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\x90\xE2\x95\xA3"));  // ╠══════════════════════════════════════╣
@@ -347,9 +456,8 @@ static void printCycleSummary() {
     
     // LTE Info
     Serial.print(F("\xE2\x95\x91  ICCID:          "));
-    if (g_iccid.length() > 0) {
-        Serial.print(g_iccid);
-        for (int i = g_iccid.length(); i < 20; i++) Serial.print(' ');
+    if (g_sample.iccid[0] != '\0') {
+        Serial.printf("%-20s", g_sample.iccid);
     } else {
         Serial.print(F("(not read)          "));
     }
@@ -407,6 +515,36 @@ static void fillZeros(char* dst, size_t width) {
   dst[width] = '\0';
 }
 
+// ============ [FEAT-V14 START] Medición vBat compartida por ciclo ============
+#if ENABLE_FEAT_V14_FAST_ADC
+static bool g_vbatCycleValid = false;   // Invalida al inicio de Cycle_ReadSensors
+static float g_vbatCycleValue = 0.0f;   // Unidades de trama (V x100)
+
+/**
+ * @brief Devuelve la medición vBat del ciclo (la toma solo la primera vez)
+ * 
+ * La trama (Cycle_ReadSensors) y FIX-V3 (Cycle_BufferWrite) comparten la
+ * misma ráfaga calibrada de ADCSensorModule::readOversampled().
+ * 
+ * @param[out] outValue vBat en unidades de trama (V x100)
+ * @return true si hay medición válida
+ */
+static bool vbatCycleMeasure(float& outValue) {
+  if (!g_vbatCycleValid) {
+    uint32_t t0 = micros();
+    if (!adcSensor.readOversampled()) return false;
+    g_vbatCycleValue = adcSensor.getValue();
+    g_vbatCycleValid = true;
+    Serial.printf("[FEAT-V14] vBat: %u mV pin, %.0f (x100) en %lu us\n",
+                  (unsigned)adcSensor.getPinMilliVolts(), g_vbatCycleValue,
+                  (unsigned long)(micros() - t0));
+  }
+  outValue = g_vbatCycleValue;
+  return true;
+}
+#endif
+// ============ [FEAT-V14 END] ============
+
 // ============ [FIX-V3 START] Funciones de control de batería ============
 #if ENABLE_FIX_V3_LOW_BATTERY_MODE
 /**
@@ -419,6 +557,18 @@ static void fillZeros(char* dst, size_t width) {
  * @return Voltaje filtrado en voltios
  */
 static float readVBatFiltered() {
+    // ============ [FEAT-V14] Reusar medición del ciclo (sin ráfaga extra) ============
+    #if ENABLE_FEAT_V14_FAST_ADC
+    float shared;
+    if (vbatCycleMeasure(shared)) {
+        #if ENABLE_FIX_V8_VBAT_UNITS
+        return shared / ADC_MULTIPLIER;  // FIX-V8: V x100 -> voltios (umbrales FIX-V3)
+        #else
+        return shared;
+        #endif
+    }
+    #endif
+
     float sum = 0.0f;
     
     // Descartar primera lectura (ruido de multiplexor)
@@ -428,11 +578,15 @@ static float readVBatFiltered() {
     // Tomar N muestras y promediar
     for (int i = 0; i < FIX_V3_VBAT_FILTER_SAMPLES; i++) {
         adcSensor.readSensor();
-        sum += adcSensor.getValue();  // Ya calibrado en voltios reales
+        sum += adcSensor.getValue();  // Unidades de trama (V x100)
         delay(FIX_V3_VBAT_FILTER_DELAY_MS);
     }
     
+    #if ENABLE_FIX_V8_VBAT_UNITS
+    return sum / FIX_V3_VBAT_FILTER_SAMPLES / ADC_MULTIPLIER;  // FIX-V8: a voltios
+    #else
     return sum / FIX_V3_VBAT_FILTER_SAMPLES;
+    #endif
 }
 
 /**
@@ -530,6 +684,23 @@ static bool evaluateBatteryState(float vBatFiltered) {
         return false;
     }
 }
+
+/**
+ * @brief FIX-V3 sobre el vBat de este ciclo, evaluado una sola vez
+ * 
+ * Lo llaman el bring-up en paralelo (FEAT-V12), antes de encender el modem,
+ * y Cycle_BufferWrite. La histéresis avanza un paso por ciclo aunque se
+ * consulte dos veces.
+ * 
+ * @return true si puede operar normalmente (enviar LTE)
+ */
+static bool batteryAllowsLte() {
+    if (!g_batteryEvaluated) {
+        g_batteryOk = evaluateBatteryState(readVBatFiltered());
+        g_batteryEvaluated = true;
+    }
+    return g_batteryOk;
+}
 #endif
 // ============ [FIX-V3 END] ============
 
@@ -565,6 +736,142 @@ static void formatAlt(char* out, size_t outSz, float altMeters) {
   snprintf(out, outSz, "%ld", a);
 }
 
+/**
+ * @brief Una lectura completa de las sondas Modbus (4 slots de trama)
+ * 
+ * Con FEAT-V16 sondea todas las sondas detectadas según el plan fusionado;
+ * sin él, lee los 4 holding registers de MODBUS_SLAVE_ID.
+ * 
+ * @param[out] out Valores por slot (var1..var4)
+ * @return true si la lectura fue completa
+ */
+static bool rs485ReadOnce(int32_t out[4]) {
+  #if ENABLE_FEAT_V16_PROBE_REGISTRY
+  return ProbeRegistry::poll(out);
+  #else
+  if (!rs485Sensor.readSensor()) return false;
+  for (uint8_t r = 0; r < 4; r++) {
+    out[r] = rs485Sensor.getRegister(r);
+  }
+  return true;
+  #endif
+}
+
+// ============ [FEAT-V17 START] Reductores robustos con muestreo adaptativo ============
+#if ENABLE_FEAT_V17_ROBUST_STATS
+/** @brief Política por ruta, elegida en compilación */
+typedef SampleStats::Stream<FEAT_V17_MAX_SAMPLES, SampleStats::TrimmedMean> AdcStats;
+typedef SampleStats::Stream<FEAT_V17_MAX_SAMPLES, SampleStats::TrimmedMean> EnvStats;
+typedef SampleStats::Stream<FEAT_V17_RS485_MAX_SAMPLES, SampleStats::Median> RegStats;
+
+/** @brief Resumen de un reductor para logs */
+struct StatsInfo {
+  uint8_t taken;       ///< Muestras aceptadas por el acumulador
+  uint8_t rejected;    ///< Outliers descartados por MAD
+  bool deadlineHit;    ///< Cortado por deadline
+};
+
+/** @brief true si el deadline ya venció */
+static inline bool statsDeadline(uint32_t deadlineMs) {
+  return (int32_t)(millis() - deadlineMs) >= 0;
+}
+
+#if !ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+/** @brief Log compacto de un reductor (lectores secuenciales) */
+static void statsLog(const char* name, const StatsInfo& info) {
+  Serial.printf("[FEAT-V17] %s: %u muestras, %u outliers%s\n", name,
+                (unsigned)info.taken, (unsigned)info.rejected,
+                info.deadlineHit ? " (deadline)" : "");
+}
+#endif
+
+/**
+ * @brief vBat x100: descarta, muestrea hasta estabilizar, media recortada
+ * @param discard Lecturas iniciales a descartar
+ * @param deadlineMs Límite absoluto en millis()
+ * @param[out] out vBat x100
+ * @param[out] info Resumen
+ * @return true si hubo al menos una muestra
+ */
+static bool statsReadADC(uint8_t discard, uint32_t deadlineMs, int32_t& out, StatsInfo& info) {
+  AdcStats s;
+  memset(&info, 0, sizeof(info));
+  for (uint8_t i = 0; i < discard && !statsDeadline(deadlineMs); i++) {
+    (void)adcSensor.readSensor();
+  }
+  for (uint8_t a = 0; a < 2 * FEAT_V17_MAX_SAMPLES && !s.full(); a++) {
+    if (statsDeadline(deadlineMs)) { info.deadlineHit = true; break; }
+    if (!adcSensor.readSensor()) continue;
+    s.add((int32_t)lround(adcSensor.getValue()));
+    if (s.count() >= FEAT_V17_MIN_SAMPLES && s.stable(FEAT_V17_TOL_ADC)) break;
+  }
+  info.taken = s.count();
+  if (info.taken == 0) return false;
+  out = s.reduce();
+  info.rejected = s.rejected();
+  return true;
+}
+
+/**
+ * @brief Temperatura/humedad x100 con el mismo esquema que statsReadADC()
+ * @return true si hubo al menos una muestra
+ */
+static bool statsReadI2C(uint8_t discard, uint32_t deadlineMs, int32_t& t100, int32_t& h100, StatsInfo& info) {
+  EnvStats st, sh;
+  memset(&info, 0, sizeof(info));
+  for (uint8_t i = 0; i < discard && !statsDeadline(deadlineMs); i++) {
+    (void)i2cSensor.readSensor();
+  }
+  for (uint8_t a = 0; a < 2 * FEAT_V17_MAX_SAMPLES && !st.full(); a++) {
+    if (statsDeadline(deadlineMs)) { info.deadlineHit = true; break; }
+    if (!i2cSensor.readSensor()) continue;
+    st.add((int32_t)lround(i2cSensor.getTemperature() * 100.0f));
+    sh.add((int32_t)lround(i2cSensor.getHumidity() * 100.0f));
+    if (st.count() >= FEAT_V17_MIN_SAMPLES &&
+        st.stable(FEAT_V17_TOL_TEMP) && sh.stable(FEAT_V17_TOL_HUM)) break;
+  }
+  info.taken = st.count();
+  if (info.taken == 0) return false;
+  t100 = st.reduce();
+  h100 = sh.reduce();
+  info.rejected = max(st.rejected(), sh.rejected());
+  return true;
+}
+
+/**
+ * @brief Slots RS485: mediana por slot, corta cuando todos coinciden
+ * @return true si hubo al menos una lectura completa
+ */
+static bool statsReadRS485(uint8_t discard, uint32_t deadlineMs, int32_t out[4], StatsInfo& info) {
+  RegStats s[4];
+  int32_t v[4];
+  memset(&info, 0, sizeof(info));
+  for (uint8_t i = 0; i < discard && !statsDeadline(deadlineMs); i++) {
+    (void)rs485ReadOnce(v);
+  }
+  for (uint8_t a = 0; a < 2 * FEAT_V17_RS485_MAX_SAMPLES && !s[0].full(); a++) {
+    if (statsDeadline(deadlineMs)) { info.deadlineHit = true; break; }
+    if (!rs485ReadOnce(v)) continue;
+    bool stable = true;
+    for (uint8_t r = 0; r < 4; r++) {
+      s[r].add(v[r]);
+      stable = stable && s[r].stable(FEAT_V17_TOL_RS485);
+    }
+    if (s[0].count() >= FEAT_V17_RS485_MIN_SAMPLES && stable) break;
+  }
+  info.taken = s[0].count();
+  if (info.taken == 0) return false;
+  for (uint8_t r = 0; r < 4; r++) {
+    out[r] = s[r].reduce();
+    info.rejected = max(info.rejected, s[r].rejected());
+  }
+  return true;
+}
+#endif
+// ============ [FEAT-V17 END] ============
+
+// Lectores secuenciales: con FEAT-V13 los reemplaza sampleSensorsConcurrent()
+#if !ENABLE_FEAT_V13_CONCURRENT_SAMPLING
 /**
  * @brief Lee el sensor ADC descartando muestras iniciales y promediando
  * 
@@ -573,13 +880,31 @@ static void formatAlt(char* out, size_t outSz, float altMeters) {
  * 2. Promedia las siguientes KEEP_SAMPLES lecturas (5)
  * 3. Redondea el resultado a entero
  * 
- * @param[out] outValueStr String de salida con el valor promediado
+ * @param[out] outValue Valor promediado en unidades de trama
  * 
  * @return true si se obtuvieron lecturas válidas, false si todas fallaron
  * 
  * @note El descarte de muestras iniciales elimina efectos transitorios del multiplexor ADC
  */
-static bool readADC_DiscardAndAverage(String& outValueStr) {
+static bool readADC_DiscardAndAverage(int32_t& outValue) {
+  // ============ [FEAT-V14] Ráfaga calibrada compartida con FIX-V3 ============
+  #if ENABLE_FEAT_V14_FAST_ADC
+  float shared;
+  if (vbatCycleMeasure(shared)) {
+    outValue = (int32_t)lround(shared);
+    return true;
+  }
+  #endif
+
+  // ============ [FEAT-V17] Muestreo adaptativo + rechazo MAD ============
+  #if ENABLE_FEAT_V17_ROBUST_STATS
+  int32_t v;
+  StatsInfo info;
+  bool ok = statsReadADC(DISCARD_SAMPLES, millis() + FEAT_V17_SEQ_DEADLINE_MS, v, info);
+  statsLog("ADC", info);
+  if (ok) outValue = v;
+  return ok;
+  #else
   double sum = 0.0;
   uint8_t got = 0;
 
@@ -593,11 +918,40 @@ static bool readADC_DiscardAndAverage(String& outValueStr) {
 
   if (got == 0) return false;
 
-  int avgInt = (int)lround(sum / got);
-  outValueStr = String(avgInt);
+  outValue = (int32_t)lround(sum / got);
   return true;
+  #endif
 }
+#endif
+
+// ============ [FEAT-V15 START] Espera de asentamiento de sonda ============
+#if ENABLE_FEAT_V15_POWER_RAILS
+/**
+ * @brief Espera lo que falte del asentamiento de un riel y lo registra
+ * 
+ * El riel se encendió al inicio de AppInit; normalmente NVS, RTC y LittleFS
+ * ya consumieron la mayor parte del tiempo de asentamiento.
+ * 
+ * @param rail Riel de la sonda
+ * @param untilMs Límite absoluto en millis()
+ * @return true si la sonda está asentada (leer sin descartes)
+ */
+static bool probeSettle(PowerRails::Rail rail, uint32_t untilMs) {
+  uint32_t waited = 0;
+  bool ready = PowerRails::waitReady(rail, untilMs, &waited);
+  Serial.printf("[FEAT-V15] %s: espera asentamiento %lu ms%s\n",
+                PowerRails::name(rail), (unsigned long)waited,
+                ready ? "" : " (no listo)");
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  if (rail == PowerRails::RAIL_RS485) g_timing.rs485SettleWait = waited;
+  else if (rail == PowerRails::RAIL_I2C) g_timing.i2cSettleWait = waited;
+  #endif
+  return ready;
+}
+#endif
+// ============ [FEAT-V15 END] ============
 
+#if !ENABLE_FEAT_V13_CONCURRENT_SAMPLING
 /**
  * @brief Lee el sensor I2C (temperatura y humedad) con descarte y promediado
  * 
@@ -606,20 +960,38 @@ static bool readADC_DiscardAndAverage(String& outValueStr) {
  * 2. Promedia las siguientes KEEP_SAMPLES lecturas (5)
  * 3. Multiplica por 100 para almacenar con 2 decimales como entero
  * 
- * @param[out] outTempStr String con temperatura promediada (en centésimas de grado)
- * @param[out] outHumStr String con humedad promediada (en centésimas de porcentaje)
+ * @param[out] outTemp Temperatura promediada (en centésimas de grado)
+ * @param[out] outHum Humedad promediada (en centésimas de porcentaje)
  * 
  * @return true si se obtuvieron lecturas válidas, false si todas fallaron
  * 
- * @note Los valores se almacenan multiplicados por 100 (ej: 25.67°C → "2567")
+ * @note Los valores se almacenan multiplicados por 100 (ej: 25.67°C → 2567)
  */
-static bool readI2C_DiscardAndAverage(String& outTempStr, String& outHumStr) {
+static bool readI2C_DiscardAndAverage(int32_t& outTemp, int32_t& outHum) {
+  uint8_t discard = DISCARD_SAMPLES;
+
+  // ============ [FEAT-V15] Sonda asentada: sin descartes a ciegas ============
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  if (probeSettle(PowerRails::RAIL_I2C, millis() + FEAT_V15_MAX_SETTLE_WAIT_MS)) discard = 0;
+  #endif
+
+  // ============ [FEAT-V17] Muestreo adaptativo + rechazo MAD ============
+  #if ENABLE_FEAT_V17_ROBUST_STATS
+  int32_t t100, h100;
+  StatsInfo info;
+  bool ok = statsReadI2C(discard, millis() + FEAT_V17_SEQ_DEADLINE_MS, t100, h100, info);
+  statsLog("I2C", info);
+  if (!ok) return false;
+  outTemp = t100;
+  outHum  = h100;
+  return true;
+  #else
   double sumT = 0.0, sumH = 0.0;
   uint8_t got = 0;
 
-  for (uint8_t i = 0; i < (DISCARD_SAMPLES + KEEP_SAMPLES); i++) {
+  for (uint8_t i = 0; i < (discard + KEEP_SAMPLES); i++) {
     if (!i2cSensor.readSensor()) continue;
-    if (i >= DISCARD_SAMPLES) {
+    if (i >= discard) {
       sumT += i2cSensor.getTemperature();
       sumH += i2cSensor.getHumidity();
       got++;
@@ -628,11 +1000,10 @@ static bool readI2C_DiscardAndAverage(String& outTempStr, String& outHumStr) {
 
   if (got == 0) return false;
 
-  int t100 = (int)lround((sumT / got) * 100.0);
-  int h100 = (int)lround((sumH / got) * 100.0);
-  outTempStr = String(t100);
-  outHumStr  = String(h100);
+  outTemp = (int32_t)lround((sumT / got) * 100.0);
+  outHum  = (int32_t)lround((sumH / got) * 100.0);
   return true;
+  #endif
 }
 
 /**
@@ -643,130 +1014,409 @@ static bool readI2C_DiscardAndAverage(String& outTempStr, String& outHumStr) {
  * 1. Descarta las primeras DISCARD_SAMPLES lecturas (5)
  * 2. Toma la última lectura válida de las siguientes KEEP_SAMPLES (5)
  * 
- * @param[out] regsOut Array de 4 strings con los valores de los 4 registros Modbus
+ * @param[out] regsOut Valores de los 4 registros Modbus
  * 
  * @return true si se obtuvo al menos una lectura válida, false si todas fallaron
  * 
  * @note Lee 4 registros consecutivos via Modbus RTU (función 0x03 - Read Holding Registers)
  */
-static bool readRS485_DiscardAndTakeLast(String regsOut[4]) {
+static bool readRS485_DiscardAndTakeLast(int32_t regsOut[4]) {
+  // ============ [FEAT-V17] Mediana por slot con muestreo adaptativo ============
+  #if ENABLE_FEAT_V17_ROBUST_STATS
+  uint8_t discard = DISCARD_SAMPLES;
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  if (probeSettle(PowerRails::RAIL_RS485, millis() + FEAT_V15_MAX_SETTLE_WAIT_MS)) discard = 0;
+  #endif
+  int32_t v[4];
+  StatsInfo info;
+  bool ok = statsReadRS485(discard, millis() + FEAT_V17_SEQ_DEADLINE_MS, v, info);
+  statsLog("RS485", info);
+  if (!ok) return false;
+  memcpy(regsOut, v, sizeof(v));
+  return true;
+  #else
+  // ============ [FEAT-V15] Sonda asentada: primera lectura válida ============
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  if (probeSettle(PowerRails::RAIL_RS485, millis() + FEAT_V15_MAX_SETTLE_WAIT_MS)) {
+    int32_t v[4];
+    for (uint8_t i = 0; i < FEAT_V15_RS485_MAX_READS; i++) {
+      if (!rs485ReadOnce(v)) continue;
+      memcpy(regsOut, v, sizeof(v));
+      return true;
+    }
+    return false;
+  }
+  #endif
+
   bool okLast = false;
+  int32_t v[4];
 
   for (uint8_t i = 0; i < (DISCARD_SAMPLES + KEEP_SAMPLES); i++) {
-    bool ok = rs485Sensor.readSensor();
+    bool ok = rs485ReadOnce(v);
     if (i >= DISCARD_SAMPLES && ok) {
       okLast = true;
-      regsOut[0] = rs485Sensor.getRegisterString(0);
-      regsOut[1] = rs485Sensor.getRegisterString(1);
-      regsOut[2] = rs485Sensor.getRegisterString(2);
-      regsOut[3] = rs485Sensor.getRegisterString(3);
+      memcpy(regsOut, v, sizeof(v));
     }
   }
 
   return okLast;
+  #endif
 }
+#endif
+
+// ============ [FEAT-V10 START] Report-by-exception ============
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+/** @brief Bandas muertas por variable (orden var1..var7) */
+static const int32_t RBE_DEADBAND[VAR_COUNT] = {
+  FEAT_V10_DEADBAND_VAR1, FEAT_V10_DEADBAND_VAR2, FEAT_V10_DEADBAND_VAR3,
+  FEAT_V10_DEADBAND_VAR4, FEAT_V10_DEADBAND_VAR5, FEAT_V10_DEADBAND_VAR6,
+  FEAT_V10_DEADBAND_VAR7
+};
 
 /**
- * @brief Envía todas las tramas del buffer por LTE y las marca como procesadas
- * 
- * Implementa un sistema completo de transmisión con selección inteligente de operadora:
+ * @brief Decide si la muestra actual debe reportarse (trama + buffer + LTE)
  * 
- * 1. **Recuperación de operadora persistente:**
- *    - Lee operadora exitosa anterior desde NVS ("lastOperator")
- *    - Si no existe, escanea todas las operadoras disponibles
- * 
- * 2. **Selección de operadora:**
- *    - Si hay operadora guardada: la usa directamente (optimización)
- *    - Si no: testea todas y selecciona la mejor según score de señal
- *    - Score = (4×SINR) + 2×(RSRP+120) + (RSRQ+20)
- * 
- * 3. **Conexión LTE:**
- *    - Enciende modem SIM7080G
- *    - Configura operadora seleccionada
- *    - Attach a red, activa PDP context
- *    - Abre conexión TCP al servidor
- * 
- * 4. **Transmisión de tramas:**
- *    - Lee todas las líneas del buffer (máx MAX_LINES_TO_READ)
- *    - Salta líneas ya marcadas como procesadas
- *    - Envía cada línea por TCP
- *    - Marca como procesada si envío exitoso
- *    - Detiene envío al primer fallo (preserva datos)
+ * Reporta si:
+ * - No hay referencia previa (primer ciclo tras power-on / reset)
+ * - Alguna variable se movió MÁS que su banda muerta
+ * - Venció el heartbeat (FEAT_V10_HEARTBEAT_S) o el RTC retrocedió
  * 
- * 5. **Gestión de operadora persistente:**
- *    - Si hubo éxito: guarda operadora en NVS para próximos ciclos
- *    - Si falló todo: borra operadora guardada para forzar escaneo
+ * @param nowEpoch Epoch actual del RTC
+ * @return true si se debe reportar, false si la muestra se suprime
+ */
+static bool rbeShouldReport(uint32_t nowEpoch) {
+  if (!g_rbeHasReference) {
+    Serial.println(F("[FEAT-V10] Sin referencia previa -> reportar"));
+    return true;
+  }
+
+  if (nowEpoch < g_rbeLastSentEpoch ||
+      (nowEpoch - g_rbeLastSentEpoch) >= (uint32_t)FEAT_V10_HEARTBEAT_S) {
+    Serial.println(F("[FEAT-V10] Heartbeat vencido -> reportar"));
+    return true;
+  }
+
+  for (uint8_t i = 0; i < VAR_COUNT; i++) {
+    int32_t delta = g_sample.var[i] - g_rbeLastSent[i];
+    if (delta < 0) delta = -delta;
+    if (delta > RBE_DEADBAND[i]) {
+      Serial.printf("[FEAT-V10] var%u cambio %ld > banda %ld -> reportar\n",
+                    (unsigned)(i + 1), (long)delta, (long)RBE_DEADBAND[i]);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Toma la muestra actual como nueva referencia tras guardarla en buffer
+ * @param epoch Epoch de la trama reportada
+ */
+static void rbeCommitReport(uint32_t epoch) {
+  for (uint8_t i = 0; i < VAR_COUNT; i++) {
+    g_rbeLastSent[i] = g_sample.var[i];
+  }
+  g_rbeLastSentEpoch = epoch;
+  g_rbeHasReference = true;
+  g_rbeSuppressed = 0;
+}
+#endif
+// ============ [FEAT-V10 END] ============
+
+// ============ [FEAT-V11 START] Wakeup alineado a reloj ============
+#if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+/**
+ * @brief Actualiza la estimación de deriva al despertar por timer
  * 
- * @return true si se envió al menos una trama exitosamente, false si no se pudo enviar ninguna
+ * Compara los segundos de RTC transcurridos contra los µs programados en el
+ * timer. La medición incluye la latencia de boot, que así también se compensa
+ * (la muestra cae sobre el slot, no solo el wakeup).
  * 
- * @note Las tramas que no se enviaron permanecen en el buffer para el próximo ciclo
- * @note El sistema optimiza reconectándose a la última operadora exitosa
- * @see BUFFERModule::markLineAsProcessed()
- * @see LTEModule::testOperator()
- * @see LTEModule::getBestOperator()
+ * @param wakeEpoch Epoch RTC leído tras initializeRTC()
  */
-static bool sendBufferOverLTE_AndMarkProcessed() {
-  if (!lte.powerOn()) return false;
+static void alignUpdateDrift(uint32_t wakeEpoch) {
+  if (g_alignSleepEpoch == 0 || g_alignTimerUs == 0 ||
+      wakeEpoch < FEAT_V11_MIN_VALID_EPOCH || wakeEpoch < g_alignSleepEpoch) {
+    return;
+  }
 
-  Operadora operadoraAUsar;
-  bool tieneOperadoraGuardada = false;
+  int64_t measuredUs = (int64_t)(wakeEpoch - g_alignSleepEpoch) * 1000000LL;
+  int64_t errPpm = ((measuredUs - (int64_t)g_alignTimerUs) * 1000000LL) / (int64_t)g_alignTimerUs;
 
-  preferences.begin("sensores", false);
-  if (preferences.isKey("lastOperator")) {
-    operadoraAUsar = (Operadora)preferences.getUChar("lastOperator", 0);
-    tieneOperadoraGuardada = true;
-    Serial.print("[INFO][APP] Usando operadora guardada: ");
-    Serial.println(OPERADORAS[operadoraAUsar].nombre);
+  if (errPpm > FEAT_V11_MAX_DRIFT_PPM || errPpm < -FEAT_V11_MAX_DRIFT_PPM) {
+    Serial.printf("[FEAT-V11] Medicion de deriva descartada (%ld ppm)\n", (long)errPpm);
+  } else {
+    g_alignDriftPpm += (int32_t)((errPpm - g_alignDriftPpm) / FEAT_V11_DRIFT_EMA_DIV);
+    Serial.printf("[FEAT-V11] Deriva medida %ld ppm -> estimada %ld ppm\n",
+                  (long)errPpm, (long)g_alignDriftPpm);
   }
-  preferences.end();
+  g_alignSleepEpoch = 0;  // Consumida
+}
 
-  if (!tieneOperadoraGuardada) {
-    Serial.println("[INFO][APP] No hay operadora guardada. Probando todas...");
-    for (uint8_t i = 0; i < NUM_OPERADORAS; i++) {
-      lte.testOperator((Operadora)i);
-    }
-    operadoraAUsar = lte.getBestOperator();
-    Serial.print("[INFO][APP] Mejor operadora seleccionada: ");
-    Serial.println(OPERADORAS[operadoraAUsar].nombre);
+/**
+ * @brief Calcula el sleep hasta el próximo slot alineado y registra la referencia
+ * @return µs a programar en el timer de wakeup
+ */
+static uint64_t alignComputeSleepUs() {
+  uint32_t periodS = (uint32_t)(g_cfg.sleep_time_us / 1000000ULL);
+  uint32_t nowEpoch = getEpochTime();
+
+  if (periodS == 0 || nowEpoch < FEAT_V11_MIN_VALID_EPOCH) {
+    Serial.println(F("[FEAT-V11] RTC sin hora valida, usando sleep fijo"));
+    g_alignSleepEpoch = 0;
+    return g_cfg.sleep_time_us;
   }
 
-#if ENABLE_FIX_V1_SKIP_RESET_PDP
-  // ============ [FIX-V1 START] Si tiene operadora guardada, skip reset ============
-  bool configOk = lte.configureOperator(operadoraAUsar, tieneOperadoraGuardada);
-  // ============ [FIX-V1 END] ============
-#else
-  bool configOk = lte.configureOperator(operadoraAUsar);
+  uint32_t minSleepS = FEAT_V11_MIN_SLEEP_S;
+  if (minSleepS >= periodS) minSleepS = periodS / 2;
+
+  uint32_t wallS = SleepModule::secondsToNextSlot(nowEpoch, periodS, g_alignOffsetS, minSleepS);
+  uint64_t timerUs = SleepModule::compensateDriftUs(wallS, g_alignDriftPpm);
+
+  g_alignSleepEpoch = nowEpoch;
+  g_alignTimerUs = timerUs;
+
+  Serial.printf("[FEAT-V11] Slot %lus (offset %lus): wake en %lus -> timer %llu us (deriva %ld ppm)\n",
+                (unsigned long)periodS, (unsigned long)(g_alignOffsetS % periodS),
+                (unsigned long)wallS, (unsigned long long)timerUs, (long)g_alignDriftPpm);
+  return timerUs;
+}
 #endif
+// ============ [FEAT-V11 END] ============
 
-#if ENABLE_FIX_V2_FALLBACK_OPERADORA
-  // ============ [FIX-V2 START] Fallback a escaneo si falla operadora guardada ============
-  // Fecha: 13 Ene 2026
-  // Autor: Luis Ocaranza
-  // Requisito: RF-12
-  // Premisas: P2 (mínimo), P3 (defaults), P4 (flag), P5 (logs), P6 (aditivo)
-  if (!configOk && tieneOperadoraGuardada) {
-    Serial.println("[WARN][APP] Operadora guardada falló. Evaluando fallback...");
-    
-    // --- PROTECCIÓN ANTI-BUCLE: Verificar si debemos saltar escaneo ---
-    preferences.begin("sensores", false);
-    uint8_t skipCycles = preferences.getUChar("skipScanCycles", 0);
-    if (skipCycles > 0) {
-      preferences.putUChar("skipScanCycles", skipCycles - 1);
-      preferences.end();
-      Serial.print("[WARN][APP] Saltando escaneo. Ciclos restantes: ");
-      Serial.println(skipCycles - 1);
-      lte.powerOff();
-      return false;
+// ============ [FEAT-V18 START] Agregación por ventana ============
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+#if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+static_assert(FEAT_V18_TAIL_S > FEAT_V11_MIN_SLEEP_S,
+              "FEAT_V18_TAIL_S debe superar FEAT_V11_MIN_SLEEP_S");
+#endif
+
+/**
+ * @brief Suma una muestra (var5..var7 en unidades de trama) a la ventana RTC
+ */
+static void windowAdd(const int32_t v[AGG_VAR_COUNT]) {
+  for (uint8_t i = 0; i < AGG_VAR_COUNT; i++) {
+    WindowAgg& a = g_window[i];
+    if (g_windowCount == 0) {
+      a.minV = v[i];
+      a.maxV = v[i];
+      a.sum = 0;
     }
-    preferences.end();
-    // --- FIN PROTECCIÓN ANTI-BUCLE ---
-    
-    Serial.println("[INFO][APP] Iniciando escaneo de todas las operadoras...");
-    
-    // Borrar operadora de NVS inmediatamente
-    preferences.begin("sensores", false);
-    preferences.remove("lastOperator");
-    preferences.end();
+    if (v[i] < a.minV) a.minV = v[i];
+    if (v[i] > a.maxV) a.maxV = v[i];
+    a.sum += v[i];
+  }
+  if (g_windowCount < UINT16_MAX) g_windowCount++;
+}
+
+/**
+ * @brief Suma la muestra principal del ciclo (var5..var7) a la ventana
+ */
+static void windowAddCycleSample() {
+  windowAdd(&g_sample.var[AGG_FIRST_VAR]);
+}
+
+/**
+ * @brief Sub-muestra barata: una lectura I2C y una ráfaga ADC, sin descarte
+ * @return true si ambos sensores respondieron
+ */
+static bool windowSubsample() {
+  if (!i2cSensor.readSensor()) return false;
+  #if ENABLE_FEAT_V14_FAST_ADC
+  if (!adcSensor.readOversampled()) return false;
+  #else
+  if (!adcSensor.readSensor()) return false;
+  #endif
+
+  int32_t v[AGG_VAR_COUNT];
+  v[0] = (int32_t)lround(i2cSensor.getTemperature() * 100.0f);  // var5
+  v[1] = (int32_t)lround(i2cSensor.getHumidity() * 100.0f);     // var6
+  v[2] = (int32_t)lround(adcSensor.getValue());                  // var7 (V x100)
+  windowAdd(v);
+  return true;
+}
+
+/**
+ * @brief Vuelca los agregados de la ventana al formatter
+ */
+static void windowApplyToFrame() {
+  uint16_t n = g_windowCount;
+  formatter.setAggregateCount(n);
+  for (uint8_t i = 0; i < AGG_VAR_COUNT; i++) {
+    if (n == 0) {
+      formatter.setAggregate(i, 0, 0, 0);
+      continue;
+    }
+    const WindowAgg& a = g_window[i];
+    int64_t half = (a.sum >= 0) ? (n / 2) : -(int64_t)(n / 2);
+    formatter.setAggregate(i, a.minV, a.maxV, (int32_t)((a.sum + half) / n));
+  }
+}
+
+/**
+ * @brief Sleep que se haría ahora (hasta el slot con FEAT-V11, o fijo)
+ * @return µs de presupuesto para sub-muestreo + deep sleep final
+ */
+static uint64_t windowSleepBudgetUs() {
+  #if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+  uint32_t periodS = (uint32_t)(g_cfg.sleep_time_us / 1000000ULL);
+  uint32_t nowEpoch = getEpochTime();
+  if (periodS > 0 && nowEpoch >= FEAT_V11_MIN_VALID_EPOCH) {
+    return (uint64_t)SleepModule::secondsToNextSlot(nowEpoch, periodS, g_alignOffsetS, 0) * 1000000ULL;
+  }
+  #endif
+  return g_cfg.sleep_time_us;
+}
+
+/**
+ * @brief Sub-muestrea ADC/I2C en light sleep hasta dejar solo la cola de deep sleep
+ * 
+ * El modem ya está apagado (FIX-V4) y el riel RS485 se corta: solo quedan
+ * sensores de consumo bajo. Deja en g_windowElapsedUs el tiempo consumido
+ * para descontarlo del deep sleep (sin FEAT-V11, que relee el RTC).
+ */
+static void windowRun() {
+  const uint64_t subUs = (uint64_t)FEAT_V18_SUBSAMPLE_S * 1000000ULL;
+  const uint64_t tailUs = (uint64_t)FEAT_V18_TAIL_S * 1000000ULL;
+  uint64_t budgetUs = windowSleepBudgetUs();
+  g_windowElapsedUs = 0;
+  if (budgetUs <= subUs + tailUs) return;
+
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  PowerRails::powerOff(PowerRails::RAIL_RS485);  // Las sondas no se sub-muestrean
+  #endif
+
+  Serial.printf("[FEAT-V18] Sub-muestreo cada %us en light sleep (presupuesto %lus)\n",
+                (unsigned)FEAT_V18_SUBSAMPLE_S, (unsigned long)(budgetUs / 1000000ULL));
+
+  int64_t t0 = esp_timer_get_time();
+  uint16_t taken = 0, failed = 0;
+  while (g_windowElapsedUs + subUs + tailUs < budgetUs) {
+    Serial.flush();  // UART no transmite en light sleep
+    sleepModule.clearWakeupSources();
+    esp_sleep_enable_timer_wakeup(subUs);
+    esp_light_sleep_start();
+    #if ENABLE_FIX_V5_WATCHDOG
+    esp_task_wdt_reset();
+    #endif
+    if (windowSubsample()) taken++; else failed++;
+    g_windowElapsedUs = (uint64_t)(esp_timer_get_time() - t0);
+  }
+
+  Serial.printf("[FEAT-V18] Ventana: +%u sub-muestras (%u fallidas) en %lus, n=%u\n",
+                (unsigned)taken, (unsigned)failed,
+                (unsigned long)(g_windowElapsedUs / 1000000ULL), (unsigned)g_windowCount);
+}
+#endif
+// ============ [FEAT-V18 END] ============
+
+/**
+ * @brief Selecciona operadora y levanta la conexión LTE hasta TCP abierto
+ * 
+ * Parte inicial de sendBufferOverLTE_AndMarkProcessed() (el modem ya debe
+ * estar encendido). Incluye operadora persistente, FIX-V1, FIX-V2, attach,
+ * PDP y apertura TCP. En cualquier fallo deja el modem apagado.
+ * 
+ * @param[out] operadoraAUsar Operadora con la que se conectó
+ * @param[out] tieneOperadoraGuardada true si venía de NVS ("lastOperator")
+ * @return true si la conexión TCP quedó abierta
+ * 
+ * @note FEAT-V12: puede ejecutarse desde la tarea del modem (core 0), por eso
+ *       usa su propia instancia de Preferences.
+ */
+static bool lteConnect(Operadora& operadoraAUsar, bool& tieneOperadoraGuardada) {
+  tieneOperadoraGuardada = false;
+
+  // ============ [FEAT-V22 START] Operadora desde caché RTC ============
+  #if ENABLE_FEAT_V22_PERSIST_CACHE
+  uint8_t savedOp;
+  if (PersistState::lastOperator(savedOp)) {
+    operadoraAUsar = (Operadora)savedOp;
+    tieneOperadoraGuardada = true;
+    Serial.print("[INFO][APP] Usando operadora guardada: ");
+    Serial.println(OPERADORAS[operadoraAUsar].nombre);
+  }
+  #else
+  Preferences preferences;  // Instancia local: no compartir handle NVS entre tareas
+
+  preferences.begin("sensores", false);
+  if (preferences.isKey("lastOperator")) {
+    operadoraAUsar = (Operadora)preferences.getUChar("lastOperator", 0);
+    tieneOperadoraGuardada = true;
+    Serial.print("[INFO][APP] Usando operadora guardada: ");
+    Serial.println(OPERADORAS[operadoraAUsar].nombre);
+  }
+  preferences.end();
+  #endif
+  // ============ [FEAT-V22 END] ============
+
+  if (!tieneOperadoraGuardada) {
+    Serial.println("[INFO][APP] No hay operadora guardada. Probando todas...");
+    for (uint8_t i = 0; i < NUM_OPERADORAS; i++) {
+      lte.testOperator((Operadora)i);
+    }
+    operadoraAUsar = lte.getBestOperator();
+    Serial.print("[INFO][APP] Mejor operadora seleccionada: ");
+    Serial.println(OPERADORAS[operadoraAUsar].nombre);
+  }
+
+#if ENABLE_FIX_V1_SKIP_RESET_PDP
+  // ============ [FIX-V1 START] Si tiene operadora guardada, skip reset ============
+  bool configOk = lte.configureOperator(operadoraAUsar, tieneOperadoraGuardada);
+  // ============ [FIX-V1 END] ============
+#else
+  bool configOk = lte.configureOperator(operadoraAUsar);
+#endif
+
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  // FEAT-V12: el join abortó la tarea; el fallo no es de la operadora, no
+  // tocar NVS ni escanear
+  if (lte.abortRequested()) { lte.powerOff(); return false; }
+  #endif
+
+#if ENABLE_FIX_V2_FALLBACK_OPERADORA
+  // ============ [FIX-V2 START] Fallback a escaneo si falla operadora guardada ============
+  // Fecha: 13 Ene 2026
+  // Autor: Luis Ocaranza
+  // Requisito: RF-12
+  // Premisas: P2 (mínimo), P3 (defaults), P4 (flag), P5 (logs), P6 (aditivo)
+  if (!configOk && tieneOperadoraGuardada) {
+    Serial.println("[WARN][APP] Operadora guardada falló. Evaluando fallback...");
+    
+    // --- PROTECCIÓN ANTI-BUCLE: Verificar si debemos saltar escaneo ---
+    #if ENABLE_FEAT_V22_PERSIST_CACHE
+    uint8_t skipCycles = PersistState::skipScanCycles();
+    if (skipCycles > 0) {
+      PersistState::setSkipScanCycles(skipCycles - 1);  // Write-through
+    #else
+    preferences.begin("sensores", false);
+    uint8_t skipCycles = preferences.getUChar("skipScanCycles", 0);
+    if (skipCycles > 0) {
+      preferences.putUChar("skipScanCycles", skipCycles - 1);
+      FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(uint8_t));  // FEAT-V29
+      preferences.end();
+    #endif
+      Serial.print("[WARN][APP] Saltando escaneo. Ciclos restantes: ");
+      Serial.println(skipCycles - 1);
+      lte.powerOff();
+      return false;
+    }
+    #if !ENABLE_FEAT_V22_PERSIST_CACHE
+    preferences.end();
+    #endif
+    // --- FIN PROTECCIÓN ANTI-BUCLE ---
+    
+    Serial.println("[INFO][APP] Iniciando escaneo de todas las operadoras...");
+    
+    // Borrar operadora de NVS inmediatamente
+    #if ENABLE_FEAT_V22_PERSIST_CACHE
+    PersistState::clearLastOperator();  // FEAT-V22: NVS en flush()
+    #else
+    preferences.begin("sensores", false);
+    preferences.remove("lastOperator");
+    preferences.end();
+    #endif
     Serial.println("[INFO][APP] Operadora eliminada de NVS");
     
     // Escanear todas las operadoras
@@ -798,9 +1448,14 @@ static bool sendBufferOverLTE_AndMarkProcessed() {
       Serial.print(FIX_V2_SKIP_CYCLES_ON_FAIL);
       Serial.println(" ciclos de escaneo.");
       
+      #if ENABLE_FEAT_V22_PERSIST_CACHE
+      PersistState::setSkipScanCycles(FIX_V2_SKIP_CYCLES_ON_FAIL);  // Write-through
+      #else
       preferences.begin("sensores", false);
       preferences.putUChar("skipScanCycles", FIX_V2_SKIP_CYCLES_ON_FAIL);
+      FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(uint8_t));  // FEAT-V29
       preferences.end();
+      #endif
       
       lte.powerOff();
       return false;
@@ -827,279 +1482,1599 @@ static bool sendBufferOverLTE_AndMarkProcessed() {
   
   if (!lte.openTCPConnection())                 { lte.deactivatePDP(); lte.powerOff(); return false; }
 
-  String allLines[MAX_LINES_TO_READ];
-  int total = 0;
-  if (!buffer.readLines(allLines, MAX_LINES_TO_READ, total)) {
-    lte.closeTCPConnection();
-    lte.deactivatePDP();
-    lte.powerOff();
-    Serial.println("[ERROR][APP] No se pudieron leer líneas del buffer");
-    return false;
-  }
+  return true;
+}
 
-  Serial.print("[INFO][APP] Líneas en buffer: ");
-  Serial.println(total);
+// ============ [FEAT-V20 START] Inicialización diferida del modem ============
+#if ENABLE_FEAT_V2_CYCLE_TIMING
+/** @brief ms desde boot hasta deep sleep en el ciclo anterior (latencia wake->sleep) */
+RTC_DATA_ATTR static uint32_t g_lastWakeToSleepMs = 0;
+#endif
 
-  bool anySent = false;
-  int sentCount = 0;
+#if ENABLE_FEAT_V20_LAZY_INIT
+/** @brief SerialLTE y PWRKEY configurados en este boot (lte.begin() ya corrió) */
+static bool g_lteStarted = false;
 
-  for (int i = 0; i < total; i++) {
-    if (allLines[i].startsWith(PROCESSED_MARKER)) {
-      Serial.print("[DEBUG][APP] Línea ");
-      Serial.print(i+1);
-      Serial.println(" ya procesada, saltando...");
-      continue;
-    }
+/** @brief El último Cycle_Sleep confirmó el modem apagado y nadie lo tocó después */
+RTC_DATA_ATTR static bool g_modemOffConfirmed = false;
+#endif
 
-    Serial.print("[INFO][APP] Enviando línea ");
-    Serial.print(i+1);
-    Serial.print("/");
-    Serial.println(total);
-    
-    bool sentOk = lte.sendTCPData(allLines[i]);
-    if (sentOk) {
-      buffer.markLineAsProcessed(i);
-      anySent = true;
-      sentCount++;
-      Serial.print("[INFO][APP] Línea ");
-      Serial.print(i+1);
-      Serial.println(" enviada y marcada como procesada");
-      delay(50);
-    } else {
-      Serial.print("[WARN][APP] Fallo al enviar línea ");
-      Serial.print(i+1);
-      Serial.println(". Deteniendo envío. Línea permanece en buffer.");
-      break;
-    }
-  }
+/**
+ * @brief Inicializa UART/PWRKEY del modem (LTE y GNSS) en el primer uso del ciclo
+ * 
+ * Sin FEAT-V20 es un no-op: AppInit() ya llamó lte.begin().
+ */
+static void ensureLte() {
+  #if ENABLE_FEAT_V20_LAZY_INIT
+  if (g_lteStarted) return;
+  unsigned long t0 = millis();
+  lte.begin();
+  lte.setDebug(true, &Serial);
+  g_lteStarted = true;
+  g_modemOffConfirmed = false;  // A partir de aquí el modem puede quedar encendido
+  Serial.printf("[FEAT-V20] Modem UART iniciado bajo demanda (%lu ms)\n", millis() - t0);
+  #endif
+}
+// ============ [FEAT-V20 END] ============
 
-  lte.closeTCPConnection();
-  lte.deactivatePDP();
-  lte.detachNetwork();
-  lte.powerOff();
+// ============ [FEAT-V12 START] Pipeline dual-core (modem en core 0) ============
+#if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+/** @brief Bit: ICCID disponible (modem encendido o falló el encendido) */
+static const EventBits_t PIPE_BIT_ICCID = BIT0;
 
-  Serial.print("[INFO][APP] Resumen: ");
-  Serial.print(sentCount);
-  Serial.print(" de ");
-  Serial.print(total);
-  Serial.println(" tramas enviadas");
+/** @brief Bit: bring-up terminado (conectado o fallido) */
+static const EventBits_t PIPE_BIT_DONE = BIT1;
 
-  preferences.begin("sensores", false);
-  if (anySent) {
-    preferences.putUChar("lastOperator", (uint8_t)operadoraAUsar);
-    Serial.print("[INFO][APP] Operadora guardada para futuros envios: ");
-    Serial.println(OPERADORAS[operadoraAUsar].nombre);
-    CRASH_MARK_SUCCESS();  // FEAT-V3: Marcar ciclo exitoso
-    g_lteCycleSuccess = true;  // Marcar ciclo LTE exitoso para CYCLE SUMMARY
-    
-    // ============ [FEAT-V7 START] Registrar envío exitoso ============
-    #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-    ProdDiag::recordLTESendOk();
-    #endif
-    // ============ [FEAT-V7 END] ============
+/**
+ * @brief Estado compartido entre AppLoop (core 1) y la tarea del modem (core 0)
+ * @details La tarea solo escribe antes de señalar su bit correspondiente; AppLoop
+ *          solo lee después de esperar ese bit (el event group hace de barrera).
+ */
+struct LtePipeline {
+  TaskHandle_t task;
+  EventGroupHandle_t events;
+  bool active;                     ///< Lanzada en este ciclo y aún no unida
+  bool connected;                  ///< TCP abierto y pendiente de usar/cerrar
+  Operadora operadora;
+  bool tieneOperadoraGuardada;
+  char iccid[ICCID_LEN + 1];
+  unsigned long bringUpMs;
+};
+
+static LtePipeline g_pipe = {};
+
+/**
+ * @brief Tarea FreeRTOS: enciende modem, lee ICCID y levanta la conexión TCP
+ */
+static void lteBringUpTask(void* arg) {
+  (void)arg;
+  unsigned long t0 = millis();
+  g_pipe.connected = false;
+  g_pipe.iccid[0] = '\0';
+
+  if (lte.powerOn()) {
+    String iccid = lte.getICCID();
+    strncpy(g_pipe.iccid, iccid.c_str(), ICCID_LEN);
+    g_pipe.iccid[ICCID_LEN] = '\0';
+    xEventGroupSetBits(g_pipe.events, PIPE_BIT_ICCID);
+
+    g_pipe.connected = lteConnect(g_pipe.operadora, g_pipe.tieneOperadoraGuardada);
   } else {
-    if (tieneOperadoraGuardada) {
-      preferences.remove("lastOperator");
-      Serial.println("[WARN][APP] Envio fallido. Operadora eliminada. Próximo ciclo escaneará todas.");
-    }
-    // ============ [FEAT-V7 START] Registrar envío fallido ============
-    #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-    ProdDiag::recordLTESendFail();
-    #endif
-    // ============ [FEAT-V7 END] ============
+    xEventGroupSetBits(g_pipe.events, PIPE_BIT_ICCID);
   }
-  preferences.end();
 
-  return anySent;
+  g_pipe.bringUpMs = millis() - t0;
+  Serial.printf("[FEAT-V12] Bring-up LTE %s en %lu ms (core %d)\n",
+                g_pipe.connected ? "OK" : "FALLO", g_pipe.bringUpMs, xPortGetCoreID());
+  xEventGroupSetBits(g_pipe.events, PIPE_BIT_DONE);
+  vTaskDelete(NULL);
+}
+
+/** @brief true si hay una tarea de bring-up lanzada y no unida */
+static bool pipelineIsActive() {
+  return g_pipe.active;
 }
 
 /**
- * @brief Inicializa la aplicación y todos sus módulos
- * 
- * Secuencia de inicialización:
- * 
- * 1. **Configuración básica:**
- *    - Guarda configuración de usuario (tiempo de sleep)
- *    - Inicia comunicación serial para debug (115200 baud)
- * 
- * 2. **Gestión de energía:**
- *    - Inicia módulo de sleep
- *    - Detecta causa del wakeup (timer, pin, o boot desde apagado)
- * 
- * 3. **Sistema de tiempo:**
- *    - Inicializa RTC DS1307 para timestamps
- * 
- * 4. **Almacenamiento:**
- *    - Monta sistema LittleFS para buffer persistente
- *    - Si falla: entra en estado de Error
- * 
- * 5. **Sensores:**
- *    - Inicializa ADC (voltaje batería)
- *    - Inicializa I2C (temperatura/humedad)
- *    - Inicializa RS485 Modbus RTU
- * 
- * 6. **Comunicaciones:**
- *    - Configura módulo LTE (SIM7080G)
- *    - Habilita debug del modem
- * 
- * 7. **Selección de modo:**
- *    - **Si wakeup == UNDEFINED (boot desde apagado):**
- *      * Inicia BLE para configuración
- *      * Estado inicial: BleOnly
- *      * Marca próximo ciclo para lectura GPS
- *    - **Si wakeup == TIMER (wakeup desde sleep):**
- *      * Salta BLE
- *      * Estado inicial: Cycle_ReadSensors
- *      * NO lee GPS (usa coordenadas guardadas)
- * 
- * @param cfg Estructura de configuración con parámetros de usuario
- * 
- * @note BLE solo se activa en el primer boot, no en wakeups subsecuentes
- * @note GPS solo se lee en el primer ciclo post-boot para ahorrar energía
+ * @brief Condiciones para usar el modem en paralelo este ciclo
+ * @details Primer ciclo: GPS comparte el modem. Reposo FIX-V3 del ciclo
+ *          anterior: no hay LTE. La batería de este ciclo la revisa
+ *          pipelineStart(), cuando vBat ya está medido.
  */
-void AppInit(const AppConfig& cfg) {
-  g_cfg = cfg;
+static bool pipelineAllowed() {
+  #if DEBUG_MOCK_LTE || DEBUG_MOCK_ICCID
+  return false;
+  #endif
+  if (g_firstCycleAfterBoot) return false;
+  #if ENABLE_FIX_V3_LOW_BATTERY_MODE
+  if (g_restMode) return false;
+  #endif
+  return true;
+}
 
-  Serial.begin(115200);
-  delay(200);
+/**
+ * @brief ¿Lanzar el bring-up antes de conocer los valores de los sensores?
+ * @details Con FEAT-V10 solo si el reporte ya es seguro (sin referencia o
+ *          heartbeat vencido); si no, se lanza tras la decisión de excepción.
+ *          Lee el RTC (I2C): llamar antes de muestrear el bus I2C en paralelo.
+ */
+static bool pipelineEarlyWanted() {
+  if (!pipelineAllowed()) return false;
+  #if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  uint32_t nowEp = getEpochTime();
+  return !g_rbeHasReference || nowEp < g_rbeLastSentEpoch ||
+         (nowEp - g_rbeLastSentEpoch) >= (uint32_t)FEAT_V10_HEARTBEAT_S;
+  #else
+  return true;
+  #endif
+}
 
-  // ============ [FEAT-V3 START] Crash Diagnostics Init ============
-  #if ENABLE_FEAT_V3_CRASH_DIAGNOSTICS
-  CRASH_CHECKPOINT(CP_BOOT_START);
-  CrashDiag::init();
-  
-  // Imprimir reporte si hubo crash
-  if (CrashDiag::hadCrash()) {
-    Serial.println(F("\n⚠️ CRASH DETECTADO EN CICLO ANTERIOR"));
-    CrashDiag::printReport();
-    Serial.println(F("Escribe 'HISTORY' para ver historial completo\n"));
+/**
+ * @brief Lanza la tarea de bring-up LTE en FEAT_V12_MODEM_CORE
+ * @return true si la tarea quedó corriendo (false = flujo secuencial)
+ */
+static bool pipelineStart() {
+  if (g_pipe.active) return true;
+  #if ENABLE_FIX_V3_LOW_BATTERY_MODE
+  if (!batteryAllowsLte()) return false;  // FIX-V3 con el vBat de este ciclo
+  #endif
+  ensureLte();  // FEAT-V20: antes de ceder el modem a core 0
+
+  if (g_pipe.events == NULL) {
+    g_pipe.events = xEventGroupCreate();
+    if (g_pipe.events == NULL) return false;
+  }
+  xEventGroupClearBits(g_pipe.events, PIPE_BIT_ICCID | PIPE_BIT_DONE);
+  g_pipe.connected = false;
+  g_pipe.bringUpMs = 0;
+
+  BaseType_t ok = xTaskCreatePinnedToCore(lteBringUpTask, "lte_pipe",
+                                          FEAT_V12_TASK_STACK, NULL,
+                                          FEAT_V12_TASK_PRIORITY, &g_pipe.task,
+                                          FEAT_V12_MODEM_CORE);
+  if (ok != pdPASS) {
+    Serial.println(F("[FEAT-V12] No se pudo crear tarea LTE, flujo secuencial"));
+    return false;
+  }
+  g_pipe.active = true;
+  Serial.printf("[FEAT-V12] Bring-up LTE lanzado en core %d\n", FEAT_V12_MODEM_CORE);
+  return true;
+}
+
+#if ENABLE_FEAT_V19_STATE_SCHEDULER
+/** @brief true si la tarea del modem ya publicó el ICCID (no bloquea) */
+static bool pipelineIccidReady() {
+  return (xEventGroupGetBits(g_pipe.events) & PIPE_BIT_ICCID) != 0;
+}
+#else
+/**
+ * @brief Espera el ICCID leído por la tarea del modem
+ * @return ICCID (vacío si el modem no encendió o timeout)
+ */
+static const char* pipelineWaitIccid() {
+  EventBits_t bits = xEventGroupWaitBits(g_pipe.events, PIPE_BIT_ICCID, pdFALSE, pdTRUE,
+                                         pdMS_TO_TICKS(FEAT_V12_JOIN_TIMEOUT_MS));
+  if (!(bits & PIPE_BIT_ICCID)) {
+    Serial.println(F("[FEAT-V12] Timeout esperando ICCID"));
+    return "";
+  }
+  return g_pipe.iccid;
+}
+#endif
+
+/**
+ * @brief Punto de unión: espera fin del bring-up y entrega la conexión
+ * @param[out] operadoraAUsar Operadora conectada
+ * @param[out] tieneOperadoraGuardada true si venía de NVS
+ * @return true si la conexión TCP está abierta
+ */
+static bool pipelineJoin(Operadora& operadoraAUsar, bool& tieneOperadoraGuardada) {
+  unsigned long t0 = millis();
+  EventBits_t bits = xEventGroupWaitBits(g_pipe.events, PIPE_BIT_DONE, pdFALSE, pdTRUE,
+                                         pdMS_TO_TICKS(FEAT_V12_JOIN_TIMEOUT_MS));
+  g_pipe.active = false;
+
+  if (!(bits & PIPE_BIT_DONE)) {
+    // La tarea sigue en una espera AT. vTaskDelete() a mitad de un comando
+    // deja el UART a medio leer y pierde la memoria de sus String: se le pide
+    // que corte las esperas y se espera a que salga sola.
+    Serial.println(F("[FEAT-V12] Timeout en join, abortando tarea LTE"));
+    lte.requestAbort(true);
+    bits = xEventGroupWaitBits(g_pipe.events, PIPE_BIT_DONE, pdFALSE, pdTRUE,
+                               pdMS_TO_TICKS(FEAT_V12_ABORT_WAIT_MS));
+    lte.requestAbort(false);
+    if (!(bits & PIPE_BIT_DONE)) {
+      Serial.println(F("[FEAT-V12] La tarea LTE no confirmo el abort"));
+    }
+    lte.powerOff();
+    return false;
+  }
+
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  g_timing.pipelineWaitTime = millis() - t0;
+  g_timing.lteBringUpTime = g_pipe.bringUpMs;
+  #endif
+  Serial.printf("[FEAT-V12] Join: espera %lu ms (bring-up %lu ms en paralelo)\n",
+                millis() - t0, g_pipe.bringUpMs);
+
+  operadoraAUsar = g_pipe.operadora;
+  tieneOperadoraGuardada = g_pipe.tieneOperadoraGuardada;
+  bool connected = g_pipe.connected;
+  g_pipe.connected = false;  // Conexión entregada a sendBufferOverLTE
+  return connected;
+}
+
+/**
+ * @brief Cierra un bring-up no consumido (ej. FIX-V3 bloqueó LTE tras lanzarlo)
+ */
+static void pipelineFinish() {
+  if (!g_pipe.active) return;
+
+  Operadora op;
+  bool saved;
+  if (pipelineJoin(op, saved)) {
+    Serial.println(F("[FEAT-V12] Conexion no usada, cerrando"));
+    lte.closeTCPConnection();
+    lte.deactivatePDP();
+    lte.detachNetwork();
+    lte.powerOff();
+  }
+}
+#endif
+// ============ [FEAT-V12 END] ============
+
+// ============ [FEAT-V13 START] Muestreo concurrente por bus ============
+#if ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+/** @brief Planificador de tareas de muestreo (una por bus) */
+static SensorSampler g_sampler;
+
+/** @brief true si el deadline compartido ya venció */
+static inline bool sampleDeadlineHit(uint32_t deadlineMs) {
+  return (int32_t)(millis() - deadlineMs) >= 0;
+}
+
+/**
+ * @brief Trabajo ADC: misma estrategia que readADC_DiscardAndAverage() con deadline
+ * @details values[0] = vBat x100
+ */
+static void sampleJobADC(SensorResult& out, uint32_t deadlineMs) {
+  #if ENABLE_FEAT_V14_FAST_ADC
+  float shared;
+  if (vbatCycleMeasure(shared)) {  // FEAT-V14: ráfaga de pocos ms, sin deadline
+    out.values[0] = (int32_t)lround(shared);
+    out.samples = FEAT_V14_ADC_OVERSAMPLE;
+    out.ok = true;
+    return;
+  }
+  #endif
+
+  #if ENABLE_FEAT_V17_ROBUST_STATS
+  StatsInfo info;
+  out.ok = statsReadADC(DISCARD_SAMPLES, deadlineMs, out.values[0], info);  // FEAT-V17
+  out.samples = info.taken;
+  out.deadlineHit = info.deadlineHit;
+  return;
+  #endif
+
+  double sum = 0.0;
+  for (uint8_t i = 0; i < (DISCARD_SAMPLES + KEEP_SAMPLES); i++) {
+    if (sampleDeadlineHit(deadlineMs)) { out.deadlineHit = true; break; }
+    if (!adcSensor.readSensor()) continue;
+    if (i >= DISCARD_SAMPLES) {
+      sum += adcSensor.getValue();
+      out.samples++;
+    }
+  }
+  if (out.samples == 0) return;
+  out.values[0] = (int32_t)lround(sum / out.samples);
+  out.ok = true;
+}
+
+/**
+ * @brief Trabajo I2C: misma estrategia que readI2C_DiscardAndAverage() con deadline
+ * @details values[0] = temperatura x100, values[1] = humedad x100
+ */
+static void sampleJobI2C(SensorResult& out, uint32_t deadlineMs) {
+  double sumT = 0.0, sumH = 0.0;
+  uint8_t discard = DISCARD_SAMPLES;
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  if (probeSettle(PowerRails::RAIL_I2C, deadlineMs)) discard = 0;  // FEAT-V15
+  #endif
+  #if ENABLE_FEAT_V17_ROBUST_STATS
+  StatsInfo info;
+  out.ok = statsReadI2C(discard, deadlineMs, out.values[0], out.values[1], info);  // FEAT-V17
+  out.samples = info.taken;
+  out.deadlineHit = info.deadlineHit;
+  return;
+  #endif
+  for (uint8_t i = 0; i < (discard + KEEP_SAMPLES); i++) {
+    if (sampleDeadlineHit(deadlineMs)) { out.deadlineHit = true; break; }
+    if (!i2cSensor.readSensor()) continue;
+    if (i >= discard) {
+      sumT += i2cSensor.getTemperature();
+      sumH += i2cSensor.getHumidity();
+      out.samples++;
+    }
+  }
+  if (out.samples == 0) return;
+  out.values[0] = (int32_t)lround((sumT / out.samples) * 100.0);
+  out.values[1] = (int32_t)lround((sumH / out.samples) * 100.0);
+  out.ok = true;
+}
+
+/**
+ * @brief Trabajo RS485: misma estrategia que readRS485_DiscardAndTakeLast() con deadline
+ * @details values[0..3] = registros Modbus de la última lectura válida
+ */
+static void sampleJobRS485(SensorResult& out, uint32_t deadlineMs) {
+  #if ENABLE_FEAT_V17_ROBUST_STATS
+  uint8_t discard = DISCARD_SAMPLES;
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  if (probeSettle(PowerRails::RAIL_RS485, deadlineMs)) discard = 0;
+  #endif
+  StatsInfo info;
+  out.ok = statsReadRS485(discard, deadlineMs, out.values, info);  // FEAT-V17
+  out.samples = info.taken;
+  out.deadlineHit = info.deadlineHit;
+  return;
+  #endif
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  if (probeSettle(PowerRails::RAIL_RS485, deadlineMs)) {  // FEAT-V15: sin descartes
+    for (uint8_t i = 0; i < FEAT_V15_RS485_MAX_READS; i++) {
+      if (sampleDeadlineHit(deadlineMs)) { out.deadlineHit = true; return; }
+      if (!rs485ReadOnce(out.values)) continue;
+      out.samples = 1;
+      out.ok = true;
+      return;
+    }
+    return;
+  }
+  #endif
+  for (uint8_t i = 0; i < (DISCARD_SAMPLES + KEEP_SAMPLES); i++) {
+    if (sampleDeadlineHit(deadlineMs)) { out.deadlineHit = true; break; }
+    int32_t v[4];
+    bool ok = rs485ReadOnce(v);
+    if (i >= DISCARD_SAMPLES && ok) {
+      out.samples++;
+      for (uint8_t r = 0; r < 4; r++) {
+        out.values[r] = v[r];
+      }
+      out.ok = true;
+    }
+  }
+}
+
+/**
+ * @brief Espera el resultado de un bus y registra su latencia
+ * @return true si llegó un resultado válido
+ */
+static bool sampleCollect(SensorBus bus, bool launched, const char* name,
+                          uint32_t untilMs, SensorResult& r) {
+  if (!launched) {
+    Serial.printf("[FEAT-V13] %s: tarea no lanzada (bus ocupado)\n", name);
+    return false;
+  }
+  if (!g_sampler.waitFor(bus, r, untilMs)) {
+    Serial.printf("[FEAT-V13] %s: sin resultado antes del deadline\n", name);
+    return false;
+  }
+  Serial.printf("[FEAT-V13] %s: %lu ms, %u muestras%s\n", name,
+                (unsigned long)r.latencyMs, (unsigned)r.samples,
+                r.deadlineHit ? " (deadline)" : "");
+  return r.ok;
+}
+
+/**
+ * @brief Muestrea ADC, I2C y RS485 en paralelo con deadline compartido
+ * 
+ * Lanza una tarea por bus y recoge los resultados por SampleSlot. El tiempo
+ * de la fase pasa de (ADC + I2C + RS485) a max(ADC, I2C, RS485).
+ * 
+ * @param[in,out] s Muestra del ciclo; var1..var7 quedan en 0 si el bus falla
+ */
+static void sampleSensorsConcurrent(Sample& s) {
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  bool earlyLte = pipelineEarlyWanted();  // Lee RTC antes de ocupar el bus I2C
+  #endif
+
+  // ============ [FEAT-V16] Detección (boot en frío) fuera del deadline ============
+  #if ENABLE_FEAT_V16_PROBE_REGISTRY
+  if (ProbeRegistry::detectionPending()) {
+    #if ENABLE_FEAT_V15_POWER_RAILS
+    (void)probeSettle(PowerRails::RAIL_RS485, millis() + FEAT_V15_MAX_SETTLE_WAIT_MS);
+    #endif
+    ProbeRegistry::detect();
+  }
+  #endif
+
+  uint32_t deadline = millis() + FEAT_V13_DEADLINE_MS;
+  uint32_t waitUntil = deadline + FEAT_V13_GRACE_MS;
+
+  bool adcRun = g_sampler.start(SensorBus::ADC, sampleJobADC, deadline);
+  bool i2cRun = g_sampler.start(SensorBus::I2C, sampleJobI2C, deadline);
+  bool rsRun  = g_sampler.start(SensorBus::RS485, sampleJobRS485, deadline);
+
+  SensorResult r;
+  if (sampleCollect(SensorBus::ADC, adcRun, "ADC", waitUntil, r)) {
+    s.var[SAMPLE_VBAT] = r.values[0];
+  }
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  g_timing.adcSampleTime = adcRun ? r.latencyMs : 0;
+  #endif
+
+  // ============ [FEAT-V12] vBat medido sin carga del modem -> lanzar bring-up ============
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  if (earlyLte) (void)pipelineStart();
+  #endif
+
+  memset(&r, 0, sizeof(r));
+  if (sampleCollect(SensorBus::I2C, i2cRun, "I2C", waitUntil, r)) {
+    s.var[SAMPLE_TEMP] = r.values[0];
+    s.var[SAMPLE_HUM] = r.values[1];
+  }
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  g_timing.i2cSampleTime = r.latencyMs;
+  #endif
+
+  memset(&r, 0, sizeof(r));
+  if (sampleCollect(SensorBus::RS485, rsRun, "RS485", waitUntil, r)) {
+    for (uint8_t i = 0; i < 4; i++) {
+      s.var[SAMPLE_RS485_0 + i] = r.values[i];
+    }
+  }
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  g_timing.rs485SampleTime = r.latencyMs;
+  #endif
+}
+#endif
+// ============ [FEAT-V13 END] ============
+
+// ============ [FEAT-V30 START] Trama de telemetría ============
+#if ENABLE_FEAT_V30_TELEMETRY_FRAME
+/**
+ * @brief Arma y envía la trama de telemetría por la conexión TCP abierta
+ *
+ * No pasa por el buffer: si el envío falla sigue vencida y se reintenta en
+ * la próxima sesión, con la ventana de tiempos actualizada.
+ */
+static void telemetrySend() {
+  char b64[Telemetry::BASE64_MAX];
+  size_t n = Telemetry::build(g_sample.iccid, g_sample.epoch, b64, sizeof(b64));
+  if (n == 0) {
+    Serial.println(F("[FEAT-V30] Trama de telemetría no cupo en el buffer"));
+    return;
+  }
+  if (lte.sendTCPData((const uint8_t*)b64, n)) {
+    Telemetry::commit();
+    Serial.println(F("[FEAT-V30] Telemetría enviada"));
+  } else {
+    Serial.println(F("[FEAT-V30] Fallo al enviar telemetría, se reintenta en la próxima sesión"));
+  }
+}
+#endif
+// ============ [FEAT-V30 END] ============
+
+/**
+ * @brief Envía todas las tramas del buffer por LTE y las marca como procesadas
+ * 
+ * Implementa un sistema completo de transmisión con selección inteligente de operadora:
+ * 
+ * 1. **Recuperación de operadora persistente:**
+ *    - Lee operadora exitosa anterior desde NVS ("lastOperator")
+ *    - Si no existe, escanea todas las operadoras disponibles
+ * 
+ * 2. **Selección de operadora:**
+ *    - Si hay operadora guardada: la usa directamente (optimización)
+ *    - Si no: testea todas y selecciona la mejor según score de señal
+ *    - Score = (4×SINR) + 2×(RSRP+120) + (RSRQ+20)
+ * 
+ * 3. **Conexión LTE:**
+ *    - Enciende modem SIM7080G
+ *    - Configura operadora seleccionada
+ *    - Attach a red, activa PDP context
+ *    - Abre conexión TCP al servidor
+ * 
+ * 4. **Transmisión de tramas:**
+ *    - Lee todas las líneas del buffer (máx MAX_LINES_TO_READ)
+ *    - Salta líneas ya marcadas como procesadas
+ *    - Envía cada línea por TCP
+ *    - Marca como procesada si envío exitoso
+ *    - Detiene envío al primer fallo (preserva datos)
+ * 
+ * 5. **Gestión de operadora persistente:**
+ *    - Si hubo éxito: guarda operadora en NVS para próximos ciclos
+ *    - Si falló todo: borra operadora guardada para forzar escaneo
+ * 
+ * @return true si se envió al menos una trama exitosamente, false si no se pudo enviar ninguna
+ * 
+ * @note Las tramas que no se enviaron permanecen en el buffer para el próximo ciclo
+ * @note El sistema optimiza reconectándose a la última operadora exitosa
+ * @see BUFFERModule::markLineAsProcessed()
+ * @see LTEModule::testOperator()
+ * @see LTEModule::getBestOperator()
+ */
+static bool sendBufferOverLTE_AndMarkProcessed() {
+  Operadora operadoraAUsar = Operadora::MOVISTAR;
+  bool tieneOperadoraGuardada = false;
+  ensureLte();  // FEAT-V20
+
+  // ============ [FEAT-V12 START] Conexión ya levantada en core 0 ============
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  bool connected = pipelineIsActive()
+                   ? pipelineJoin(operadoraAUsar, tieneOperadoraGuardada)
+                   : (lte.powerOn() && lteConnect(operadoraAUsar, tieneOperadoraGuardada));
+  #else
+  bool connected = lte.powerOn() && lteConnect(operadoraAUsar, tieneOperadoraGuardada);
+  #endif
+  // ============ [FEAT-V12 END] ============
+  if (!connected) return false;
+
+  String allLines[MAX_LINES_TO_READ];
+  int total = 0;
+  if (!buffer.readLines(allLines, MAX_LINES_TO_READ, total)) {
+    lte.closeTCPConnection();
+    lte.deactivatePDP();
+    lte.powerOff();
+    Serial.println("[ERROR][APP] No se pudieron leer líneas del buffer");
+    return false;
+  }
+
+  // FEAT-V27: líneas por trama vía DLOG (diferidas, fuera del tiempo de sendLte)
+  DLOG(APP, INFO, APP_BUF_LINES, total);
+
+  bool anySent = false;
+  int sentCount = 0;
+  #if ENABLE_FEAT_V30_TELEMETRY_FRAME
+  bool linkOk = true;  // FEAT-V30: la sesión TCP sigue usable tras las tramas
+  #endif
+
+  for (int i = 0; i < total; i++) {
+    if (allLines[i].startsWith(PROCESSED_MARKER)) {
+      DLOG(APP, VERBOSE, APP_LINE_SKIP, i + 1);
+      continue;
+    }
+
+    DLOG(APP, INFO, APP_LINE_SEND, i + 1, total);
     
-    // ============ [FEAT-V7 START] Registrar crash en ProductionDiag ============
+    bool sentOk = lte.sendTCPData(allLines[i]);
+    if (sentOk) {
+      buffer.markLineAsProcessed(i);
+      anySent = true;
+      sentCount++;
+      DLOG(APP, INFO, APP_LINE_SENT, i + 1);
+      delay(50);
+    } else {
+      DLOG(APP, WARNING, APP_LINE_FAIL, i + 1);
+      #if ENABLE_FEAT_V30_TELEMETRY_FRAME
+      linkOk = false;
+      #endif
+      break;
+    }
+  }
+
+  // ============ [FEAT-V30 START] Telemetría en la misma sesión TCP ============
+  #if ENABLE_FEAT_V30_TELEMETRY_FRAME
+  // Muestra suprimida (FEAT-V10): sin ICCID ni epoch, espera al próximo reporte
+  if (linkOk && g_sample.epoch != 0 && Telemetry::due()) {
+    telemetrySend();
+  }
+  #endif
+  // ============ [FEAT-V30 END] ============
+
+  lte.closeTCPConnection();
+  lte.deactivatePDP();
+  lte.detachNetwork();
+  lte.powerOff();
+
+  DLOG(APP, INFO, APP_SEND_SUMMARY, sentCount, total);
+
+  #if !ENABLE_FEAT_V22_PERSIST_CACHE
+  preferences.begin("sensores", false);
+  #endif
+  if (anySent) {
+    #if ENABLE_FEAT_V22_PERSIST_CACHE
+    PersistState::setLastOperator((uint8_t)operadoraAUsar);  // FEAT-V22: solo si cambió
+    #else
+    preferences.putUChar("lastOperator", (uint8_t)operadoraAUsar);
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(uint8_t));  // FEAT-V29
+    #endif
+    Serial.print("[INFO][APP] Operadora guardada para futuros envios: ");
+    Serial.println(OPERADORAS[operadoraAUsar].nombre);
+    CRASH_MARK_SUCCESS();  // FEAT-V3: Marcar ciclo exitoso
+    g_lteCycleSuccess = true;  // Marcar ciclo LTE exitoso para CYCLE SUMMARY
+    
+    // ============ [FEAT-V7 START] Registrar envío exitoso ============
     #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-    ProdDiag::recordCrash(CrashDiag::getLastCheckpoint());
+    ProdDiag::recordLTESendOk();
+    #endif
+    // ============ [FEAT-V7 END] ============
+  } else {
+    if (tieneOperadoraGuardada) {
+      #if ENABLE_FEAT_V22_PERSIST_CACHE
+      PersistState::clearLastOperator();
+      #else
+      preferences.remove("lastOperator");
+      #endif
+      Serial.println("[WARN][APP] Envio fallido. Operadora eliminada. Próximo ciclo escaneará todas.");
+    }
+    // ============ [FEAT-V7 START] Registrar envío fallido ============
+    #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+    ProdDiag::recordLTESendFail();
     #endif
     // ============ [FEAT-V7 END] ============
   }
+  #if !ENABLE_FEAT_V22_PERSIST_CACHE
+  preferences.end();
+  #endif
+
+  return anySent;
+}
+
+/**
+ * @brief Inicializa la aplicación y todos sus módulos
+ * 
+ * Secuencia de inicialización:
+ * 
+ * 1. **Configuración básica:**
+ *    - Guarda configuración de usuario (tiempo de sleep)
+ *    - Inicia comunicación serial para debug (115200 baud)
+ * 
+ * 2. **Gestión de energía:**
+ *    - Inicia módulo de sleep
+ *    - Detecta causa del wakeup (timer, pin, o boot desde apagado)
+ * 
+ * 3. **Sistema de tiempo:**
+ *    - Inicializa RTC DS1307 para timestamps
+ * 
+ * 4. **Almacenamiento:**
+ *    - Monta sistema LittleFS para buffer persistente
+ *    - Si falla: entra en estado de Error
+ * 
+ * 5. **Sensores:**
+ *    - Inicializa ADC (voltaje batería)
+ *    - Inicializa I2C (temperatura/humedad)
+ *    - Inicializa RS485 Modbus RTU
+ * 
+ * 6. **Comunicaciones:**
+ *    - Configura módulo LTE (SIM7080G)
+ *    - Habilita debug del modem
+ * 
+ * 7. **Selección de modo:**
+ *    - **Si wakeup == UNDEFINED (boot desde apagado):**
+ *      * Inicia BLE para configuración
+ *      * Estado inicial: BleOnly
+ *      * Marca próximo ciclo para lectura GPS
+ *    - **Si wakeup == TIMER (wakeup desde sleep):**
+ *      * Salta BLE
+ *      * Estado inicial: Cycle_ReadSensors
+ *      * NO lee GPS (usa coordenadas guardadas)
+ * 
+ * @param cfg Estructura de configuración con parámetros de usuario
+ * 
+ * @note BLE solo se activa en el primer boot, no en wakeups subsecuentes
+ * @note GPS solo se lee en el primer ciclo post-boot para ahorrar energía
+ */
+void AppInit(const AppConfig& cfg) {
+  g_cfg = cfg;
+
+  // ============ [FEAT-V23 START] Abrir wake en el ring de trazas ============
+  // Primero que todo: los spans de init (FS, RTC, modem) cuelgan de este wake
+  #if ENABLE_FEAT_V23_TRACE_SPANS
+  TraceSpan::begin();
+  #endif
+  // ============ [FEAT-V23 END] ============
+
+  Serial.begin(115200);
+
+  // ============ [FEAT-V27 START] Tarea de vaciado del log diferido ============
+  #if ENABLE_FEAT_V27_DEFERRED_LOG
+  DeferredLog::begin(&Serial);
+  #endif
+  // ============ [FEAT-V27 END] ============
+
+  // ============ [FEAT-V15 START] Energizar sondas lo antes posible ============
+  // El asentamiento corre en paralelo con NVS, RTC, LittleFS y BLE/LTE init
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  PowerRails::powerOn(PowerRails::RAIL_RS485);
+  #endif
+  // ============ [FEAT-V15 END] ============
+
+  delay(200);
+
+  // ============ [FEAT-V3 START] Crash Diagnostics Init ============
+  #if ENABLE_FEAT_V3_CRASH_DIAGNOSTICS
+  CRASH_CHECKPOINT(CP_BOOT_START);
+  CrashDiag::init();
+  
+  // Imprimir reporte si hubo crash
+  if (CrashDiag::hadCrash()) {
+    Serial.println(F("\n⚠️ CRASH DETECTADO EN CICLO ANTERIOR"));
+    CrashDiag::printReport();
+    Serial.println(F("Escribe 'HISTORY' para ver historial completo\n"));
+    
+    // ============ [FEAT-V7 START] Registrar crash en ProductionDiag ============
+    #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+    ProdDiag::recordCrash(CrashDiag::getLastCheckpoint());
+    #endif
+    // ============ [FEAT-V7 END] ============
+  }
+  #endif
+  // ============ [FEAT-V3 END] ============
+
+  // ============ [FEAT-V0 START] Imprimir versión al iniciar ============
+  printFirmwareVersion();
+  // ============ [FEAT-V0 END] ============
+
+  // ============ [FEAT-V1 START] Imprimir feature flags activos ============
+  printActiveFlags();
+  // ============ [FEAT-V1 END] ============
+
+  // ============ [FIX-V5 START] Inicializar Watchdog de Sistema ============
+  #if ENABLE_FIX_V5_WATCHDOG
+  // ESP-IDF v5.x requiere estructura de configuración
+  const esp_task_wdt_config_t wdt_config = {
+    .timeout_ms = FIX_V5_WATCHDOG_TIMEOUT_S * 1000,  // Convertir a ms
+    .idle_core_mask = 0,                             // No monitorear idle tasks
+    .trigger_panic = true                            // Reset en timeout
+  };
+  esp_task_wdt_init(&wdt_config);
+  esp_task_wdt_add(NULL);  // Agregar tarea actual (loopTask)
+  Serial.print(F("[FIX-V5] Watchdog iniciado ("));
+  Serial.print(FIX_V5_WATCHDOG_TIMEOUT_S);
+  Serial.println(F("s)"));
+  #endif
+  // ============ [FIX-V5 END] ============
+
+  // ============ [FEAT-V4 START] Validación anti boot-loop ============
+  #if ENABLE_FEAT_V4_PERIODIC_RESTART
+  {
+    esp_reset_reason_t reset_reason = esp_reset_reason();
+    
+    // [FEAT-V5] Log de contadores stress test al inicio (verificar persistencia RTC)
+    #if DEBUG_STRESS_TEST_ENABLED
+    Serial.printf("[STRESS] Boot - restart_count=%lu, cycle_count=%lu (RTC persist check)\n",
+                  g_stress_restart_count, g_stress_cycle_count);
+    #endif
+    
+    // Caso 1: Boot después de restart planificado FEAT-V4
+    if (g_last_restart_reason_feat4 == FEAT4_RESTART_EXECUTED) {
+      Serial.println(F("[FEAT-V4] Boot post-restart periódico detectado."));
+      Serial.printf("[FEAT-V4] Tiempo acumulado antes de restart: %llu us\n", g_accum_sleep_us);
+      
+      // Reset completo del acumulador y flag
+      g_accum_sleep_us = 0;
+      g_last_restart_reason_feat4 = FEAT4_RESTART_NONE;
+    }
+    // Caso 2: Power-on (power cycle completo) - resetear acumulador y contadores stress
+    else if (reset_reason == ESP_RST_POWERON) {
+      Serial.println(F("[FEAT-V4] Power-on detectado. Reseteando acumulador."));
+      g_accum_sleep_us = 0;
+      g_last_restart_reason_feat4 = FEAT4_RESTART_NONE;
+      #if DEBUG_STRESS_TEST_ENABLED
+      g_stress_restart_count = 0;
+      g_stress_cycle_count = 0;
+      Serial.println(F("[STRESS] Power-on: contadores reseteados a 0"));
+      #endif
+    }
+    // Caso 3: Wakeup normal de deep sleep - acumulador persiste (no hacer nada)
+    
+    // Log estado actual del acumulador
+    float pct = (FEAT_V4_THRESHOLD_US > 0) ? 
+                ((float)g_accum_sleep_us / FEAT_V4_THRESHOLD_US * 100.0f) : 0.0f;
+    Serial.printf("[FEAT-V4] Acumulador: %llu / %llu us (%.1f%%)\n",
+        g_accum_sleep_us, 
+        (uint64_t)FEAT_V4_THRESHOLD_US,
+        pct);
+  }
+  #endif
+  // ============ [FEAT-V4 END] ============
+
+  sleepModule.begin();
+  g_wakeupCause = sleepModule.getWakeupCause();
+
+  (void)initializeRTC();
+
+  // ============ [FEAT-V11 START] Estimar deriva del timer de sleep ============
+  #if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+  if (g_wakeupCause == ESP_SLEEP_WAKEUP_TIMER) {
+    alignUpdateDrift(getEpochTime());
+  } else {
+    g_alignSleepEpoch = 0;  // Boot en frío: sin referencia válida
+  }
+  #endif
+  // ============ [FEAT-V11 END] ============
+
+  if (!buffer.begin()) {
+    g_state = AppState::Error;
+    g_initialized = true;
+    return;
+  }
+  CRASH_CHECKPOINT(CP_BOOT_LITTLEFS_OK);  // FEAT-V3
+
+  // ============ [FEAT-V7 START] Inicializar Production Diagnostics ============
+  #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+  ProdDiag::init();
+  ProdDiag::setResetReason((uint8_t)esp_reset_reason());
+  #endif
+  // ============ [FEAT-V7 END] ============
+
+  // ============ [FEAT-V22 START] Estado persistente en RTC ============
+  #if ENABLE_FEAT_V22_PERSIST_CACHE
+  (void)PersistState::begin();  // NVS solo si la copia RTC no es válida
+  #endif
+  // ============ [FEAT-V22 END] ============
+
+  (void)adcSensor.begin();
+  (void)i2cSensor.begin();
+  (void)rs485Sensor.begin();
+
+  // ============ [FEAT-V16 START] Registro de sondas Modbus ============
+  #if ENABLE_FEAT_V16_PROBE_REGISTRY
+  ProbeRegistry::begin(rs485Sensor, g_wakeupCause == ESP_SLEEP_WAKEUP_UNDEFINED);
+  #if ENABLE_FEAT_V15_POWER_RAILS
+  PowerRails::setSettleMs(PowerRails::RAIL_RS485, ProbeRegistry::warmupMs());
+  #endif
+  #endif
+  // ============ [FEAT-V16 END] ============
+
+  // ============ [FEAT-V20 START] Modem bajo demanda ============
+  // Con FEAT-V20 SerialLTE se inicia en el primer uso (ensureLte()): ciclos
+  // suprimidos (FEAT-V10) sin tramas pendientes o en reposo (FIX-V3) no lo
+  // configuran nunca.
+  #if !ENABLE_FEAT_V20_LAZY_INIT
+  lte.begin();
+  lte.setDebug(true, &Serial);
+  #endif
+  // ============ [FEAT-V20 END] ============
+
+  if (g_wakeupCause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+    #if ENABLE_FEAT_V9_BLE_CONFIG
+    ble.begin("RV03");
+    g_state = AppState::BleOnly;
+    #else
+    // BLE deshabilitado - saltar directamente a ciclo de sensores
+    Serial.println(F("[INFO][APP] BLE DESHABILITADO - Iniciando ciclo directo"));
+    g_state = AppState::Cycle_ReadSensors;
+    #endif
+    g_firstCycleAfterBoot = true;
+  } else {
+    g_state = AppState::Cycle_ReadSensors;
+    g_firstCycleAfterBoot = false;
+  }
+
+  #if ENABLE_FEAT_V28_MEM_WATERMARKS
+  StateSched::captureInitMem(g_initMem);  // FEAT-V28: pico de AppInit (BLE, FS, LTE)
+  #endif
+
+  g_initialized = true;
+}
+
+// ============ [FEAT-V19 START] Handlers y tabla de estados ============
+using StateSched::Step;
+using StateSched::Ctx;
+
+static void printCyclePath();
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+static void finishCycleMem();
+#endif
+
+#if ENABLE_FEAT_V9_BLE_CONFIG
+/**
+ * @brief BleOnly: cede mientras la ventana BLE esté abierta; al cerrarse abre el ciclo
+ */
+static Step stateBleOnly(Ctx& ctx) {
+  (void)ctx;
+  if (ble.isActive()) return Step::Yield;
+
+  TIMING_RESET(g_timing);  // Inicia timing del ciclo cuando termina BLE
+  g_lteCycleSuccess = false;  // Reset para CYCLE SUMMARY
+  g_lastCSQ = 99;  // Reset CSQ
+
+  // ============ [DEBUG-EMI] Log de inicio de ciclo diagnóstico EMI ============
+  #if DEBUG_EMI_DIAGNOSTIC_ENABLED
+  g_emiDiagCycleCount++;
+  Serial.println();
+  Serial.println(F("╔════════════════════════════════════════════════════════════╗"));
+  Serial.printf(   "║  [EMI-DIAG] CICLO #%lu / %d                                  ║\n", 
+                  g_emiDiagCycleCount, DEBUG_EMI_DIAGNOSTIC_CYCLES);
+  Serial.printf(   "║  Heap libre: %lu bytes                                     ║\n", ESP.getFreeHeap());
+  Serial.println(F("║  Modo: COMUNICACIÓN REAL (mocks desactivados)              ║"));
+  Serial.println(F("╚════════════════════════════════════════════════════════════╝"));
+  #endif
+
+  // ============ [FEAT-V5] Log de inicio de ciclo stress test ============
+  #if DEBUG_STRESS_TEST_ENABLED
+  g_stress_cycle_count++;
+  g_stress_heap_start = ESP.getFreeHeap();
+  g_stress_cycle_start_ms = millis();  // Track tiempo real del ciclo
+  Serial.println();
+  Serial.println(F("\n[STRESS] ══════════════════════════════════════"));
+  Serial.printf("[STRESS] CICLO #%lu (restart #%lu)\n", g_stress_cycle_count, g_stress_restart_count);
+  Serial.printf("[STRESS] Heap libre: %lu bytes\n", g_stress_heap_start);
+  #if ENABLE_FEAT_V4_PERIODIC_RESTART
+  uint64_t threshold = FEAT_V4_THRESHOLD_US;
+  uint8_t pct = (uint8_t)((g_accum_sleep_us * 100ULL) / threshold);
+  uint32_t secsToRestart = (uint32_t)((threshold - g_accum_sleep_us) / 1000000ULL);
+  Serial.printf("[STRESS] Tiempo acum: %llu / %llu us (%u%%)\n", g_accum_sleep_us, threshold, pct);
+  Serial.printf("[STRESS] Proximo restart en: ~%lu seg\n", secsToRestart);
+  #endif
+  Serial.println(F("[STRESS] ══════════════════════════════════════"));
+  #endif
+
+  return Step::Done;  // -> Cycle_ReadSensors
+}
+#endif
+
+/**
+ * @brief Cycle_ReadSensors: muestrea los 3 buses y decide reporte (FEAT-V10) y ruta GPS
+ */
+static Step stateReadSensors(Ctx& ctx) {
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  g_timing.wakeToSample = millis();  // FEAT-V20: latencia wake->primera muestra
+  g_timing.prevWakeToSleep = g_lastWakeToSleepMs;
+  Serial.printf("[TIMING] wakeToSample: %lu ms\n", g_timing.wakeToSample);
+  #endif
+  #if ENABLE_FEAT_V14_FAST_ADC
+  g_vbatCycleValid = false;  // FEAT-V14: nueva medición vBat para este ciclo
+  #endif
+  #if ENABLE_FIX_V3_LOW_BATTERY_MODE
+  g_batteryEvaluated = false;  // FIX-V3: evaluar con el vBat de este ciclo
+  #endif
+  g_sample.clear();  // FEAT-V21: sensor que falla -> 0 en la trama
+  #if DEBUG_STRESS_TEST_ENABLED
+  stressPathBegin();  // FEAT-V21
+  #endif
+
+  // ============ [FEAT-V13 START] Muestreo concurrente por bus ============
+  #if ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+  sampleSensorsConcurrent(g_sample);  // Incluye lanzamiento FEAT-V12
+  #else
+  if (!readADC_DiscardAndAverage(g_sample.var[SAMPLE_VBAT])) g_sample.var[SAMPLE_VBAT] = 0;
+
+  // ============ [FEAT-V12 START] Lanzar bring-up LTE en paralelo ============
+  // vBat ya se midió sin la carga del modem. Con FEAT-V10 solo se lanza
+  // temprano si el reporte ya es seguro (sin referencia o heartbeat vencido).
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  if (pipelineEarlyWanted()) (void)pipelineStart();
+  #endif
+  // ============ [FEAT-V12 END] ============
+
+  if (!readI2C_DiscardAndAverage(g_sample.var[SAMPLE_TEMP], g_sample.var[SAMPLE_HUM])) {
+    g_sample.var[SAMPLE_TEMP] = 0;
+    g_sample.var[SAMPLE_HUM] = 0;
+  }
+
+  (void)readRS485_DiscardAndTakeLast(&g_sample.var[SAMPLE_RS485_0]);
+  #endif
+  // ============ [FEAT-V13 END] ============
+
+  #if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  windowAddCycleSample();  // FEAT-V18: la muestra principal también cuenta
+  #endif
+
+  // ============ [FEAT-V10 START] Suprimir muestra sin cambios ============
+  #if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  // El primer ciclo post-boot siempre reporta (adquiere GPS)
+  if (!g_firstCycleAfterBoot && !rbeShouldReport(getEpochTime())) {
+    if (g_rbeSuppressed < UINT16_MAX) g_rbeSuppressed++;
+    DLOG(APP, INFO, APP_RBE_SUPPRESSED, (unsigned)g_rbeSuppressed);  // FEAT-V27
+    ctx.next = (uint8_t)AppState::Cycle_Sleep;  // Sin trama, sin buffer, sin LTE
+    // CompactBuffer deja en el archivo solo tramas sin enviar: si quedaron de
+    // un envío fallido se reintentan ahora y no recién en el próximo reporte
+    size_t pending = buffer.getFileSize();
+    #if ENABLE_FIX_V3_LOW_BATTERY_MODE
+    if (!batteryAllowsLte()) pending = 0;
+    #endif
+    if (pending > 0) {
+      DLOG(APP, INFO, APP_RBE_PENDING, (unsigned)pending);  // FEAT-V27
+      ctx.next = (uint8_t)AppState::Cycle_SendLTE;
+    }
+    return Step::Done;
+  }
+  #endif
+  // ============ [FEAT-V10 END] ============
+
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  // FEAT-V12: muestra reportable -> solapar bring-up con GPS NVS/trama/buffer
+  if (pipelineAllowed()) (void)pipelineStart();
+  #endif
+
+  if (g_firstCycleAfterBoot) {
+    Serial.println("[INFO][APP] Primer ciclo: leyendo GPS");
+    g_firstCycleAfterBoot = false;
+    ctx.next = (uint8_t)AppState::Cycle_Gps;
+  }
+  return Step::Done;  // Ciclo subsecuente -> Cycle_GpsNvs
+}
+
+/**
+ * @brief Cycle_GpsNvs: recupera las últimas coordenadas guardadas por Cycle_Gps
+ */
+static Step stateGpsNvs(Ctx& ctx) {
+  (void)ctx;
+  Serial.println("[INFO][APP] Ciclo subsecuente: recuperando coordenadas GPS de NVS");
+
+  // ============ [FEAT-V22 START] Coordenadas desde caché RTC ============
+  #if ENABLE_FEAT_V22_PERSIST_CACHE
+  float lat, lng, alt;
+  if (PersistState::gps(lat, lng, alt)) {
+  #else
+  preferences.begin("sensores", true);
+  if (preferences.isKey("gps_lat") && preferences.isKey("gps_lng") && preferences.isKey("gps_alt")) {
+    float lat = preferences.getFloat("gps_lat", 0.0f);
+    float lng = preferences.getFloat("gps_lng", 0.0f);
+    float alt = preferences.getFloat("gps_alt", 0.0f);
+    preferences.end();
+  #endif
+  // ============ [FEAT-V22 END] ============
+
+    formatCoord(g_lat, sizeof(g_lat), lat);
+    formatCoord(g_lng, sizeof(g_lng), lng);
+    formatAlt(g_alt, sizeof(g_alt), alt);
+
+    Serial.print("[INFO][APP] GPS recuperado - Lat: ");
+    Serial.print(g_lat);
+    Serial.print(", Lng: ");
+    Serial.print(g_lng);
+    Serial.print(", Alt: ");
+    Serial.println(g_alt);
+  } else {
+    #if !ENABLE_FEAT_V22_PERSIST_CACHE
+    preferences.end();
+    #endif
+    fillZeros(g_lat, COORD_LEN);
+    fillZeros(g_lng, COORD_LEN);
+    fillZeros(g_alt, ALT_LEN);
+    Serial.println("[WARN][APP] No hay coordenadas GPS en NVS, usando ceros");
+  }
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_Gps: adquiere fix GNSS (primer ciclo tras boot) y lo persiste en NVS
+ */
+static Step stateGps(Ctx& ctx) {
+  (void)ctx;
+  fillZeros(g_lat, COORD_LEN);
+  fillZeros(g_lng, COORD_LEN);
+  fillZeros(g_alt, ALT_LEN);
+
+  #if DEBUG_MOCK_GPS
+  // [DEBUG][FEAT-V5] GPS simulado para stress test
+  {
+    unsigned long mockStart = millis();
+    formatCoord(g_lat, sizeof(g_lat), 19.4326f);   // CDMX dummy lat
+    formatCoord(g_lng, sizeof(g_lng), -99.1332f);  // CDMX dummy lng
+    formatAlt(g_alt, sizeof(g_alt), 2240.0f);      // CDMX dummy alt
+    Serial.printf("[MOCK][GPS] Coords: %s, %s, alt=%s (%lums)\n", 
+                  g_lat, g_lng, g_alt, millis() - mockStart);
+  }
+  return Step::Done;
+  #endif
+
+  GpsFix fix;
+  bool gotFix = false;
+
+  ensureLte();  // FEAT-V20: GNSS comparte SerialLTE
+  if (gps.powerOn()) {
+    gotFix = gps.getCoordinatesAndShutdown(fix);
+  }
+
+  if (gotFix && fix.hasFix) {
+    formatCoord(g_lat, sizeof(g_lat), fix.latitude);
+    formatCoord(g_lng, sizeof(g_lng), fix.longitude);
+    formatAlt(g_alt, sizeof(g_alt), fix.altitude);
+
+    #if ENABLE_FEAT_V22_PERSIST_CACHE
+    PersistState::setGps(fix.latitude, fix.longitude, fix.altitude);  // FEAT-V22: NVS en flush()
+    #else
+    preferences.begin("sensores", false);
+    preferences.putFloat("gps_lat", fix.latitude);
+    preferences.putFloat("gps_lng", fix.longitude);
+    preferences.putFloat("gps_alt", fix.altitude);
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(float));  // FEAT-V29
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(float));
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(float));
+    preferences.end();
+    #endif
+
+    Serial.println("[INFO][APP] Coordenadas GPS guardadas en NVS");
+    Serial.print("[INFO][APP] Lat: ");
+    Serial.print(g_lat);
+    Serial.print(", Lng: ");
+    Serial.print(g_lng);
+    Serial.print(", Alt: ");
+    Serial.println(g_alt);
+  } else {
+    Serial.println("[WARN][APP] No se obtuvo fix GPS, usando ceros");
+  }
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_GetICCID: lee el ICCID (o lo toma de la tarea FEAT-V12, cediendo mientras llega)
+ */
+static Step stateGetIccid(Ctx& ctx) {
+  (void)ctx;  // Solo lo usa la espera del ICCID con FEAT-V19
+  #if DEBUG_MOCK_ICCID
+  // [DEBUG][FEAT-V5] ICCID simulado para stress test
+  {
+    unsigned long mockStart = millis();
+    g_sample.setIccid("89520000000000000000");  // ICCID dummy
+    Serial.printf("[MOCK][ICCID] %s (%lums)\n", g_sample.iccid, millis() - mockStart);
+  }
+  #else
+  ensureLte();  // FEAT-V20
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  if (pipelineIsActive()) {
+    #if ENABLE_FEAT_V19_STATE_SCHEDULER
+    // FEAT-V19: ceder hasta que core 0 publique el ICCID (deadline del estado)
+    if (!pipelineIccidReady()) {
+      if (!ctx.timedOut) return Step::Yield;
+      Serial.println(F("[FEAT-V12] Timeout esperando ICCID"));
+      g_sample.setIccid("");
+    } else {
+      g_sample.setIccid(g_pipe.iccid);
+    }
+    #else
+    g_sample.setIccid(pipelineWaitIccid());  // FEAT-V12: modem ya encendido en core 0
+    #endif
+  } else
+  #endif
+  if (lte.powerOn()) {
+    g_sample.setIccid(lte.getICCID().c_str());  // String solo dentro de la capa AT
+    lte.powerOff();
+  } else {
+    g_sample.setIccid("");
+  }
+  #endif
+
+  // ============ [FEAT-V11 START] Desfase por dispositivo ============
+  #if ENABLE_FEAT_V11_ALIGNED_WAKEUP && FEAT_V11_ICCID_OFFSET
+  if (g_sample.iccid[0] != '\0') {
+    g_alignOffsetS = SleepModule::hashOffsetS(g_sample.iccid, FEAT_V11_OFFSET_WINDOW_S);
+  }
+  #endif
+  // ============ [FEAT-V11 END] ============
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_BuildFrame: arma la trama y su versión Base64 en g_frame
+ */
+static Step stateBuildFrame(Ctx& ctx) {
+  (void)ctx;
+  g_sample.epoch = getEpochTime();
+  g_lastEpoch = g_sample.epoch;  // FEAT-V7: Guardar epoch numérico
+
+  // ============ [FEAT-V9 START] Actualizar epoch en ProductionDiag ============
+  #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+  ProdDiag::setCurrentEpoch(g_lastEpoch);
+  #endif
+  // ============ [FEAT-V9 END] ============
+
+  formatter.reset();
+  formatter.setSample(g_sample);  // FEAT-V21: ICCID, epoch y var1..var7 sin String
+  formatter.setLat(g_lat);
+  formatter.setLng(g_lng);
+  formatter.setAlt(g_alt);
+  #if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  formatter.setSuppressed(g_rbeSuppressed);  // FEAT-V10
+  #endif
+  #if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  windowApplyToFrame();  // FEAT-V18
+  #endif
+
+  char frameNormal[FRAME_MAX_LEN];
+  if (!formatter.buildFrame(frameNormal, sizeof(frameNormal))) {
+    return Step::Fail;
+  }
+  Serial.println("[INFO][APP] === TRAMA NORMAL ===");
+  Serial.println(frameNormal);
+
+  Serial.println("[DEBUG][APP] Generando trama Base64...");
+  if (!formatter.buildFrameBase64(g_frame, sizeof(g_frame))) {
+    return Step::Fail;
+  }
+  Serial.println("[INFO][APP] === TRAMA BASE64 ===");
+  Serial.println(g_frame);
+  Serial.println();
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_BufferWrite: persiste la trama; FIX-V3 puede desviar a sleep
+ */
+static Step stateBufferWrite(Ctx& ctx) {
+  (void)ctx;  // Solo lo usa el desvío de FIX-V3
+  Serial.println("[INFO][APP] Guardando trama en buffer (persistente)...");
+  bool saved = buffer.appendLine(g_frame);
+  #if DEBUG_STRESS_TEST_ENABLED
+  stressPathEnd();  // FEAT-V21
+  #endif
+  if (saved) {
+    Serial.println("[INFO][APP] Trama guardada exitosamente en buffer");
+    #if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+    rbeCommitReport(g_lastEpoch);  // FEAT-V10: nueva referencia, suprimidas = 0
+    #endif
+    #if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+    g_windowCount = 0;  // FEAT-V18: nueva ventana tras trama persistida
+    #endif
+  } else {
+    Serial.println("[ERROR][APP] Fallo al guardar trama en buffer");
+  }
+
+#if ENABLE_FIX_V3_LOW_BATTERY_MODE
+  // ============ [FIX-V3 START] Verificar batería antes de LTE ============
+  // Si FEAT-V12 ya lanzó el bring-up, la evaluación se hizo antes de encender
+  // el modem y aquí solo se consulta su resultado.
+  if (!batteryAllowsLte()) {
+    // Estamos en reposo - SALTAR LTE, ir directo a sleep
+    Serial.println(F("[FIX-V3] Datos guardados. LTE bloqueado por bateria baja."));
+    Serial.print(F("[FIX-V3] Buffer tiene tramas pendientes. TX cuando vBat >= "));
+    Serial.print(FIX_V3_UTS_LOW_EXIT, 2);
+    Serial.println(F("V estable."));
+    ctx.next = (uint8_t)AppState::Cycle_Sleep;  // Saltar LTE
+    return Step::Done;
+  }
+  // ============ [FIX-V3 END] ============
+#endif
+
+  Serial.println("[DEBUG][APP] Pasando a Cycle_SendLTE");
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_SendLTE: envía las tramas pendientes del buffer
+ */
+static Step stateSendLte(Ctx& ctx) {
+  (void)ctx;
+  #if DEBUG_MOCK_LTE
+  // [DEBUG][FEAT-V5] LTE simulado para stress test - marca todo como enviado
+  {
+    unsigned long mockStart = millis();
+    String lines[20];
+    int count = 0;
+    if (buffer.readUnprocessedLines(lines, 20, count)) {
+      for (int i = 0; i < count; i++) {
+        buffer.markLineAsProcessed(i);
+      }
+    }
+    Serial.printf("[MOCK][LTE] %d tramas marcadas como enviadas (%lums)\n", count, millis() - mockStart);
+  }
+  #else
+  Serial.println("[DEBUG][APP] Iniciando envio por LTE...");
+  (void)sendBufferOverLTE_AndMarkProcessed();
+  Serial.println("[DEBUG][APP] Envio completado, pasando a CompactBuffer");
+  #endif
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_CompactBuffer: elimina del buffer las tramas ya enviadas
+ */
+static Step stateCompactBuffer(Ctx& ctx) {
+  (void)ctx;
+  Serial.println("[INFO][APP] Eliminando solo tramas procesadas del buffer...");
+  (void)buffer.removeProcessedLines();
+  Serial.println("[INFO][APP] Buffer compactado. Tramas no enviadas permanecen para próximo ciclo.");
+  return Step::Done;
+}
+
+/**
+ * @brief Cycle_Sleep: cierra el ciclo (resúmenes, diagnósticos) y entra a deep sleep
+ */
+static Step stateSleep(Ctx& ctx) {
+  (void)ctx;  // Solo lo usa el stress test
+  #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+  pipelineFinish();  // FEAT-V12: nunca dormir con la tarea LTE viva
+  #endif
+  TIMING_FINALIZE(g_timing);
+  printCyclePath();  // FEAT-V19: ruta crítica del ciclo
+  #if ENABLE_FEAT_V28_MEM_WATERMARKS
+  finishCycleMem();  // FEAT-V28: marcas de memoria por fase (antes de saveStats)
+  #endif
+  TIMING_PRINT_SUMMARY(g_timing);
+  printCycleSummary();  // Resumen de datos del ciclo
+
+  // ============ [FEAT-V7 START] Finalizar ciclo y guardar diagnósticos ============
+  #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+  ProdDiag::incrementCycle();
+  ProdDiag::evaluateCycleEMI();
+  ProdDiag::saveStats(g_lastEpoch);  // Usar último epoch conocido
+  ProdDiag::resetCycleEMI();  // Resetear para próximo ciclo
+  #endif
+  // ============ [FEAT-V7 END] ============
+
+  // ============ [FEAT-V30 START] Ventana de tiempos para la telemetría ============
+  #if ENABLE_FEAT_V30_TELEMETRY_FRAME
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  Telemetry::endCycle(&g_timing);
+  #else
+  Telemetry::endCycle(nullptr);
+  #endif
+  #endif
+  // ============ [FEAT-V30 END] ============
+
+  // ============ [FEAT-V22 START] Volcado único de estado a NVS ============
+  #if ENABLE_FEAT_V22_PERSIST_CACHE
+  (void)PersistState::flush();  // Tarea LTE ya terminó (pipelineFinish)
+  #endif
+  // ============ [FEAT-V22 END] ============
+
+  // ============ [DEBUG-EMI] Reporte de diagnóstico EMI ============
+  #if DEBUG_EMI_DIAGNOSTIC_ENABLED
+  Serial.printf("\n[EMI-DIAG] Fin ciclo %lu / %d\n", g_emiDiagCycleCount, DEBUG_EMI_DIAGNOSTIC_CYCLES);
+
+  if (g_emiDiagCycleCount >= DEBUG_EMI_DIAGNOSTIC_CYCLES) {
+    // Generar reporte final
+    printEMIDiagnosticReport(&Serial);
+
+    // Resetear para siguiente ronda
+    resetEMIDiagnosticStats();
+    g_emiDiagCycleCount = 0;
+
+    Serial.println(F("[EMI-DIAG] *** Estadísticas reseteadas. Iniciando nueva ronda ***"));
+  }
   #endif
-  // ============ [FEAT-V3 END] ============
-
-  // ============ [FEAT-V0 START] Imprimir versión al iniciar ============
-  printFirmwareVersion();
-  // ============ [FEAT-V0 END] ============
 
-  // ============ [FEAT-V1 START] Imprimir feature flags activos ============
-  printActiveFlags();
-  // ============ [FEAT-V1 END] ============
+  // ============ [FEAT-V5] Log de fin de ciclo stress test ============
+  #if DEBUG_STRESS_TEST_ENABLED
+  {
+    uint32_t heapNow = ESP.getFreeHeap();
+    int32_t heapDelta = (int32_t)heapNow - (int32_t)g_stress_heap_start;
+    Serial.println(F("\n[STRESS] ────────── FIN CICLO ──────────"));
+    Serial.printf("[STRESS] Heap: %lu -> %lu (%+ld bytes)%s\n", 
+                  g_stress_heap_start, heapNow, heapDelta,
+                  (heapDelta < -500) ? " ⚠️ LEAK?" : "");
+    Serial.printf("[STRESS] Ciclos totales: %lu\n", g_stress_cycle_count);
+    Serial.println(F("[STRESS] ──────────────────────────────\n"));
+  }
+  #endif
 
-  // ============ [FIX-V5 START] Inicializar Watchdog de Sistema ============
-  #if ENABLE_FIX_V5_WATCHDOG
-  // ESP-IDF v5.x requiere estructura de configuración
-  const esp_task_wdt_config_t wdt_config = {
-    .timeout_ms = FIX_V5_WATCHDOG_TIMEOUT_S * 1000,  // Convertir a ms
-    .idle_core_mask = 0,                             // No monitorear idle tasks
-    .trigger_panic = true                            // Reset en timeout
-  };
-  esp_task_wdt_init(&wdt_config);
-  esp_task_wdt_add(NULL);  // Agregar tarea actual (loopTask)
-  Serial.print(F("[FIX-V5] Watchdog iniciado ("));
-  Serial.print(FIX_V5_WATCHDOG_TIMEOUT_S);
-  Serial.println(F("s)"));
+  // ============ [FIX-V4 START] Apagar modem antes de deep sleep ============
+  #if ENABLE_FIX_V4_MODEM_POWEROFF_SLEEP
+  // Garantizar apagado limpio del modem según datasheet SIM7080G
+  // Referencia: Hardware Design v1.05, Page 23, 27
+  // "It is strongly recommended to turn off the module through PWRKEY 
+  //  or AT command before disconnecting the module VBAT power."
+  #if ENABLE_FEAT_V20_LAZY_INIT
+  // FEAT-V20: modem sin usar en este ciclo y apagado confirmado -> sin sondeo AT
+  if (!g_lteStarted && g_modemOffConfirmed) {
+    DLOG(APP, INFO, APP_MODEM_OFF_SKIP);  // FEAT-V27
+  } else
   #endif
-  // ============ [FIX-V5 END] ============
+  {
+    ensureLte();
+    DLOG(APP, INFO, APP_MODEM_OFF_BEGIN);  // FEAT-V27: fuera de la espera del URC
+    bool off = lte.powerOff();  // Ahora usa URC "NORMAL POWER DOWN" + PWRKEY fallback
+    DLOG(APP, INFO, APP_MODEM_OFF_DONE);
+    #if ENABLE_FEAT_V20_LAZY_INIT
+    g_modemOffConfirmed = off;
+    #else
+    (void)off;
+    #endif
+  }
+  #endif
+  // ============ [FIX-V4 END] ============
 
-  // ============ [FEAT-V4 START] Validación anti boot-loop ============
+  // ============ [FEAT-V4 START] Reinicio periódico preventivo ============
   #if ENABLE_FEAT_V4_PERIODIC_RESTART
   {
-    esp_reset_reason_t reset_reason = esp_reset_reason();
-    
-    // [FEAT-V5] Log de contadores stress test al inicio (verificar persistencia RTC)
+    // Acumular tiempo: en stress test usa tiempo REAL, en producción usa sleep planificado
     #if DEBUG_STRESS_TEST_ENABLED
-    Serial.printf("[STRESS] Boot - restart_count=%lu, cycle_count=%lu (RTC persist check)\n",
-                  g_stress_restart_count, g_stress_cycle_count);
+    // En stress test: acumular SOLO tiempo real del ciclo (awake)
+    // No sumamos sleep porque no hacemos deep sleep real en stress test
+    uint32_t cycle_real_ms = millis() - g_stress_cycle_start_ms;
+    uint64_t time_to_add = (uint64_t)cycle_real_ms * 1000ULL;  // ms -> us
+    g_accum_sleep_us += time_to_add;
+    Serial.printf("[STRESS] Tiempo ciclo real: %lu ms (%llu us agregados)\\n", 
+                  cycle_real_ms, time_to_add);
+    Serial.printf("[STRESS] Acumulador ahora: %llu / %llu us\\n", 
+                  g_accum_sleep_us, (uint64_t)FEAT_V4_THRESHOLD_US);
+    #else
+    // En producción: acumular solo tiempo de sleep planificado
+    g_accum_sleep_us += g_cfg.sleep_time_us;
     #endif
-    
-    // Caso 1: Boot después de restart planificado FEAT-V4
-    if (g_last_restart_reason_feat4 == FEAT4_RESTART_EXECUTED) {
-      Serial.println(F("[FEAT-V4] Boot post-restart periódico detectado."));
-      Serial.printf("[FEAT-V4] Tiempo acumulado antes de restart: %llu us\n", g_accum_sleep_us);
-      
-      // Reset completo del acumulador y flag
-      g_accum_sleep_us = 0;
-      g_last_restart_reason_feat4 = FEAT4_RESTART_NONE;
-    }
-    // Caso 2: Power-on (power cycle completo) - resetear acumulador y contadores stress
-    else if (reset_reason == ESP_RST_POWERON) {
-      Serial.println(F("[FEAT-V4] Power-on detectado. Reseteando acumulador."));
-      g_accum_sleep_us = 0;
-      g_last_restart_reason_feat4 = FEAT4_RESTART_NONE;
+
+    // Log del progreso del acumulador (FEAT-V27: enteros de 32 bits, en s y décimas de %)
+    unsigned accumS = (unsigned)(g_accum_sleep_us / 1000000ULL);
+    unsigned limitS = (unsigned)(FEAT_V4_THRESHOLD_US / 1000000ULL);
+    unsigned pct10 = (FEAT_V4_THRESHOLD_US > 0) ?
+                     (unsigned)(g_accum_sleep_us * 1000ULL / FEAT_V4_THRESHOLD_US) : 0;
+
+    // ¿Alcanzamos el threshold (24h por defecto)?
+    if (g_accum_sleep_us >= FEAT_V4_THRESHOLD_US) {
+      DLOG(APP, INFO, APP_RESTART_DUE, accumS, limitS, pct10 / 10, pct10 % 10);
+
+      // [FEAT-V5] Incrementar contador de restarts
       #if DEBUG_STRESS_TEST_ENABLED
-      g_stress_restart_count = 0;
-      g_stress_cycle_count = 0;
-      Serial.println(F("[STRESS] Power-on: contadores reseteados a 0"));
+      uint32_t cycles_completed = g_stress_cycle_count;  // Guardar antes de reset
+      g_stress_restart_count++;
+      Serial.printf("[STRESS] *** RESTART #%lu alcanzado tras %lu ciclos ***\n", 
+                    g_stress_restart_count, cycles_completed);
+      g_stress_cycle_count = 0;  // Reset ciclos para nuevo período (después del log)
+      #endif
+
+      // FEAT-V27: banner diferido; el flush previo a esp_restart() lo vacía
+      DLOG(APP, INFO, APP_RESTART_TOP);
+      DLOG(APP, INFO, APP_RESTART_TITLE);
+      DLOG(APP, INFO, APP_RESTART_SEP);
+      DLOG(APP, INFO, APP_RESTART_ACCUM, accumS);
+      #if FEAT_V4_STRESS_TEST_MODE
+      DLOG(APP, INFO, APP_RESTART_LIMIT_M, limitS, (int)FEAT_V4_RESTART_MINUTES);
+      #else
+      DLOG(APP, INFO, APP_RESTART_LIMIT_H, limitS, (int)FEAT_V4_RESTART_HOURS);
+      #endif
+      DLOG(APP, INFO, APP_RESTART_REASON, (int)esp_reset_reason());
+      DLOG(APP, INFO, APP_RESTART_MOTIVE);
+      DLOG(APP, INFO, APP_RESTART_EXEC);
+      DLOG(APP, INFO, APP_RESTART_BOTTOM);
+
+      // ============ [FEAT-V7 START] Registrar reinicio periódico ============
+      #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+      ProdDiag::recordPeriodicRestart(ProdDiag::getStats().totalCycles);
+      #endif
+      // ============ [FEAT-V7 END] ============
+
+      // Marcar que el restart fue intencional (anti boot-loop)
+      g_last_restart_reason_feat4 = FEAT4_RESTART_EXECUTED;
+
+      // Integración FEAT-V3: Checkpoint antes de restart
+      CRASH_CHECKPOINT(CP_SLEEP_ENTER);  // Usar mismo checkpoint (es un "exit" limpio)
+      CRASH_SYNC_NVS();
+
+      #if ENABLE_FEAT_V27_DEFERRED_LOG
+      DeferredLog::flush(FEAT_V27_FLUSH_TIMEOUT_MS);  // FEAT-V27: vaciar log diferido
       #endif
+      Serial.flush();  // Garantizar que logs se envían
+      delay(100);
+
+      esp_restart();  // Reinicio limpio - NO llega a deep sleep
+      // Nunca llega aquí
+    } else {
+      DLOG(APP, INFO, APP_RESTART_SLEEP, accumS, limitS, pct10 / 10, pct10 % 10);
     }
-    // Caso 3: Wakeup normal de deep sleep - acumulador persiste (no hacer nada)
-    
-    // Log estado actual del acumulador
-    float pct = (FEAT_V4_THRESHOLD_US > 0) ? 
-                ((float)g_accum_sleep_us / FEAT_V4_THRESHOLD_US * 100.0f) : 0.0f;
-    Serial.printf("[FEAT-V4] Acumulador: %llu / %llu us (%.1f%%)\n",
-        g_accum_sleep_us, 
-        (uint64_t)FEAT_V4_THRESHOLD_US,
-        pct);
   }
   #endif
   // ============ [FEAT-V4 END] ============
 
-  sleepModule.begin();
-  g_wakeupCause = sleepModule.getWakeupCause();
+  // ============ [STRESS TEST] Skip deep sleep para ciclos rápidos ============
+  #if DEBUG_STRESS_TEST_ENABLED
+  Serial.println(F("[STRESS] Skipping deep sleep - volviendo a inicio inmediatamente"));
+  delay(500);  // Pequeña pausa para no saturar logs
+  #if ENABLE_FEAT_V9_BLE_CONFIG
+  ctx.next = (uint8_t)AppState::BleOnly;  // Volver al inicio con BLE
+  #else
+  ctx.next = (uint8_t)AppState::Cycle_ReadSensors;  // Saltar BLE, directo a sensores
+  #endif
+  #if ENABLE_FEAT_V29_FLASH_WEAR
+  FlashWear::endCycle(0);  // FEAT-V29: período real desconocido, conserva el último
+  #endif
+  return Step::Done;  // Sin deep sleep
+  #endif
+  // ============ [STRESS TEST END] ============
 
-  (void)initializeRTC();
+  #if ENABLE_FEAT_V2_CYCLE_TIMING
+  g_lastWakeToSleepMs = millis();  // FEAT-V20: latencia wake->sleep (sin ventana FEAT-V18)
+  Serial.printf("[TIMING] wakeToSleep: %lu ms\n", (unsigned long)g_lastWakeToSleepMs);
+  #endif
 
-  if (!buffer.begin()) {
-    g_state = AppState::Error;
-    g_initialized = true;
-    return;
-  }
-  CRASH_CHECKPOINT(CP_BOOT_LITTLEFS_OK);  // FEAT-V3
+  // ============ [FEAT-V18 START] Sub-muestreo en light sleep ============
+  #if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  windowRun();
+  #endif
+  // ============ [FEAT-V18 END] ============
 
-  // ============ [FEAT-V7 START] Inicializar Production Diagnostics ============
-  #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-  ProdDiag::init();
-  ProdDiag::setResetReason((uint8_t)esp_reset_reason());
+  CRASH_CHECKPOINT(CP_SLEEP_ENTER);  // FEAT-V3
+  CRASH_SYNC_NVS();  // FEAT-V3: Guardar estado antes de sleep
+  #if ENABLE_FEAT_V3_CRASH_DIAGNOSTICS && ENABLE_FEAT_V26_CRASH_RTC_LAZY
+  CrashDiag::printNvsStats();  // FEAT-V26: escrituras NVS ahorradas en el ciclo
   #endif
-  // ============ [FEAT-V7 END] ============
+  #if ENABLE_FEAT_V29_FLASH_WEAR
+  FlashWear::endCycle((uint32_t)(g_cfg.sleep_time_us / 1000000ULL));  // FEAT-V29: desgaste del ciclo
+  #endif
+  // ============ [FEAT-V27 START] Vaciar log diferido antes de dormir ============
+  #if ENABLE_FEAT_V27_DEFERRED_LOG
+  DeferredLog::flush(FEAT_V27_FLUSH_TIMEOUT_MS);
+  DeferredLog::printStats(&Serial);
+  #endif
+  // ============ [FEAT-V27 END] ============
+  sleepModule.clearWakeupSources();
+  // ============ [FEAT-V11 START] Sleep hasta el próximo slot alineado ============
+  #if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+  esp_sleep_enable_timer_wakeup(alignComputeSleepUs());
+  #elif ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  esp_sleep_enable_timer_wakeup(g_cfg.sleep_time_us - g_windowElapsedUs);  // FEAT-V18
+  #else
+  esp_sleep_enable_timer_wakeup(g_cfg.sleep_time_us);
+  #endif
+  // ============ [FEAT-V11 END] ============
+  sleepModule.enterDeepSleep();
+  return Step::Done;  // No se alcanza
+}
 
-  (void)adcSensor.begin();
-  (void)i2cSensor.begin();
-  (void)rs485Sensor.begin();
+#define ST(s) ((uint8_t)AppState::s)
 
-  lte.begin();
-  lte.setDebug(true, &Serial);
+/**
+ * @brief Tabla de estados: handler, deadline, transiciones y campo de timing
+ * @details Indexada por AppState. onDone es la transición por defecto; los
+ *          handlers con varias salidas de éxito la cambian vía ctx.next.
+ */
+static const StateSched::StateDef g_stateTable[] = {
+  // id                      nombre           handler              deadline (ms)                  onDone                  onFail             timing
+  { ST(Boot),                "boot",          nullptr,             0,                             ST(Boot),               ST(Error),         nullptr },
+#if ENABLE_FEAT_V9_BLE_CONFIG
+  { ST(BleOnly),             "ble",           stateBleOnly,        0,                             ST(Cycle_ReadSensors),  ST(Cycle_ReadSensors), &CycleTiming::bleTime },
+#else
+  { ST(BleOnly),             "ble",           nullptr,             0,                             ST(Cycle_ReadSensors),  ST(Cycle_ReadSensors), nullptr },
+#endif
+  { ST(Cycle_ReadSensors),   "sensors",       stateReadSensors,    FEAT_V19_DEADLINE_SENSORS_MS,  ST(Cycle_GpsNvs),       ST(Cycle_Sleep),   &CycleTiming::sensorsTime },
+  { ST(Cycle_GpsNvs),        "nvsGps",        stateGpsNvs,         FEAT_V19_DEADLINE_NVS_MS,      ST(Cycle_GetICCID),     ST(Cycle_GetICCID), &CycleTiming::nvsGpsTime },
+  { ST(Cycle_Gps),           "gps",           stateGps,            FEAT_V19_DEADLINE_GPS_MS,      ST(Cycle_GetICCID),     ST(Cycle_GetICCID), &CycleTiming::gpsTime },
+  { ST(Cycle_GetICCID),      "iccid",         stateGetIccid,       FEAT_V19_DEADLINE_ICCID_MS,    ST(Cycle_BuildFrame),   ST(Cycle_BuildFrame), &CycleTiming::iccidTime },
+  { ST(Cycle_BuildFrame),    "buildFrame",    stateBuildFrame,     FEAT_V19_DEADLINE_FRAME_MS,    ST(Cycle_BufferWrite),  ST(Error),         &CycleTiming::buildFrameTime },
+  { ST(Cycle_BufferWrite),   "bufferWrite",   stateBufferWrite,    FEAT_V19_DEADLINE_BUFFER_MS,   ST(Cycle_SendLTE),      ST(Cycle_SendLTE), &CycleTiming::bufferWriteTime },
+  { ST(Cycle_SendLTE),       "sendLte",       stateSendLte,        FEAT_V19_DEADLINE_LTE_MS,      ST(Cycle_CompactBuffer), ST(Cycle_CompactBuffer), &CycleTiming::sendLteTime },
+  { ST(Cycle_CompactBuffer), "compactBuffer", stateCompactBuffer,  FEAT_V19_DEADLINE_BUFFER_MS,   ST(Cycle_Sleep),        ST(Cycle_Sleep),   &CycleTiming::compactBufferTime },
+  { ST(Cycle_Sleep),         "sleep",         stateSleep,          0,                             ST(Cycle_ReadSensors),  ST(Cycle_ReadSensors), nullptr },
+  { ST(Error),               "error",         nullptr,             0,                             ST(Error),              ST(Error),         nullptr },
+};
 
-  if (g_wakeupCause == ESP_SLEEP_WAKEUP_UNDEFINED) {
-    #if ENABLE_FEAT_V9_BLE_CONFIG
-    ble.begin("RV03");
-    g_state = AppState::BleOnly;
-    #else
-    // BLE deshabilitado - saltar directamente a ciclo de sensores
-    Serial.println(F("[INFO][APP] BLE DESHABILITADO - Iniciando ciclo directo"));
-    g_state = AppState::Cycle_ReadSensors;
-    #endif
-    g_firstCycleAfterBoot = true;
-  } else {
-    g_state = AppState::Cycle_ReadSensors;
-    g_firstCycleAfterBoot = false;
-  }
+static_assert(sizeof(g_stateTable) / sizeof(g_stateTable[0]) == ST(Error) + 1,
+              "g_stateTable debe tener una fila por AppState");
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+static_assert(ST(Error) + 1 <= FEAT_V28_MAX_PHASES,
+              "FEAT_V28_MAX_PHASES debe cubrir todos los AppState");
+#endif
 
-  g_initialized = true;
+#undef ST
+
+/** @brief Planificador de la FSM (la ruta se reinicia al entrar a Cycle_ReadSensors) */
+static StateSched::Scheduler g_scheduler(g_stateTable,
+                                         sizeof(g_stateTable) / sizeof(g_stateTable[0]),
+                                         (uint8_t)AppState::Cycle_ReadSensors);
+
+static void printCyclePath() {
+  g_scheduler.printPath();
+}
+
+// ============ [FEAT-V28 START] Cierre de marcas de memoria del ciclo ============
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+/**
+ * @brief Imprime las marcas por fase y registra los mínimos del ciclo en ProdDiag
+ */
+static void finishCycleMem() {
+  g_timing.mem[(uint8_t)AppState::Boot] = g_initMem;
+  g_scheduler.printMem(g_timing);
+
+  #if ENABLE_FEAT_V7_PRODUCTION_DIAG
+  uint8_t heapPhase = 0, blockPhase = 0, stackPhase = 0;
+  for (uint8_t i = 1; i <= (uint8_t)AppState::Error; i++) {
+    const PhaseMem& m = g_timing.mem[i];
+    if (m.minFreeHeap == 0) continue;  // Fase no ejecutada
+    if (m.minFreeHeap < g_timing.mem[heapPhase].minFreeHeap) heapPhase = i;
+    if (m.minLargestBlock < g_timing.mem[blockPhase].minLargestBlock) blockPhase = i;
+    if (m.minStackFree < g_timing.mem[stackPhase].minStackFree) stackPhase = i;
+  }
+  ProdDiag::recordMemWatermarks(g_timing.mem[heapPhase].minFreeHeap, heapPhase,
+                                g_timing.mem[blockPhase].minLargestBlock, blockPhase,
+                                g_timing.mem[stackPhase].minStackFree, stackPhase);
+  #endif
 }
+#endif
+// ============ [FEAT-V28 END] ============
+// ============ [FEAT-V19 END] ============
 
 /**
  * @brief Loop principal de la máquina de estados finitos (FSM)
  * 
- * Ejecuta la lógica de cada estado de la FSM. Debe ser llamada continuamente
- * desde loop() de Arduino.
+ * Ejecuta una invocación del estado actual vía g_scheduler (FEAT-V19): el
+ * handler de g_stateTable corre, su duración se registra en g_timing y se
+ * aplica la transición. Los estados que esperan I/O ceden (Step::Yield) y
+ * se reinvocan en la siguiente llamada. Con FEAT-V19 en 0 el switch original
+ * invoca los mismos handlers. Debe ser llamada continuamente desde loop()
+ * de Arduino.
  * 
  * **Estados y transiciones:**
  * 
@@ -1110,7 +3085,13 @@ void AppInit(const AppConfig& cfg) {
  * - **Cycle_ReadSensors:**
  *   - Lee ADC (batería), I2C (temp/hum), RS485 (4 registros)
  *   - Si es primer ciclo → Cycle_Gps
- *   - Si no → recupera GPS de NVS y va a Cycle_GetICCID
+ *   - Muestra suprimida (FEAT-V10) → Cycle_SendLTE con tramas pendientes,
+ *     si no Cycle_Sleep
+ *   - Si no → Cycle_GpsNvs
+ * 
+ * - **Cycle_GpsNvs:**
+ *   - Recupera GPS de NVS (ceros si no hay)
+ *   - Siempre → Cycle_GetICCID
  * 
  * - **Cycle_Gps:**
  *   - Enciende GNSS, espera fix, guarda coordenadas en NVS
@@ -1189,6 +3170,37 @@ void AppLoop() {
       ProdDiag::printEventLog();
     }
     #endif
+
+    // Comandos FEAT-V16: Registro de sondas
+    #if ENABLE_FEAT_V16_PROBE_REGISTRY
+    if (cmd == "PROBES") {
+      ProbeRegistry::printStatus();
+    } else if (cmd == "PROBES REDETECT") {
+      ProbeRegistry::detect();
+      ProbeRegistry::printStatus();
+    }
+    #endif
+
+    // Comandos FEAT-V23: Trazas de spans
+    #if ENABLE_FEAT_V23_TRACE_SPANS
+    if (cmd == "TRACE") {
+      TraceSpan::printText(&Serial);
+    } else if (cmd == "TRACE BIN") {
+      Serial.println(F("[FEAT-V23] TRACE BIN"));
+      TraceSpan::dumpBinary(&Serial);
+      Serial.println();
+    } else if (cmd == "TRACE CLEAR") {
+      TraceSpan::clear();
+      Serial.println(F("[FEAT-V23] Ring de trazas borrado"));
+    }
+    #endif
+
+    // Comandos FEAT-V33: Micro-benchmarks
+    #if ENABLE_FEAT_V33_MICRO_BENCH
+    if (cmd == "BENCH") {
+      MicroBench::runAndPrint(&Serial);
+    }
+    #endif
   }
   // ============ [FEAT-V9 END] ============
 
@@ -1211,45 +3223,18 @@ void AppLoop() {
   #endif
   #endif
 
+  // ============ [FEAT-V19 START] Despacho por tabla ============
+  #if ENABLE_FEAT_V19_STATE_SCHEDULER
+  uint8_t state = (uint8_t)g_state;
+  g_scheduler.step(state, g_timing);
+  g_state = (AppState)state;
+  #else
+  // Switch original: mismos handlers, bloqueantes, sin deadlines ni ruta
+  Ctx ctx = { 0, true, false, 0 };
   switch (g_state) {
     #if ENABLE_FEAT_V9_BLE_CONFIG
     case AppState::BleOnly: {
-      if (!ble.isActive()) {
-        TIMING_RESET(g_timing);  // Inicia timing del ciclo cuando termina BLE
-        g_lteCycleSuccess = false;  // Reset para CYCLE SUMMARY
-        g_lastCSQ = 99;  // Reset CSQ
-        
-        // ============ [DEBUG-EMI] Log de inicio de ciclo diagnóstico EMI ============
-        #if DEBUG_EMI_DIAGNOSTIC_ENABLED
-        g_emiDiagCycleCount++;
-        Serial.println();
-        Serial.println(F("╔════════════════════════════════════════════════════════════╗"));
-        Serial.printf(   "║  [EMI-DIAG] CICLO #%lu / %d                                  ║\n", 
-                        g_emiDiagCycleCount, DEBUG_EMI_DIAGNOSTIC_CYCLES);
-        Serial.printf(   "║  Heap libre: %lu bytes                                     ║\n", ESP.getFreeHeap());
-        Serial.println(F("║  Modo: COMUNICACIÓN REAL (mocks desactivados)              ║"));
-        Serial.println(F("╚════════════════════════════════════════════════════════════╝"));
-        #endif
-        
-        // ============ [FEAT-V5] Log de inicio de ciclo stress test ============
-        #if DEBUG_STRESS_TEST_ENABLED
-        g_stress_cycle_count++;
-        g_stress_heap_start = ESP.getFreeHeap();
-        g_stress_cycle_start_ms = millis();  // Track tiempo real del ciclo
-        Serial.println();
-        Serial.println(F("\n[STRESS] ══════════════════════════════════════"));
-        Serial.printf("[STRESS] CICLO #%lu (restart #%lu)\n", g_stress_cycle_count, g_stress_restart_count);
-        Serial.printf("[STRESS] Heap libre: %lu bytes\n", g_stress_heap_start);
-        #if ENABLE_FEAT_V4_PERIODIC_RESTART
-        uint64_t threshold = FEAT_V4_THRESHOLD_US;
-        uint8_t pct = (uint8_t)((g_accum_sleep_us * 100ULL) / threshold);
-        uint32_t secsToRestart = (uint32_t)((threshold - g_accum_sleep_us) / 1000000ULL);
-        Serial.printf("[STRESS] Tiempo acum: %llu / %llu us (%u%%)\n", g_accum_sleep_us, threshold, pct);
-        Serial.printf("[STRESS] Proximo restart en: ~%lu seg\n", secsToRestart);
-        #endif
-        Serial.println(F("[STRESS] ══════════════════════════════════════"));
-        #endif
-        
+      if (stateBleOnly(ctx) == Step::Done) {
         g_state = AppState::Cycle_ReadSensors;
       }
       break;
@@ -1258,177 +3243,43 @@ void AppLoop() {
 
     case AppState::Cycle_ReadSensors: {
       TIMING_START(g_timing, sensors);
-      String vBat;
-      if (!readADC_DiscardAndAverage(vBat)) vBat = "0";
-
-      String vTemp, vHum;
-      if (!readI2C_DiscardAndAverage(vTemp, vHum)) { vTemp = "0"; vHum = "0"; }
-
-      String regs[4] = {"0","0","0","0"};
-      (void)readRS485_DiscardAndTakeLast(regs);
-
-      
-      g_varStr[0] = regs[0];
-      g_varStr[1] = regs[1];
-      g_varStr[2] = regs[2];
-      g_varStr[3] = regs[3];
-      g_varStr[4] = vTemp;
-      g_varStr[5] = vHum;
-      g_varStr[6] = vBat;
+      ctx.next = (uint8_t)AppState::Cycle_GpsNvs;
+      (void)stateReadSensors(ctx);  // Puede desviar a Cycle_Gps o Cycle_Sleep
       TIMING_END(g_timing, sensors);
-
-      if (g_firstCycleAfterBoot) {
-        Serial.println("[INFO][APP] Primer ciclo: leyendo GPS");
-        g_state = AppState::Cycle_Gps;
-        g_firstCycleAfterBoot = false;
-      } else {
-        TIMING_START(g_timing, nvsGps);
-        Serial.println("[INFO][APP] Ciclo subsecuente: recuperando coordenadas GPS de NVS");
-        
-        preferences.begin("sensores", true);
-        if (preferences.isKey("gps_lat") && preferences.isKey("gps_lng") && preferences.isKey("gps_alt")) {
-          float lat = preferences.getFloat("gps_lat", 0.0f);
-          float lng = preferences.getFloat("gps_lng", 0.0f);
-          float alt = preferences.getFloat("gps_alt", 0.0f);
-          preferences.end();
-          
-          formatCoord(g_lat, sizeof(g_lat), lat);
-          formatCoord(g_lng, sizeof(g_lng), lng);
-          formatAlt(g_alt, sizeof(g_alt), alt);
-          
-          Serial.print("[INFO][APP] GPS recuperado - Lat: ");
-          Serial.print(g_lat);
-          Serial.print(", Lng: ");
-          Serial.print(g_lng);
-          Serial.print(", Alt: ");
-          Serial.println(g_alt);
-        } else {
-          preferences.end();
-          fillZeros(g_lat, COORD_LEN);
-          fillZeros(g_lng, COORD_LEN);
-          fillZeros(g_alt, ALT_LEN);
-          Serial.println("[WARN][APP] No hay coordenadas GPS en NVS, usando ceros");
-        }
-        TIMING_END(g_timing, nvsGps);
-        g_state = AppState::Cycle_GetICCID;
-      }
+      g_state = (AppState)ctx.next;
       break;
     }
 
-    case AppState::Cycle_Gps: {
-      TIMING_START(g_timing, gps);
-      fillZeros(g_lat, COORD_LEN);
-      fillZeros(g_lng, COORD_LEN);
-      fillZeros(g_alt, ALT_LEN);
-
-      #if DEBUG_MOCK_GPS
-      // [DEBUG][FEAT-V5] GPS simulado para stress test
-      {
-        unsigned long mockStart = millis();
-        formatCoord(g_lat, sizeof(g_lat), 19.4326f);   // CDMX dummy lat
-        formatCoord(g_lng, sizeof(g_lng), -99.1332f);  // CDMX dummy lng
-        formatAlt(g_alt, sizeof(g_alt), 2240.0f);      // CDMX dummy alt
-        Serial.printf("[MOCK][GPS] Coords: %s, %s, alt=%s (%lums)\n", 
-                      g_lat, g_lng, g_alt, millis() - mockStart);
-      }
-      TIMING_END(g_timing, gps);
+    case AppState::Cycle_GpsNvs: {
+      TIMING_START(g_timing, nvsGps);
+      (void)stateGpsNvs(ctx);
+      TIMING_END(g_timing, nvsGps);
       g_state = AppState::Cycle_GetICCID;
       break;
-      #endif
-
-      GpsFix fix;
-      bool gotFix = false;
-
-      if (gps.powerOn()) {
-        gotFix = gps.getCoordinatesAndShutdown(fix);
-      }
+    }
 
-      if (gotFix && fix.hasFix) {
-        formatCoord(g_lat, sizeof(g_lat), fix.latitude);
-        formatCoord(g_lng, sizeof(g_lng), fix.longitude);
-        formatAlt(g_alt, sizeof(g_alt), fix.altitude);
-        
-        preferences.begin("sensores", false);
-        preferences.putFloat("gps_lat", fix.latitude);
-        preferences.putFloat("gps_lng", fix.longitude);
-        preferences.putFloat("gps_alt", fix.altitude);
-        preferences.end();
-        
-        Serial.println("[INFO][APP] Coordenadas GPS guardadas en NVS");
-        Serial.print("[INFO][APP] Lat: ");
-        Serial.print(g_lat);
-        Serial.print(", Lng: ");
-        Serial.print(g_lng);
-        Serial.print(", Alt: ");
-        Serial.println(g_alt);
-      } else {
-        Serial.println("[WARN][APP] No se obtuvo fix GPS, usando ceros");
-      }
+    case AppState::Cycle_Gps: {
+      TIMING_START(g_timing, gps);
+      (void)stateGps(ctx);
       TIMING_END(g_timing, gps);
       g_state = AppState::Cycle_GetICCID;
       break;
     }
+
     case AppState::Cycle_GetICCID: {
       TIMING_START(g_timing, iccid);
-      
-      #if DEBUG_MOCK_ICCID
-      // [DEBUG][FEAT-V5] ICCID simulado para stress test
-      {
-        unsigned long mockStart = millis();
-        g_iccid = "89520000000000000000";  // ICCID dummy
-        Serial.printf("[MOCK][ICCID] %s (%lums)\n", g_iccid.c_str(), millis() - mockStart);
-      }
-      #else
-      if (lte.powerOn()) {
-        g_iccid = lte.getICCID();
-        lte.powerOff();
-      } else {
-        g_iccid = "";
-      }
-      #endif
-      
+      (void)stateGetIccid(ctx);
       TIMING_END(g_timing, iccid);
       g_state = AppState::Cycle_BuildFrame;
       break;
     }
+
     case AppState::Cycle_BuildFrame: {
       TIMING_START(g_timing, buildFrame);
-      g_epoch = getEpochString();
-      g_lastEpoch = (uint32_t)g_epoch.toInt();  // FEAT-V7: Guardar epoch numérico
-
-      // ============ [FEAT-V9 START] Actualizar epoch en ProductionDiag ============
-      #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-      ProdDiag::setCurrentEpoch(g_lastEpoch);
-      #endif
-      // ============ [FEAT-V9 END] ============
-
-      formatter.reset();
-      formatter.setIccid(g_iccid.c_str());
-      formatter.setEpoch(g_epoch.c_str());
-      formatter.setLat(g_lat);
-      formatter.setLng(g_lng);
-      formatter.setAlt(g_alt);
-
-      for (uint8_t i = 0; i < VAR_COUNT; i++) {
-        formatter.setVar(i, g_varStr[i].c_str());
-      }
-
-      char frameNormal[FRAME_MAX_LEN];
-      if (!formatter.buildFrame(frameNormal, sizeof(frameNormal))) {
-        g_state = AppState::Error;
-        break;
-      }
-      Serial.println("[INFO][APP] === TRAMA NORMAL ===");
-      Serial.println(frameNormal);
-
-      Serial.println("[DEBUG][APP] Generando trama Base64...");
-      if (!formatter.buildFrameBase64(g_frame, sizeof(g_frame))) {
+      if (stateBuildFrame(ctx) != Step::Done) {
         g_state = AppState::Error;
         break;
       }
-      Serial.println("[INFO][APP] === TRAMA BASE64 ===");
-      Serial.println(g_frame);
-      Serial.println();
       TIMING_END(g_timing, buildFrame);
       g_state = AppState::Cycle_BufferWrite;
       break;
@@ -1436,58 +3287,16 @@ void AppLoop() {
 
     case AppState::Cycle_BufferWrite: {
       TIMING_START(g_timing, bufferWrite);
-      Serial.println("[INFO][APP] Guardando trama en buffer (persistente)...");
-      bool saved = buffer.appendLine(String(g_frame));
-      if (saved) {
-        Serial.println("[INFO][APP] Trama guardada exitosamente en buffer");
-      } else {
-        Serial.println("[ERROR][APP] Fallo al guardar trama en buffer");
-      }
+      ctx.next = (uint8_t)AppState::Cycle_SendLTE;
+      (void)stateBufferWrite(ctx);  // FIX-V3 puede saltar LTE
       TIMING_END(g_timing, bufferWrite);
-      
-#if ENABLE_FIX_V3_LOW_BATTERY_MODE
-      // ============ [FIX-V3 START] Verificar batería antes de LTE ============
-      float vBatFiltered = readVBatFiltered();
-      
-      if (!evaluateBatteryState(vBatFiltered)) {
-        // Estamos en reposo - SALTAR LTE, ir directo a sleep
-        Serial.println(F("[FIX-V3] Datos guardados. LTE bloqueado por bateria baja."));
-        Serial.print(F("[FIX-V3] Buffer tiene tramas pendientes. TX cuando vBat >= "));
-        Serial.print(FIX_V3_UTS_LOW_EXIT, 2);
-        Serial.println(F("V estable."));
-        g_state = AppState::Cycle_Sleep;  // Saltar LTE
-        break;
-      }
-      // ============ [FIX-V3 END] ============
-#endif
-      
-      Serial.println("[DEBUG][APP] Pasando a Cycle_SendLTE");
-      g_state = AppState::Cycle_SendLTE;
+      g_state = (AppState)ctx.next;
       break;
     }
 
     case AppState::Cycle_SendLTE: {
       TIMING_START(g_timing, sendLte);
-      
-      #if DEBUG_MOCK_LTE
-      // [DEBUG][FEAT-V5] LTE simulado para stress test - marca todo como enviado
-      {
-        unsigned long mockStart = millis();
-        String lines[20];
-        int count = 0;
-        if (buffer.readUnprocessedLines(lines, 20, count)) {
-          for (int i = 0; i < count; i++) {
-            buffer.markLineAsProcessed(i);
-          }
-        }
-        Serial.printf("[MOCK][LTE] %d tramas marcadas como enviadas (%lums)\n", count, millis() - mockStart);
-      }
-      #else
-      Serial.println("[DEBUG][APP] Iniciando envio por LTE...");
-      (void)sendBufferOverLTE_AndMarkProcessed();
-      Serial.println("[DEBUG][APP] Envio completado, pasando a CompactBuffer");
-      #endif
-      
+      (void)stateSendLte(ctx);
       TIMING_END(g_timing, sendLte);
       g_state = AppState::Cycle_CompactBuffer;
       break;
@@ -1495,166 +3304,16 @@ void AppLoop() {
 
     case AppState::Cycle_CompactBuffer: {
       TIMING_START(g_timing, compactBuffer);
-      Serial.println("[INFO][APP] Eliminando solo tramas procesadas del buffer...");
-      (void)buffer.removeProcessedLines();
-      Serial.println("[INFO][APP] Buffer compactado. Tramas no enviadas permanecen para próximo ciclo.");
+      (void)stateCompactBuffer(ctx);
       TIMING_END(g_timing, compactBuffer);
       g_state = AppState::Cycle_Sleep;
       break;
     }
 
     case AppState::Cycle_Sleep: {
-      TIMING_FINALIZE(g_timing);
-      TIMING_PRINT_SUMMARY(g_timing);
-      printCycleSummary();  // Resumen de datos del ciclo
-      
-      // ============ [FEAT-V7 START] Finalizar ciclo y guardar diagnósticos ============
-      #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-      ProdDiag::incrementCycle();
-      ProdDiag::evaluateCycleEMI();
-      ProdDiag::saveStats(g_lastEpoch);  // Usar último epoch conocido
-      ProdDiag::resetCycleEMI();  // Resetear para próximo ciclo
-      #endif
-      // ============ [FEAT-V7 END] ============
-      
-      // ============ [DEBUG-EMI] Reporte de diagnóstico EMI ============
-      #if DEBUG_EMI_DIAGNOSTIC_ENABLED
-      Serial.printf("\n[EMI-DIAG] Fin ciclo %lu / %d\n", g_emiDiagCycleCount, DEBUG_EMI_DIAGNOSTIC_CYCLES);
-      
-      if (g_emiDiagCycleCount >= DEBUG_EMI_DIAGNOSTIC_CYCLES) {
-        // Generar reporte final
-        printEMIDiagnosticReport(&Serial);
-        
-        // Resetear para siguiente ronda
-        resetEMIDiagnosticStats();
-        g_emiDiagCycleCount = 0;
-        
-        Serial.println(F("[EMI-DIAG] *** Estadísticas reseteadas. Iniciando nueva ronda ***"));
-      }
-      #endif
-      
-      // ============ [FEAT-V5] Log de fin de ciclo stress test ============
-      #if DEBUG_STRESS_TEST_ENABLED
-      {
-        uint32_t heapNow = ESP.getFreeHeap();
-        int32_t heapDelta = (int32_t)heapNow - (int32_t)g_stress_heap_start;
-        Serial.println(F("\n[STRESS] ────────── FIN CICLO ──────────"));
-        Serial.printf("[STRESS] Heap: %lu -> %lu (%+ld bytes)%s\n", 
-                      g_stress_heap_start, heapNow, heapDelta,
-                      (heapDelta < -500) ? " ⚠️ LEAK?" : "");
-        Serial.printf("[STRESS] Ciclos totales: %lu\n", g_stress_cycle_count);
-        Serial.println(F("[STRESS] ──────────────────────────────\n"));
-      }
-      #endif
-      
-      // ============ [FIX-V4 START] Apagar modem antes de deep sleep ============
-      #if ENABLE_FIX_V4_MODEM_POWEROFF_SLEEP
-      // Garantizar apagado limpio del modem según datasheet SIM7080G
-      // Referencia: Hardware Design v1.05, Page 23, 27
-      // "It is strongly recommended to turn off the module through PWRKEY 
-      //  or AT command before disconnecting the module VBAT power."
-      Serial.println(F("[FIX-V4] Asegurando apagado de modem antes de sleep..."));
-      lte.powerOff();  // Ahora usa URC "NORMAL POWER DOWN" + PWRKEY fallback
-      Serial.println(F("[FIX-V4] Secuencia de apagado completada."));
-      #endif
-      // ============ [FIX-V4 END] ============
-      
-      // ============ [FEAT-V4 START] Reinicio periódico preventivo ============
-      #if ENABLE_FEAT_V4_PERIODIC_RESTART
-      {
-        // Acumular tiempo: en stress test usa tiempo REAL, en producción usa sleep planificado
-        #if DEBUG_STRESS_TEST_ENABLED
-        // En stress test: acumular SOLO tiempo real del ciclo (awake)
-        // No sumamos sleep porque no hacemos deep sleep real en stress test
-        uint32_t cycle_real_ms = millis() - g_stress_cycle_start_ms;
-        uint64_t time_to_add = (uint64_t)cycle_real_ms * 1000ULL;  // ms -> us
-        g_accum_sleep_us += time_to_add;
-        Serial.printf("[STRESS] Tiempo ciclo real: %lu ms (%llu us agregados)\\n", 
-                      cycle_real_ms, time_to_add);
-        Serial.printf("[STRESS] Acumulador ahora: %llu / %llu us\\n", 
-                      g_accum_sleep_us, (uint64_t)FEAT_V4_THRESHOLD_US);
-        #else
-        // En producción: acumular solo tiempo de sleep planificado
-        g_accum_sleep_us += g_cfg.sleep_time_us;
-        #endif
-        
-        // Log del progreso del acumulador
-        float pct = (FEAT_V4_THRESHOLD_US > 0) ? 
-                    ((float)g_accum_sleep_us / FEAT_V4_THRESHOLD_US * 100.0f) : 0.0f;
-        Serial.printf("[FEAT-V4] Acumulador: %llu / %llu us (%.1f%%) -> ", 
-            g_accum_sleep_us, (uint64_t)FEAT_V4_THRESHOLD_US, pct);
-        
-        // ¿Alcanzamos el threshold (24h por defecto)?
-        if (g_accum_sleep_us >= FEAT_V4_THRESHOLD_US) {
-          Serial.println(F("RESTART"));
-          
-          // [FEAT-V5] Incrementar contador de restarts
-          #if DEBUG_STRESS_TEST_ENABLED
-          uint32_t cycles_completed = g_stress_cycle_count;  // Guardar antes de reset
-          g_stress_restart_count++;
-          Serial.printf("[STRESS] *** RESTART #%lu alcanzado tras %lu ciclos ***\n", 
-                        g_stress_restart_count, cycles_completed);
-          g_stress_cycle_count = 0;  // Reset ciclos para nuevo período (después del log)
-          #endif
-          
-          Serial.println(F(""));
-          Serial.println(F("╔════════════════════════════════════════════════════╗"));
-          Serial.println(F("║  [FEAT-V4] REINICIO PERIODICO PREVENTIVO           ║"));
-          Serial.println(F("╠════════════════════════════════════════════════════╣"));
-          Serial.printf(   "║  Tiempo acumulado: %llu us\n", g_accum_sleep_us);
-          #if FEAT_V4_STRESS_TEST_MODE
-          Serial.printf(   "║  Threshold: %llu us (%d minutos STRESS)\n", (uint64_t)FEAT_V4_THRESHOLD_US, FEAT_V4_RESTART_MINUTES);
-          #else
-          Serial.printf(   "║  Threshold: %llu us (%d horas)\n", (uint64_t)FEAT_V4_THRESHOLD_US, FEAT_V4_RESTART_HOURS);
-          #endif
-          Serial.printf(   "║  Reset reason anterior: %d\n", (int)esp_reset_reason());
-          Serial.println(F("║  Motivo: PERIODIC_24H (planificado)                ║"));
-          Serial.println(F("║  Ejecutando esp_restart() en punto seguro...       ║"));
-          Serial.println(F("╚════════════════════════════════════════════════════╝"));
-          
-          // ============ [FEAT-V7 START] Registrar reinicio periódico ============
-          #if ENABLE_FEAT_V7_PRODUCTION_DIAG
-          ProdDiag::recordPeriodicRestart(ProdDiag::getStats().totalCycles);
-          #endif
-          // ============ [FEAT-V7 END] ============
-          
-          // Marcar que el restart fue intencional (anti boot-loop)
-          g_last_restart_reason_feat4 = FEAT4_RESTART_EXECUTED;
-          
-          // Integración FEAT-V3: Checkpoint antes de restart
-          CRASH_CHECKPOINT(CP_SLEEP_ENTER);  // Usar mismo checkpoint (es un "exit" limpio)
-          CRASH_SYNC_NVS();
-          
-          Serial.flush();  // Garantizar que logs se envían
-          delay(100);
-          
-          esp_restart();  // Reinicio limpio - NO llega a deep sleep
-          // Nunca llega aquí
-        } else {
-          Serial.println(F("sleep"));
-        }
-      }
-      #endif
-      // ============ [FEAT-V4 END] ============
-      
-      // ============ [STRESS TEST] Skip deep sleep para ciclos rápidos ============
-      #if DEBUG_STRESS_TEST_ENABLED
-      Serial.println(F("[STRESS] Skipping deep sleep - volviendo a inicio inmediatamente"));
-      delay(500);  // Pequeña pausa para no saturar logs
-      #if ENABLE_FEAT_V9_BLE_CONFIG
-      g_state = AppState::BleOnly;  // Volver al inicio con BLE
-      #else
-      g_state = AppState::Cycle_ReadSensors;  // Saltar BLE, directo a sensores
-      #endif
-      break;  // Salir del case sin hacer deep sleep
-      #endif
-      // ============ [STRESS TEST END] ============
-      
-      CRASH_CHECKPOINT(CP_SLEEP_ENTER);  // FEAT-V3
-      CRASH_SYNC_NVS();  // FEAT-V3: Guardar estado antes de sleep
-      sleepModule.clearWakeupSources();
-      esp_sleep_enable_timer_wakeup(g_cfg.sleep_time_us);
-      sleepModule.enterDeepSleep();
+      ctx.next = (uint8_t)AppState::Cycle_ReadSensors;
+      (void)stateSleep(ctx);  // Solo retorna en stress test
+      g_state = (AppState)ctx.next;
       break;
     }
 
@@ -1664,4 +3323,6 @@ void AppLoop() {
       delay(1000);
       break;
   }
+  #endif
+  // ============ [FEAT-V19 END] ============
 }
@@ -28,6 +28,25 @@
 // ESTRUCTURA DE TIEMPOS
 // ============================================================
 
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+/**
+ * @brief Marcas de memoria de una fase (FEAT-V28), registradas por StateSched
+ *
+ * minFreeHeap es exacto cuando el mínimo histórico del heap bajó durante la
+ * fase (PEAK_HEAP); si no, es el menor valor muestreado en sus invocaciones.
+ */
+struct PhaseMem {
+    uint32_t minFreeHeap;       // Heap libre mínimo (bytes, 0 = fase no ejecutada)
+    uint32_t minLargestBlock;   // Bloque libre más grande mínimo (fragmentación)
+    uint16_t minStackFree;      // High-water mark del stack de loop() (bytes libres)
+    uint8_t  flags;             // PHASE_MEM_PEAK_*
+    uint8_t  reserved;
+};
+
+#define PHASE_MEM_PEAK_HEAP   0x01  // El mínimo histórico del heap bajó en esta fase
+#define PHASE_MEM_PEAK_STACK  0x02  // El high-water mark del stack bajó en esta fase
+#endif
+
 /**
  * @brief Estructura para almacenar tiempos de cada fase del ciclo
  */
@@ -49,7 +68,25 @@ struct CycleTiming {
     unsigned long lteSend;          // Enviar datos
     unsigned long lteClose;         // Cerrar y apagar
     unsigned long compactBufferTime;// Compactar buffer
+#if ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+    unsigned long adcSampleTime;    // FEAT-V13: latencia tarea ADC
+    unsigned long i2cSampleTime;    // FEAT-V13: latencia tarea I2C
+    unsigned long rs485SampleTime;  // FEAT-V13: latencia tarea RS485
+#endif
+#if ENABLE_FEAT_V15_POWER_RAILS
+    unsigned long i2cSettleWait;    // FEAT-V15: espera asentamiento AHT20
+    unsigned long rs485SettleWait;  // FEAT-V15: espera asentamiento sonda Modbus
+#endif
+#if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+    unsigned long lteBringUpTime;   // FEAT-V12: bring-up LTE en core 0 (paralelo)
+    unsigned long pipelineWaitTime; // FEAT-V12: espera de AppLoop en el join
+#endif
     unsigned long cycleTotal;       // Ciclo completo
+    unsigned long wakeToSample;     // FEAT-V20: boot -> inicio de Cycle_ReadSensors
+    unsigned long prevWakeToSleep;  // FEAT-V20: boot -> deep sleep del ciclo anterior (RTC)
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+    PhaseMem mem[FEAT_V28_MAX_PHASES];  // FEAT-V28: por id de estado (0 = AppInit)
+#endif
 };
 
 // ============================================================
@@ -155,6 +192,30 @@ inline void printTimingSummary(const CycleTiming& timing) {
     Serial.printf("%6lu", timing.sensorsTime);
     Serial.println(F(" ms         ║"));
     
+#if ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+    Serial.print(F("║   - ADC:       "));
+    Serial.printf("%6lu", timing.adcSampleTime);
+    Serial.println(F(" ms         ║"));
+    
+    Serial.print(F("║   - I2C:       "));
+    Serial.printf("%6lu", timing.i2cSampleTime);
+    Serial.println(F(" ms         ║"));
+    
+    Serial.print(F("║   - RS485:     "));
+    Serial.printf("%6lu", timing.rs485SampleTime);
+    Serial.println(F(" ms         ║"));
+#endif
+    
+#if ENABLE_FEAT_V15_POWER_RAILS
+    Serial.print(F("║   - I2C wait:  "));
+    Serial.printf("%6lu", timing.i2cSettleWait);
+    Serial.println(F(" ms         ║"));
+    
+    Serial.print(F("║   - RS485 wait:"));
+    Serial.printf("%6lu", timing.rs485SettleWait);
+    Serial.println(F(" ms         ║"));
+#endif
+    
     Serial.print(F("║  NVS GPS:      "));
     Serial.printf("%6lu", timing.nvsGpsTime);
     Serial.println(F(" ms         ║"));
@@ -183,6 +244,16 @@ inline void printTimingSummary(const CycleTiming& timing) {
     Serial.printf("%6lu", timing.compactBufferTime);
     Serial.println(F(" ms         ║"));
     
+#if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+    Serial.print(F("║  LTE bring-up: "));
+    Serial.printf("%6lu", timing.lteBringUpTime);
+    Serial.println(F(" ms (core0)  ║"));
+    
+    Serial.print(F("║  Join wait:    "));
+    Serial.printf("%6lu", timing.pipelineWaitTime);
+    Serial.println(F(" ms         ║"));
+#endif
+    
     Serial.println(F("╠══════════════════════════════════════╣"));
     
     Serial.print(F("║  CYCLE TOTAL:  "));
@@ -191,6 +262,14 @@ inline void printTimingSummary(const CycleTiming& timing) {
     Serial.printf("%.1f", timing.cycleTotal / 1000.0);
     Serial.println(F(" s) ║"));
     
+    Serial.print(F("║  Wake->sample: "));
+    Serial.printf("%6lu", timing.wakeToSample);
+    Serial.println(F(" ms         ║"));
+    
+    Serial.print(F("║  Prev wake->zz:"));
+    Serial.printf("%6lu", timing.prevWakeToSleep);
+    Serial.println(F(" ms         ║"));
+    
     Serial.println(F("╚══════════════════════════════════════╝"));
     Serial.println(F(""));
 }
@@ -53,6 +53,27 @@
 #define DEBUG_RTC_ENABLED    true
 #define DEBUG_APP_ENABLED    true
 
+// =============================================================================
+// NIVEL POR MÓDULO PARA EL LOG DIFERIDO (FEAT-V27, DLOG en DeferredLog.h)
+// =============================================================================
+
+/**
+ * @brief Nivel máximo que se compila en cada módulo (0-4)
+ * Por defecto VERBOSE: mismas líneas que antes. Bajar a INFO elimina del
+ * binario, por ejemplo, las líneas [DEBUG] por trama del envío LTE.
+ */
+#define DEBUG_ADC_LEVEL      DEBUG_LEVEL_VERBOSE
+#define DEBUG_I2C_LEVEL      DEBUG_LEVEL_VERBOSE
+#define DEBUG_RS485_LEVEL    DEBUG_LEVEL_VERBOSE
+#define DEBUG_GPS_LEVEL      DEBUG_LEVEL_VERBOSE
+#define DEBUG_LTE_LEVEL      DEBUG_LEVEL_VERBOSE
+#define DEBUG_BUFFER_LEVEL   DEBUG_LEVEL_VERBOSE
+#define DEBUG_BLE_LEVEL      DEBUG_LEVEL_VERBOSE
+#define DEBUG_FORMAT_LEVEL   DEBUG_LEVEL_VERBOSE
+#define DEBUG_SLEEP_LEVEL    DEBUG_LEVEL_VERBOSE
+#define DEBUG_RTC_LEVEL      DEBUG_LEVEL_VERBOSE
+#define DEBUG_APP_LEVEL      DEBUG_LEVEL_VERBOSE
+
 // =============================================================================
 // MACROS DE DEBUG
 // =============================================================================
@@ -0,0 +1,280 @@
+/**
+ * @file DeferredLog.cpp
+ * @brief Anillo MPSC sin locks y tarea de vaciado del log diferido
+ * @version FEAT-V27
+ * @date 2026-10-18
+ */
+
+#include "DeferredLog.h"
+
+#if ENABLE_FEAT_V27_DEFERRED_LOG
+
+#include <atomic>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace DeferredLog {
+
+static_assert((FEAT_V27_RING_SIZE & (FEAT_V27_RING_SIZE - 1)) == 0,
+              "FEAT_V27_RING_SIZE debe ser potencia de 2");
+static const uint32_t RING_MASK = FEAT_V27_RING_SIZE - 1;
+
+/**
+ * @brief Celda del anillo (cola acotada de Vyukov)
+ *
+ * seq == pos      -> libre para el productor que reservó pos
+ * seq == pos + 1  -> publicada, lista para el consumidor
+ */
+struct Cell {
+  std::atomic<uint32_t> seq;
+  Record rec;
+};
+
+static Cell s_cells[FEAT_V27_RING_SIZE];
+static std::atomic<uint32_t> s_enqPos(0);
+static volatile uint32_t s_deqPos = 0;        ///< Solo lo avanza la tarea de vaciado
+static std::atomic<uint32_t> s_dropped(0);
+static std::atomic<uint32_t> s_posted(0);
+static uint32_t s_droppedReported = 0;
+static uint16_t s_highWater = 0;
+static volatile bool s_ready = false;
+static volatile bool s_busy = false;          ///< Tarea con registro en curso
+static Print* s_out = nullptr;
+static TaskHandle_t s_task = nullptr;
+static volatile bool s_lineOpen = false;      ///< Línea sin cerrar (posibles bytes detrás)
+
+// ---------------------------------------------------------------------------
+// Render (tarea de vaciado, o en el acto antes de begin())
+// ---------------------------------------------------------------------------
+
+static void closeLine() {
+  if (s_lineOpen) {
+    s_out->println();
+    s_lineOpen = false;
+  }
+}
+
+/** @brief Bytes de un registro DLOG_BYTES: imprimibles tal cual, CR/LF como espacio */
+static void renderBytes(const Record& r) {
+  char text[DLOG_BYTES_PER_RECORD + 4];
+  uint8_t n = r.args[0] & 0x7F;
+  if (n > DLOG_BYTES_PER_RECORD) n = DLOG_BYTES_PER_RECORD;
+  const uint8_t* b = (const uint8_t*)&r.args[1];
+  uint8_t k = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t c = b[i];
+    text[k++] = (c == '\r' || c == '\n') ? ' ' : ((c >= 0x20 && c < 0x7F) ? (char)c : '.');
+  }
+  if (r.args[0] & 0x80) {
+    text[k++] = '.'; text[k++] = '.'; text[k++] = '.';
+  }
+  s_out->write((const uint8_t*)text, k);
+}
+
+static void renderText(const Record& r) {
+  if (r.id == DLOG_BYTES) {
+    renderBytes(r);
+    return;
+  }
+  closeLine();
+  if (r.id == DLOG_LITERAL) {
+    s_out->println(r.lit.text);
+    return;
+  }
+  if (r.id == DLOG_LITERAL_INT) {
+    s_out->print(r.lit.text);
+    s_out->println(r.lit.value);
+    return;
+  }
+  char line[FEAT_V27_LINE_MAX];
+  int n = snprintf(line, sizeof(line), DLOG_FORMATS[r.id],
+                   r.args[0], r.args[1], r.args[2], r.args[3]);
+  if (n < 0) return;
+  if ((size_t)n >= sizeof(line)) n = sizeof(line) - 1;
+  s_out->write((const uint8_t*)line, n);
+  s_lineOpen = true;  // Se cierra en el próximo registro que no sea BYTES
+}
+
+static void renderBinary(const Record& r) {
+  if (r.id == DLOG_LITERAL || r.id == DLOG_LITERAL_INT) {
+    renderText(r);  // Sin ID de catálogo: viaja como texto
+    return;
+  }
+  uint8_t frame[3 + 6 + 4 * MAX_ARGS + 1];
+  uint8_t len = 6 + 4 * r.nargs;
+  frame[0] = DLOG_SYNC0;
+  frame[1] = DLOG_SYNC1;
+  frame[2] = len;
+  memcpy(&frame[3], &r.tUs, 4);
+  memcpy(&frame[7], &r.id, 2);
+  memcpy(&frame[9], r.args, 4 * r.nargs);
+  uint8_t x = 0;
+  for (uint8_t i = 2; i < 3 + len; i++) x ^= frame[i];
+  frame[3 + len] = x;
+  s_out->write(frame, 4 + len);
+}
+
+static void render(const Record& r) {
+  #if FEAT_V27_BINARY_WIRE
+  renderBinary(r);
+  #else
+  renderText(r);
+  #endif
+}
+
+// ---------------------------------------------------------------------------
+// Cola
+// ---------------------------------------------------------------------------
+
+static bool pop(Record& out) {
+  Cell& c = s_cells[s_deqPos & RING_MASK];
+  uint32_t seq = c.seq.load(std::memory_order_acquire);
+  if ((int32_t)(seq - (s_deqPos + 1)) < 0) return false;
+  out = c.rec;
+  c.seq.store(s_deqPos + RING_MASK + 1, std::memory_order_release);
+  s_deqPos++;
+  return true;
+}
+
+static void enqueue(const Record& r) {
+  if (!s_ready) {
+    render(r);  // Sin tarea: en el acto
+    return;
+  }
+  uint32_t pos = s_enqPos.load(std::memory_order_relaxed);
+  Cell* c;
+  for (;;) {
+    c = &s_cells[pos & RING_MASK];
+    uint32_t seq = c->seq.load(std::memory_order_acquire);
+    int32_t dif = (int32_t)(seq - pos);
+    if (dif == 0) {
+      if (s_enqPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (dif < 0) {
+      s_dropped.fetch_add(1, std::memory_order_relaxed);  // Lleno: nunca bloquear
+      return;
+    } else {
+      pos = s_enqPos.load(std::memory_order_relaxed);
+    }
+  }
+  c->rec = r;
+  c->seq.store(pos + 1, std::memory_order_release);
+  s_posted.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void drainTask(void* arg) {
+  (void)arg;
+  Record r;
+  for (;;) {
+    uint32_t used = s_enqPos.load(std::memory_order_relaxed) - s_deqPos;
+    if (used > s_highWater) s_highWater = (uint16_t)used;
+
+    s_busy = true;
+    bool any = false;
+    while (pop(r)) {
+      render(r);
+      any = true;
+    }
+    uint32_t dropped = s_dropped.load(std::memory_order_relaxed);
+    if (dropped != s_droppedReported) {
+      Record d = {};
+      d.id = DLOG_DROPPED;
+      d.nargs = 1;
+      d.args[0] = dropped - s_droppedReported;
+      d.tUs = (uint32_t)esp_timer_get_time();
+      render(d);
+      s_droppedReported = dropped;
+    }
+    if (!any) closeLine();  // Una vuelta sin registros: cerrar encabezado pendiente
+    s_busy = false;
+    vTaskDelay(pdMS_TO_TICKS(FEAT_V27_DRAIN_PERIOD_MS));
+  }
+}
+
+// ---------------------------------------------------------------------------
+// API
+// ---------------------------------------------------------------------------
+
+void begin(Print* out) {
+  s_out = out;
+  for (uint32_t i = 0; i < FEAT_V27_RING_SIZE; i++) {
+    s_cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+  s_enqPos.store(0, std::memory_order_relaxed);
+  s_deqPos = 0;
+  BaseType_t ok = xTaskCreatePinnedToCore(drainTask, "dlog",
+                                          FEAT_V27_TASK_STACK, NULL,
+                                          FEAT_V27_TASK_PRIORITY, &s_task,
+                                          FEAT_V27_TASK_CORE);
+  s_ready = (ok == pdPASS);
+  if (!s_ready) {
+    Serial.println(F("[FEAT-V27] No se pudo crear tarea de log, impresión directa"));
+  }
+}
+
+void push(DLogId id, uint8_t nargs, const uint32_t* args) {
+  Record r;
+  r.tUs = (uint32_t)esp_timer_get_time();
+  r.id = id;
+  r.nargs = nargs;
+  r.reserved = 0;
+  for (uint8_t i = 0; i < MAX_ARGS; i++) r.args[i] = (i < nargs) ? args[i] : 0;
+  enqueue(r);
+}
+
+void postBytes(DLogId id, uint32_t arg, const uint8_t* data, size_t len, size_t maxBytes) {
+  post(id, arg);
+  size_t n = (len < maxBytes) ? len : maxBytes;
+  for (size_t off = 0; off < n; off += DLOG_BYTES_PER_RECORD) {
+    size_t chunk = n - off;
+    if (chunk > DLOG_BYTES_PER_RECORD) chunk = DLOG_BYTES_PER_RECORD;
+    bool last = (off + chunk >= n);
+    Record r = {};
+    r.tUs = (uint32_t)esp_timer_get_time();
+    r.id = DLOG_BYTES;
+    r.nargs = MAX_ARGS;
+    r.args[0] = (uint32_t)chunk | ((last && len > maxBytes) ? 0x80 : 0);
+    memcpy(&r.args[1], data + off, chunk);
+    enqueue(r);
+  }
+}
+
+void postLiteral(const char* text) {
+  Record r = {};
+  r.tUs = (uint32_t)esp_timer_get_time();
+  r.id = DLOG_LITERAL;
+  r.lit.text = text;
+  enqueue(r);
+}
+
+void postLiteral(const char* text, int32_t value) {
+  Record r = {};
+  r.tUs = (uint32_t)esp_timer_get_time();
+  r.id = DLOG_LITERAL_INT;
+  r.lit.text = text;
+  r.lit.value = value;
+  enqueue(r);
+}
+
+bool flush(uint32_t timeoutMs) {
+  if (!s_ready) return true;
+  uint32_t start = millis();
+  while ((s_enqPos.load(std::memory_order_relaxed) != s_deqPos || s_busy || s_lineOpen) &&
+         (millis() - start < timeoutMs)) {
+    vTaskDelay(pdMS_TO_TICKS(1));
+  }
+  bool empty = (s_enqPos.load(std::memory_order_relaxed) == s_deqPos);
+  s_out->flush();
+  return empty;
+}
+
+void printStats(Print* out) {
+  out->printf("[FEAT-V27] Log diferido: %lu encolados, %lu descartados, ocupación máx %u/%u\n",
+              (unsigned long)s_posted.load(std::memory_order_relaxed),
+              (unsigned long)s_dropped.load(std::memory_order_relaxed),
+              (unsigned)s_highWater, (unsigned)FEAT_V27_RING_SIZE);
+}
+
+}  // namespace DeferredLog
+
+#endif  // ENABLE_FEAT_V27_DEFERRED_LOG
@@ -0,0 +1,153 @@
+/**
+ * @file DeferredLog.h
+ * @brief Log diferido: registros compactos (ID + argumentos) en un anillo sin locks
+ * @version FEAT-V27
+ * @date 2026-10-18
+ *
+ * USO:
+ *   DLOG(APP, INFO, APP_LINE_SEND, i + 1, total);        - Registro de catálogo
+ *   DLOG_BYTES(LTE, INFO, LTE_CASEND_DATA, len, data, len, 50);
+ *                                                        - Encabezado + bytes
+ *   DeferredLog::postLiteral("Error: CNMP fallo");       - Literal en flash
+ *   DeferredLog::flush(500);                             - Antes de dormir/reiniciar
+ *
+ * El productor solo reserva una celda (CAS), copia 24 bytes y publica: no
+ * toca la UART ni formatea. Una tarea de baja prioridad vacía el anillo y
+ * escribe en Serial: texto formateado en el dispositivo o, con
+ * FEAT_V27_BINARY_WIRE, tramas binarias que reconstruye tools/log_decoder.cpp.
+ * Con el anillo lleno el registro se descarta y se cuenta (nunca bloquea).
+ *
+ * FILTRADO:
+ *   En compilación por módulo: DEBUG_<MÓDULO>_ENABLED y DEBUG_<MÓDULO>_LEVEL
+ *   (DebugConfig.h). Un registro filtrado no genera código.
+ *
+ * ORDEN:
+ *   Los registros diferidos salen en orden entre sí, pero pueden quedar
+ *   detrás de Serial.print directos posteriores. El modo binario lleva
+ *   t_us para reordenar en el host.
+ *
+ * Con ENABLE_FEAT_V27_DEFERRED_LOG = 0 las macros imprimen en el acto el
+ * mismo texto del catálogo (comportamiento previo).
+ */
+
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <Arduino.h>
+#include "FeatureFlags.h"
+#include "DebugConfig.h"
+#include "LogCatalog.h"
+
+/** @brief Filtro de compilación por módulo y nivel */
+#define DLOG_ENABLED_(module, level) \
+  (DEBUG_GLOBAL_ENABLED && DEBUG_##module##_ENABLED && (DEBUG_##module##_LEVEL >= DEBUG_LEVEL_##level))
+
+#if ENABLE_FEAT_V27_DEFERRED_LOG
+
+namespace DeferredLog {
+
+/** @brief Máximo de argumentos por registro */
+static const uint8_t MAX_ARGS = 4;
+
+/**
+ * @brief Registro encolado (24 bytes)
+ */
+struct Record {
+  uint32_t tUs;       ///< esp_timer_get_time() al encolar
+  uint16_t id;        ///< DLogId
+  uint8_t nargs;      ///< Argumentos válidos
+  uint8_t reserved;
+  union {
+    uint32_t args[MAX_ARGS];
+    struct {
+      const char* text;   ///< DLOG_LITERAL*: literal en flash
+      int32_t value;
+    } lit;
+  };
+};
+
+/**
+ * @brief Inicializa el anillo y crea la tarea de vaciado.
+ * @param out Destino del texto/binario (Serial).
+ * @note Antes de begin() (o si la tarea no se pudo crear) los registros se
+ *       imprimen en el acto.
+ */
+void begin(Print* out);
+
+/** @brief Encola un registro de catálogo (uso interno de post()). */
+void push(DLogId id, uint8_t nargs, const uint32_t* args);
+
+/**
+ * @brief Encola un registro de catálogo con hasta 4 enteros.
+ */
+template <typename... A>
+inline void post(DLogId id, A... a) {
+  static_assert(sizeof...(A) <= MAX_ARGS, "DLOG: maximo 4 argumentos");
+  const uint32_t v[sizeof...(A) + 1] = {(uint32_t)a..., 0};
+  push(id, (uint8_t)sizeof...(A), v);
+}
+
+/**
+ * @brief Encola un encabezado de catálogo seguido de bytes en trozos DLOG_BYTES.
+ * @param id Encabezado (formato con un %u como máximo).
+ * @param arg Argumento del encabezado.
+ * @param data Bytes a mostrar (se copian).
+ * @param len Longitud total.
+ * @param maxBytes Bytes a copiar como máximo; el resto se indica con "...".
+ */
+void postBytes(DLogId id, uint32_t arg, const uint8_t* data, size_t len, size_t maxBytes);
+
+/**
+ * @brief Encola un literal. El puntero se guarda tal cual: solo literales en flash.
+ */
+void postLiteral(const char* text);
+
+/** @brief Encola un literal seguido de un entero (equivale a print(text); println(value)). */
+void postLiteral(const char* text, int32_t value);
+
+/**
+ * @brief Espera a que la tarea vacíe el anillo y la UART.
+ * @param timeoutMs Espera máxima.
+ * @return true si quedó vacío.
+ */
+bool flush(uint32_t timeoutMs);
+
+/** @brief Imprime encolados, descartados y ocupación máxima del anillo. */
+void printStats(Print* out);
+
+}  // namespace DeferredLog
+
+#define DLOG(module, level, id, ...) \
+  do { if (DLOG_ENABLED_(module, level)) DeferredLog::post(DLOG_##id, ##__VA_ARGS__); } while (0)
+#define DLOG_BYTES(module, level, id, arg, data, len, maxBytes) \
+  do { if (DLOG_ENABLED_(module, level)) DeferredLog::postBytes(DLOG_##id, arg, data, len, maxBytes); } while (0)
+
+#else
+
+namespace DeferredLog {
+
+template <typename... A>
+inline void printNow(DLogId id, A... a) {
+  Serial.printf(DLOG_FORMATS[id], a...);
+  Serial.println();
+}
+
+inline void printBytesNow(DLogId id, uint32_t arg, const uint8_t* data, size_t len, size_t maxBytes) {
+  Serial.printf(DLOG_FORMATS[id], arg);
+  for (size_t i = 0; i < len && i < maxBytes; i++) {
+    Serial.print((char)data[i]);
+  }
+  if (len > maxBytes) Serial.print("...");
+  Serial.println();
+}
+
+}  // namespace DeferredLog
+
+#define DLOG(module, level, id, ...) \
+  do { if (DLOG_ENABLED_(module, level)) DeferredLog::printNow(DLOG_##id, ##__VA_ARGS__); } while (0)
+#define DLOG_BYTES(module, level, id, arg, data, len, maxBytes) \
+  do { if (DLOG_ENABLED_(module, level)) DeferredLog::printBytesNow(DLOG_##id, arg, data, len, maxBytes); } while (0)
+
+#endif  // ENABLE_FEAT_V27_DEFERRED_LOG
+
+#endif  // DEFERRED_LOG_H
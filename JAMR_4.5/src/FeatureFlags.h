@@ -250,6 +250,20 @@
 /** @brief Máximo ciclos de recuperación completos por boot (evita loops) */
 #define FIX_V7_MAX_RECOVERY_PER_BOOT          1
 
+/**
+ * FIX-V8: Unidades de vBat en FIX-V3
+ * Sistema: Energía
+ * Archivo: AppController.cpp (readVBatFiltered)
+ * Descripción: ADCSensorModule::getValue() devuelve vBat en unidades de trama
+ *              (V x100), pero readVBatFiltered() lo pasaba tal cual a
+ *              evaluateBatteryState(), que compara contra 3.20/3.80 V: el
+ *              reposo nunca se activaba. Divide por ADC_MULTIPLIER en la
+ *              lectura propia y en la compartida de FEAT-V14.
+ * Documentación: fixs-feats/fixs/FIX_V8_VBAT_UNIDADES.md
+ * Estado: Implementado
+ */
+#define ENABLE_FIX_V8_VBAT_UNITS              1
+
 // ============================================================
 // FEAT FLAGS - Nuevas funcionalidades
 // ============================================================
@@ -329,6 +343,303 @@
  */
 #define ENABLE_FEAT_V9_BLE_CONFIG             0  // 0=deshabilitado, 1=habilitado
 
+/**
+ * FEAT-V10: Report-by-Exception (deadband por variable + heartbeat)
+ * Sistema: Core/AppController/Formato
+ * Archivo: AppController.cpp, src/data_format/FORMATModule.h, .cpp
+ * Descripción: Solo genera trama (buffer + LTE) cuando alguna variable sale
+ *              de su banda muerta o vence el intervalo máximo de silencio.
+ *              - Deadband independiente para var1..var7 (mismas unidades de la trama)
+ *              - Heartbeat: trama obligatoria cada FEAT_V10_HEARTBEAT_S
+ *              - Contador de muestras suprimidas viaja en la trama (campo extra)
+ *                para que el servidor distinga "sin cambio" de "dato perdido"
+ * Dependencias: RTC (epoch para heartbeat)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V10_REPORT_BY_EXCEPTION   1
+
+/**
+ * FEAT-V11: Wakeup alineado a reloj con compensación de deriva
+ * Sistema: Core/AppController/Sleep
+ * Archivo: AppController.cpp, src/data_sleepwakeup/SLEEPModule.h, .cpp
+ * Descripción: El sleep se calcula desde el epoch del RTC para despertar en
+ *              slots alineados (:00, :10, :20...) sin importar cuánto duró el ciclo.
+ *              - Deriva del timer de sleep estimada con lecturas sucesivas de getEpochTime()
+ *              - Desfase opcional por dispositivo (hash del ICCID) para no saturar celda/servidor
+ *              - Fallback a sleep fijo si el RTC no tiene hora válida
+ * Dependencias: RTC (DS1307/DS3231)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V11_ALIGNED_WAKEUP        1
+
+/**
+ * FEAT-V12: Pipeline dual-core (bring-up LTE en paralelo con sensores)
+ * Sistema: Core/AppController/LTE
+ * Archivo: AppController.cpp, CycleTiming.h
+ * Descripción: El encendido del modem, lectura de ICCID, selección de operadora,
+ *              attach, PDP y apertura TCP corren en una tarea FreeRTOS fijada a
+ *              FEAT_V12_MODEM_CORE mientras AppLoop (core 1) lee sensores, arma
+ *              la trama y escribe el buffer. Ambas ramas se unen antes de transmitir.
+ *              - Primer ciclo post-boot: secuencial (GPS comparte el modem)
+ *              - Reposo FIX-V3 / mocks: secuencial
+ *              - Con FEAT-V10: lanzamiento temprano solo si el reporte es seguro
+ * Dependencias: FreeRTOS (ESP32-S3 dual core)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V12_DUAL_CORE_PIPELINE    1
+
+/**
+ * FEAT-V13: Muestreo concurrente por bus (ADC, I2C, RS485)
+ * Sistema: Sensores/AppController
+ * Archivo: src/data_sensors/SensorSampler.h, .cpp, SampleSlot.h, AppController.cpp
+ * Descripción: Cada bus corre su lazo de descarte+muestreo en una tarea FreeRTOS
+ *              propia con un deadline compartido. Resultados vía slot lock-free
+ *              de un productor (seqlock). Un Modbus lento ya no retrasa ADC/I2C.
+ *              - Latencia por sensor en CycleTiming (adc/i2c/rs485SampleTime)
+ *              - Bus ocupado por trabajo colgado: no se relanza (valor "0")
+ * Dependencias: FreeRTOS, FEAT-V2 (timing)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V13_CONCURRENT_SAMPLING   1
+
+/**
+ * FEAT-V14: Lectura rápida de vBat (ráfaga sobremuestreada + calibración eFuse)
+ * Sistema: Sensores/ADC
+ * Archivo: src/data_sensors/ADCSensorModule.cpp, AppController.cpp
+ * Descripción: Reemplaza los lazos analogRead()+delay() (~550 ms) por una
+ *              ráfaga de analogReadMilliVolts() sin pausas (pocos ms). Una sola
+ *              medición por ciclo compartida por la trama y FIX-V3.
+ *              - ADC_VOLT_BAT (GPIO13) es ADC2: sin modo continuo/DMA en S3
+ * Dependencias: Arduino-ESP32 3.x (calibración curve fitting), FIX-V3
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V14_FAST_ADC              1
+
+/**
+ * FEAT-V15: Planificador de rieles de sonda (encendido temprano + asentamiento)
+ * Sistema: Sensores/AppController
+ * Archivo: src/data_sensors/PowerRails.h, .cpp, AppController.cpp
+ * Descripción: ENPOWER se activa al inicio de AppInit; el asentamiento de cada
+ *              sonda corre en paralelo con NVS, RTC, LittleFS y encendido del
+ *              modem (FEAT-V12). El lector solo espera lo que falte y toma las
+ *              muestras necesarias: sin los 5 descartes Modbus/I2C a ciegas.
+ * Dependencias: Ninguna (FEAT-V12/V13 recomendados)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V15_POWER_RAILS           1
+
+/**
+ * FEAT-V16: Registro de drivers de sondas Modbus con autodetección
+ * Sistema: Sensores/RS485
+ * Archivo: src/data_sensors/ProbeRegistry.h, .cpp, RS485Module.cpp, AppController.cpp
+ * Descripción: Cada driver declara slave ID, función, mapa de registros,
+ *              escalado y calentamiento (JAMR 4.5, DFRobot EC / EC-pH, Seeed EC).
+ *              Detección en boot en frío, persistida en NVS + RTC. Los wakeups
+ *              sondean solo lo presente, fusionando registros adyacentes.
+ * Dependencias: FEAT-V15 (calentamiento por sonda, opcional)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V16_PROBE_REGISTRY        1
+
+/**
+ * FEAT-V17: Estadística robusta en streaming para muestras de sensores
+ * Sistema: Sensores/AppController
+ * Archivo: src/data_sensors/SampleStats.h, AppController.cpp, ADCSensorModule.cpp
+ * Descripción: Acumulador de punto fijo (min/max/count, mediana, MAD) con
+ *              rechazo de outliers por MAD y política de reducción elegida en
+ *              compilación (media recortada ADC/I2C, mediana RS485). El número
+ *              de muestras se adapta: corta en cuanto la señal es estable.
+ * Dependencias: Ninguna (reemplaza promedios double de las 3 rutas)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V17_ROBUST_STATS          1
+
+/**
+ * FEAT-V18: Agregación por ventana con sub-muestreo en light sleep
+ * Sistema: AppController/Formato
+ * Archivo: AppController.cpp, src/data_format/FORMATModule.h/.cpp, config_data_format.h
+ * Descripción: Durante el intervalo de sleep el equipo despierta en light sleep
+ *              cada FEAT_V18_SUBSAMPLE_S, lee ADC e I2C y acumula min/max/suma/
+ *              count en RTC. La trama agrega n + min/max/media de var5..var7
+ *              (el "último" es el valor normal de la trama). Sin modem por muestra.
+ * Costo: +17 % de energía en 30 días simulados (1321 vs 1128 mAh) y el boot
+ *        más largo pasa de 239 s a 546 s (light sleep dentro del ciclo).
+ *        Apagado por defecto: habilitar solo donde la resolución lo amerite.
+ * Dependencias: FEAT-V11 (opcional, presupuesto hasta el slot), FEAT-V14 (opcional)
+ * Estado: Implementado (deshabilitado por defecto)
+ */
+#define ENABLE_FEAT_V18_WINDOW_AGGREGATION    0
+
+/**
+ * FEAT-V19: Planificador cooperativo de estados dirigido por tabla
+ * Sistema: Core/AppController
+ * Archivo: src/StateScheduler.h, .cpp, AppController.cpp
+ * Descripción: AppLoop() deja el switch y recorre g_stateTable (handler,
+ *              deadline, transiciones éxito/fallo, campo CycleTiming). Con el
+ *              flag activo se aplican los deadlines a estados que ceden
+ *              (Step::Yield), se reportan excesos y se imprime la ruta del ciclo.
+ *              Con 0 vuelve el switch original, que llama a los mismos
+ *              handlers, sin deadlines ni ruta.
+ * Dependencias: FEAT-V2 (campos de CycleTiming)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V19_STATE_SCHEDULER       1
+
+/**
+ * FEAT-V20: Inicialización diferida del modem y latencias de wake
+ * Sistema: Core/AppController
+ * Archivo: AppController.cpp, src/CycleTiming.h
+ * Descripción: SerialLTE/PWRKEY (LTE y GNSS) se configuran en el primer uso
+ *              (ensureLte()). Si el ciclo no tocó el modem y el sleep anterior
+ *              confirmó su apagado, FIX-V4 omite el sondeo AT. Mide latencia
+ *              wake->primera muestra y wake->sleep en CycleTiming (con FEAT-V2).
+ * Dependencias: FIX-V4 (confirmación de apagado), FEAT-V2 (medición)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V20_LAZY_INIT             1
+
+// FEAT-V21 (muestra tipada sin String) no tiene flag: el cambio de tipos es
+// permanente y no hay ruta String que restaurar. Ver FEAT_V21_TYPED_SAMPLE.md.
+
+/**
+ * FEAT-V22: Caché write-back en RTC del estado NVS
+ * Sistema: Core/Persistencia
+ * Archivo: src/data_buffer/PersistState.h/.cpp, AppController.cpp
+ * Descripción: lastOperator, skipScanCycles y gps_* se cargan de NVS solo
+ *              cuando la copia RTC no es válida (boot en frío). El ciclo lee
+ *              y escribe la copia RTC; un único flush() antes del deep sleep
+ *              escribe las claves cambiadas. skipScanCycles (anti-bucle
+ *              FIX-V2) se escribe de inmediato.
+ * Dependencias: Ninguna (compatible con FEAT-V12: acceso bajo spinlock)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V22_PERSIST_CACHE         1
+
+/**
+ * FEAT-V23: Spans jerárquicos en µs con ring en memoria RTC
+ * Sistema: Core/Observabilidad
+ * Archivo: src/TraceSpan.h/.cpp, StateScheduler.cpp, LTEModule.cpp,
+ *          GPSModule.cpp, BUFFERModule.cpp, ProductionDiag.cpp
+ * Descripción: Cada handler de estado, comando AT y operación LittleFS
+ *              registra inicio/duración en µs, profundidad y core en un ring
+ *              RTC que sobrevive al deep sleep. Comandos TRACE / TRACE BIN /
+ *              TRACE CLEAR por Serial y TRACE por BLE (formato JTRC).
+ * Dependencias: FEAT-V19 (nombres de fase)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V23_TRACE_SPANS           1
+
+/**
+ * FEAT-V25: Ring binario O(1) para el log de eventos de ProdDiag
+ * Sistema: Diagnóstico
+ * Archivo: src/data_diagnostics/ProductionDiag.cpp
+ * Descripción: /diag/events.bin preasignado con cabecera (head/count) y
+ *              slots de 8 bytes. logEvent() escribe un slot y la cabecera;
+ *              ya no lee ni reescribe events.txt al rotar. printEventLog()
+ *              mantiene la salida "epoch,código,dato". events.txt existente
+ *              se migra al ring en init().
+ * Dependencias: FEAT-V7
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V25_EVENT_RING            1
+
+/**
+ * FEAT-V26: Contexto de crash en RTC con promoción diferida a NVS
+ * Sistema: Diagnóstico
+ * Archivo: src/data_diagnostics/CrashDiagnostics.cpp, LTEModule.cpp
+ * Descripción: Checkpoints y último comando/respuesta AT quedan en
+ *              RTC_NOINIT_ATTR con CRC32 (sobreviven panic/WDT). CRASH_SYNC_NVS() escribe
+ *              solo si el checkpoint cambió, a tasa acotada; el contexto
+ *              completo se promueve a NVS en el boot posterior a un crash.
+ *              Reporte por ciclo de escrituras NVS hechas/evitadas.
+ * Dependencias: FEAT-V3
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V26_CRASH_RTC_LAZY        1
+
+/**
+ * FEAT-V27: Log diferido con codificación binaria
+ * Sistema: Debug / Logging
+ * Archivo: src/DeferredLog.h/.cpp, src/LogCatalog.h, tools/log_decoder.cpp
+ * Descripción: Los puntos de log del camino crítico (envío por trama,
+ *              CASEND, debugPrint de LTEModule) encolan un registro de
+ *              24 bytes (ID de formato + argumentos) en un anillo sin locks.
+ *              Una tarea de baja prioridad lo vacía a Serial como texto o
+ *              como tramas binarias que reconstruye el decodificador host.
+ *              Filtrado por módulo y nivel en compilación (DebugConfig.h).
+ * Dependencias: Ninguna
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V27_DEFERRED_LOG          1
+
+/**
+ * FEAT-V28: Marcas de heap y stack por fase del ciclo
+ * Sistema: Diagnóstico / Core
+ * Archivo: src/StateScheduler.cpp, src/CycleTiming.h, ProductionDiag.cpp
+ * Descripción: Cada fase de CycleTiming registra heap libre mínimo, bloque
+ *              libre más grande y high-water mark del stack de loop().
+ *              Los peores valores del ciclo se acumulan en ProductionStats
+ *              y, bajo umbral, se registra el evento EVT_MEM_ALARM ('M').
+ * Dependencias: FEAT-V2, FEAT-V19 (planificador), FEAT-V7 (ProductionStats)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V28_MEM_WATERMARKS        1
+
+/**
+ * FEAT-V29: Contabilidad de desgaste de flash por subsistema
+ * Sistema: Diagnóstico / Almacenamiento
+ * Archivo: src/data_diagnostics/FlashWear.h/.cpp
+ * Descripción: Envuelve las escrituras LittleFS y los puts de Preferences
+ *              de BUFFERModule, ProdDiag, CrashDiag, PersistState y
+ *              AppController. Cuenta bytes, archivos reescritos y bloques
+ *              borrados estimados por subsistema y ciclo, y proyecta la
+ *              vida útil de la flash en el comando STATS.
+ * Dependencias: FEAT-V7 (sección en STATS)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V29_FLASH_WEAR            1
+
+/**
+ * FEAT-V30: Trama de telemetría in-band (ProductionStats + tiempos)
+ * Sistema: Formato / LTE / Diagnóstico
+ * Archivo: src/data_format/TelemetryFrame.h/.cpp, TelemetryLayout.h
+ * Descripción: Cada N ciclos envía, en la misma sesión TCP que las tramas
+ *              de datos, una trama binaria en Base64 con los contadores de
+ *              ProductionStats en delta (LEB128) y p50/p90/máx por fase de
+ *              CycleTiming. Decodificador: tools/telemetry_decoder.cpp.
+ * Dependencias: FEAT-V7 (obligatoria), FEAT-V2 (sección de tiempos)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V30_TELEMETRY_FRAME       1
+
+/**
+ * FEAT-V33: Micro-benchmarks de trama, Base64, parseo, CRC y buffer
+ * Sistema: Diagnóstico / Herramientas
+ * Archivo: src/data_diagnostics/MicroBench.h/.cpp, tools/bench/jamr_bench.cpp
+ * Descripción: Comando Serial BENCH: corre con entradas fijas buildFrame,
+ *              Base64, parseo de CPSI y CGNSINF, CRC16 y lectura/compactado
+ *              del buffer (en un archivo aparte) e imprime ns/op y ciclos
+ *              por byte. Los mismos kernels corren en el host con conteo de
+ *              heap y comparación contra tools/bench/baseline.txt.
+ * Dependencias: FEAT-V7 (CRC16), FEAT-V9 (comandos Serial)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V33_MICRO_BENCH           1
+
+/**
+ * FEAT-V34: Descarga masiva del buffer por BLE
+ * Sistema: Buffer / BLE
+ * Archivo: src/data_buffer/BLEModule.h/.cpp
+ * Descripción: Comando BLE BULK[:token]: recorre buffer.txt por offset, sin
+ *              el tope de MAX_LINES_TO_READ, y empaqueta varias líneas por
+ *              notificación en registros binarios. MTU de hasta 517, control
+ *              de flujo por créditos (CREDIT:n) en lugar de delay(50), token
+ *              de reanudación y KB/s en la característica de estado.
+ * Dependencias: FEAT-V7 (CRC16 del token), FEAT-V9 (modo BLE)
+ * Estado: Implementado
+ */
+#define ENABLE_FEAT_V34_BLE_BULK              1
+
 // ============================================================
 // FEAT-V4: PARÁMETROS DE REINICIO PERIÓDICO
 // ============================================================
@@ -359,6 +670,348 @@
 #define FEAT4_RESTART_PERIODIC                1   // Restart por tiempo >= 24h
 #define FEAT4_RESTART_EXECUTED                2   // Restart fue ejecutado
 
+// ============================================================
+// FEAT-V10: PARÁMETROS DE REPORT-BY-EXCEPTION
+// ============================================================
+
+/**
+ * @brief Bandas muertas por variable (mismas unidades enteras de la trama)
+ * Orden: var1..var4 = registros RS485 (crudos), var5 = temp x100 (°C),
+ *        var6 = humedad x100 (%), var7 = vBat x100 (V)
+ * Un cambio MAYOR a la banda respecto a la última trama reportada dispara envío.
+ */
+#define FEAT_V10_DEADBAND_VAR1                5
+#define FEAT_V10_DEADBAND_VAR2                5
+#define FEAT_V10_DEADBAND_VAR3                5
+#define FEAT_V10_DEADBAND_VAR4                5
+#define FEAT_V10_DEADBAND_VAR5                50    // 0.50 °C
+#define FEAT_V10_DEADBAND_VAR6                200   // 2.00 %HR
+#define FEAT_V10_DEADBAND_VAR7                10    // 0.10 V
+
+/** @brief Intervalo máximo sin reportar (heartbeat) en segundos */
+#define FEAT_V10_HEARTBEAT_S                  3600
+
+/** @brief Ancho del campo de suprimidas en la trama (dígitos, satura en 9999) */
+#define FEAT_V10_SUPPRESSED_LEN               4
+
+// ============================================================
+// FEAT-V11: PARÁMETROS DE WAKEUP ALINEADO
+// ============================================================
+
+/** @brief Sleep mínimo (s). Si el próximo slot está más cerca, se salta al siguiente */
+#define FEAT_V11_MIN_SLEEP_S                  30
+
+/** @brief Habilitar desfase por dispositivo derivado del ICCID */
+#define FEAT_V11_ICCID_OFFSET                 1
+
+/** @brief Ventana de dispersión del desfase por ICCID (s), acotada al periodo */
+#define FEAT_V11_OFFSET_WINDOW_S              120
+
+/** @brief Divisor del filtro EMA de deriva (mayor = más lento/estable) */
+#define FEAT_V11_DRIFT_EMA_DIV                4
+
+/** @brief Deriva máxima aceptada (ppm). Mediciones fuera de rango se descartan */
+#define FEAT_V11_MAX_DRIFT_PPM                50000   // 5% (oscilador RC interno)
+
+/** @brief Epoch mínimo considerado válido (2023-11-14). Menor = RTC sin hora */
+#define FEAT_V11_MIN_VALID_EPOCH              1700000000UL
+
+// ============================================================
+// FEAT-V12: PARÁMETROS DE PIPELINE DUAL-CORE
+// ============================================================
+
+/** @brief Core donde corre la tarea del modem (AppLoop corre en core 1) */
+#define FEAT_V12_MODEM_CORE                   0
+
+/** @brief Stack de la tarea del modem (bytes). Strings de respuestas AT */
+#define FEAT_V12_TASK_STACK                   8192
+
+/** @brief Prioridad de la tarea del modem (loopTask = 1) */
+#define FEAT_V12_TASK_PRIORITY                1
+
+/** @brief Timeout del join (ms). Cubre escaneo de operadoras + attach + TCP */
+#define FEAT_V12_JOIN_TIMEOUT_MS              600000UL
+
+/** @brief Espera (ms) a que la tarea salga tras requestAbort() en el timeout del join */
+#define FEAT_V12_ABORT_WAIT_MS                60000UL
+
+// ============================================================
+// FEAT-V13: PARÁMETROS DE MUESTREO CONCURRENTE
+// ============================================================
+
+/** @brief Deadline compartido de muestreo (ms desde el lanzamiento) */
+#define FEAT_V13_DEADLINE_MS                  6000UL
+
+/** @brief Margen de espera tras el deadline (>= MODBUS_TIMEOUT_MS, transacción en curso) */
+#define FEAT_V13_GRACE_MS                     1500UL
+
+/** @brief Core de las tareas de muestreo (AppLoop = core 1, modem = core 0) */
+#define FEAT_V13_SAMPLER_CORE                 1
+
+/** @brief Stack por tarea de muestreo (bytes) */
+#define FEAT_V13_TASK_STACK                   4096
+
+/** @brief Prioridad de las tareas de muestreo (> loopTask para no esperar CPU) */
+#define FEAT_V13_TASK_PRIORITY                2
+
+// ============================================================
+// FEAT-V14: PARÁMETROS DE LECTURA RÁPIDA ADC
+// ============================================================
+
+/** @brief Lecturas descartadas al inicio de la ráfaga */
+#define FEAT_V14_ADC_DISCARD                  4
+
+/** @brief Lecturas promediadas (sobremuestreo, ~40 us c/u) */
+#define FEAT_V14_ADC_OVERSAMPLE               64
+
+/**
+ * @brief Ajuste (V) sumado a la lectura calibrada, en lugar de ADC_ADJUSTMENT
+ * @details ADC_ADJUSTMENT (0.3 V) compensa el error de analogRead() sin
+ *          calibrar. analogReadMilliVolts() ya corrige con la curva eFuse, así
+ *          que aquí no se suma. Ajustar contra multímetro si el hardware
+ *          tuviera un offset real (p. ej. un diodo en serie con el divisor).
+ */
+#define FEAT_V14_ADC_ADJUSTMENT               0.0f
+
+// ============================================================
+// FEAT-V15: PARÁMETROS DE RIELES DE SONDA
+// ============================================================
+
+/** @brief Asentamiento de la sonda Modbus tras ENPOWER (ms, según datasheet) */
+#define FEAT_V15_RS485_SETTLE_MS              1500UL
+
+/** @brief Asentamiento del AHT20 tras power-on (ms, datasheet >= 40) */
+#define FEAT_V15_I2C_SETTLE_MS                100UL
+
+/** @brief Intentos Modbus tras asentar (primera lectura válida gana) */
+#define FEAT_V15_RS485_MAX_READS              3
+
+/** @brief Espera máxima de asentamiento en la ruta secuencial (ms) */
+#define FEAT_V15_MAX_SETTLE_WAIT_MS           5000UL
+
+// ============================================================
+// FEAT-V16: PARÁMETROS DE REGISTRO DE SONDAS
+// ============================================================
+
+/** @brief Namespace NVS del resultado de detección */
+#define FEAT_V16_NVS_NAMESPACE                "probes"
+
+/** @brief Peticiones Modbus máximas del plan por ciclo */
+#define FEAT_V16_MAX_BLOCKS                   8
+
+/** @brief Hueco máximo (registros) que se lee de más para fusionar rangos */
+#define FEAT_V16_MERGE_GAP                    2
+
+/** @brief Intentos por driver durante la detección */
+#define FEAT_V16_DETECT_TRIES                 2
+
+/** @brief Ciclos consecutivos con sondeo fallido antes de re-detectar */
+#define FEAT_V16_REDETECT_FAILS               3
+
+/** @brief Tope de ciclos de espera entre detecciones vacías (espera 0, 1, 3, 7...) */
+#define FEAT_V16_REDETECT_MAX_WAIT            36
+
+// ============================================================
+// FEAT-V17: PARÁMETROS DE ESTADÍSTICA ROBUSTA
+// ============================================================
+
+/** @brief Muestras mínimas / máximas ADC e I2C (antes KEEP_SAMPLES = 5 fijo) */
+#define FEAT_V17_MIN_SAMPLES                  3
+#define FEAT_V17_MAX_SAMPLES                  8
+
+/** @brief Muestras mínimas / máximas RS485 */
+#define FEAT_V17_RS485_MIN_SAMPLES            2
+#define FEAT_V17_RS485_MAX_SAMPLES            5
+
+/** @brief Rechazo: |x - mediana| > K * 1.4826 * MAD */
+#define FEAT_V17_MAD_K                        3
+
+/** @brief Media recortada: descarta n / TRIM_DIV por extremo */
+#define FEAT_V17_TRIM_DIV                     4
+
+/** @brief Tolerancia de estabilidad (MAD) por ruta, unidades de trama */
+#define FEAT_V17_TOL_ADC                      2     // V x100
+#define FEAT_V17_TOL_TEMP                     5     // °C x100
+#define FEAT_V17_TOL_HUM                      20    // %HR x100
+#define FEAT_V17_TOL_RS485                    1     // Registro crudo
+
+/** @brief Ráfaga FEAT-V14: mínimo de lecturas y tolerancia (mV en pin) */
+#define FEAT_V17_ADC_BURST_MIN                16
+#define FEAT_V17_TOL_ADC_MV                   3
+
+/** @brief Límite de la ruta secuencial (sin FEAT-V13) */
+#define FEAT_V17_SEQ_DEADLINE_MS              15000UL
+
+// ============================================================
+// FEAT-V18: PARÁMETROS DE AGREGACIÓN POR VENTANA
+// ============================================================
+
+/** @brief Periodo de sub-muestreo en light sleep (segundos) */
+#define FEAT_V18_SUBSAMPLE_S                  60
+
+/** @brief Cola mínima de deep sleep tras la última sub-muestra (segundos).
+ *  Debe superar FEAT_V11_MIN_SLEEP_S para no saltar al slot siguiente. */
+#define FEAT_V18_TAIL_S                       45
+
+/** @brief Ancho del contador de muestras de la ventana (satura en 999) */
+#define FEAT_V18_COUNT_LEN                    3
+
+// ============================================================
+// FEAT-V19: PARÁMETROS DEL PLANIFICADOR DE ESTADOS
+// ============================================================
+
+/** @brief Deadline por estado (ms). Estados bloqueantes: solo se reporta el exceso */
+#define FEAT_V19_DEADLINE_SENSORS_MS          30000UL
+#define FEAT_V19_DEADLINE_NVS_MS              2000UL
+#define FEAT_V19_DEADLINE_GPS_MS              180000UL
+#define FEAT_V19_DEADLINE_ICCID_MS            120000UL  // Incluye espera del ICCID de FEAT-V12
+#define FEAT_V19_DEADLINE_FRAME_MS            1000UL
+#define FEAT_V19_DEADLINE_BUFFER_MS           10000UL
+#define FEAT_V19_DEADLINE_LTE_MS              900000UL
+
+/** @brief Tramos máximos registrados en la ruta de un ciclo */
+#define FEAT_V19_PATH_MAX                     16
+
+// ============================================================
+// FEAT-V22: PARÁMETROS DE LA CACHÉ DE ESTADO PERSISTENTE
+// ============================================================
+
+/** @brief Namespace NVS cacheado (mismo que usaba AppController) */
+#define FEAT_V22_NVS_NAMESPACE                "sensores"
+
+// ============================================================
+// FEAT-V23: PARÁMETROS DE TRAZAS DE SPANS
+// ============================================================
+
+/** @brief Registros del ring RTC (20 bytes c/u: 96 = 1920 bytes de RTC slow) */
+#define FEAT_V23_RING_SIZE                    96
+
+/** @brief Nombres distintos máximos en un volcado binario */
+#define FEAT_V23_MAX_NAMES                    48
+
+// ============================================================
+// FEAT-V25: PARÁMETROS DEL RING DE EVENTOS
+// ============================================================
+
+/** @brief Archivo del ring binario (reemplaza PROD_DIAG_EVENTS_FILE) */
+#define FEAT_V25_EVENTS_FILE                  "/diag/events.bin"
+
+/** @brief Slots del ring (8 bytes c/u: 128 = 1040 bytes con cabecera) */
+#define FEAT_V25_EVENT_SLOTS                  128
+
+/** @brief Magic de la cabecera ("EVRG" en little endian) */
+#define FEAT_V25_RING_MAGIC                   0x47525645UL
+
+// ============================================================
+// FEAT-V26: PARÁMETROS DE PROMOCIÓN DIFERIDA DE CRASHDIAG
+// ============================================================
+
+/** @brief Intervalo mínimo entre escrituras del checkpoint a NVS (cubre brownout) */
+#define FEAT_V26_NVS_SYNC_MIN_MS              60000UL
+
+// ============================================================
+// FEAT-V27: PARÁMETROS DE LOG DIFERIDO
+// ============================================================
+
+/** @brief Celdas del anillo (potencia de 2, 24 bytes c/u) */
+#define FEAT_V27_RING_SIZE                    128
+
+/** @brief 1 = tramas binarias (tools/log_decoder), 0 = texto formateado en el dispositivo
+ *  Texto por defecto: una consola serie normal sigue siendo legible. */
+#define FEAT_V27_BINARY_WIRE                  0
+
+/** @brief Núcleo de la tarea de vaciado */
+#define FEAT_V27_TASK_CORE                    0
+
+/** @brief Prioridad de la tarea de vaciado (baja) */
+#define FEAT_V27_TASK_PRIORITY                1
+
+/** @brief Stack de la tarea de vaciado (bytes) */
+#define FEAT_V27_TASK_STACK                   3072
+
+/** @brief Periodo de sondeo del anillo cuando está vacío (ms) */
+#define FEAT_V27_DRAIN_PERIOD_MS              10
+
+/** @brief Largo máximo de una línea formateada (bytes; un borde ═ de 54 columnas ocupa 162) */
+#define FEAT_V27_LINE_MAX                     176
+
+/** @brief Bytes máximos copiados por DLOG_BYTES de respuestas del modem */
+#define FEAT_V27_BYTES_MAX                    48
+
+/** @brief Espera máxima para vaciar el log antes de dormir/reiniciar (ms) */
+#define FEAT_V27_FLUSH_TIMEOUT_MS             500
+
+// ============================================================
+// FEAT-V28: PARÁMETROS DE MARCAS DE MEMORIA
+// ============================================================
+
+/** @brief Fases registradas (>= cantidad de AppState) */
+#define FEAT_V28_MAX_PHASES                   12
+
+/** @brief Alarma si el heap libre mínimo del ciclo baja de este valor (bytes) */
+#define FEAT_V28_HEAP_ALARM_BYTES             40000UL
+
+/** @brief Alarma si el bloque libre más grande baja de este valor (fragmentación) */
+#define FEAT_V28_BLOCK_ALARM_BYTES            16384UL
+
+/** @brief Alarma si el stack libre de loop() baja de este valor (bytes) */
+#define FEAT_V28_STACK_ALARM_BYTES            1024
+
+// ============================================================
+// FEAT-V29: PARÁMETROS DE DESGASTE DE FLASH
+// ============================================================
+
+/** @brief Ciclos de borrado por sector garantizados por la flash SPI */
+#define FEAT_V29_ENDURANCE_CYCLES             100000UL
+
+/** @brief Bloque de borrado (LittleFS y página NVS) */
+#define FEAT_V29_BLOCK_SIZE                   4096UL
+
+/** @brief Bytes de metadatos por commit de LittleFS (par de bloques de directorio) */
+#define FEAT_V29_LFS_META_BYTES               128
+
+/** @brief Tamaño de la partición "nvs" (tabla default de Arduino: 0x5000) */
+#define FEAT_V29_NVS_PARTITION_BYTES          20480UL
+
+// ============================================================
+// FEAT-V30: PARÁMETROS DE TELEMETRÍA IN-BAND
+// ============================================================
+
+/** @brief Ciclos entre tramas de telemetría (= ventana de percentiles, máx 255) */
+#define FEAT_V30_EVERY_N_CYCLES               36
+
+/** @brief Cada cuántas tramas los contadores van absolutos (resincroniza el servidor) */
+#define FEAT_V30_KEYFRAME_EVERY               24
+
+// ============================================================
+// FEAT-V33: PARÁMETROS DE MICRO-BENCHMARKS
+// ============================================================
+
+/** @brief Repeticiones por kernel; se informa la mediana (máx 15) */
+#define FEAT_V33_REPEATS                      5
+
+/** @brief Archivo de los kernels de buffer (se borra al terminar) */
+#define FEAT_V33_BENCH_FILE                   "/bench.txt"
+
+// ============================================================
+// FEAT-V34: PARÁMETROS DE DESCARGA MASIVA BLE
+// ============================================================
+
+/** @brief MTU ATT que se ofrece al cliente (máx 517) */
+#define FEAT_V34_MTU                          517
+
+/** @brief Notificaciones que el cliente tiene concedidas al iniciar BULK */
+#define FEAT_V34_INITIAL_CREDITS              8
+
+/** @brief Sin créditos nuevos durante este tiempo, la descarga se pausa (ms) */
+#define FEAT_V34_STALL_MS                     15000
+
+/** @brief Período de la notificación de estado durante la descarga (ms) */
+#define FEAT_V34_STATUS_MS                    1000
+
+/** @brief Reconexiones permitidas tras una descarga interrumpida */
+#define FEAT_V34_MAX_RECONNECTS               3
+
 // ============================================================
 // FUNCIÓN DE DEBUG: Imprimir flags activos
 // ============================================================
@@ -421,6 +1074,12 @@ inline void printActiveFlags() {
     Serial.println(F("  [ ] FIX-V7: Zombie Mitigation"));
     #endif
     
+    #if ENABLE_FIX_V8_VBAT_UNITS
+    Serial.println(F("  [X] FIX-V8: vBat Units (V x100 -> V)"));
+    #else
+    Serial.println(F("  [ ] FIX-V8: vBat Units"));
+    #endif
+    
     // FEAT Flags
     #if ENABLE_FEAT_V2_CYCLE_TIMING
     Serial.println(F("  [X] FEAT-V2: Cycle Timing"));
@@ -464,6 +1123,134 @@ inline void printActiveFlags() {
     #else
     Serial.println(F("  [ ] FEAT-V9: BLE Config Mode (DISABLED)"));
     #endif
+
+    #if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+    Serial.print(F("  [X] FEAT-V10: Report-by-Exception (heartbeat "));
+    Serial.print(FEAT_V10_HEARTBEAT_S);
+    Serial.println(F("s)"));
+    #else
+    Serial.println(F("  [ ] FEAT-V10: Report-by-Exception"));
+    #endif
+
+    #if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+    Serial.println(F("  [X] FEAT-V11: Aligned Wakeup (drift comp)"));
+    #else
+    Serial.println(F("  [ ] FEAT-V11: Aligned Wakeup"));
+    #endif
+
+    #if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+    Serial.println(F("  [X] FEAT-V12: Dual-Core Pipeline (LTE || sensores)"));
+    #else
+    Serial.println(F("  [ ] FEAT-V12: Dual-Core Pipeline"));
+    #endif
+
+    #if ENABLE_FEAT_V13_CONCURRENT_SAMPLING
+    Serial.println(F("  [X] FEAT-V13: Concurrent Bus Sampling"));
+    #else
+    Serial.println(F("  [ ] FEAT-V13: Concurrent Bus Sampling"));
+    #endif
+
+    #if ENABLE_FEAT_V14_FAST_ADC
+    Serial.println(F("  [X] FEAT-V14: Fast Calibrated vBat"));
+    #else
+    Serial.println(F("  [ ] FEAT-V14: Fast Calibrated vBat"));
+    #endif
+
+    #if ENABLE_FEAT_V15_POWER_RAILS
+    Serial.println(F("  [X] FEAT-V15: Probe Power Rails"));
+    #else
+    Serial.println(F("  [ ] FEAT-V15: Probe Power Rails"));
+    #endif
+
+    #if ENABLE_FEAT_V16_PROBE_REGISTRY
+    Serial.println(F("  [X] FEAT-V16: Modbus Probe Registry"));
+    #else
+    Serial.println(F("  [ ] FEAT-V16: Modbus Probe Registry"));
+    #endif
+
+    #if ENABLE_FEAT_V17_ROBUST_STATS
+    Serial.println(F("  [X] FEAT-V17: Robust Sample Stats"));
+    #else
+    Serial.println(F("  [ ] FEAT-V17: Robust Sample Stats"));
+    #endif
+
+    #if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+    Serial.println(F("  [X] FEAT-V18: Windowed Aggregation"));
+    #else
+    Serial.println(F("  [ ] FEAT-V18: Windowed Aggregation"));
+    #endif
+
+    #if ENABLE_FEAT_V19_STATE_SCHEDULER
+    Serial.println(F("  [X] FEAT-V19: Table-Driven State Scheduler"));
+    #else
+    Serial.println(F("  [ ] FEAT-V19: Table-Driven State Scheduler"));
+    #endif
+
+    #if ENABLE_FEAT_V20_LAZY_INIT
+    Serial.println(F("  [X] FEAT-V20: Lazy Module Init"));
+    #else
+    Serial.println(F("  [ ] FEAT-V20: Lazy Module Init"));
+    #endif
+
+    #if ENABLE_FEAT_V22_PERSIST_CACHE
+    Serial.println(F("  [X] FEAT-V22: RTC Persist Cache"));
+    #else
+    Serial.println(F("  [ ] FEAT-V22: RTC Persist Cache"));
+    #endif
+
+    #if ENABLE_FEAT_V23_TRACE_SPANS
+    Serial.println(F("  [X] FEAT-V23: Trace Spans"));
+    #else
+    Serial.println(F("  [ ] FEAT-V23: Trace Spans"));
+    #endif
+
+    #if ENABLE_FEAT_V25_EVENT_RING
+    Serial.println(F("  [X] FEAT-V25: ProdDiag Event Ring"));
+    #else
+    Serial.println(F("  [ ] FEAT-V25: ProdDiag Event Ring"));
+    #endif
+
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    Serial.println(F("  [X] FEAT-V26: CrashDiag RTC Lazy NVS"));
+    #else
+    Serial.println(F("  [ ] FEAT-V26: CrashDiag RTC Lazy NVS"));
+    #endif
+
+    #if ENABLE_FEAT_V27_DEFERRED_LOG
+    Serial.println(F("  [X] FEAT-V27: Deferred Binary Log"));
+    #else
+    Serial.println(F("  [ ] FEAT-V27: Deferred Binary Log"));
+    #endif
+
+    #if ENABLE_FEAT_V28_MEM_WATERMARKS
+    Serial.println(F("  [X] FEAT-V28: Memory Watermarks"));
+    #else
+    Serial.println(F("  [ ] FEAT-V28: Memory Watermarks"));
+    #endif
+
+    #if ENABLE_FEAT_V29_FLASH_WEAR
+    Serial.println(F("  [X] FEAT-V29: Flash Wear"));
+    #else
+    Serial.println(F("  [ ] FEAT-V29: Flash Wear"));
+    #endif
+
+    #if ENABLE_FEAT_V30_TELEMETRY_FRAME
+    Serial.println(F("  [X] FEAT-V30: Telemetry Frame"));
+    #else
+    Serial.println(F("  [ ] FEAT-V30: Telemetry Frame"));
+    #endif
+
+    #if ENABLE_FEAT_V33_MICRO_BENCH
+    Serial.println(F("  [X] FEAT-V33: Micro Benchmarks"));
+    #else
+    Serial.println(F("  [ ] FEAT-V33: Micro Benchmarks"));
+    #endif
+
+    #if ENABLE_FEAT_V34_BLE_BULK
+    Serial.println(F("  [X] FEAT-V34: BLE Bulk Download"));
+    #else
+    Serial.println(F("  [ ] FEAT-V34: BLE Bulk Download"));
+    #endif
     
     // DEBUG Flags (FEAT-V5)
     #if DEBUG_STRESS_TEST_ENABLED
@@ -0,0 +1,82 @@
+/**
+ * @file LogCatalog.h
+ * @brief Catálogo de formatos del log diferido (ID -> formato printf)
+ * @version FEAT-V27
+ * @date 2026-10-18
+ *
+ * Compartido entre el firmware (DeferredLog) y el decodificador host
+ * (tools/log_decoder.cpp): no incluir Arduino.h ni nada del ESP32 aquí.
+ *
+ * REGLAS DEL CATÁLOGO:
+ *   - Solo agregar al final: el ID es la posición y viaja en el binario.
+ *   - Argumentos: hasta 4 enteros de 32 bits (%d, %u, %X). Sin %s ni %f;
+ *     para texto/bytes usar DLOG_BYTES (trozos de 12 bytes).
+ *   - El texto replica la línea Serial original (incluye [NIVEL][MÓDULO]).
+ */
+
+#ifndef LOG_CATALOG_H
+#define LOG_CATALOG_H
+
+#include <stdint.h>
+
+#define DLOG_CATALOG(X) \
+  /* ---- Reservados (sin formato de catálogo) ---- */ \
+  X(BYTES,            "")  /* Continuación: a0 = n, a1..a3 = hasta 12 bytes */ \
+  X(LITERAL,          "")  /* Literal en flash (solo en el dispositivo) */ \
+  X(LITERAL_INT,      "")  /* Literal en flash + entero */ \
+  X(DROPPED,          "[WARN][LOG] %u registros descartados (anillo lleno)") \
+  /* ---- AppController: envío del buffer ---- */ \
+  X(APP_BUF_LINES,    "[INFO][APP] Líneas en buffer: %d") \
+  X(APP_LINE_SKIP,    "[DEBUG][APP] Línea %d ya procesada, saltando...") \
+  X(APP_LINE_SEND,    "[INFO][APP] Enviando línea %d/%d") \
+  X(APP_LINE_SENT,    "[INFO][APP] Línea %d enviada y marcada como procesada") \
+  X(APP_LINE_FAIL,    "[WARN][APP] Fallo al enviar línea %d. Deteniendo envío. Línea permanece en buffer.") \
+  X(APP_SEND_SUMMARY, "[INFO][APP] Resumen: %d de %d tramas enviadas") \
+  /* ---- LTEModule: CASEND ---- */ \
+  X(LTE_CASEND_CMD,   "Enviando: AT+CASEND=0,%u") \
+  X(LTE_CASEND_DATA,  "Datos (%u bytes): ") \
+  X(LTE_CASEND_RESP,  "Respuesta CASEND: ") \
+  /* ---- AppController: lectura y fin de ciclo ---- */ \
+  X(APP_RBE_SUPPRESSED, "[FEAT-V10] Muestra suprimida (sin cambios). Suprimidas: %u") \
+  X(APP_MODEM_OFF_SKIP, "[FEAT-V20] Modem no usado y apagado confirmado, se omite sondeo") \
+  X(APP_MODEM_OFF_BEGIN, "[FIX-V4] Asegurando apagado de modem antes de sleep...") \
+  X(APP_MODEM_OFF_DONE, "[FIX-V4] Secuencia de apagado completada.") \
+  X(APP_RESTART_SLEEP,  "[FEAT-V4] Acumulador: %u / %u s (%u.%u%%) -> sleep") \
+  X(APP_RESTART_DUE,    "[FEAT-V4] Acumulador: %u / %u s (%u.%u%%) -> RESTART") \
+  X(APP_RESTART_TOP,    "\n╔════════════════════════════════════════════════════╗") \
+  X(APP_RESTART_TITLE,  "║  [FEAT-V4] REINICIO PERIODICO PREVENTIVO           ║") \
+  X(APP_RESTART_SEP,    "╠════════════════════════════════════════════════════╣") \
+  X(APP_RESTART_ACCUM,  "║  Tiempo acumulado: %u s") \
+  X(APP_RESTART_LIMIT_H, "║  Threshold: %u s (%d horas)") \
+  X(APP_RESTART_LIMIT_M, "║  Threshold: %u s (%d minutos STRESS)") \
+  X(APP_RESTART_REASON, "║  Reset reason anterior: %d") \
+  X(APP_RESTART_MOTIVE, "║  Motivo: PERIODIC_24H (planificado)                ║") \
+  X(APP_RESTART_EXEC,   "║  Ejecutando esp_restart() en punto seguro...       ║") \
+  X(APP_RESTART_BOTTOM, "╚════════════════════════════════════════════════════╝") \
+  X(APP_RBE_PENDING,    "[FEAT-V10] Buffer con tramas pendientes (%u B) -> LTE")
+
+enum DLogId : uint16_t {
+#define DLOG_ENUM_(id, fmt) DLOG_##id,
+  DLOG_CATALOG(DLOG_ENUM_)
+#undef DLOG_ENUM_
+  DLOG_COUNT
+};
+
+static const char* const DLOG_FORMATS[DLOG_COUNT] = {
+#define DLOG_FMT_(id, fmt) fmt,
+  DLOG_CATALOG(DLOG_FMT_)
+#undef DLOG_FMT_
+};
+
+/** @brief Bytes útiles por registro DLOG_BYTES */
+#define DLOG_BYTES_PER_RECORD  12
+
+/**
+ * FORMATO BINARIO EN EL CABLE (FEAT_V27_BINARY_WIRE = 1), little endian:
+ *   0xA5 0x4C | u8 len | u32 t_us | u16 id | u32 args[(len - 6) / 4] | u8 xor
+ *   xor = XOR de len..último byte de args. Intercalado con texto normal.
+ */
+#define DLOG_SYNC0  0xA5
+#define DLOG_SYNC1  0x4C
+
+#endif  // LOG_CATALOG_H
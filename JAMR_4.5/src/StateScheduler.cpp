@@ -0,0 +1,213 @@
+/**
+ * @file StateScheduler.cpp
+ * @brief Implementación del planificador de estados dirigido por tabla
+ * @version FEAT-V19
+ * @date 2026-10-18
+ */
+
+#include "StateScheduler.h"
+#include "TraceSpan.h"  // FEAT-V23: Span por invocación de handler
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>    // FEAT-V28: uxTaskGetStackHighWaterMark
+#endif
+
+namespace StateSched {
+
+static const uint8_t NO_STATE = 0xFF;
+
+Scheduler::Scheduler(const StateDef* table, uint8_t count, uint8_t cycleStart)
+    : table_(table),
+      count_(count),
+      cycleStart_(cycleStart),
+      active_(NO_STATE),
+      enteredMs_(0),
+      yields_(0),
+      overruns_(0),
+      pathLen_(0) {}
+
+void Scheduler::step(uint8_t& state, CycleTiming& timing) {
+  if (state >= count_ || table_[state].handler == nullptr) {
+    delay(1000);  // Estado sin handler (Boot/Error): equivalente al default original
+    return;
+  }
+
+  // Entrada a un estado nuevo (por transición o asignación externa)
+  bool firstCall = (state != active_);
+  if (firstCall) {
+    active_ = state;
+    enteredMs_ = millis();
+    yields_ = 0;
+    if (state == cycleStart_) pathLen_ = 0;
+    // ============ [FEAT-V28 START] Marcas de memoria al entrar ============
+    #if ENABLE_FEAT_V28_MEM_WATERMARKS
+    memFreeMin_ = UINT32_MAX;
+    memBlockMin_ = UINT32_MAX;
+    memEntryMin_ = ESP.getMinFreeHeap();
+    memEntryHwm_ = uxTaskGetStackHighWaterMark(NULL);
+    sampleMem();
+    #endif
+    // ============ [FEAT-V28 END] ============
+  }
+
+  const StateDef& def = table_[state];
+  Ctx ctx;
+  ctx.next = def.onDone;
+  ctx.firstCall = firstCall;
+  ctx.elapsedMs = millis() - enteredMs_;
+  ctx.timedOut = false;
+
+  // ============ [FEAT-V19 START] Deadline de estados que ceden ============
+  #if ENABLE_FEAT_V19_STATE_SCHEDULER
+  ctx.timedOut = (def.timeoutMs > 0 && ctx.elapsedMs >= def.timeoutMs);
+  #endif
+  // ============ [FEAT-V19 END] ============
+
+  Step result;
+  {
+    TRACE_SPAN(def.name);  // FEAT-V23: los spans de módulos quedan anidados bajo la fase
+    result = def.handler(ctx);
+  }
+  uint32_t elapsed = millis() - enteredMs_;
+  #if ENABLE_FEAT_V28_MEM_WATERMARKS
+  sampleMem();  // FEAT-V28: también tras cada invocación cedida
+  #endif
+
+  if (result == Step::Yield) {
+    if (!ctx.timedOut) {
+      if (yields_ < 255) yields_++;
+      return;
+    }
+    Serial.printf("[FEAT-V19] %s: deadline %lu ms vencido, forzando transicion\n",
+                  def.name, (unsigned long)def.timeoutMs);
+    result = Step::Fail;
+  }
+
+  bool overrun = false;
+  #if ENABLE_FEAT_V19_STATE_SCHEDULER
+  if (def.timeoutMs > 0 && elapsed > def.timeoutMs) {
+    overrun = true;
+    if (overruns_ < UINT16_MAX) overruns_++;
+    Serial.printf("[FEAT-V19] %s: %lu ms > deadline %lu ms\n",
+                  def.name, (unsigned long)elapsed, (unsigned long)def.timeoutMs);
+  }
+  #endif
+
+  leave(state, elapsed, overrun, timing);
+
+  // La transición puede volver al mismo estado: forzar nueva entrada
+  active_ = NO_STATE;
+  state = (result == Step::Done) ? ctx.next : def.onFail;
+}
+
+void Scheduler::leave(uint8_t state, uint32_t elapsed, bool overrun, CycleTiming& timing) {
+  const StateDef& def = table_[state];
+
+  if (def.timing != nullptr) {
+    timing.*(def.timing) = elapsed;
+    #if ENABLE_FEAT_V2_CYCLE_TIMING
+    Serial.print(F("[TIMING] "));
+    Serial.print(def.name);
+    Serial.print(F(": "));
+    Serial.print(elapsed);
+    Serial.println(F(" ms"));
+    #endif
+  }
+
+  // ============ [FEAT-V28 START] Cerrar marcas de memoria de la fase ============
+  #if ENABLE_FEAT_V28_MEM_WATERMARKS
+  if (state < FEAT_V28_MAX_PHASES) {
+    PhaseMem& m = timing.mem[state];
+    uint32_t globalMin = ESP.getMinFreeHeap();
+    uint32_t hwm = uxTaskGetStackHighWaterMark(NULL);
+    m.flags = 0;
+    m.minFreeHeap = memFreeMin_;
+    if (globalMin < memEntryMin_) {  // El pico ocurrió dentro de la fase: valor exacto
+      m.minFreeHeap = globalMin;
+      m.flags |= PHASE_MEM_PEAK_HEAP;
+    }
+    m.minLargestBlock = memBlockMin_;
+    m.minStackFree = (uint16_t)((hwm > UINT16_MAX) ? UINT16_MAX : hwm);
+    if (hwm < memEntryHwm_) m.flags |= PHASE_MEM_PEAK_STACK;
+    m.reserved = 0;
+  }
+  #endif
+  // ============ [FEAT-V28 END] ============
+
+  if (pathLen_ < FEAT_V19_PATH_MAX) {
+    Hop& h = path_[pathLen_++];
+    h.state = state;
+    h.yields = yields_;
+    h.overrun = overrun;
+    h.ms = elapsed;
+  }
+}
+
+void Scheduler::printPath() const {
+  #if ENABLE_FEAT_V19_STATE_SCHEDULER
+  uint32_t total = 0;
+  uint8_t worst = 0;
+  for (uint8_t i = 0; i < pathLen_; i++) {
+    total += path_[i].ms;
+    if (path_[i].ms > path_[worst].ms) worst = i;
+  }
+
+  Serial.print(F("[FEAT-V19] Ruta:"));
+  for (uint8_t i = 0; i < pathLen_; i++) {
+    const Hop& h = path_[i];
+    Serial.printf(" %s%s %lu", (i == 0) ? "" : "> ", table_[h.state].name, (unsigned long)h.ms);
+    if (h.yields > 0) Serial.printf("(y%u)", (unsigned)h.yields);
+    if (h.overrun) Serial.print('!');
+  }
+  Serial.printf(" = %lu ms\n", (unsigned long)total);
+
+  if (pathLen_ > 0 && total > 0) {
+    Serial.printf("[FEAT-V19] Tramo dominante: %s (%lu%%)\n",
+                  table_[path_[worst].state].name,
+                  (unsigned long)((uint64_t)path_[worst].ms * 100ULL / total));
+  }
+  #endif
+}
+
+// ============ [FEAT-V28 START] Marcas de memoria por fase ============
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+void Scheduler::sampleMem() {
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t block = ESP.getMaxAllocHeap();
+  if (freeHeap < memFreeMin_) memFreeMin_ = freeHeap;
+  if (block < memBlockMin_) memBlockMin_ = block;
+}
+
+void captureInitMem(PhaseMem& out) {
+  // Cada despertar es un boot: el mínimo histórico cubre exactamente AppInit
+  uint32_t hwm = uxTaskGetStackHighWaterMark(NULL);
+  out.minFreeHeap = ESP.getMinFreeHeap();
+  out.minLargestBlock = ESP.getMaxAllocHeap();
+  out.minStackFree = (uint16_t)((hwm > UINT16_MAX) ? UINT16_MAX : hwm);
+  out.flags = PHASE_MEM_PEAK_HEAP | PHASE_MEM_PEAK_STACK;
+  out.reserved = 0;
+}
+
+void Scheduler::printMem(const CycleTiming& timing) const {
+  uint8_t worst = NO_STATE;
+  Serial.println(F("[FEAT-V28] Memoria por fase (heap min / bloque max min / stack libre), *=pico en la fase:"));
+  for (uint8_t i = 0; i < count_ && i < FEAT_V28_MAX_PHASES; i++) {
+    const PhaseMem& m = timing.mem[i];
+    if (m.minFreeHeap == 0) continue;  // Fase no ejecutada en este ciclo
+    Serial.printf("[FEAT-V28]   %-14s %7lu%c %7lu %6u%c\n",
+                  (i == 0) ? "init" : table_[i].name,
+                  (unsigned long)m.minFreeHeap, (m.flags & PHASE_MEM_PEAK_HEAP) ? '*' : ' ',
+                  (unsigned long)m.minLargestBlock,
+                  (unsigned)m.minStackFree, (m.flags & PHASE_MEM_PEAK_STACK) ? '*' : ' ');
+    if (worst == NO_STATE || m.minFreeHeap < timing.mem[worst].minFreeHeap) worst = i;
+  }
+  if (worst != NO_STATE) {
+    Serial.printf("[FEAT-V28] Pico de heap: %s (%lu B libres)\n",
+                  (worst == 0) ? "init" : table_[worst].name,
+                  (unsigned long)timing.mem[worst].minFreeHeap);
+  }
+}
+#endif
+// ============ [FEAT-V28 END] ============
+
+}  // namespace StateSched
@@ -0,0 +1,137 @@
+/**
+ * @file StateScheduler.h
+ * @brief Planificador cooperativo de estados dirigido por tabla
+ * @version FEAT-V19
+ * @date 2026-10-18
+ *
+ * Cada estado se declara con un handler, un deadline y sus transiciones de
+ * éxito/fallo. El planificador invoca el handler una vez por AppLoop(),
+ * registra la duración del estado en el campo de CycleTiming indicado y
+ * mantiene la ruta del ciclo (estados visitados y sus tiempos).
+ *
+ * Un handler puede devolver Step::Yield mientras espera I/O: AppLoop()
+ * retorna (watchdog y comandos Serial siguen atendidos) y el handler se
+ * vuelve a invocar en la siguiente iteración. Con FEAT-V19 activo, vencido
+ * el deadline se hace una última invocación con ctx.timedOut = true para que
+ * el estado cierre; si aun así cede, se fuerza la transición de fallo.
+ */
+
+#ifndef STATE_SCHEDULER_H
+#define STATE_SCHEDULER_H
+
+#include <Arduino.h>
+#include "FeatureFlags.h"
+#include "CycleTiming.h"
+
+namespace StateSched {
+
+/** @brief Resultado de una invocación de handler */
+enum class Step : uint8_t {
+  Done = 0,   ///< Terminó: ir a ctx.next (por defecto onDone)
+  Fail,       ///< Falló: ir a onFail
+  Yield       ///< Esperando I/O: reinvocar en el próximo AppLoop()
+};
+
+/** @brief Contexto entregado al handler en cada invocación */
+struct Ctx {
+  uint8_t next;        ///< Próximo estado (preasignado a onDone, el handler puede cambiarlo)
+  bool firstCall;      ///< Primera invocación desde que se entró al estado
+  bool timedOut;       ///< Deadline vencido: última oportunidad para cerrar
+  uint32_t elapsedMs;  ///< Tiempo transcurrido en el estado
+};
+
+typedef Step (*Handler)(Ctx& ctx);
+
+/** @brief Campo de CycleTiming donde se registra la duración del estado */
+typedef unsigned long CycleTiming::*TimingField;
+
+/** @brief Declaración de un estado (una fila de la tabla) */
+struct StateDef {
+  uint8_t id;            ///< Debe coincidir con el índice en la tabla
+  const char* name;      ///< Nombre de fase para logs [TIMING] (ej. "sensors")
+  Handler handler;
+  uint32_t timeoutMs;    ///< Deadline del estado (0 = sin límite)
+  uint8_t onDone;        ///< Transición por defecto en éxito
+  uint8_t onFail;        ///< Transición en fallo o deadline vencido
+  TimingField timing;    ///< nullptr = no registrar
+};
+
+/** @brief Tramo de la ruta del ciclo */
+struct Hop {
+  uint8_t state;
+  uint8_t yields;        ///< Invocaciones cedidas (satura en 255)
+  bool overrun;          ///< Superó su deadline
+  uint32_t ms;
+};
+
+/**
+ * @brief Planificador sobre una tabla constante de estados
+ *
+ * No posee el estado actual: step() recibe la variable del llamador, de modo
+ * que las asignaciones directas (AppInit, Error) siguen siendo válidas; el
+ * planificador detecta la entrada a un estado comparando con el anterior.
+ */
+class Scheduler {
+ public:
+  /**
+   * @param table Tabla indexada por id de estado
+   * @param count Filas de la tabla
+   * @param cycleStart Estado que abre un ciclo (reinicia la ruta)
+   */
+  Scheduler(const StateDef* table, uint8_t count, uint8_t cycleStart);
+
+  /**
+   * @brief Ejecuta una invocación del estado actual y aplica la transición
+   * @param state Estado actual (entrada/salida)
+   * @param timing Estructura de tiempos del ciclo
+   */
+  void step(uint8_t& state, CycleTiming& timing);
+
+  /** @brief Imprime la ruta del ciclo y el tramo dominante */
+  void printPath() const;
+
+  /** @brief Estados que superaron su deadline desde el arranque */
+  uint16_t overruns() const { return overruns_; }
+
+  #if ENABLE_FEAT_V28_MEM_WATERMARKS
+  /**
+   * @brief Imprime heap/bloque/stack por fase y la fase con el pico del ciclo
+   * @param timing Estructura con las marcas (mem[0] = AppInit)
+   */
+  void printMem(const CycleTiming& timing) const;
+  #endif
+
+ private:
+  void leave(uint8_t state, uint32_t elapsed, bool overrun, CycleTiming& timing);
+
+  const StateDef* table_;
+  uint8_t count_;
+  uint8_t cycleStart_;
+  uint8_t active_;        ///< Estado en curso (0xFF = ninguno)
+  uint32_t enteredMs_;
+  uint8_t yields_;
+  uint16_t overruns_;
+  Hop path_[FEAT_V19_PATH_MAX];
+  uint8_t pathLen_;
+
+  #if ENABLE_FEAT_V28_MEM_WATERMARKS
+  void sampleMem();
+
+  uint32_t memFreeMin_;   ///< Menor heap libre muestreado en la fase
+  uint32_t memBlockMin_;  ///< Menor bloque libre muestreado en la fase
+  uint32_t memEntryMin_;  ///< ESP.getMinFreeHeap() al entrar
+  uint32_t memEntryHwm_;  ///< High-water mark del stack al entrar
+  #endif
+};
+
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+/**
+ * @brief Marcas de memoria desde el boot hasta ahora (fase "init" de AppInit)
+ * @param out Destino (mem[0] de CycleTiming)
+ */
+void captureInitMem(PhaseMem& out);
+#endif
+
+}  // namespace StateSched
+
+#endif
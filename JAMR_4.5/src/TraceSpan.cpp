@@ -0,0 +1,211 @@
+/**
+ * @file TraceSpan.cpp
+ * @brief Implementación del anillo de trazas en RTC
+ * @version FEAT-V23
+ * @date 2026-10-18
+ */
+
+#include "TraceSpan.h"
+
+#if ENABLE_FEAT_V23_TRACE_SPANS
+
+#include <esp_app_desc.h>
+#include <freertos/FreeRTOS.h>
+
+namespace TraceSpan {
+
+static const uint32_t RING_MAGIC = 0x4A545243;  // "JTRC"
+static const uint8_t DUMP_VERSION = 1;
+static const uint8_t DEPTH_MASK = 0x7F;
+static const uint8_t CORE_BIT = 0x80;
+
+RTC_DATA_ATTR static uint32_t s_magic = 0;
+RTC_DATA_ATTR static uint8_t s_fwId[8];
+RTC_DATA_ATTR static uint16_t s_wake = 0;
+RTC_DATA_ATTR static uint16_t s_head = 0;    ///< Próxima posición a escribir
+RTC_DATA_ATTR static uint16_t s_count = 0;
+RTC_DATA_ATTR static Record s_ring[FEAT_V23_RING_SIZE];
+
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/** @brief Profundidad actual por núcleo (no persiste: el anidamiento es por despertar) */
+static uint8_t s_depth[2] = {0, 0};
+
+static inline uint8_t coreIndex() {
+  return (uint8_t)(xPortGetCoreID() & 1);
+}
+
+/** @brief Copia la etiqueta: salta "AT+"/"AT" y toma hasta 4 caracteres alfanuméricos */
+static void copyTag(char dst[TAG_LEN], const char* src) {
+  memset(dst, 0, TAG_LEN);
+  if (src == nullptr) return;
+  if ((src[0] == 'A' || src[0] == 'a') && (src[1] == 'T' || src[1] == 't')) {
+    src += 2;
+    if (*src == '+' || *src == '&') src++;
+  }
+  for (uint8_t i = 0; i < TAG_LEN && isalnum((unsigned char)src[i]); i++) {
+    dst[i] = src[i];
+  }
+}
+
+static void push(const Record& r) {
+  portENTER_CRITICAL(&s_mux);
+  s_ring[s_head] = r;
+  s_head = (uint16_t)((s_head + 1) % FEAT_V23_RING_SIZE);
+  if (s_count < FEAT_V23_RING_SIZE) s_count++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+Scope::Scope(const char* name, const char* tag)
+    : name_(name), startUs_((uint32_t)esp_timer_get_time()) {
+  uint8_t core = coreIndex();
+  depth_ = s_depth[core];
+  if (s_depth[core] < DEPTH_MASK) s_depth[core]++;
+  copyTag(tag_, tag);
+}
+
+Scope::~Scope() {
+  uint32_t endUs = (uint32_t)esp_timer_get_time();
+  uint8_t core = coreIndex();
+  if (s_depth[core] > 0) s_depth[core]--;
+
+  Record r;
+  r.name = name_;
+  r.startUs = startUs_;
+  r.durUs = endUs - startUs_;
+  r.wake = s_wake;
+  r.depth = (uint8_t)((depth_ & DEPTH_MASK) | (core ? CORE_BIT : 0));
+  r.reserved = 0;
+  memcpy(r.tag, tag_, TAG_LEN);
+  push(r);
+}
+
+void begin() {
+  const esp_app_desc_t* app = esp_app_get_description();
+  bool sameFw = (s_magic == RING_MAGIC) && memcmp(s_fwId, app->app_elf_sha256, sizeof(s_fwId)) == 0;
+  if (!sameFw || s_head >= FEAT_V23_RING_SIZE || s_count > FEAT_V23_RING_SIZE) {
+    // Firmware nuevo o RTC sin inicializar: los punteros a nombres no son válidos
+    memcpy(s_fwId, app->app_elf_sha256, sizeof(s_fwId));
+    s_magic = RING_MAGIC;
+    s_wake = 0;
+    s_head = 0;
+    s_count = 0;
+  }
+  s_wake++;
+  s_depth[0] = 0;
+  s_depth[1] = 0;
+}
+
+void record(const char* name, uint32_t startUs, uint32_t endUs, uint8_t depth) {
+  Record r;
+  r.name = name;
+  r.startUs = startUs;
+  r.durUs = endUs - startUs;
+  r.wake = s_wake;
+  r.depth = (uint8_t)((depth & DEPTH_MASK) | (coreIndex() ? CORE_BIT : 0));
+  r.reserved = 0;
+  memset(r.tag, 0, TAG_LEN);
+  push(r);
+}
+
+uint16_t count() {
+  return s_count;
+}
+
+void clear() {
+  portENTER_CRITICAL(&s_mux);
+  s_head = 0;
+  s_count = 0;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+/** @brief Índice en el anillo del i-ésimo registro (0 = más antiguo) */
+static inline uint16_t slot(uint16_t i) {
+  return (uint16_t)((s_head + FEAT_V23_RING_SIZE - s_count + i) % FEAT_V23_RING_SIZE);
+}
+
+void printText(Print* out) {
+  if (out == nullptr) return;
+  out->printf("[FEAT-V23] Trazas despertar #%u (%u registros en anillo)\n",
+              (unsigned)s_wake, (unsigned)s_count);
+  for (uint16_t i = 0; i < s_count; i++) {
+    const Record& r = s_ring[slot(i)];
+    if (r.wake != s_wake) continue;
+    out->printf("  c%u %10lu us %*s%s", (unsigned)((r.depth & CORE_BIT) ? 1 : 0),
+                (unsigned long)r.startUs, (int)((r.depth & DEPTH_MASK) * 2), "", r.name);
+    if (r.tag[0] != '\0') out->printf("[%.4s]", r.tag);
+    out->printf(" %lu us\n", (unsigned long)r.durUs);
+  }
+}
+
+static size_t writeU16(Print* out, uint16_t v) {
+  uint8_t b[2] = {(uint8_t)(v & 0xFF), (uint8_t)(v >> 8)};
+  return out->write(b, sizeof(b));
+}
+
+static size_t writeU32(Print* out, uint32_t v) {
+  uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+  return out->write(b, sizeof(b));
+}
+
+/** @brief Índice del nombre en la tabla del volcado (satura en el último) */
+static uint16_t nameIndex(const char* const* names, uint16_t nameCount, const char* name) {
+  for (uint16_t k = 0; k < nameCount; k++) {
+    if (names[k] == name) return k;
+  }
+  return (uint16_t)(nameCount - 1);
+}
+
+size_t dumpBinary(Print* out) {
+  if (out == nullptr) return 0;
+
+  // Copia consistente del anillo (la tarea LTE puede estar registrando).
+  // Solo bajo demanda: no ocupa DRAM el resto del tiempo.
+  Record* snap = (Record*)malloc(sizeof(Record) * FEAT_V23_RING_SIZE);
+  if (snap == nullptr) return 0;
+  portENTER_CRITICAL(&s_mux);
+  uint16_t n = s_count;
+  for (uint16_t i = 0; i < n; i++) snap[i] = s_ring[slot(i)];
+  portEXIT_CRITICAL(&s_mux);
+
+  // Tabla de nombres por puntero (los literales repetidos comparten dirección)
+  const char* names[FEAT_V23_MAX_NAMES];
+  uint16_t nameCount = 0;
+  for (uint16_t i = 0; i < n && nameCount < FEAT_V23_MAX_NAMES; i++) {
+    bool known = false;
+    for (uint16_t k = 0; k < nameCount && !known; k++) known = (names[k] == snap[i].name);
+    if (!known) names[nameCount++] = snap[i].name;
+  }
+
+  size_t w = 0;
+  w += out->write((const uint8_t*)"JTRC", 4);
+  w += out->write(DUMP_VERSION);
+  w += out->write((uint8_t)2);
+  w += writeU16(out, s_wake);
+  w += writeU16(out, nameCount);
+  w += writeU16(out, n);
+
+  for (uint16_t k = 0; k < nameCount; k++) {
+    size_t len = strlen(names[k]);
+    if (len > 255) len = 255;
+    w += out->write((uint8_t)len);
+    w += out->write((const uint8_t*)names[k], len);
+  }
+
+  for (uint16_t i = 0; i < n; i++) {
+    const Record& r = snap[i];
+    w += writeU16(out, nameIndex(names, nameCount, r.name));
+    w += writeU16(out, r.wake);
+    w += writeU32(out, r.startUs);
+    w += writeU32(out, r.durUs);
+    w += out->write(r.depth);
+    w += out->write((const uint8_t*)r.tag, TAG_LEN);
+  }
+
+  free(snap);
+  return w;
+}
+
+}  // namespace TraceSpan
+
+#endif  // ENABLE_FEAT_V23_TRACE_SPANS
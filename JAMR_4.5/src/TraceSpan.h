@@ -0,0 +1,122 @@
+/**
+ * @file TraceSpan.h
+ * @brief Trazas jerárquicas en µs sobre un anillo en memoria RTC
+ * @version FEAT-V23
+ * @date 2026-10-18
+ *
+ * USO:
+ *   TRACE_SPAN("lte.attach");          - Tramo hasta el fin del bloque
+ *   TRACE_SPAN_TAG("at", cmd);         - Igual, con etiqueta de 4 caracteres
+ *                                        tomada del comando AT ("AT+CSQ" -> "CSQ")
+ *   TraceSpan::dumpBinary(&Serial);    - Volcado binario (decodificador host)
+ *
+ * Cada tramo se registra al cerrarse: inicio y duración con
+ * esp_timer_get_time(), profundidad de anidamiento por núcleo y número de
+ * despertar. El anillo vive en RTC_DATA_ATTR y sobrevive deep sleep y
+ * reinicios por crash; se vacía al cambiar el firmware (SHA del ELF).
+ *
+ * OVERHEAD:
+ *   Con ENABLE_FEAT_V23_TRACE_SPANS = 0 las macros se expanden a nada.
+ *   Activo: 2 lecturas de esp_timer + una escritura de 20 bytes bajo spinlock.
+ *
+ * FORMATO BINARIO (little endian, versión 1):
+ *   "JTRC" | u8 versión | u8 núcleos | u16 despertar actual | u16 nombres | u16 registros
+ *   nombres:   u8 longitud + bytes (sin '\0'), índice = orden de aparición
+ *   registros: u16 nombre | u16 despertar | u32 inicio_us | u32 duración_us |
+ *              u8 profundidad (bit 7 = núcleo) | char[4] etiqueta
+ *   Más antiguo primero.
+ */
+
+#ifndef TRACE_SPAN_H
+#define TRACE_SPAN_H
+
+#include <Arduino.h>
+#include "FeatureFlags.h"
+
+#if ENABLE_FEAT_V23_TRACE_SPANS
+
+namespace TraceSpan {
+
+/** @brief Longitud de la etiqueta por registro */
+static const uint8_t TAG_LEN = 4;
+
+/**
+ * @brief Registro de un tramo cerrado (20 bytes en RTC)
+ */
+struct Record {
+  const char* name;     ///< Literal en flash (válido mientras no cambie el firmware)
+  uint32_t startUs;     ///< esp_timer_get_time() al abrir (desde el boot de este despertar)
+  uint32_t durUs;       ///< Duración
+  uint16_t wake;        ///< Número de despertar
+  uint8_t depth;        ///< Anidamiento (bits 0..6) | núcleo (bit 7)
+  uint8_t reserved;
+  char tag[TAG_LEN];    ///< Etiqueta opcional (sin '\0' si ocupa los 4)
+};
+
+/**
+ * @brief Tramo RAII: abre en el constructor, registra en el destructor
+ */
+class Scope {
+ public:
+  explicit Scope(const char* name, const char* tag = nullptr);
+  ~Scope();
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+ private:
+  const char* name_;
+  uint32_t startUs_;
+  uint8_t depth_;
+  char tag_[TAG_LEN];
+};
+
+/**
+ * @brief Valida el anillo RTC e incrementa el contador de despertares.
+ * @note Llamar una vez al inicio de AppInit().
+ */
+void begin();
+
+/**
+ * @brief Registra un tramo ya medido (ej: estados del planificador que ceden).
+ * @param name Literal con el nombre.
+ * @param startUs Inicio (esp_timer_get_time()).
+ * @param endUs Fin (esp_timer_get_time()).
+ * @param depth Profundidad de anidamiento.
+ */
+void record(const char* name, uint32_t startUs, uint32_t endUs, uint8_t depth);
+
+/** @brief Registros válidos en el anillo. */
+uint16_t count();
+
+/** @brief Vacía el anillo (conserva el contador de despertares). */
+void clear();
+
+/**
+ * @brief Imprime los tramos del despertar actual en texto indentado.
+ * @param out Destino (Serial).
+ */
+void printText(Print* out);
+
+/**
+ * @brief Vuelca el anillo completo en el formato binario documentado arriba.
+ * @param out Destino (Serial o transporte BLE).
+ * @return Bytes escritos.
+ */
+size_t dumpBinary(Print* out);
+
+}  // namespace TraceSpan
+
+#define TRACE_CAT_(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT_(a, b)
+#define TRACE_SPAN(name) TraceSpan::Scope TRACE_CAT(traceSpan_, __LINE__)(name)
+#define TRACE_SPAN_TAG(name, tag) TraceSpan::Scope TRACE_CAT(traceSpan_, __LINE__)(name, tag)
+
+#else
+
+#define TRACE_SPAN(name) do {} while (0)
+#define TRACE_SPAN_TAG(name, tag) do {} while (0)
+
+#endif  // ENABLE_FEAT_V23_TRACE_SPANS
+
+#endif  // TRACE_SPAN_H
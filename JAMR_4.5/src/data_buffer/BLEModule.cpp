@@ -6,6 +6,176 @@
 #include "BLEModule.h"
 #include "config_data_buffer.h"
 #include "../DebugConfig.h"
+#include "../FeatureFlags.h"
+
+// ============ [FEAT-V23 START] Volcado de trazas por BLE ============
+#if ENABLE_FEAT_V23_TRACE_SPANS
+#include "../TraceSpan.h"
+
+/**
+ * @brief Adaptador Print que trocea el volcado binario en notificaciones de 20 bytes
+ *        (MTU por defecto 23 - 3 de cabecera ATT)
+ */
+class BLENotifyPrint : public Print {
+public:
+    explicit BLENotifyPrint(BLECharacteristic* ch) : ch_(ch), len_(0), total_(0) {}
+
+    size_t write(uint8_t b) override {
+        buf_[len_++] = b;
+        total_++;
+        if (len_ == sizeof(buf_)) flush();
+        return 1;
+    }
+
+    void flush() {
+        if (len_ == 0) return;
+        ch_->setValue(buf_, len_);
+        ch_->notify();
+        len_ = 0;
+        delay(10);  // Dar tiempo al stack BLE a vaciar la cola
+    }
+
+    size_t total() const { return total_; }
+
+private:
+    BLECharacteristic* ch_;
+    uint8_t buf_[20];
+    size_t len_;
+    size_t total_;
+};
+#endif
+// ============ [FEAT-V23 END] ============
+
+// ============ [FEAT-V34 START] Descarga masiva por BLE ============
+#if ENABLE_FEAT_V34_BLE_BULK
+#include "../data_diagnostics/ProductionDiag.h"
+
+#if !ENABLE_FEAT_V7_PRODUCTION_DIAG
+#error "FEAT-V34 requiere FEAT-V7 (ProdDiag::calculateCRC16 para el token)"
+#endif
+
+/*
+ * Notificaciones de BULK por la característica de lectura (enteros
+ * little-endian; cada una consume un crédito):
+ *
+ *   'S' guard:u16 start:u32 size:u32 payload:u16       Inicio
+ *   'D' seq:u16 guard:u16 next:u32 { len:u16 bytes[len] }...   Registros
+ *   'E' seq:u16 guard:u16 next:u32 records:u32 bytes:u32       Fin
+ *
+ * Un registro es una línea pendiente de buffer.txt sin "\r\n". Si no cabe en
+ * lo que queda de la notificación, sigue en la siguiente: el bit 15 de len
+ * indica que la línea continúa. "next" es el offset desde el que reanudar;
+ * si la notificación corta una línea, apunta al inicio de esa línea.
+ *
+ * Token de reanudación: guard (4 dígitos hex) seguido de next (8 dígitos),
+ * ambos de la misma notificación ('S' lleva los de start). guard es el CRC16
+ * de los bytes [0, next) del archivo: cualquier cambio antes de next lo
+ * invalida; agregar tramas al final no. BUFFERModule reescribe el archivo
+ * completo al marcar o compactar, así que en la práctica eso también lo
+ * invalida y el cliente reinicia con BULK.
+ */
+
+/** @brief Valor máximo de un atributo ATT */
+static const uint16_t BULK_PAYLOAD_MAX = 512;
+/** @brief Cabecera de una notificación 'D' */
+static const uint8_t BULK_HEADER = 9;
+/** @brief Notificaciones como máximo por llamada a update() */
+static const uint8_t BULK_BURST = 16;
+/** @brief Bit de "la línea continúa" en len */
+static const uint16_t BULK_MORE = 0x8000;
+/** @brief Largo de PROCESSED_MARKER */
+static const size_t PROCESSED_LEN = sizeof(PROCESSED_MARKER) - 1;
+
+struct BLEModule::BulkTransfer {
+    File file;
+    uint8_t tx[BULK_PAYLOAD_MAX];   // Notificación en armado
+    uint8_t rd[256];                // Lectura del archivo
+    size_t rdLen;
+    size_t rdPos;
+    bool eof;
+    uint32_t pos;                   // Offset de rd[rdPos]
+    uint16_t crc;                   // CRC16 de [0, pos)
+    uint32_t lineStart;             // Offset de la línea en curso
+    uint16_t lineCrc;               // CRC16 de [0, lineStart)
+    bool inLine;                    // La línea en curso sigue en la próxima notificación
+    bool started;                   // 'S' enviada
+    uint16_t payloadMax;            // MTU negociado - 3
+    uint16_t seq;
+    uint32_t startOffset;
+    uint32_t size;
+    uint32_t creditFloor;           // creditsGranted al iniciar
+    uint32_t sent;                  // Notificaciones aceptadas por el stack
+    uint32_t retries;               // Notificaciones rechazadas y reenviadas
+    size_t txLen;                   // tx armada y aún no aceptada (0 = ninguna)
+    bool txLast;                    // tx pendiente es la 'E'
+    uint32_t records;
+    uint32_t bytes;
+    unsigned long t0;
+    unsigned long lastSend;
+    unsigned long lastStatus;
+
+    /** @brief Deja al menos k bytes sin leer en rd (menos al final del archivo) */
+    size_t avail(size_t k) {
+        size_t n = rdLen - rdPos;
+        if (n >= k || eof) return n;
+        memmove(rd, rd + rdPos, n);
+        rdLen = n;
+        rdPos = 0;
+        size_t r = file.read(rd + rdLen, sizeof(rd) - rdLen);
+        if (r == 0) eof = true;
+        rdLen += r;
+        return rdLen - rdPos;
+    }
+
+    uint8_t take() {
+        pos++;
+        crc = ProdDiag::calculateCRC16(rd + rdPos, 1, crc);
+        return rd[rdPos++];
+    }
+
+    /** @brief Descarta hasta el próximo '\n' inclusive */
+    void skipLine() {
+        while (avail(1) && take() != '\n') {}
+    }
+
+    /** @brief Tras una notificación llena: si la línea terminaba justo ahí, la cierra */
+    void eatEol() {
+        if (avail(1) && rd[rdPos] == '\r') take();
+        if (!avail(1)) {
+            inLine = false;
+        } else if (rd[rdPos] == '\n') {
+            take();
+            inLine = false;
+        }
+    }
+
+    /** @brief Offset desde el que reanudar después de lo ya enviado */
+    uint32_t next() const {
+        return inLine ? lineStart : pos;
+    }
+
+    /** @brief guard del token para next() */
+    uint16_t nextGuard() const {
+        return inLine ? lineCrc : crc;
+    }
+};
+
+static void putU16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void putU32(uint8_t* p, uint32_t v) {
+    putU16(p, v & 0xFFFF);
+    putU16(p + 2, v >> 16);
+}
+
+/** @brief KB/s de payload */
+static float bulkRate(uint32_t bytes, unsigned long ms) {
+    return ms ? bytes * 1000.0f / 1024.0f / ms : 0.0f;
+}
+#endif
+// ============ [FEAT-V34 END] ============
 
 // Variable estática para acceso desde callbacks
 static BLEModule* bleModuleInstance = nullptr;
@@ -20,7 +190,23 @@ BLEModule::BLEModule(BUFFERModule& bufferModule)
       oldDeviceConnected(false),
       bleActive(false),
       startTime(0),
-      lastConnectionTime(0) {
+      lastConnectionTime(0)
+#if ENABLE_FEAT_V34_BLE_BULK
+      , bulk(nullptr),
+      bulkRequested(false),
+      bulkStopRequested(false),
+      bulkHasToken(false),
+      bulkReqGuard(0),
+      bulkReqOffset(0),
+      creditsGranted(0),
+      bulkNotifyOk(false),
+      bulkState("IDLE"),
+      bulkGuard(0),
+      bulkNextOffset(0),
+      bulkKbps(0.0f),
+      reconnects(0)
+#endif
+{
     bleModuleInstance = this;
 }
 
@@ -28,6 +214,12 @@ bool BLEModule::begin(const char* deviceName) {
     // Crear dispositivo BLE
     BLEDevice::init(deviceName);
     
+    #if ENABLE_FEAT_V34_BLE_BULK
+    // FEAT-V34: el MTU final lo fija el cliente; se lee al iniciar BULK
+    BLEDevice::setMTU(FEAT_V34_MTU);
+    reconnects = 0;
+    #endif
+    
     // Crear servidor BLE
     pServer = BLEDevice::createServer();
     ServerCallbacks* serverCallbacks = new ServerCallbacks(this);
@@ -46,11 +238,20 @@ bool BLEModule::begin(const char* deviceName) {
     pCharRead->addDescriptor(new BLE2902());
     
     // Característica de control (Write)
+    // FEAT-V34: también sin respuesta, para que CREDIT:n no espere un ida y vuelta
     pCharControl = pService->createCharacteristic(
         CHAR_UUID_CONTROL,
         BLECharacteristic::PROPERTY_WRITE
+    #if ENABLE_FEAT_V34_BLE_BULK
+        | BLECharacteristic::PROPERTY_WRITE_NR
+    #endif
     );
-    pCharControl->setCallbacks(new CharacteristicCallbacks(this));
+    CharacteristicCallbacks* charCallbacks = new CharacteristicCallbacks(this);
+    pCharControl->setCallbacks(charCallbacks);
+    #if ENABLE_FEAT_V34_BLE_BULK
+    // FEAT-V34: onStatus dice si el stack aceptó cada notificación de BULK
+    pCharRead->setCallbacks(charCallbacks);
+    #endif
     
     // Característica de estado (Read/Notify)
     pCharStatus = pService->createCharacteristic(
@@ -95,6 +296,22 @@ void BLEModule::update() {
     
     // Manejar reconexión
     if (!deviceConnected && oldDeviceConnected) {
+        #if ENABLE_FEAT_V34_BLE_BULK
+        // FEAT-V34: descarga cortada o pausada, se vuelve a anunciar para
+        // que el cliente reanude con el token
+        bool resumable = bulk != nullptr || bulkRequested || strcmp(bulkState, "STALL") == 0;
+        bulkRequested = false;
+        bulkStopRequested = false;
+        if (bulk) finishBulk("CUT");
+        if (resumable && reconnects < FEAT_V34_MAX_RECONNECTS) {
+            reconnects++;
+            oldDeviceConnected = false;
+            startTime = millis();
+            BLEDevice::startAdvertising();
+            DEBUG_INFO(BLE, "Descarga BULK interrumpida. Esperando reconexión...");
+            return;
+        }
+        #endif
         DEBUG_INFO(BLE, "Cliente BLE desconectado. Apagando BLE...");
         end();
         return;
@@ -108,6 +325,18 @@ void BLEModule::update() {
         // Enviar estado inicial
         sendBufferStatus();
     }
+    
+    #if ENABLE_FEAT_V34_BLE_BULK
+    if (deviceConnected) {
+        if (bulkStopRequested) {
+            bulkStopRequested = false;
+            bulkRequested = false;
+            if (bulk) finishBulk("STOP");
+        }
+        if (bulkRequested) startBulk();
+        if (bulk) pumpBulk();
+    }
+    #endif
 }
 
 void BLEModule::end() {
@@ -117,6 +346,10 @@ void BLEModule::end() {
     
     bleActive = false;
     
+    #if ENABLE_FEAT_V34_BLE_BULK
+    if (bulk) finishBulk("STOP");
+    #endif
+    
     if (pServer) {
         pServer->getAdvertising()->stop();
     }
@@ -179,6 +412,18 @@ void BLEModule::sendBufferStatus() {
     status += "SIZE:" + String(buffer.getFileSize()) + "|";
     status += "EXISTS:" + String(buffer.fileExists() ? "YES" : "NO");
     
+    #if ENABLE_FEAT_V34_BLE_BULK
+    status += "|MTU:" + String((unsigned long)pServer->getPeerMTU(pServer->getConnId()));
+    status += "|BULK:" + String(bulkState);
+    if (strcmp(bulkState, "IDLE") != 0) {
+        char token[13];
+        snprintf(token, sizeof(token), "%04X%08lX", bulkGuard, (unsigned long)bulkNextOffset);
+        status += "|OFF:" + String((unsigned long)bulkNextOffset);
+        status += "|KBPS:" + String(bulkKbps, 1);
+        status += "|TOKEN:" + String(token);
+    }
+    #endif
+    
     pCharStatus->setValue(status.c_str());
     pCharStatus->notify();
     
@@ -186,9 +431,28 @@ void BLEModule::sendBufferStatus() {
 }
 
 void BLEModule::processCommand(const String& command) {
+    #if ENABLE_FEAT_V34_BLE_BULK
+    // FEAT-V34: CREDIT:n llega cada pocas notificaciones; sin log
+    if (command.startsWith("CREDIT:")) {
+        long n = command.substring(7).toInt();
+        if (n > 0) creditsGranted += (uint32_t)n;
+        return;
+    }
+    #endif
+    
     Serial.print("Comando BLE recibido: ");
     Serial.println(command);
     
+    #if ENABLE_FEAT_V34_BLE_BULK
+    // READ, CLEAR y REMOVE_PROCESSED tocan el archivo o la característica de
+    // lectura que usa la descarga
+    if (bulkBusy() && (command.startsWith("READ") || command == "CLEAR" ||
+                       command == "REMOVE_PROCESSED")) {
+        pCharControl->setValue("ERROR: Descarga BULK en curso");
+        return;
+    }
+    #endif
+    
     if (command == "READ_ALL") {
         // Leer y enviar todas las líneas no procesadas
         sendBufferData(MAX_LINES_TO_READ);
@@ -226,12 +490,272 @@ void BLEModule::processCommand(const String& command) {
         }
         sendBufferStatus();
         
+    #if ENABLE_FEAT_V23_TRACE_SPANS
+    } else if (command == "TRACE") {
+        // FEAT-V23: ring de spans en formato JTRC por la característica de lectura
+        if (deviceConnected) {
+            BLENotifyPrint out(pCharRead);
+            TraceSpan::dumpBinary(&out);
+            out.flush();
+            String msg = "OK: TRACE " + String((unsigned long)out.total()) + " bytes";
+            pCharControl->setValue(msg.c_str());
+            Serial.println("[FEAT-V23] " + msg);
+        }
+    #endif
+
+    #if ENABLE_FEAT_V34_BLE_BULK
+    } else if (command == "BULK_STOP") {
+        // FEAT-V34: se atiende en update(); STATUS conserva el token
+        bulkStopRequested = true;
+
+    } else if (command == "BULK" || command.startsWith("BULK:")) {
+        // FEAT-V34: BULK desde el inicio, BULK:<token> para reanudar
+        String token = command.substring(5);
+        bool valid = command.length() == 4 || token.length() == 12;
+        for (unsigned int i = 0; valid && i < token.length(); i++) {
+            valid = isxdigit((unsigned char)token[i]);
+        }
+        if (!valid) {
+            pCharControl->setValue("ERROR: Token inválido");
+        } else {
+            bulkHasToken = token.length() == 12;
+            if (bulkHasToken) {
+                bulkReqGuard = strtoul(token.substring(0, 4).c_str(), nullptr, 16);
+                bulkReqOffset = strtoul(token.substring(4).c_str(), nullptr, 16);
+            }
+            bulkRequested = true;
+        }
+    #endif
+
     } else {
         pCharControl->setValue("ERROR: Comando desconocido");
         Serial.println("Comando BLE desconocido");
     }
 }
 
+// ============ [FEAT-V34 START] Descarga masiva por BLE ============
+#if ENABLE_FEAT_V34_BLE_BULK
+bool BLEModule::bulkBusy() const {
+    return bulk != nullptr || bulkRequested;
+}
+
+void BLEModule::startBulk() {
+    bulkRequested = false;
+    if (bulk) finishBulk("STOP");
+    
+    // Sin archivo la descarga sale igual, vacía ('S' y 'E')
+    bool exists = buffer.fileExists();
+    File file;
+    if (exists) {
+        file = LittleFS.open(buffer.getFilePath(), "r");
+        if (!file) {
+            pCharControl->setValue("ERROR: No se pudo leer el buffer");
+            return;
+        }
+    }
+    
+    uint16_t guard = 0xFFFF;  // CRC16 de [0, 0): valor inicial
+    uint32_t size = exists ? file.size() : 0;
+    uint32_t offset = 0;
+    
+    if (bulkHasToken) {
+        // El token vale si [0, offset) no cambió y offset es inicio de línea
+        offset = bulkReqOffset;
+        bool valid = offset <= size;
+        uint8_t chunk[64];
+        uint8_t last = '\n';
+        for (uint32_t done = 0; valid && done < offset;) {
+            size_t want = offset - done < sizeof(chunk) ? offset - done : sizeof(chunk);
+            size_t got = file.read(chunk, want);
+            if (got == 0) {
+                valid = false;
+                break;
+            }
+            guard = ProdDiag::calculateCRC16(chunk, got, guard);
+            last = chunk[got - 1];
+            done += got;
+        }
+        valid = valid && last == '\n' && guard == bulkReqGuard;
+        if (!valid) {
+            if (exists) file.close();
+            pCharControl->setValue("ERROR: Token inválido, reiniciar con BULK");
+            Serial.println("[FEAT-V34] Token rechazado: el buffer cambió");
+            return;
+        }
+    }
+    if (exists) file.seek(offset);
+    
+    bulk = new BulkTransfer();
+    BulkTransfer& b = *bulk;
+    b.file = file;
+    b.eof = !exists;
+    b.pos = b.lineStart = b.startOffset = offset;
+    b.crc = b.lineCrc = guard;
+    b.size = size;
+    int payload = (int)pServer->getPeerMTU(pServer->getConnId()) - 3;
+    if (payload < 20) payload = 20;
+    if (payload > BULK_PAYLOAD_MAX) payload = BULK_PAYLOAD_MAX;
+    b.payloadMax = payload;
+    b.creditFloor = creditsGranted;
+    b.t0 = b.lastSend = b.lastStatus = millis();
+    
+    bulkState = "RUN";
+    bulkGuard = guard;
+    bulkNextOffset = offset;
+    bulkKbps = 0.0f;
+    
+    String msg = "OK: BULK " + String((unsigned long)offset) + "/" + String((unsigned long)size) +
+                 " payload " + String(payload);
+    pCharControl->setValue(msg.c_str());
+    Serial.println("[FEAT-V34] " + msg);
+}
+
+size_t BLEModule::packBulk() {
+    BulkTransfer& b = *bulk;
+    size_t n = BULK_HEADER;
+    
+    // Cada registro necesita su largo y al menos un byte
+    while (n + 3 <= b.payloadMax) {
+        if (!b.inLine) {
+            size_t a = b.avail(PROCESSED_LEN);
+            if (a == 0) break;
+            const uint8_t* p = b.rd + b.rdPos;
+            if (p[0] == '\r' || p[0] == '\n') {
+                b.take();
+                continue;
+            }
+            if (a >= PROCESSED_LEN && memcmp(p, PROCESSED_MARKER, PROCESSED_LEN) == 0) {
+                b.skipLine();
+                continue;
+            }
+            b.inLine = true;
+            b.lineStart = b.pos;
+            b.lineCrc = b.crc;
+        }
+        
+        size_t lenAt = n;
+        n += 2;
+        uint16_t len = 0;
+        while (n < b.payloadMax) {
+            if (!b.avail(1)) {
+                b.inLine = false;
+                break;
+            }
+            uint8_t c = b.take();
+            if (c == '\n') {
+                b.inLine = false;
+                break;
+            }
+            if (c == '\r') continue;
+            b.tx[n++] = c;
+            len++;
+        }
+        if (b.inLine) b.eatEol();
+        
+        putU16(b.tx + lenAt, len | (b.inLine ? BULK_MORE : 0));
+        b.bytes += len;
+        if (!b.inLine) b.records++;
+    }
+    
+    if (n == BULK_HEADER) return 0;
+    b.tx[0] = 'D';
+    putU16(b.tx + 1, b.seq++);
+    putU16(b.tx + 3, b.nextGuard());
+    putU32(b.tx + 5, b.next());
+    return n;
+}
+
+void BLEModule::pumpBulk() {
+    BulkTransfer& b = *bulk;
+    unsigned long now = millis();
+    
+    for (uint8_t i = 0; i < BULK_BURST; i++) {
+        uint32_t credits = FEAT_V34_INITIAL_CREDITS + (creditsGranted - b.creditFloor);
+        if (b.sent >= credits) break;
+        
+        // Una notificación rechazada se reenvía tal cual: packBulk() ya avanzó
+        if (b.txLen == 0) {
+            b.txLast = false;
+            if (!b.started) {
+                b.tx[0] = 'S';
+                putU16(b.tx + 1, bulkGuard);
+                putU32(b.tx + 3, b.startOffset);
+                putU32(b.tx + 7, b.size);
+                putU16(b.tx + 11, b.payloadMax);
+                b.txLen = 13;
+                b.started = true;
+            } else if ((b.txLen = packBulk()) == 0) {
+                b.tx[0] = 'E';
+                putU16(b.tx + 1, b.seq);
+                putU16(b.tx + 3, b.crc);
+                putU32(b.tx + 5, b.pos);
+                putU32(b.tx + 9, b.records);
+                putU32(b.tx + 13, b.bytes);
+                b.txLen = 17;
+                b.txLast = true;
+            }
+        }
+        
+        // notify() no espera al cliente: encola el paquete en el stack y
+        // onStatus informa si lo aceptó. Con la cola llena (congestión) el
+        // paquete se descarta; se reintenta en el próximo update(), y sin
+        // aceptar nada durante FEAT_V34_STALL_MS la descarga pasa a STALL
+        bulkNotifyOk = false;
+        pCharRead->setValue(b.tx, b.txLen);
+        pCharRead->notify();
+        if (!bulkNotifyOk) {
+            b.retries++;
+            break;
+        }
+        b.txLen = 0;
+        b.sent++;
+        b.lastSend = now;
+        bulkNextOffset = b.next();
+        bulkGuard = b.nextGuard();
+        
+        if (b.txLast) {
+            finishBulk("DONE");
+            return;
+        }
+    }
+    
+    if (now - b.lastSend > FEAT_V34_STALL_MS) {
+        finishBulk("STALL");
+        return;
+    }
+    
+    if (now - b.lastStatus >= FEAT_V34_STATUS_MS) {
+        b.lastStatus = now;
+        bulkKbps = bulkRate(b.bytes, now - b.t0);
+        sendBufferStatus();
+    }
+}
+
+void BLEModule::finishBulk(const char* state) {
+    BulkTransfer& b = *bulk;
+    bulkKbps = bulkRate(b.bytes, millis() - b.t0);
+    // Con una notificación sin aceptar, el token queda en la última aceptada
+    if (b.txLen == 0) {
+        bulkNextOffset = b.next();
+        bulkGuard = b.nextGuard();
+    }
+    bulkState = state;
+    if (b.file) b.file.close();
+    
+    String msg = "OK: BULK " + String(state) + " " + String((unsigned long)b.records) +
+                 " registros, " + String((unsigned long)b.bytes) + " B, " +
+                 String(bulkKbps, 1) + " KB/s, " + String((unsigned long)b.retries) +
+                 " reintentos";
+    delete bulk;
+    bulk = nullptr;
+    
+    pCharControl->setValue(msg.c_str());
+    Serial.println("[FEAT-V34] " + msg);
+    sendBufferStatus();
+}
+#endif
+// ============ [FEAT-V34 END] ============
+
 // =============================================================================
 // Implementación de ServerCallbacks
 // =============================================================================
@@ -256,3 +780,13 @@ void CharacteristicCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
         module->processCommand(command);
     }
 }
+
+#if ENABLE_FEAT_V34_BLE_BULK
+void CharacteristicCallbacks::onStatus(BLECharacteristic* pCharacteristic, Status s, uint32_t code) {
+    if (pCharacteristic != module->pCharRead) {
+        return;
+    }
+    (void)code;
+    module->bulkNotifyOk = (s == Status::SUCCESS_NOTIFY);
+}
+#endif
@@ -11,6 +11,7 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include "BUFFERModule.h"
+#include "../FeatureFlags.h"
 
 // UUIDs para el servicio y características BLE
 #define SERVICE_UUID        "4fafc201-1fb5-459e-8fcc-c5c9c331914b"
@@ -65,6 +66,7 @@ class BLEModule {
     
     /**
      * Envía el estado actual del buffer (tamaño, líneas, etc).
+     * Con FEAT-V34 agrega el estado de la descarga BULK: KB/s, offset y token.
      */
     void sendBufferStatus();
     
@@ -87,6 +89,59 @@ class BLEModule {
      * @param command Comando recibido del cliente BLE.
      */
     void processCommand(const String& command);
+    
+    // ============ [FEAT-V34 START] Descarga masiva por BLE ============
+    #if ENABLE_FEAT_V34_BLE_BULK
+    struct BulkTransfer;                // Estado de la descarga; en el heap solo mientras dura
+    BulkTransfer* bulk;
+    
+    // Escritos desde el callback BLE, atendidos en update()
+    volatile bool bulkRequested;
+    volatile bool bulkStopRequested;
+    volatile bool bulkHasToken;
+    volatile uint16_t bulkReqGuard;
+    volatile uint32_t bulkReqOffset;
+    volatile uint32_t creditsGranted;   // Suma de CREDIT:n; solo la escribe el callback
+    volatile bool bulkNotifyOk;         // onStatus de la última notificación de lectura
+    
+    // Resultado de la última descarga (para STATUS)
+    const char* bulkState;
+    uint16_t bulkGuard;
+    uint32_t bulkNextOffset;
+    float bulkKbps;
+    uint8_t reconnects;
+    
+    /**
+     * Abre buffer.txt, valida el token y arma la descarga pedida por BULK.
+     */
+    void startBulk();
+    
+    /**
+     * Envía notificaciones mientras haya créditos; pausa la descarga si el
+     * cliente deja de concederlos durante FEAT_V34_STALL_MS. Una notificación
+     * que el stack rechaza (cola llena) se reintenta en la próxima llamada.
+     */
+    void pumpBulk();
+    
+    /**
+     * Cierra la descarga en curso y guarda su resultado.
+     * @param state Estado final para STATUS ("DONE", "STALL", "STOP", "CUT").
+     */
+    void finishBulk(const char* state);
+    
+    /**
+     * Llena una notificación 'D' con registros del archivo.
+     * @return Largo de la notificación; 0 si no queda nada por enviar.
+     */
+    size_t packBulk();
+    
+    /**
+     * Indica si hay una descarga en curso o pedida (READ, CLEAR y
+     * REMOVE_PROCESSED se rechazan mientras tanto).
+     */
+    bool bulkBusy() const;
+    #endif
+    // ============ [FEAT-V34 END] ============
 };
 
 /**
@@ -114,6 +169,14 @@ class CharacteristicCallbacks: public BLECharacteristicCallbacks {
     
     void onWrite(BLECharacteristic* pCharacteristic);
     
+    #if ENABLE_FEAT_V34_BLE_BULK
+    /**
+     * Resultado de notify() en la característica de lectura (FEAT-V34).
+     * El stack lo informa dentro de la misma llamada a notify().
+     */
+    void onStatus(BLECharacteristic* pCharacteristic, Status s, uint32_t code);
+    #endif
+    
   private:
     BLEModule* module;
 };
@@ -9,13 +9,21 @@
 
 #include "BUFFERModule.h"
 #include "config_data_buffer.h"
+#include "../TraceSpan.h"  // FEAT-V23
+#include "../data_diagnostics/FlashWear.h"  // FEAT-V29
 
 BUFFERModule::BUFFERModule() {
     filePath = BUFFER_FILE_PATH;
     isInitialized = false;
 }
 
+BUFFERModule::BUFFERModule(const char* path) {
+    filePath = path;
+    isInitialized = false;
+}
+
 bool BUFFERModule::begin() {
+    TRACE_SPAN("fs.mount");
     if (!LittleFS.begin()) {
         return false;
     }
@@ -24,7 +32,12 @@ bool BUFFERModule::begin() {
 }
 
 bool BUFFERModule::appendLine(const String& line) {
-    if (!isInitialized) {
+    return appendLine(line.c_str());
+}
+
+bool BUFFERModule::appendLine(const char* line) {
+    TRACE_SPAN("fs.append");
+    if (!isInitialized || line == nullptr) {
         return false;
     }
     
@@ -33,12 +46,14 @@ bool BUFFERModule::appendLine(const String& line) {
         return false;
     }
     
-    file.println(line);
+    FLASH_WEAR_FILE(fw, SUB_BUFFER, "a");  // FEAT-V29
+    FLASH_WEAR_ADD(fw, file.println(line));
     file.close();
     return true;
 }
 
 bool BUFFERModule::readLines(String* lines, int maxLines, int& count) {
+    TRACE_SPAN("fs.read");
     if (!isInitialized) {
         return false;
     }
@@ -59,6 +74,7 @@ bool BUFFERModule::readLines(String* lines, int maxLines, int& count) {
 }
 
 bool BUFFERModule::clearFile() {
+    TRACE_SPAN("fs.clear");
     if (!isInitialized) {
         return false;
     }
@@ -70,6 +86,7 @@ bool BUFFERModule::clearFile() {
 }
 
 bool BUFFERModule::fileExists() {
+    TRACE_SPAN("fs.exists");
     if (!isInitialized) {
         return false;
     }
@@ -77,6 +94,7 @@ bool BUFFERModule::fileExists() {
 }
 
 size_t BUFFERModule::getFileSize() {
+    TRACE_SPAN("fs.size");
     if (!isInitialized) {
         return 0;
     }
@@ -96,6 +114,7 @@ size_t BUFFERModule::getFileSize() {
 }
 
 bool BUFFERModule::readUnprocessedLines(String* lines, int maxLines, int& count) {
+    TRACE_SPAN("fs.readPending");
     if (!isInitialized) {
         return false;
     }
@@ -120,6 +139,7 @@ bool BUFFERModule::readUnprocessedLines(String* lines, int maxLines, int& count)
 }
 
 bool BUFFERModule::markLineAsProcessed(int lineNumber) {
+    TRACE_SPAN("fs.mark");
     if (!isInitialized || lineNumber < 0) {
         return false;
     }
@@ -159,8 +179,9 @@ bool BUFFERModule::markLineAsProcessed(int lineNumber) {
         return false;
     }
     
+    FLASH_WEAR_FILE(fw, SUB_BUFFER, "w");  // FEAT-V29
     for (int i = 0; i < totalLines; i++) {
-        file.println(allLines[i]);
+        FLASH_WEAR_ADD(fw, file.println(allLines[i]));
     }
     
     file.close();
@@ -168,6 +189,7 @@ bool BUFFERModule::markLineAsProcessed(int lineNumber) {
 }
 
 bool BUFFERModule::markLinesAsProcessed(int* lineNumbers, int count) {
+    TRACE_SPAN("fs.markN");
     if (!isInitialized || count <= 0) {
         return false;
     }
@@ -207,8 +229,9 @@ bool BUFFERModule::markLinesAsProcessed(int* lineNumbers, int count) {
         return false;
     }
     
+    FLASH_WEAR_FILE(fw, SUB_BUFFER, "w");  // FEAT-V29
     for (int i = 0; i < totalLines; i++) {
-        file.println(allLines[i]);
+        FLASH_WEAR_ADD(fw, file.println(allLines[i]));
     }
     
     file.close();
@@ -216,6 +239,7 @@ bool BUFFERModule::markLinesAsProcessed(int* lineNumbers, int count) {
 }
 
 bool BUFFERModule::removeProcessedLines() {
+    TRACE_SPAN("fs.compact");
     if (!isInitialized) {
         return false;
     }
@@ -253,10 +277,15 @@ bool BUFFERModule::removeProcessedLines() {
         return false;
     }
     
+    FLASH_WEAR_FILE(fw, SUB_BUFFER, "w");  // FEAT-V29
     for (int i = 0; i < unprocessedCount; i++) {
-        file.println(unprocessedLines[i]);
+        FLASH_WEAR_ADD(fw, file.println(unprocessedLines[i]));
     }
     
     file.close();
     return true;
 }
+
+const char* BUFFERModule::getFilePath() const {
+    return filePath;
+}
@@ -30,6 +30,12 @@ class BUFFERModule {
      */
     BUFFERModule();
     
+    /**
+     * @brief Constructor con otra ruta (FEAT-V33: el benchmark no toca buffer.txt)
+     * @param path Ruta del archivo en LittleFS.
+     */
+    explicit BUFFERModule(const char* path);
+    
     /**
      * Inicializa el sistema de archivos LittleFS.
      * @return true si la inicialización fue exitosa, false en caso contrario.
@@ -42,6 +48,13 @@ class BUFFERModule {
      * @return true si la línea se agregó correctamente, false en caso contrario.
      */
     bool appendLine(const String& line);
+
+    /**
+     * Agrega una línea desde un buffer fijo, sin crear String (FEAT-V21).
+     * @param line Cadena terminada en '\0' a agregar al archivo.
+     * @return true si la línea se agregó correctamente, false en caso contrario.
+     */
+    bool appendLine(const char* line);
     
     /**
      * Lee múltiples líneas del archivo y las almacena en un arreglo.
@@ -101,6 +114,12 @@ class BUFFERModule {
      */
     bool removeProcessedLines();
     
+    /**
+     * Ruta del archivo en LittleFS (FEAT-V34: la descarga BULK lo recorre por offset).
+     * @return Ruta del archivo.
+     */
+    const char* getFilePath() const;
+    
   private:
     const char* filePath;      // Ruta del archivo en el sistema de archivos
     bool isInitialized;        // Indica si el sistema de archivos fue inicializado correctamente
@@ -0,0 +1,253 @@
+/**
+ * @file PersistState.cpp
+ * @brief Implementación de la caché RTC del estado persistente
+ * @version FEAT-V22
+ * @date 2026-10-18
+ */
+
+#include "PersistState.h"
+
+#if ENABLE_FEAT_V22_PERSIST_CACHE
+
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include "../data_diagnostics/FlashWear.h"  // FEAT-V29
+
+namespace PersistState {
+
+/** @brief Claves del namespace (bit de dirty) */
+enum Key : uint8_t {
+  KEY_OPERATOR  = 1 << 0,  ///< "lastOperator"
+  KEY_SKIP_SCAN = 1 << 1,  ///< "skipScanCycles"
+  KEY_GPS       = 1 << 2   ///< "gps_lat", "gps_lng", "gps_alt"
+};
+
+/** @brief Claves que no esperan al flush() */
+static const uint8_t WRITE_THROUGH = KEY_SKIP_SCAN;
+
+static const uint32_t RTC_MAGIC = 0x50535431;  // "PST1"
+
+/** @brief Copia tipada del namespace */
+struct Data {
+  bool hasOperator;
+  uint8_t lastOperator;
+  uint8_t skipScanCycles;
+  bool hasGps;
+  float gpsLat;
+  float gpsLng;
+  float gpsAlt;
+};
+
+RTC_DATA_ATTR static uint32_t s_magic = 0;
+RTC_DATA_ATTR static uint32_t s_crc = 0;
+RTC_DATA_ATTR static Data s_data;
+RTC_DATA_ATTR static uint8_t s_dirty = 0;
+
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/** @brief Escrituras absorbidas por la caché en este despertar (para el log) */
+static uint16_t s_deferred = 0;
+
+/** @brief CRC32 (reflejado, 0xEDB88320) de la copia RTC */
+static uint32_t dataCrc() {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(&s_data);
+  uint32_t crc = 0xFFFFFFFFUL;
+  for (size_t i = 0; i < sizeof(s_data); i++) {
+    crc ^= p[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+    }
+  }
+  return ~crc;
+}
+
+/** @brief Escribe en NVS las claves de mask (sesión ya abierta) */
+static uint8_t writeKeys(Preferences& prefs, uint8_t mask, const Data& d) {
+  uint8_t n = 0;
+  if (mask & KEY_OPERATOR) {
+    if (d.hasOperator) prefs.putUChar("lastOperator", d.lastOperator);
+    else prefs.remove("lastOperator");
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(uint8_t));  // FEAT-V29 (remove también escribe)
+    n++;
+  }
+  if (mask & KEY_SKIP_SCAN) {
+    prefs.putUChar("skipScanCycles", d.skipScanCycles);
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(uint8_t));  // FEAT-V29
+    n++;
+  }
+  if (mask & KEY_GPS) {
+    prefs.putFloat("gps_lat", d.gpsLat);
+    prefs.putFloat("gps_lng", d.gpsLng);
+    prefs.putFloat("gps_alt", d.gpsAlt);
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(float));  // FEAT-V29
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(float));
+    FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(float));
+    n++;
+  }
+  return n;
+}
+
+/**
+ * @brief Cierra una modificación: marca dirty y resella la copia RTC
+ * @note Llamar dentro de la sección crítica
+ */
+static void touch(uint8_t key) {
+  s_dirty |= key;
+  s_crc = dataCrc();
+}
+
+/** @brief Escribe ya una clave write-through y la limpia de dirty */
+static void writeThrough(uint8_t key) {
+  Data snap;
+  portENTER_CRITICAL(&s_mux);
+  snap = s_data;
+  s_dirty &= (uint8_t)~key;
+  portEXIT_CRITICAL(&s_mux);
+
+  Preferences prefs;  // Instancia local: puede llamarse desde core 0
+  if (prefs.begin(FEAT_V22_NVS_NAMESPACE, false)) {
+    writeKeys(prefs, key, snap);
+    prefs.end();
+  } else {
+    portENTER_CRITICAL(&s_mux);
+    s_dirty |= key;  // Reintentar en flush()
+    portEXIT_CRITICAL(&s_mux);
+  }
+}
+
+bool begin() {
+  if (s_magic == RTC_MAGIC && s_crc == dataCrc()) {
+    Serial.printf("[FEAT-V22] Estado persistente desde RTC (pendientes 0x%02X)\n",
+                  (unsigned)s_dirty);
+    return false;
+  }
+
+  uint32_t t0 = millis();
+  memset(&s_data, 0, sizeof(s_data));
+  Preferences prefs;
+  if (prefs.begin(FEAT_V22_NVS_NAMESPACE, true)) {
+    s_data.hasOperator = prefs.isKey("lastOperator");
+    s_data.lastOperator = prefs.getUChar("lastOperator", 0);
+    s_data.skipScanCycles = prefs.getUChar("skipScanCycles", 0);
+    s_data.hasGps = prefs.isKey("gps_lat") && prefs.isKey("gps_lng") && prefs.isKey("gps_alt");
+    s_data.gpsLat = prefs.getFloat("gps_lat", 0.0f);
+    s_data.gpsLng = prefs.getFloat("gps_lng", 0.0f);
+    s_data.gpsAlt = prefs.getFloat("gps_alt", 0.0f);
+    prefs.end();
+  }
+  s_dirty = 0;
+  s_crc = dataCrc();
+  s_magic = RTC_MAGIC;
+  Serial.printf("[FEAT-V22] Estado persistente cargado de NVS en %lu ms\n",
+                (unsigned long)(millis() - t0));
+  return true;
+}
+
+bool lastOperator(uint8_t& op) {
+  portENTER_CRITICAL(&s_mux);
+  bool has = s_data.hasOperator;
+  op = s_data.lastOperator;
+  portEXIT_CRITICAL(&s_mux);
+  return has;
+}
+
+void setLastOperator(uint8_t op) {
+  portENTER_CRITICAL(&s_mux);
+  if (!s_data.hasOperator || s_data.lastOperator != op) {
+    s_data.hasOperator = true;
+    s_data.lastOperator = op;
+    touch(KEY_OPERATOR);
+  }
+  s_deferred++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void clearLastOperator() {
+  portENTER_CRITICAL(&s_mux);
+  if (s_data.hasOperator) {
+    s_data.hasOperator = false;
+    touch(KEY_OPERATOR);
+  }
+  s_deferred++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+uint8_t skipScanCycles() {
+  portENTER_CRITICAL(&s_mux);
+  uint8_t n = s_data.skipScanCycles;
+  portEXIT_CRITICAL(&s_mux);
+  return n;
+}
+
+void setSkipScanCycles(uint8_t n) {
+  bool changed = false;
+  portENTER_CRITICAL(&s_mux);
+  if (s_data.skipScanCycles != n) {
+    s_data.skipScanCycles = n;
+    touch(KEY_SKIP_SCAN);
+    changed = true;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  if (changed && (WRITE_THROUGH & KEY_SKIP_SCAN)) writeThrough(KEY_SKIP_SCAN);
+}
+
+bool gps(float& lat, float& lng, float& alt) {
+  portENTER_CRITICAL(&s_mux);
+  bool has = s_data.hasGps;
+  lat = s_data.gpsLat;
+  lng = s_data.gpsLng;
+  alt = s_data.gpsAlt;
+  portEXIT_CRITICAL(&s_mux);
+  return has;
+}
+
+void setGps(float lat, float lng, float alt) {
+  portENTER_CRITICAL(&s_mux);
+  if (!s_data.hasGps || s_data.gpsLat != lat || s_data.gpsLng != lng || s_data.gpsAlt != alt) {
+    s_data.hasGps = true;
+    s_data.gpsLat = lat;
+    s_data.gpsLng = lng;
+    s_data.gpsAlt = alt;
+    touch(KEY_GPS);
+  }
+  s_deferred++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+uint8_t flush() {
+  Data snap;
+  portENTER_CRITICAL(&s_mux);
+  uint8_t mask = s_dirty;
+  snap = s_data;
+  portEXIT_CRITICAL(&s_mux);
+
+  uint16_t deferred = s_deferred;
+  s_deferred = 0;
+
+  if (mask == 0) {
+    Serial.printf("[FEAT-V22] Flush: sin cambios (%u escrituras absorbidas en RTC)\n",
+                  (unsigned)deferred);
+    return 0;
+  }
+
+  uint32_t t0 = millis();
+  Preferences prefs;
+  if (!prefs.begin(FEAT_V22_NVS_NAMESPACE, false)) {
+    Serial.println(F("[FEAT-V22] Flush: no se pudo abrir NVS, se reintenta el próximo ciclo"));
+    return 0;
+  }
+  uint8_t n = writeKeys(prefs, mask, snap);
+  prefs.end();
+
+  portENTER_CRITICAL(&s_mux);
+  s_dirty &= (uint8_t)~mask;
+  portEXIT_CRITICAL(&s_mux);
+
+  Serial.printf("[FEAT-V22] Flush: %u claves (mask 0x%02X) en %lu ms, %u escrituras absorbidas\n",
+                (unsigned)n, (unsigned)mask, (unsigned long)(millis() - t0), (unsigned)deferred);
+  return n;
+}
+
+}  // namespace PersistState
+
+#endif  // ENABLE_FEAT_V22_PERSIST_CACHE
@@ -0,0 +1,71 @@
+/**
+ * @file PersistState.h
+ * @brief Caché write-back en RTC del estado persistente del namespace NVS "sensores".
+ * @version FEAT-V22
+ * @date 2026-10-18
+ *
+ * El estado (operadora, anti-bucle de escaneo, última posición GPS) se carga
+ * de NVS una sola vez cuando la copia RTC no es válida (boot en frío, pérdida
+ * de alimentación) y vive en RTC_DATA_ATTR entre deep sleeps. Los módulos leen
+ * y escriben la copia RTC; flush() escribe en una sola sesión NVS las claves
+ * que cambiaron, antes del deep sleep.
+ *
+ * Claves críticas (write-through): skipScanCycles. Es la protección anti-bucle
+ * de FIX-V2 y debe sobrevivir a un brownout durante el escaneo de operadoras.
+ *
+ * Seguro entre núcleos: la tarea LTE de FEAT-V12 (core 0) y el ciclo (core 1)
+ * acceden a la misma copia bajo un spinlock.
+ */
+
+#ifndef PERSISTSTATE_H
+#define PERSISTSTATE_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+
+namespace PersistState {
+
+/**
+ * @brief Carga el estado: copia RTC si es válida, si no lee NVS una vez.
+ * @return true si se leyó NVS (copia RTC inválida).
+ */
+bool begin();
+
+/**
+ * @brief Operadora guardada por el último envío exitoso.
+ * @param[out] op Índice de operadora.
+ * @return true si hay operadora guardada ("lastOperator").
+ */
+bool lastOperator(uint8_t& op);
+
+/** @brief Guarda la operadora (diferido hasta flush()). */
+void setLastOperator(uint8_t op);
+
+/** @brief Elimina la operadora guardada (diferido hasta flush()). */
+void clearLastOperator();
+
+/** @brief Ciclos de escaneo pendientes de saltar (FIX-V2). */
+uint8_t skipScanCycles();
+
+/** @brief Asigna ciclos a saltar. Write-through: se escribe en NVS de inmediato. */
+void setSkipScanCycles(uint8_t n);
+
+/**
+ * @brief Última posición GPS persistida.
+ * @return true si hay coordenadas guardadas.
+ */
+bool gps(float& lat, float& lng, float& alt);
+
+/** @brief Guarda la posición GPS (diferido hasta flush()). */
+void setGps(float lat, float lng, float alt);
+
+/**
+ * @brief Escribe en NVS las claves modificadas (una sola apertura).
+ * @note Llamar antes de deep sleep / restart, sin la tarea LTE activa.
+ * @return Número de claves escritas o eliminadas.
+ */
+uint8_t flush();
+
+}  // namespace PersistState
+
+#endif
@@ -15,12 +15,18 @@
 #include <Preferences.h>
 #include <LittleFS.h>
 #include <esp_system.h>
+#include "FlashWear.h"  // FEAT-V29
 
 // ============================================================
-// VARIABLES RTC (sobreviven reset, NO brownout)
+// VARIABLES RTC NOINIT (sobreviven panic/WDT/SW reset y deep sleep)
 // ============================================================
+// RTC_DATA_ATTR se recarga con su valor inicial en todo reset que no sea
+// un despertar de deep sleep, así que tras un panic/WDT el contexto se
+// perdería. RTC_NOINIT_ATTR no se toca en el arranque: tras power-on o
+// brownout trae basura, y por eso se valida con magic + CRC32.
 
-RTC_DATA_ATTR static CrashContext g_crash_ctx;
+RTC_NOINIT_ATTR static CrashContext g_crash_ctx;
+RTC_NOINIT_ATTR static uint32_t g_crash_crc;
 
 // ============================================================
 // VARIABLES LOCALES
@@ -37,6 +43,31 @@ static uint16_t s_crash_count = 0;
 static uint8_t s_consecutive_crashes = 0;
 static uint8_t s_cycles_since_success = 0;
 
+// ============ [FEAT-V26 START] Promoción diferida RTC -> NVS ============
+#if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+static CrashContext s_prev_ctx;          ///< Contexto del despertar anterior (copia antes del reset)
+static bool s_prev_valid = false;
+static uint8_t s_nvs_cp = CP_NONE;       ///< Checkpoint que ya está en NVS
+static bool s_synced = false;            ///< Hubo al menos un sync este despertar
+static uint32_t s_last_sync_ms = 0;
+static uint16_t s_nvs_writes = 0;        ///< Escrituras NVS este despertar
+static uint16_t s_nvs_saved = 0;         ///< Escrituras evitadas este despertar
+RTC_DATA_ATTR static uint32_t s_nvs_saved_total;  ///< Evitadas desde el último reset (no deep sleep)
+
+/** @brief putUChar solo si el valor cambió (Preferences ya abierto) */
+static void putU8IfChanged(const char* key, uint8_t value) {
+    if (s_prefs.getUChar(key, (uint8_t)~value) == value) {
+        s_nvs_saved++;
+        s_nvs_saved_total++;
+        return;
+    }
+    s_prefs.putUChar(key, value);
+    FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));  // FEAT-V29
+    s_nvs_writes++;
+}
+#endif
+// ============ [FEAT-V26 END] ============
+
 // ============================================================
 // FUNCIONES AUXILIARES INTERNAS
 // ============================================================
@@ -57,6 +88,29 @@ static void safeCopy(char* dst, const char* src, size_t maxLen) {
     dst[len] = '\0';
 }
 
+/** @brief CRC32 del contexto RTC (mismo polinomio que PersistState) */
+static uint32_t ctxCrc() {
+    const uint8_t* p = (const uint8_t*)&g_crash_ctx;
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < sizeof(g_crash_ctx); i++) {
+        crc ^= p[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+        }
+    }
+    return ~crc;
+}
+
+/** @brief Recalcula el CRC tras modificar el contexto */
+static void seal() {
+    g_crash_crc = ctxCrc();
+}
+
+/** @brief Contexto RTC íntegro (no es basura de power-on/brownout) */
+static bool ctxValid() {
+    return g_crash_ctx.magic == CRASH_DIAG_MAGIC && g_crash_crc == ctxCrc();
+}
+
 /**
  * @brief Agregar checkpoint al historial circular
  */
@@ -101,9 +155,10 @@ static void writeLogEntry(uint8_t eventType, uint32_t epoch) {
             return;
         }
         // Inicializar con ceros
+        FLASH_WEAR_FILE(fwInit, SUB_CRASHLOG, "w");  // FEAT-V29
         uint8_t zeros[sizeof(CrashLogEntry)] = {0};
         for (int i = 0; i < CRASH_DIAG_LOG_MAX_ENTRIES; i++) {
-            logFile.write(zeros, sizeof(CrashLogEntry));
+            FLASH_WEAR_ADD(fwInit, logFile.write(zeros, sizeof(CrashLogEntry)));
         }
         logFile.close();
         logFile = LittleFS.open(CRASH_DIAG_LOG_PATH, "r+");
@@ -112,14 +167,18 @@ static void writeLogEntry(uint8_t eventType, uint32_t epoch) {
     // Posicionar y escribir
     size_t pos = currentIdx * sizeof(CrashLogEntry);
     logFile.seek(pos);
-    logFile.write((uint8_t*)&entry, sizeof(CrashLogEntry));
+    {
+        FLASH_WEAR_FILE(fw, SUB_CRASHLOG, "r+");  // FEAT-V29
+        FLASH_WEAR_ADD(fw, logFile.write((uint8_t*)&entry, sizeof(CrashLogEntry)));
+    }
     logFile.close();
     
     // Actualizar índice
     currentIdx = (currentIdx + 1) % CRASH_DIAG_LOG_MAX_ENTRIES;
     idxFile = LittleFS.open("/crash_idx.bin", "w");
     if (idxFile) {
-        idxFile.write(&currentIdx, 1);
+        FLASH_WEAR_FILE(fwIdx, SUB_CRASHLOG, "w");  // FEAT-V29
+        FLASH_WEAR_ADD(fwIdx, idxFile.write(&currentIdx, 1));
         idxFile.close();
     }
 }
@@ -150,6 +209,18 @@ bool init() {
     // Incrementar boot count
     s_boot_count++;
     s_prefs.putUShort(NVS_KEY_BOOT_COUNT, s_boot_count);
+    FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint16_t));  // FEAT-V29
+    
+    // ============ [FEAT-V26 START] Conservar contexto RTC del despertar anterior ============
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    s_nvs_writes++;
+    s_nvs_cp = s_prefs.getUChar(NVS_KEY_LAST_CHECKPOINT, CP_NONE);
+    s_prev_valid = ctxValid();
+    if (s_prev_valid) {
+        memcpy(&s_prev_ctx, &g_crash_ctx, sizeof(s_prev_ctx));
+    }
+    #endif
+    // ============ [FEAT-V26 END] ============
     
     // Analizar tipo de reset
     if (isCrashReason(s_last_reset_reason)) {
@@ -161,11 +232,26 @@ bool init() {
         s_prefs.putUShort(NVS_KEY_CRASH_COUNT, s_crash_count);
         s_prefs.putUChar(NVS_KEY_CONSEC_CRASH, s_consecutive_crashes);
         s_prefs.putUChar(NVS_KEY_CYCLES_FAIL, s_cycles_since_success);
+        FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint16_t));  // FEAT-V29
+        FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));
+        FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));
         
         // Guardar contexto del crash si RTC válido
-        if (g_crash_ctx.magic == CRASH_DIAG_MAGIC) {
+        if (ctxValid()) {
             s_prefs.putUChar(NVS_KEY_LAST_CHECKPOINT, g_crash_ctx.checkpoint);
             s_prefs.putUChar(NVS_KEY_LAST_REASON, s_last_reset_reason);
+            FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));  // FEAT-V29
+            FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));
+            // ============ [FEAT-V26 START] Promoción del contexto RTC (solo tras crash) ============
+            #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+            s_prefs.putString(NVS_KEY_LAST_AT_CMD, g_crash_ctx.last_at_command);
+            s_prefs.putString(NVS_KEY_LAST_AT_RESP, g_crash_ctx.last_at_response);
+            FLASH_WEAR_NVS(SUB_NVS_CRASH, strlen(g_crash_ctx.last_at_command) + 1);  // FEAT-V29
+            FLASH_WEAR_NVS(SUB_NVS_CRASH, strlen(g_crash_ctx.last_at_response) + 1);
+            s_nvs_cp = g_crash_ctx.checkpoint;
+            s_nvs_writes += 4;
+            #endif
+            // ============ [FEAT-V26 END] ============
             // Escribir al log de LittleFS
             writeLogEntry(1, millis()); // 1 = crash
         }
@@ -176,6 +262,8 @@ bool init() {
         s_cycles_since_success = 0;
         s_prefs.putUChar(NVS_KEY_CONSEC_CRASH, 0);
         s_prefs.putUChar(NVS_KEY_CYCLES_FAIL, 0);
+        FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));  // FEAT-V29
+        FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));
     }
     // Deep sleep y SW reset: solo incrementar boot_count (ya hecho arriba)
     
@@ -184,6 +272,7 @@ bool init() {
     // Resetear contexto RTC para nuevo ciclo
     memset(&g_crash_ctx, 0, sizeof(g_crash_ctx));
     g_crash_ctx.magic = CRASH_DIAG_MAGIC;
+    seal();
     
     s_initialized = true;
     return true;
@@ -193,27 +282,67 @@ void setCheckpoint(CrashCheckpoint cp) {
     g_crash_ctx.checkpoint = (uint8_t)cp;
     g_crash_ctx.timestamp_ms = millis();
     addToHistory((uint8_t)cp);
+    seal();
 }
 
 void logATCommand(const char* cmd) {
     safeCopy(g_crash_ctx.last_at_command, cmd, CRASH_DIAG_AT_CMD_LEN);
+    seal();
 }
 
 void logATResponse(const char* resp) {
     safeCopy(g_crash_ctx.last_at_response, resp, CRASH_DIAG_AT_RESP_LEN);
+    seal();
 }
 
 void setRSSI(int8_t rssi) {
     g_crash_ctx.rssi = rssi;
+    seal();
 }
 
 void syncToNVS() {
+    // ============ [FEAT-V26 START] Sync acotado ============
+    // El contexto ya vive en RTC NOINIT (sobrevive panic/WDT). NVS solo cubre el
+    // brownout: se escribe si el checkpoint cambió y además es el primer
+    // sync del despertar, pasó FEAT_V26_NVS_SYNC_MIN_MS o es CP_SLEEP_ENTER
+    // (deja "ciclo cerrado" en NVS).
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    uint32_t now = millis();
+    bool changed = (g_crash_ctx.checkpoint != s_nvs_cp);
+    bool due = !s_synced ||
+               (now - s_last_sync_ms >= FEAT_V26_NVS_SYNC_MIN_MS) ||
+               (g_crash_ctx.checkpoint == CP_SLEEP_ENTER);
+    if (!changed || !due) {
+        s_nvs_saved++;
+        s_nvs_saved_total++;
+        return;
+    }
+    #endif
+    // ============ [FEAT-V26 END] ============
+    
     if (!s_prefs.begin(CRASH_DIAG_NVS_NAMESPACE, false)) {
         return;
     }
     s_prefs.putUChar(NVS_KEY_LAST_CHECKPOINT, g_crash_ctx.checkpoint);
+    FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));  // FEAT-V29
     s_prefs.end();
+    
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    s_nvs_cp = g_crash_ctx.checkpoint;
+    s_synced = true;
+    s_last_sync_ms = now;
+    s_nvs_writes++;
+    #endif
+}
+
+// ============ [FEAT-V26 START] Reporte de escrituras NVS ============
+#if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+void printNvsStats() {
+    Serial.printf("[FEAT-V26] NVS crashdiag este ciclo: %u escrituras, %u evitadas (evitadas desde power-on: %lu)\n",
+                  (unsigned)s_nvs_writes, (unsigned)s_nvs_saved, (unsigned long)s_nvs_saved_total);
 }
+#endif
+// ============ [FEAT-V26 END] ============
 
 bool hadCrash() {
     return s_had_crash;
@@ -251,11 +380,23 @@ void printReport() {
     
     // Contexto RTC
     Serial.println(F(""));
-    if (g_crash_ctx.magic == CRASH_DIAG_MAGIC || s_had_crash) {
+    // ============ [FEAT-V26 START] Reportar el contexto del despertar anterior ============
+    // init() reinicia g_crash_ctx para el ciclo nuevo; la copia previa conserva
+    // checkpoint, historial y último AT del ciclo que terminó en crash.
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    const CrashContext& ctx = s_prev_valid ? s_prev_ctx : g_crash_ctx;
+    #else
+    const CrashContext& ctx = g_crash_ctx;
+    #endif
+    // ============ [FEAT-V26 END] ============
+    if (ctxValid() || s_had_crash) {
         // Cargar checkpoint de NVS si está disponible
         s_prefs.begin(CRASH_DIAG_NVS_NAMESPACE, true);
         uint8_t lastCp = s_prefs.getUChar(NVS_KEY_LAST_CHECKPOINT, 0);
         s_prefs.end();
+        #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+        if (s_prev_valid) lastCp = ctx.checkpoint;  // RTC es exacto; NVS puede estar atrasado
+        #endif
         
         Serial.print(F("Last Checkpoint: "));
         Serial.print(checkpointToString((CrashCheckpoint)lastCp));
@@ -264,22 +405,22 @@ void printReport() {
         Serial.println(F(")"));
         
         Serial.print(F("Last AT Command: "));
-        Serial.println(g_crash_ctx.last_at_command[0] ? g_crash_ctx.last_at_command : "(none)");
+        Serial.println(ctx.last_at_command[0] ? ctx.last_at_command : "(none)");
         
         Serial.print(F("Last AT Response: "));
-        Serial.println(g_crash_ctx.last_at_response[0] ? g_crash_ctx.last_at_response : "(none)");
+        Serial.println(ctx.last_at_response[0] ? ctx.last_at_response : "(none)");
         
         Serial.print(F("RSSI: "));
-        Serial.print(g_crash_ctx.rssi);
+        Serial.print(ctx.rssi);
         Serial.println(F(" dBm"));
         
         // Historial
         Serial.println(F(""));
         Serial.println(F("Checkpoint History (newest first):"));
-        int idx = g_crash_ctx.history_idx;
+        int idx = ctx.history_idx;
         for (int i = 0; i < CRASH_DIAG_HISTORY_SIZE; i++) {
             idx = (idx - 1 + CRASH_DIAG_HISTORY_SIZE) % CRASH_DIAG_HISTORY_SIZE;
-            uint8_t cp = g_crash_ctx.history[idx];
+            uint8_t cp = ctx.history[idx];
             if (cp != 0) {
                 Serial.print(F("  ["));
                 Serial.print(i);
@@ -370,9 +511,31 @@ void markCycleSuccess() {
     if (!s_prefs.begin(CRASH_DIAG_NVS_NAMESPACE, false)) {
         return;
     }
+    // ============ [FEAT-V26 START] Solo escribir contadores que cambian ============
+    // En régimen normal ambos ya están en 0: success_ep se escribe solo al
+    // cerrar una racha de fallos (es millis() y no aporta en cada ciclo).
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    bool streakEnded = (s_prefs.getUChar(NVS_KEY_CONSEC_CRASH, 0) != 0) ||
+                       (s_prefs.getUChar(NVS_KEY_CYCLES_FAIL, 0) != 0);
+    putU8IfChanged(NVS_KEY_CONSEC_CRASH, 0);
+    putU8IfChanged(NVS_KEY_CYCLES_FAIL, 0);
+    if (streakEnded) {
+        s_prefs.putULong(NVS_KEY_SUCCESS_EPOCH, millis());
+        FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint32_t));  // FEAT-V29
+        s_nvs_writes++;
+    } else {
+        s_nvs_saved++;
+        s_nvs_saved_total++;
+    }
+    #else
     s_prefs.putUChar(NVS_KEY_CONSEC_CRASH, 0);
     s_prefs.putUChar(NVS_KEY_CYCLES_FAIL, 0);
     s_prefs.putULong(NVS_KEY_SUCCESS_EPOCH, millis());
+    FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));  // FEAT-V29
+    FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint8_t));
+    FLASH_WEAR_NVS(SUB_NVS_CRASH, sizeof(uint32_t));
+    #endif
+    // ============ [FEAT-V26 END] ============
     s_prefs.end();
     
     // Log success
@@ -8,7 +8,7 @@
  * post-mortem de crashes en dispositivos IoT desplegados en campo.
  * 
  * Estrategia de persistencia dual:
- * - RTC Memory: Rápido (~1µs), sobrevive reset/WDT, NO brownout
+ * - RTC Memory (RTC_NOINIT_ATTR + CRC): Rápido (~1µs), sobrevive reset/WDT/panic, NO brownout
  * - NVS: Lento (~1-5ms), sobrevive TODO incluyendo brownout
  * - LittleFS: Historial extendido (32 eventos)
  * 
@@ -104,7 +104,8 @@ enum CrashCheckpoint : uint8_t {
  * @struct CrashContext
  * @brief Contexto de crash almacenado en RTC memory
  * 
- * Esta estructura sobrevive a reset y WDT, pero NO a brownout.
+ * Esta estructura sobrevive a reset, panic y WDT (RTC_NOINIT_ATTR), pero
+ * NO a brownout. Se valida con magic + CRC32 antes de usarla.
  * Se usa para capturar el estado exacto al momento del crash.
  */
 struct CrashContext {
@@ -238,6 +239,13 @@ namespace CrashDiag {
      */
     void syncToNVS();
     
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    /**
+     * @brief Imprimir escrituras NVS hechas y evitadas en este despertar (FEAT-V26)
+     */
+    void printNvsStats();
+    #endif
+    
     // ---- Análisis post-mortem ----
     
     /**
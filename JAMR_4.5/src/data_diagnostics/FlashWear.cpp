@@ -0,0 +1,181 @@
+/**
+ * @file FlashWear.cpp
+ * @brief Implementación de la contabilidad de desgaste de flash
+ * @version FEAT-V29
+ * @date 2026-10-18
+ */
+
+#include "FlashWear.h"
+
+#if ENABLE_FEAT_V29_FLASH_WEAR
+
+#include <LittleFS.h>
+#include <freertos/FreeRTOS.h>
+
+namespace FlashWear {
+
+/** @brief Tamaño de una entrada NVS */
+static const uint32_t NVS_ENTRY_BYTES = 32;
+
+/** @brief Entradas por página NVS de 4 KB (32 B de cabecera + bitmap) */
+static const uint32_t NVS_ENTRIES_PER_PAGE = 126;
+
+/** @brief Nombres para los logs (orden de Sub) */
+static const char* const SUB_NAMES[SUB_COUNT] = {
+  "buffer", "stats", "events", "crashlog", "nvsCrash", "nvsApp"
+};
+
+/**
+ * @brief Contadores de un subsistema en un ciclo
+ * @note En NVS, bytes = entradas * 32 (lo que realmente ocupa la página)
+ */
+struct Counters {
+  uint32_t bytes;       ///< Bytes escritos
+  uint32_t eraseMilli;  ///< Bloques/páginas borrados estimados (milésimas)
+  uint16_t writes;      ///< Sesiones de archivo o puts NVS
+  uint16_t rewrites;    ///< Sesiones "w" (archivo truncado y reescrito)
+};
+
+static Counters s_cycle[SUB_COUNT];
+
+// Acumulados desde el power-on (RTC: sin escrituras de flash propias)
+RTC_DATA_ATTR static Counters s_last[SUB_COUNT];   ///< Último ciclo cerrado (STATS)
+RTC_DATA_ATTR static uint32_t s_cycles = 0;
+RTC_DATA_ATTR static uint64_t s_lfsMilli = 0;
+RTC_DATA_ATTR static uint64_t s_nvsMilli = 0;
+RTC_DATA_ATTR static uint64_t s_bytes = 0;
+RTC_DATA_ATTR static uint32_t s_periodS = 0;
+
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline bool isNvs(uint8_t sub) {
+  return sub == SUB_NVS_CRASH || sub == SUB_NVS_APP;
+}
+
+FileSession::FileSession(Sub sub, const char* mode)
+    : bytes_(0), sub_(sub), rewrite_(mode != nullptr && mode[0] == 'w') {}
+
+FileSession::~FileSession() {
+  if (bytes_ == 0) return;  // Apertura fallida o sin cambios: LittleFS no hace commit
+
+  uint32_t blocks = (bytes_ + FEAT_V29_BLOCK_SIZE - 1) / FEAT_V29_BLOCK_SIZE;
+  uint32_t milli = blocks * 1000UL +
+                   (uint32_t)FEAT_V29_LFS_META_BYTES * 1000UL / FEAT_V29_BLOCK_SIZE;
+
+  portENTER_CRITICAL(&s_mux);
+  Counters& c = s_cycle[sub_];
+  c.bytes += bytes_;
+  c.eraseMilli += milli;
+  c.writes++;
+  if (rewrite_) c.rewrites++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void notePut(Sub sub, size_t bytes) {
+  uint32_t entries = 1;
+  if (bytes > 8) entries += (uint32_t)((bytes + NVS_ENTRY_BYTES - 1) / NVS_ENTRY_BYTES);
+
+  portENTER_CRITICAL(&s_mux);
+  Counters& c = s_cycle[sub];
+  c.bytes += entries * NVS_ENTRY_BYTES;
+  c.writes++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+/** @brief Imprime milésimas como "N.NNN" */
+static void printMilli(uint64_t milli) {
+  Serial.printf("%lu.%03lu", (unsigned long)(milli / 1000), (unsigned long)(milli % 1000));
+}
+
+void endCycle(uint32_t periodS) {
+  Counters cycle[SUB_COUNT];
+  portENTER_CRITICAL(&s_mux);
+  memcpy(cycle, s_cycle, sizeof(cycle));
+  memset(s_cycle, 0, sizeof(s_cycle));
+  portEXIT_CRITICAL(&s_mux);
+
+  uint32_t lfsMilli = 0;
+  uint32_t nvsMilli = 0;
+  uint32_t bytes = 0;
+  Serial.print(F("[FEAT-V29] Flash:"));
+  for (uint8_t i = 0; i < SUB_COUNT; i++) {
+    Counters& c = cycle[i];
+    if (isNvs(i)) {
+      c.eraseMilli = c.bytes * 1000UL / (NVS_ENTRY_BYTES * NVS_ENTRIES_PER_PAGE);
+      nvsMilli += c.eraseMilli;
+    } else {
+      lfsMilli += c.eraseMilli;
+    }
+    bytes += c.bytes;
+    if (c.writes == 0) continue;
+    Serial.printf(" %s %luB x%u", SUB_NAMES[i], (unsigned long)c.bytes, c.writes);
+    if (c.rewrites) Serial.printf(" (w%u)", c.rewrites);
+  }
+  Serial.print(F(" | LFS "));
+  printMilli(lfsMilli);
+  Serial.print(F(" blq, NVS "));
+  printMilli(nvsMilli);
+  Serial.println(F(" pag"));
+
+  memcpy(s_last, cycle, sizeof(s_last));
+  s_cycles++;
+  s_lfsMilli += lfsMilli;
+  s_nvsMilli += nvsMilli;
+  s_bytes += bytes;
+  if (periodS > 0) s_periodS = periodS;
+}
+
+/**
+ * @brief Imprime la vida proyectada de una región con nivelación de desgaste
+ * @param units Bloques o páginas disponibles para rotar
+ * @param milliTotal Borrados acumulados (milésimas) en s_cycles ciclos
+ */
+static void printLife(uint32_t units, uint64_t milliTotal) {
+  if (s_cycles == 0 || milliTotal == 0 || units == 0) {
+    Serial.println(F("sin datos"));
+    return;
+  }
+  // ciclos_vida = unidades * resistencia / (borrados por ciclo)
+  uint64_t lifeCycles = (uint64_t)units * FEAT_V29_ENDURANCE_CYCLES * 1000u *
+                        s_cycles / milliTotal;
+  uint32_t period = s_periodS ? s_periodS : 600;
+  uint64_t years = lifeCycles * period / (86400ULL * 365ULL);
+  Serial.printf("%llu ciclos (~%llu anios)\n",
+                (unsigned long long)lifeCycles, (unsigned long long)years);
+}
+
+void printSummary() {
+  Serial.print(F("║  FLASH (desde power-on, "));
+  Serial.print(s_cycles);
+  Serial.println(F(" ciclos):"));
+
+  for (uint8_t i = 0; i < SUB_COUNT; i++) {
+    const Counters& c = s_last[i];
+    if (c.writes == 0) continue;
+    Serial.printf("║    %-8s %5luB x%u w%u ", SUB_NAMES[i],
+                  (unsigned long)c.bytes, c.writes, c.rewrites);
+    printMilli(c.eraseMilli);
+    Serial.println(isNvs(i) ? F(" pag") : F(" blq"));
+  }
+
+  if (s_cycles > 0) {
+    Serial.print(F("║    Prom/ciclo: "));
+    Serial.print((uint32_t)(s_bytes / s_cycles));
+    Serial.print(F(" B, LFS "));
+    printMilli(s_lfsMilli / s_cycles);
+    Serial.print(F(" blq, NVS "));
+    printMilli(s_nvsMilli / s_cycles);
+    Serial.println(F(" pag"));
+  }
+
+  Serial.print(F("║    Vida LittleFS: "));
+  printLife((uint32_t)(LittleFS.totalBytes() / FEAT_V29_BLOCK_SIZE), s_lfsMilli);
+  Serial.print(F("║    Vida NVS: "));
+  // NVS reserva una página libre para la recolección
+  uint32_t nvsPages = FEAT_V29_NVS_PARTITION_BYTES / FEAT_V29_BLOCK_SIZE;
+  printLife(nvsPages > 1 ? nvsPages - 1 : 0, s_nvsMilli);
+}
+
+}  // namespace FlashWear
+
+#endif  // ENABLE_FEAT_V29_FLASH_WEAR
@@ -0,0 +1,111 @@
+/**
+ * @file FlashWear.h
+ * @brief Contabilidad de desgaste de flash por subsistema (LittleFS y NVS)
+ * @version FEAT-V29
+ * @date 2026-10-18
+ *
+ * USO:
+ *   File f = LittleFS.open(path, "w");
+ *   FLASH_WEAR_FILE(fw, SUB_STATS, "w");       - Sesión de escritura hasta el fin del bloque
+ *   FLASH_WEAR_ADD(fw, f.write(buf, len));     - Cuenta los bytes devueltos y los retorna
+ *   prefs.putUChar("k", v);
+ *   FLASH_WEAR_NVS(SUB_NVS_APP, sizeof(uint8_t));  - Cuenta un put de Preferences
+ *
+ * MODELO DE BORRADO (estimación, no lectura del driver):
+ *   LittleFS es copy-on-write: cada sesión con bytes escritos reescribe al
+ *   menos un bloque de 4 KB (ceil(bytes / bloque)) más un commit de metadatos
+ *   (FEAT_V29_LFS_META_BYTES dentro de un par de bloques). Una sesión "w"
+ *   cuenta además como archivo reescrito.
+ *   NVS escribe entradas de 32 bytes (1 para enteros, 1 + ceil(len / 32) para
+ *   strings/blobs) y borra una página de 4 KB cada 126 entradas.
+ *   Un put con el mismo valor cuenta igual: la cifra es una cota superior.
+ *
+ * Los contadores del ciclo viven en RAM; los acumulados desde el power-on en
+ * RTC_DATA_ATTR, así la contabilidad no escribe flash.
+ *
+ * OVERHEAD:
+ *   Con ENABLE_FEAT_V29_FLASH_WEAR = 0 las macros se expanden a la expresión
+ *   original o a nada.
+ */
+
+#ifndef FLASH_WEAR_H
+#define FLASH_WEAR_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+
+#if ENABLE_FEAT_V29_FLASH_WEAR
+
+namespace FlashWear {
+
+/**
+ * @brief Subsistemas que escriben flash
+ */
+enum Sub : uint8_t {
+  SUB_BUFFER = 0,   ///< BUFFERModule (buffer.txt)
+  SUB_STATS,        ///< ProdDiag::saveStats() (/diag/stats.bin)
+  SUB_EVENTS,       ///< Eventos ProdDiag (events.txt / events.bin)
+  SUB_CRASHLOG,     ///< CrashDiag (crash_log.bin + índice)
+  SUB_NVS_CRASH,    ///< Preferences "crash_diag"
+  SUB_NVS_APP,      ///< Preferences "sensores"
+  SUB_COUNT
+};
+
+/**
+ * @brief Sesión de escritura sobre un archivo abierto (RAII)
+ *
+ * Acumula los bytes de varias escrituras y las contabiliza al cerrarse el
+ * bloque, porque LittleFS reescribe el bloque una vez por sesión, no por
+ * cada print().
+ */
+class FileSession {
+ public:
+  FileSession(Sub sub, const char* mode);
+  ~FileSession();
+
+  FileSession(const FileSession&) = delete;
+  FileSession& operator=(const FileSession&) = delete;
+
+  /** @brief Suma bytes escritos y los devuelve sin modificar */
+  size_t add(size_t bytes) { bytes_ += bytes; return bytes; }
+
+ private:
+  uint32_t bytes_;
+  Sub sub_;
+  bool rewrite_;
+};
+
+/**
+ * @brief Contabiliza un put de Preferences.
+ * @param sub SUB_NVS_CRASH o SUB_NVS_APP.
+ * @param bytes Tamaño del valor (strlen + 1 para strings).
+ */
+void notePut(Sub sub, size_t bytes);
+
+/**
+ * @brief Imprime la línea del ciclo, acumula en RTC y reinicia el ciclo.
+ * @param periodS Período nominal del ciclo en segundos (proyección de vida).
+ * @note Llamar una vez antes del deep sleep, después del último write.
+ */
+void endCycle(uint32_t periodS);
+
+/**
+ * @brief Sección FLASH del comando STATS: ciclo anterior, promedio y vida.
+ */
+void printSummary();
+
+}  // namespace FlashWear
+
+#define FLASH_WEAR_FILE(var, sub, mode) FlashWear::FileSession var(FlashWear::sub, mode)
+#define FLASH_WEAR_ADD(var, expr) ((var).add(expr))
+#define FLASH_WEAR_NVS(sub, bytes) FlashWear::notePut(FlashWear::sub, bytes)
+
+#else
+
+#define FLASH_WEAR_FILE(var, sub, mode) do {} while (0)
+#define FLASH_WEAR_ADD(var, expr) (expr)
+#define FLASH_WEAR_NVS(sub, bytes) do {} while (0)
+
+#endif  // ENABLE_FEAT_V29_FLASH_WEAR
+
+#endif  // FLASH_WEAR_H
@@ -0,0 +1,324 @@
+/**
+ * @file MicroBench.cpp
+ * @brief Implementación de los micro-benchmarks (FEAT-V33)
+ * @version FEAT-V33
+ * @date 2026-10-18
+ */
+
+#include "MicroBench.h"
+
+#if ENABLE_FEAT_V33_MICRO_BENCH
+
+#include <esp_timer.h>
+#if ENABLE_FIX_V5_WATCHDOG
+#include <esp_task_wdt.h>
+#endif
+
+#include "ProductionDiag.h"
+#include "../version_info.h"
+#include "../data_format/FORMATModule.h"
+#include "../data_lte/LTEModule.h"
+#include "../data_gps/GPSModule.h"
+#include "../data_buffer/BUFFERModule.h"
+#include "../data_buffer/config_data_buffer.h"
+
+namespace MicroBench {
+
+// ============================================================
+// ENTRADAS FIJAS
+// ============================================================
+
+static const uint16_t CRC_BYTES = 256;      ///< Bloque del orden de ProductionStats
+static const uint8_t BUFFER_LINES = 20;     ///< Líneas del archivo de buffer
+static const uint8_t REPEATS_MAX = 15;
+
+static const char CPSI_LINE[] =
+    "+CPSI: LTE CAT-M1,Online,334-020,0x2A1F,27446123,318,EUTRAN-BAND2,900,5,5,-11,-95,-65,12\r\n";
+
+static const char CGNSINF_LINE[] =
+    "+CGNSINF: 1,1,20261018120000.000,19.432608,-99.133209,2240.000,0.00,0.0,1,,1.1,1.4,0.9,,12,8,,,42,,";
+
+/** @brief Estado de los kernels (en el heap durante run(), fuera de la medida) */
+struct Fixture {
+  FormatModule format;
+  LTEModule lte;
+  GPSModule gps;
+  BUFFERModule buffer;
+  char frame[FRAME_MAX_LEN];
+  size_t frameLen;
+  char b64[FRAME_BASE64_MAX_LEN];
+  String cpsi;
+  uint8_t crcData[CRC_BYTES];
+  String lines[BUFFER_LINES];
+  volatile uint32_t sink;   ///< Los resultados se acumulan aquí para que el compilador no los descarte
+
+  Fixture() : lte(Serial1), gps(Serial1, GPS_PWRKEY_PIN), buffer(FEAT_V33_BENCH_FILE) {}
+};
+
+static Fixture* s_fx = nullptr;
+
+/** @brief Archivo de buffer: BUFFER_LINES tramas, las pares ya procesadas */
+static uint32_t writeBufferFile() {
+  File f = LittleFS.open(FEAT_V33_BENCH_FILE, "w");
+  if (!f) return 0;
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < BUFFER_LINES; i++) {
+    if ((i & 1) == 0) n += f.print(PROCESSED_MARKER);
+    n += f.println(s_fx->b64);
+  }
+  f.close();
+  return n;
+}
+
+// ============================================================
+// KERNELS
+// ============================================================
+
+/**
+ * @brief Un kernel: setup() una vez (devuelve bytes de entrada por operación,
+ *        0 = no se pudo preparar); prepare() antes de cada operación, fuera
+ *        de la medida (nullptr = tanda continua); op() es lo medido.
+ */
+struct Kernel {
+  const char* name;
+  uint16_t iters;
+  uint32_t (*setup)();
+  uint32_t (*prepare)();
+  bool (*op)();
+};
+
+static uint32_t setupFormat() {
+  Sample sample;
+  sample.clear();
+  sample.epoch = 1792324800UL;
+  strcpy(sample.iccid, "89520201234567890123");
+  static const int32_t VARS[VAR_COUNT] = {245, 1013, 3712, 5520, 2417, 881, 4095};
+  for (uint8_t i = 0; i < VAR_COUNT; i++) sample.var[i] = VARS[i];
+
+  s_fx->format.reset();
+  s_fx->format.setSample(sample);
+  s_fx->format.setLat("19.432608");
+  s_fx->format.setLng("-99.133209");
+  s_fx->format.setAlt("2240");
+  if (!s_fx->format.buildFrame(s_fx->frame, sizeof(s_fx->frame))) return 0;
+  if (!s_fx->format.buildFrameBase64(s_fx->b64, sizeof(s_fx->b64))) return 0;
+  s_fx->frameLen = strlen(s_fx->frame);
+  return (uint32_t)s_fx->frameLen;
+}
+
+static bool opBuildFrame() {
+  bool ok = s_fx->format.buildFrame(s_fx->frame, sizeof(s_fx->frame));
+  s_fx->sink += (uint8_t)s_fx->frame[FRAME_MAX_LEN / 2];
+  return ok;
+}
+
+static bool opFrameBase64() {
+  bool ok = s_fx->format.buildFrameBase64(s_fx->b64, sizeof(s_fx->b64));
+  s_fx->sink += (uint8_t)s_fx->b64[0];
+  return ok;
+}
+
+static bool opEncodeBase64() {
+  size_t n = FormatModule::encodeBase64(reinterpret_cast<const uint8_t*>(s_fx->frame), s_fx->frameLen,
+                                        s_fx->b64, sizeof(s_fx->b64));
+  s_fx->sink += n;
+  return n > 0;
+}
+
+static uint32_t setupCpsi() {
+  s_fx->cpsi = CPSI_LINE;
+  return (uint32_t)s_fx->cpsi.length();
+}
+
+static bool opParseCpsi() {
+  SignalQuality sq = s_fx->lte.parseSignalQuality(s_fx->cpsi);  // Por valor, como en el firmware
+  s_fx->sink += (uint32_t)sq.score;
+  return sq.valid;
+}
+
+static uint32_t setupCgnsinf() { return (uint32_t)strlen(CGNSINF_LINE); }
+
+static bool opParseCgnsinf() {
+  GpsFix fix;
+  bool ok = s_fx->gps.parseCgnsinf(CGNSINF_LINE, fix) && fix.hasFix;
+  s_fx->sink += (uint32_t)fix.altitude;
+  return ok;
+}
+
+static uint32_t setupCrc() {
+  for (uint16_t i = 0; i < CRC_BYTES; i++) s_fx->crcData[i] = (uint8_t)(i * 31 + 7);
+  return CRC_BYTES;
+}
+
+static bool opCrc() {
+  s_fx->sink += ProdDiag::calculateCRC16(s_fx->crcData, CRC_BYTES);
+  return true;
+}
+
+static uint32_t setupBuffer() {
+  if (setupFormat() == 0 || !s_fx->buffer.begin()) return 0;
+  return writeBufferFile();
+}
+
+static bool opReadPending() {
+  int count = 0;
+  bool ok = s_fx->buffer.readUnprocessedLines(s_fx->lines, BUFFER_LINES, count);
+  s_fx->sink += (uint32_t)count;
+  return ok && count == BUFFER_LINES / 2;
+}
+
+static bool opCompact() { return s_fx->buffer.removeProcessedLines(); }
+
+static const Kernel KERNELS[KERNEL_COUNT] = {
+  {"format.buildFrame",   500, setupFormat,  nullptr,         opBuildFrame},
+  {"format.frameBase64",  500, setupFormat,  nullptr,         opFrameBase64},
+  {"format.encodeBase64", 1000, setupFormat, nullptr,         opEncodeBase64},
+  {"lte.parseCpsi",       200, setupCpsi,    nullptr,         opParseCpsi},
+  {"gps.parseCgnsinf",    500, setupCgnsinf, nullptr,         opParseCgnsinf},
+  {"crc16.modbus",        200, setupCrc,     nullptr,         opCrc},
+  {"buffer.readPending",  10,  setupBuffer,  nullptr,         opReadPending},
+  {"buffer.compact",      5,   setupBuffer,  writeBufferFile, opCompact},
+};
+
+// ============================================================
+// MEDIDA
+// ============================================================
+
+/** @brief Una repetición (tanda) de un kernel */
+struct Batch {
+  uint64_t ns;
+  uint32_t cycles;
+  uint64_t allocBytes;
+  uint64_t allocs;
+  uint64_t micros;
+  bool ok;
+};
+
+static uint64_t allocBytesNow(const Probes& p) { return p.allocBytes ? p.allocBytes() : 0; }
+static uint64_t allocCountNow(const Probes& p) { return p.allocCount ? p.allocCount() : 0; }
+
+static Batch measure(const Kernel& k, const Probes& p) {
+  Batch s = {0, 0, 0, 0, 0, true};
+  if (k.prepare == nullptr) {
+    uint64_t a0 = allocBytesNow(p), c0 = allocCountNow(p);
+    uint64_t m0 = micros();
+    uint64_t t0 = p.ns();
+    uint32_t y0 = p.cycles();
+    for (uint16_t i = 0; i < k.iters; i++) s.ok &= k.op();
+    s.cycles = p.cycles() - y0;
+    s.ns = p.ns() - t0;
+    s.micros = micros() - m0;
+    s.allocBytes = allocBytesNow(p) - a0;
+    s.allocs = allocCountNow(p) - c0;
+    return s;
+  }
+  for (uint16_t i = 0; i < k.iters; i++) {
+    s.ok &= k.prepare() > 0;
+    uint64_t a0 = allocBytesNow(p), c0 = allocCountNow(p);
+    uint64_t m0 = micros();
+    uint64_t t0 = p.ns();
+    uint32_t y0 = p.cycles();
+    s.ok &= k.op();
+    s.cycles += p.cycles() - y0;
+    s.ns += p.ns() - t0;
+    s.micros += micros() - m0;
+    s.allocBytes += allocBytesNow(p) - a0;
+    s.allocs += allocCountNow(p) - c0;
+  }
+  return s;
+}
+
+/** @brief Mediana in-place (n pequeño: inserción) */
+template <typename T>
+static T median(T* v, uint8_t n) {
+  for (uint8_t i = 1; i < n; i++) {
+    T x = v[i];
+    int8_t j = (int8_t)i - 1;
+    while (j >= 0 && v[j] > x) {
+      v[j + 1] = v[j];
+      j--;
+    }
+    v[j + 1] = x;
+  }
+  return v[n / 2];
+}
+
+size_t run(const Probes& probes, Result* out, uint8_t repeats) {
+  if (repeats == 0) repeats = 1;
+  if (repeats > REPEATS_MAX) repeats = REPEATS_MAX;
+
+  s_fx = new Fixture();
+  size_t count = 0;
+  for (const Kernel& k : KERNELS) {
+    #if ENABLE_FIX_V5_WATCHDOG
+    esp_task_wdt_reset();
+    #endif
+    Result& r = out[count++];
+    memset(&r, 0, sizeof(r));
+    r.name = k.name;
+    r.iters = k.iters;
+    r.bytes = k.setup();
+    r.ok = r.bytes > 0;
+    if (!r.ok) continue;
+
+    (void)measure(k, probes);  // Calentamiento: caché, primera apertura del archivo
+    uint64_t ns[REPEATS_MAX];
+    uint32_t cycles[REPEATS_MAX];
+    Batch s = {};
+    for (uint8_t i = 0; i < repeats; i++) {
+      s = measure(k, probes);
+      r.ok &= s.ok;
+      ns[i] = s.ns;
+      cycles[i] = s.cycles;
+    }
+    // Heap y micros() son deterministas: la última repetición alcanza
+    r.nsPerOp = (double)median(ns, repeats) / k.iters;
+    r.cyclesPerByte = (double)median(cycles, repeats) / k.iters / r.bytes;
+    r.allocBytesPerOp = probes.allocBytes ? (double)s.allocBytes / k.iters : -1.0;
+    r.allocsPerOp = probes.allocCount ? (double)s.allocs / k.iters : -1.0;
+    r.microsPerOp = (double)s.micros / k.iters;
+  }
+  LittleFS.remove(FEAT_V33_BENCH_FILE);
+  delete s_fx;
+  s_fx = nullptr;
+  return count;
+}
+
+// ============================================================
+// PLATAFORMA Y SALIDA
+// ============================================================
+
+static uint64_t deviceNs() { return (uint64_t)esp_timer_get_time() * 1000ULL; }
+static uint32_t deviceCycles() { return ESP.getCycleCount(); }
+
+Probes deviceProbes() {
+  Probes p = {deviceNs, deviceCycles, nullptr, nullptr};
+  return p;
+}
+
+void printTable(Print* out, const Result* results, size_t count) {
+  out->printf("%-20s %6s %6s %12s %9s %9s %9s\n", "kernel", "B", "iters", "ns/op", "cyc/B", "B/op", "allocs/op");
+  for (size_t i = 0; i < count; i++) {
+    const Result& r = results[i];
+    if (!r.ok) {
+      out->printf("%-20s FALLÓ\n", r.name);
+      continue;
+    }
+    out->printf("%-20s %6lu %6lu %12.1f %9.2f", r.name, (unsigned long)r.bytes, (unsigned long)r.iters,
+                r.nsPerOp, r.cyclesPerByte);
+    if (r.allocBytesPerOp < 0) out->printf(" %9s %9s\n", "-", "-");
+    else out->printf(" %9.1f %9.2f\n", r.allocBytesPerOp, r.allocsPerOp);
+  }
+}
+
+void runAndPrint(Print* out) {
+  out->printf("[FEAT-V33] BENCH v%s, %u repeticiones, %lu MHz\n", FW_VERSION_STRING, (unsigned)FEAT_V33_REPEATS,
+              (unsigned long)ESP.getCpuFreqMHz());
+  Result results[KERNEL_COUNT];
+  size_t n = run(deviceProbes(), results);
+  printTable(out, results, n);
+}
+
+} // namespace MicroBench
+
+#endif // ENABLE_FEAT_V33_MICRO_BENCH
@@ -0,0 +1,100 @@
+/**
+ * @file MicroBench.h
+ * @brief Micro-benchmarks deterministas de los caminos calientes (trama, Base64, parseo, CRC, buffer)
+ * @version FEAT-V33
+ * @date 2026-10-18
+ *
+ * Mide con entradas fijas:
+ *   format.buildFrame     FormatModule::buildFrame()
+ *   format.frameBase64    FormatModule::buildFrameBase64()
+ *   format.encodeBase64   FormatModule::encodeBase64() sobre la trama
+ *   lte.parseCpsi         LTEModule::parseSignalQuality() (respuesta AT+CPSI?)
+ *   gps.parseCgnsinf      GPSModule::parseCgnsinf()
+ *   crc16.modbus          ProdDiag::calculateCRC16() (mismo algoritmo que crc16() de 4.4)
+ *   buffer.readPending    BUFFERModule::readUnprocessedLines() con 20 líneas, 10 pendientes
+ *   buffer.compact        BUFFERModule::removeProcessedLines() sobre el mismo archivo
+ *
+ * Los kernels de buffer usan FEAT_V33_BENCH_FILE, nunca /buffer.txt. Sus
+ * escrituras cuentan en FlashWear (SUB_BUFFER) como cualquier otra.
+ *
+ * MEDIDAS (por kernel, mediana de FEAT_V33_REPEATS repeticiones):
+ *   ns/op     Tiempo por operación
+ *   cyc/B     Ciclos de CPU por byte de entrada (ESP32: CCOUNT a 240 MHz)
+ *   B/op      Bytes pedidos al heap por operación (solo si la plataforma
+ *             los cuenta; en el ESP32 no, se imprime "-")
+ *   allocs/op Asignaciones por operación
+ *
+ * USO:
+ *   Comando Serial "BENCH" (FEAT-V9)   - Corre todo en el equipo (~2 s)
+ *   tools/bench/jamr_bench.cpp          - Mismos kernels en el host, con
+ *                                         conteo de heap y línea base
+ *
+ * Las medidas no son del ciclo: no se corre sola ni escribe en ProductionStats.
+ */
+
+#ifndef MICRO_BENCH_H
+#define MICRO_BENCH_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+
+#if ENABLE_FEAT_V33_MICRO_BENCH
+
+#if !ENABLE_FEAT_V7_PRODUCTION_DIAG
+#error "FEAT-V33 requiere FEAT-V7 (ProdDiag::calculateCRC16)"
+#endif
+
+namespace MicroBench {
+
+/** @brief Cantidad de kernels */
+static const size_t KERNEL_COUNT = 8;
+
+/**
+ * @brief Fuentes de medida de la plataforma
+ *
+ * cycles() se resta en 32 bits: una tanda no debe pasar de 2^32 ciclos
+ * (17 s en el ESP32 a 240 MHz).
+ */
+struct Probes {
+  uint64_t (*ns)();             ///< Reloj monotónico en ns
+  uint32_t (*cycles)();         ///< Contador de ciclos
+  uint64_t (*allocBytes)();     ///< Bytes pedidos al heap acumulados; nullptr = no disponible
+  uint64_t (*allocCount)();     ///< Asignaciones acumuladas
+};
+
+/** @brief Resultado de un kernel */
+struct Result {
+  const char* name;
+  uint32_t bytes;               ///< Bytes de entrada por operación
+  uint32_t iters;               ///< Operaciones por repetición
+  double nsPerOp;
+  double cyclesPerByte;
+  double allocBytesPerOp;       ///< < 0 si la plataforma no cuenta el heap
+  double allocsPerOp;
+  double microsPerOp;           ///< micros() por operación (en el host: tiempo virtual del simulador)
+  bool ok;                      ///< false si el kernel falló (resultado no comparable)
+};
+
+/** @brief Probes del ESP32: esp_timer, ESP.getCycleCount(), sin conteo de heap */
+Probes deviceProbes();
+
+/**
+ * @brief Corre todos los kernels.
+ * @param probes Fuentes de medida.
+ * @param out Resultados (al menos KERNEL_COUNT).
+ * @param repeats Repeticiones por kernel (se informa la mediana).
+ * @return Kernels corridos.
+ */
+size_t run(const Probes& probes, Result* out, uint8_t repeats = FEAT_V33_REPEATS);
+
+/** @brief Tabla de resultados */
+void printTable(Print* out, const Result* results, size_t count);
+
+/** @brief Comando Serial BENCH: run(deviceProbes()) + printTable() */
+void runAndPrint(Print* out);
+
+} // namespace MicroBench
+
+#endif // ENABLE_FEAT_V33_MICRO_BENCH
+
+#endif // MICRO_BENCH_H
@@ -7,6 +7,9 @@
 
 #include "ProductionDiag.h"
 #include <LittleFS.h>
+#include "../FeatureFlags.h"
+#include "../TraceSpan.h"  // FEAT-V23
+#include "FlashWear.h"      // FEAT-V29
 
 // ============================================================
 // VARIABLES GLOBALES (internas al módulo)
@@ -17,11 +20,155 @@ static CycleEMIStats g_cycleEMI;
 static bool g_initialized = false;
 static uint32_t g_lastKnownEpoch = 0;
 
+// ============ [FEAT-V25 START] Ring binario de eventos ============
+#if ENABLE_FEAT_V25_EVENT_RING
+/**
+ * @brief Cabecera de /diag/events.bin (16 bytes)
+ *
+ * El archivo se preasigna completo: cabecera + FEAT_V25_EVENT_SLOTS
+ * registros. Agregar un evento escribe un slot y la cabecera, sin leer
+ * ni reescribir el resto del archivo.
+ */
+struct EventRingHeader {
+    uint32_t magic;      ///< FEAT_V25_RING_MAGIC
+    uint8_t  version;    ///< Formato del archivo
+    uint8_t  recSize;    ///< sizeof(EventRecord)
+    uint16_t slots;      ///< Capacidad (debe coincidir con FEAT_V25_EVENT_SLOTS)
+    uint16_t head;       ///< Próximo slot a escribir
+    uint16_t count;      ///< Slots válidos
+    uint32_t reserved;
+};
+
+/** @brief Evento en el ring (8 bytes) */
+struct EventRecord {
+    uint32_t epoch;
+    char     code;       ///< EVT_*
+    uint8_t  reserved;
+    uint16_t data;
+};
+
+static_assert(sizeof(EventRingHeader) == 16, "EventRingHeader debe ocupar 16 bytes");
+static_assert(sizeof(EventRecord) == 8, "EventRecord debe ocupar 8 bytes");
+
+static const uint8_t RING_VERSION = 1;
+
+/** @brief Cabecera en RAM (evita releerla en cada evento) */
+static EventRingHeader g_ring;
+
+static bool ringHeaderValid(const EventRingHeader& h) {
+    return h.magic == FEAT_V25_RING_MAGIC && h.version == RING_VERSION &&
+           h.recSize == sizeof(EventRecord) && h.slots == FEAT_V25_EVENT_SLOTS &&
+           h.head < h.slots && h.count <= h.slots;
+}
+
+/** @brief Posición en el archivo del slot i */
+static inline uint32_t ringSlotOffset(uint16_t slot) {
+    return sizeof(EventRingHeader) + (uint32_t)slot * sizeof(EventRecord);
+}
+
+/**
+ * @brief Crea el archivo con todos los slots en cero (única escritura de tamaño completo)
+ */
+static bool ringFormat() {
+    File f = LittleFS.open(FEAT_V25_EVENTS_FILE, "w");
+    if (!f) return false;
+    FLASH_WEAR_FILE(fw, SUB_EVENTS, "w");  // FEAT-V29
+
+    memset(&g_ring, 0, sizeof(g_ring));
+    g_ring.magic = FEAT_V25_RING_MAGIC;
+    g_ring.version = RING_VERSION;
+    g_ring.recSize = sizeof(EventRecord);
+    g_ring.slots = FEAT_V25_EVENT_SLOTS;
+    FLASH_WEAR_ADD(fw, f.write((const uint8_t*)&g_ring, sizeof(g_ring)));
+
+    EventRecord empty;
+    memset(&empty, 0, sizeof(empty));
+    for (uint16_t i = 0; i < FEAT_V25_EVENT_SLOTS; i++) {
+        FLASH_WEAR_ADD(fw, f.write((const uint8_t*)&empty, sizeof(empty)));
+    }
+    size_t size = f.size();
+    f.close();
+    return size == ringSlotOffset(FEAT_V25_EVENT_SLOTS);
+}
+
+/**
+ * @brief Escribe un registro en el slot head y avanza la cabecera (O(1))
+ * @note Si se corta la energía entre ambas escrituras, el evento se pierde
+ *       y el slot se reutiliza: el ring nunca queda inconsistente.
+ */
+static bool ringAppend(const EventRecord& rec) {
+    File f = LittleFS.open(FEAT_V25_EVENTS_FILE, "r+");
+    if (!f) return false;
+    FLASH_WEAR_FILE(fw, SUB_EVENTS, "r+");  // FEAT-V29
+
+    bool ok = f.seek(ringSlotOffset(g_ring.head)) &&
+              FLASH_WEAR_ADD(fw, f.write((const uint8_t*)&rec, sizeof(rec))) == sizeof(rec);
+    if (ok) {
+        g_ring.head = (uint16_t)((g_ring.head + 1) % g_ring.slots);
+        if (g_ring.count < g_ring.slots) g_ring.count++;
+        ok = f.seek(0) &&
+             FLASH_WEAR_ADD(fw, f.write((const uint8_t*)&g_ring, sizeof(g_ring))) == sizeof(g_ring);
+    }
+    f.close();
+    return ok;
+}
+
+/**
+ * @brief Importa events.txt (formato epoch,código,dato) al ring y lo borra
+ */
+static void ringMigrateText() {
+    if (!LittleFS.exists(PROD_DIAG_EVENTS_FILE)) return;
+
+    File f = LittleFS.open(PROD_DIAG_EVENTS_FILE, "r");
+    uint16_t imported = 0;
+    while (f && f.available()) {
+        String line = f.readStringUntil('\n');
+        int c1 = line.indexOf(',');
+        int c2 = line.indexOf(',', c1 + 1);
+        if (c1 <= 0 || c2 != c1 + 2) continue;
+        EventRecord rec;
+        rec.epoch = (uint32_t)strtoul(line.c_str(), nullptr, 10);
+        rec.code = line.charAt(c1 + 1);
+        rec.reserved = 0;
+        rec.data = (uint16_t)line.substring(c2 + 1).toInt();
+        if (ringAppend(rec)) imported++;
+    }
+    if (f) f.close();
+    LittleFS.remove(PROD_DIAG_EVENTS_FILE);
+    Serial.printf("[FEAT-V25] events.txt migrado al ring: %u eventos\n", (unsigned)imported);
+}
+
+/**
+ * @brief Carga la cabecera; formatea si falta o no es válida
+ */
+static bool ringInit() {
+    bool valid = false;
+    File f = LittleFS.open(FEAT_V25_EVENTS_FILE, "r");
+    if (f) {
+        valid = f.read((uint8_t*)&g_ring, sizeof(g_ring)) == sizeof(g_ring) &&
+                ringHeaderValid(g_ring) &&
+                f.size() == ringSlotOffset(FEAT_V25_EVENT_SLOTS);
+        f.close();
+    }
+    if (!valid) {
+        if (!ringFormat()) {
+            Serial.println(F("[ERROR][DIAG] No se pudo crear events.bin"));
+            return false;
+        }
+        Serial.println(F("[FEAT-V25] events.bin creado"));
+    }
+    ringMigrateText();
+    return true;
+}
+#endif
+// ============ [FEAT-V25 END] ============
+
 // ============================================================
 // IMPLEMENTACIÓN - INICIALIZACIÓN
 // ============================================================
 
 bool ProdDiag::init() {
+    TRACE_SPAN("fs.diag.init");
     // Crear directorio si no existe
     if (!LittleFS.exists(PROD_DIAG_DIR)) {
         if (!LittleFS.mkdir(PROD_DIAG_DIR)) {
@@ -40,6 +187,12 @@ bool ProdDiag::init() {
         Serial.println(F("[INFO][DIAG] Estadísticas inicializadas (primera vez)"));
     }
     
+    // ============ [FEAT-V25 START] Ring binario de eventos ============
+    #if ENABLE_FEAT_V25_EVENT_RING
+    ringInit();
+    #endif
+    // ============ [FEAT-V25 END] ============
+    
     // Resetear contadores de ciclo
     g_stats.cyclesSinceBoot = 0;
     resetCycleEMI();
@@ -120,6 +273,54 @@ void ProdDiag::recordCrash(uint8_t checkpoint) {
 // IMPLEMENTACIÓN - EMI DETECTION
 // ============================================================
 
+// ============ [FEAT-V28 START] Marcas de memoria del ciclo ============
+#if ENABLE_FEAT_V28_MEM_WATERMARKS
+/** @brief Actualiza un mínimo persistido en unidades de 16 bytes (0 = sin datos) */
+static void updateMin16(uint16_t& field, uint32_t bytes) {
+    uint32_t v = bytes / 16;
+    if (v == 0) v = 1;
+    if (v > UINT16_MAX) v = UINT16_MAX;
+    if (field == 0 || v < field) field = (uint16_t)v;
+}
+
+void ProdDiag::recordMemWatermarks(uint32_t minHeap, uint8_t heapPhase,
+                                   uint32_t minBlock, uint8_t blockPhase,
+                                   uint16_t minStack, uint8_t stackPhase) {
+    if (!g_initialized) return;
+    
+    uint16_t prevHeap = g_stats.memMinFreeHeap16;
+    updateMin16(g_stats.memMinFreeHeap16, minHeap);
+    if (g_stats.memMinFreeHeap16 != prevHeap) {
+        g_stats.memWorstPhase = heapPhase;
+    }
+    updateMin16(g_stats.memMinBlock16, minBlock);
+    if (g_stats.memMinStackFree == 0 || minStack < g_stats.memMinStackFree) {
+        g_stats.memMinStackFree = minStack;
+    }
+    
+    // Un evento por tipo y ciclo: el ring de eventos no se inunda
+    bool alarm = false;
+    if (minHeap < FEAT_V28_HEAP_ALARM_BYTES) {
+        logEvent(EVT_MEM_ALARM, (MEM_ALARM_HEAP << 8) | heapPhase);
+        alarm = true;
+    }
+    if (minBlock < FEAT_V28_BLOCK_ALARM_BYTES) {
+        logEvent(EVT_MEM_ALARM, (MEM_ALARM_BLOCK << 8) | blockPhase);
+        alarm = true;
+    }
+    if (minStack < FEAT_V28_STACK_ALARM_BYTES) {
+        logEvent(EVT_MEM_ALARM, (MEM_ALARM_STACK << 8) | stackPhase);
+        alarm = true;
+    }
+    if (alarm) {
+        Serial.printf("[FEAT-V28] ALARMA memoria: heap %lu B, bloque %lu B, stack %u B\n",
+                      (unsigned long)minHeap, (unsigned long)minBlock, (unsigned)minStack);
+        if (g_stats.memAlarms < 255) g_stats.memAlarms++;
+    }
+}
+#endif
+// ============ [FEAT-V28 END] ============
+
 void ProdDiag::resetCycleEMI() {
     memset(&g_cycleEMI, 0, sizeof(g_cycleEMI));
 }
@@ -169,8 +370,7 @@ void ProdDiag::evaluateCycleEMI() {
 // IMPLEMENTACIÓN - PERSISTENCIA
 // ============================================================
 
-uint16_t ProdDiag::calculateCRC16(const uint8_t* data, size_t len) {
-    uint16_t crc = 0xFFFF;
+uint16_t ProdDiag::calculateCRC16(const uint8_t* data, size_t len, uint16_t crc) {
     for (size_t i = 0; i < len; i++) {
         crc ^= data[i];
         for (uint8_t j = 0; j < 8; j++) {
@@ -185,6 +385,7 @@ uint16_t ProdDiag::calculateCRC16(const uint8_t* data, size_t len) {
 }
 
 bool ProdDiag::saveStats(uint32_t epoch) {
+    TRACE_SPAN("fs.diag.save");
     if (!g_initialized) return false;
     
     // Actualizar timestamp si se proporciona
@@ -209,7 +410,8 @@ bool ProdDiag::saveStats(uint32_t epoch) {
         return false;
     }
     
-    size_t written = f.write((uint8_t*)&g_stats, sizeof(ProductionStats));
+    FLASH_WEAR_FILE(fw, SUB_STATS, "w");  // FEAT-V29
+    size_t written = FLASH_WEAR_ADD(fw, f.write((uint8_t*)&g_stats, sizeof(ProductionStats)));
     f.close();
     
     if (written != sizeof(ProductionStats)) {
@@ -221,6 +423,7 @@ bool ProdDiag::saveStats(uint32_t epoch) {
 }
 
 bool ProdDiag::loadStats() {
+    TRACE_SPAN("fs.diag.load");
     if (!LittleFS.exists(PROD_DIAG_STATS_FILE)) {
         return false;
     }
@@ -276,10 +479,22 @@ void ProdDiag::setCurrentEpoch(uint32_t epoch) {
 // ============================================================
 
 void ProdDiag::logEvent(char eventCode, uint16_t data, uint32_t epoch) {
+    TRACE_SPAN("fs.diag.event");
     if (!g_initialized) return;
     
     uint32_t ts = (epoch > 0) ? epoch : g_lastKnownEpoch;
     
+    // ============ [FEAT-V25 START] Append O(1) al ring ============
+    #if ENABLE_FEAT_V25_EVENT_RING
+    EventRecord rec;
+    rec.epoch = ts;
+    rec.code = eventCode;
+    rec.reserved = 0;
+    rec.data = data;
+    if (g_ring.slots == 0 || !ringAppend(rec)) {
+        Serial.println(F("[ERROR][DIAG] No se pudo escribir events.bin"));
+    }
+    #else
     // Verificar tamaño del archivo antes de escribir
     if (LittleFS.exists(PROD_DIAG_EVENTS_FILE)) {
         File check = LittleFS.open(PROD_DIAG_EVENTS_FILE, "r");
@@ -304,7 +519,8 @@ void ProdDiag::logEvent(char eventCode, uint16_t data, uint32_t epoch) {
                         // Reescribir archivo
                         File fw = LittleFS.open(PROD_DIAG_EVENTS_FILE, "w");
                         if (fw) {
-                            fw.print(trimmed);
+                            FLASH_WEAR_FILE(fwTrim, SUB_EVENTS, "w");  // FEAT-V29
+                            FLASH_WEAR_ADD(fwTrim, fw.print(trimmed));
                             fw.close();
                         }
                     }
@@ -321,12 +537,15 @@ void ProdDiag::logEvent(char eventCode, uint16_t data, uint32_t epoch) {
     }
     
     // Formato: epoch,código,dato
-    f.print(ts);
-    f.print(',');
-    f.print(eventCode);
-    f.print(',');
-    f.println(data);
+    FLASH_WEAR_FILE(fw, SUB_EVENTS, "a");  // FEAT-V29
+    FLASH_WEAR_ADD(fw, f.print(ts));
+    FLASH_WEAR_ADD(fw, f.print(','));
+    FLASH_WEAR_ADD(fw, f.print(eventCode));
+    FLASH_WEAR_ADD(fw, f.print(','));
+    FLASH_WEAR_ADD(fw, f.println(data));
     f.close();
+    #endif
+    // ============ [FEAT-V25 END] ============
 }
 
 // ============================================================
@@ -438,14 +657,67 @@ void ProdDiag::printStats() {
     Serial.print(F("║    GPS Fails: "));
     Serial.println(g_stats.gpsFails);
     
+    // ============ [FEAT-V28 START] Marcas de memoria ============
+    #if ENABLE_FEAT_V28_MEM_WATERMARKS
+    Serial.println(F("╠══════════════════════════════════════╣"));
+    Serial.println(F("║  MEMORIA (peor ciclo):"));
+    Serial.print(F("║    Heap min: "));
+    Serial.print((uint32_t)g_stats.memMinFreeHeap16 * 16);
+    Serial.print(F(" B (fase "));
+    Serial.print(g_stats.memWorstPhase);
+    Serial.println(F(")"));
+    Serial.print(F("║    Bloque min: "));
+    Serial.print((uint32_t)g_stats.memMinBlock16 * 16);
+    Serial.println(F(" B"));
+    Serial.print(F("║    Stack min: "));
+    Serial.print(g_stats.memMinStackFree);
+    Serial.println(F(" B"));
+    Serial.print(F("║    Alarmas: "));
+    Serial.println(g_stats.memAlarms);
+    #endif
+    // ============ [FEAT-V28 END] ============
+    
+    // ============ [FEAT-V29 START] Desgaste de flash ============
+    #if ENABLE_FEAT_V29_FLASH_WEAR
+    Serial.println(F("╠══════════════════════════════════════╣"));
+    FlashWear::printSummary();
+    #endif
+    // ============ [FEAT-V29 END] ============
+    
     Serial.println(F("╚══════════════════════════════════════╝"));
     Serial.println(F(""));
 }
 
 void ProdDiag::printEventLog() {
+    TRACE_SPAN("fs.diag.log");
     Serial.println(F(""));
     Serial.println(F("=== LOG DE EVENTOS ==="));
     
+    // ============ [FEAT-V25 START] Formatear el ring como el log de texto ============
+    #if ENABLE_FEAT_V25_EVENT_RING
+    File f = LittleFS.open(FEAT_V25_EVENTS_FILE, "r");
+    if (!f || g_ring.count == 0) {
+        if (f) f.close();
+        Serial.println(F("(sin eventos)"));
+        return;
+    }
+    
+    Serial.println(F("Formato: epoch,código,dato"));
+    Serial.println(F("Códigos: B=Boot L=LTE_Fail F=Fallback E=LowBat_Enter X=LowBat_Exit"));
+    Serial.println(F("         R=Restart24h G=GPS_Fail I=EMI S=EMI_Severe C=Crash T=AT_Timeout"));
+    Serial.println(F("---"));
+    
+    // Del más antiguo al más reciente
+    uint16_t first = (uint16_t)((g_ring.head + g_ring.slots - g_ring.count) % g_ring.slots);
+    for (uint16_t i = 0; i < g_ring.count; i++) {
+        EventRecord rec;
+        uint16_t slot = (uint16_t)((first + i) % g_ring.slots);
+        if (!f.seek(ringSlotOffset(slot)) || f.read((uint8_t*)&rec, sizeof(rec)) != sizeof(rec)) break;
+        Serial.printf("%lu,%c,%u\n", (unsigned long)rec.epoch, rec.code, (unsigned)rec.data);
+    }
+    f.close();
+    Serial.printf("--- %u/%u slots\n", (unsigned)g_ring.count, (unsigned)g_ring.slots);
+    #else
     if (!LittleFS.exists(PROD_DIAG_EVENTS_FILE)) {
         Serial.println(F("(sin eventos)"));
         return;
@@ -467,12 +739,15 @@ void ProdDiag::printEventLog() {
         Serial.println(line);
     }
     f.close();
+    #endif
+    // ============ [FEAT-V25 END] ============
     
     Serial.println(F("=== FIN LOG ==="));
     Serial.println(F(""));
 }
 
 void ProdDiag::clearAll() {
+    TRACE_SPAN("fs.diag.clear");
     Serial.println(F("[INFO][DIAG] Limpiando datos de diagnóstico..."));
     
     // Borrar archivos
@@ -483,6 +758,12 @@ void ProdDiag::clearAll() {
         LittleFS.remove(PROD_DIAG_EVENTS_FILE);
     }
     
+    // ============ [FEAT-V25 START] Ring vacío preasignado ============
+    #if ENABLE_FEAT_V25_EVENT_RING
+    ringFormat();
+    #endif
+    // ============ [FEAT-V25 END] ============
+    
     // Reinicializar estructura
     memset(&g_stats, 0, sizeof(g_stats));
     g_stats.magic = PROD_DIAG_MAGIC;
@@ -18,6 +18,7 @@
 
 #include <Arduino.h>
 #include "config_production_diag.h"
+#include "../FeatureFlags.h"
 
 // ============================================================
 // ESTRUCTURA DE ESTADÍSTICAS
@@ -68,8 +69,12 @@ struct ProductionStats {
     uint32_t lastUpdateEpoch;    ///< Último update (epoch)
     uint32_t firstBootEpoch;     ///< Primer boot registrado
     
-    // Reservado para futuro
-    uint8_t  reserved[8];
+    // Marcas de memoria (FEAT-V28; ocupa el antiguo reserved[8], 0 = sin datos)
+    uint16_t memMinFreeHeap16;   ///< Peor heap libre mínimo de un ciclo (÷16 bytes)
+    uint16_t memMinBlock16;      ///< Peor bloque libre más grande (÷16 bytes)
+    uint16_t memMinStackFree;    ///< Peor stack libre de loop() (bytes)
+    uint8_t  memWorstPhase;      ///< Fase (id de AppState) del peor heap
+    uint8_t  memAlarms;          ///< Ciclos con alarma de memoria (satura en 255)
     
     // Checksum
     uint16_t crc16;              ///< Validación de integridad
@@ -172,6 +177,23 @@ namespace ProdDiag {
      */
     void recordCrash(uint8_t checkpoint);
     
+    #if ENABLE_FEAT_V28_MEM_WATERMARKS
+    /**
+     * @brief Registra las marcas de memoria del ciclo y evalúa umbrales (FEAT-V28)
+     * @param minHeap Heap libre mínimo del ciclo (bytes)
+     * @param heapPhase Fase donde ocurrió
+     * @param minBlock Bloque libre más grande mínimo (bytes)
+     * @param blockPhase Fase donde ocurrió
+     * @param minStack Stack libre mínimo de loop() (bytes)
+     * @param stackPhase Fase donde ocurrió
+     * 
+     * Bajo umbral registra EVT_MEM_ALARM con data = (tipo << 8) | fase.
+     */
+    void recordMemWatermarks(uint32_t minHeap, uint8_t heapPhase,
+                             uint32_t minBlock, uint8_t blockPhase,
+                             uint16_t minStack, uint8_t stackPhase);
+    #endif
+    
     // ---- EMI Detection ----
     
     /**
@@ -273,9 +295,11 @@ namespace ProdDiag {
      * @brief Calcula CRC16 de los datos
      * @param data Puntero a los datos
      * @param len Longitud de los datos
+     * @param crc Valor inicial: el CRC de los bytes anteriores para calcular
+     *            por partes (FEAT-V34)
      * @return CRC16
      */
-    uint16_t calculateCRC16(const uint8_t* data, size_t len);
+    uint16_t calculateCRC16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
     
     /**
      * @brief Obtiene acceso a las estadísticas (solo lectura)
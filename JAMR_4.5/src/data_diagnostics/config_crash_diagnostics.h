@@ -59,5 +59,7 @@
 #define NVS_KEY_LAST_EPOCH          "last_epoch"
 #define NVS_KEY_SUCCESS_EPOCH       "success_ep"
 #define NVS_KEY_CYCLES_FAIL         "cycles_fail"
+#define NVS_KEY_LAST_AT_CMD         "last_at_cmd"   // FEAT-V26
+#define NVS_KEY_LAST_AT_RESP        "last_at_resp"  // FEAT-V26
 
 #endif // CONFIG_CRASH_DIAGNOSTICS_H
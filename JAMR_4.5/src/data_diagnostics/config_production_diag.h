@@ -18,7 +18,7 @@
 /** @brief Archivo de estadísticas binarias */
 #define PROD_DIAG_STATS_FILE    "/diag/stats.bin"
 
-/** @brief Archivo de log de eventos (texto) */
+/** @brief Archivo de log de eventos (texto; con FEAT-V25 se migra a FEAT_V25_EVENTS_FILE) */
 #define PROD_DIAG_EVENTS_FILE   "/diag/events.txt"
 
 // ============================================================
@@ -108,4 +108,12 @@
 /** @brief PSM no se pudo deshabilitar (FIX-V7) */
 #define EVT_PSM_FAIL        'P'
 
+/** @brief Memoria bajo umbral (FEAT-V28): data = (tipo << 8) | fase */
+#define EVT_MEM_ALARM       'M'
+
+/** @brief Tipos de alarma de memoria en EVT_MEM_ALARM (FEAT-V28) */
+#define MEM_ALARM_HEAP      1
+#define MEM_ALARM_BLOCK     2
+#define MEM_ALARM_STACK     3
+
 #endif // CONFIG_PRODUCTION_DIAG_H
@@ -69,6 +69,19 @@ void FormatModule::reset() {
   for (uint8_t i = 0; i < VAR_COUNT; i++) {
     fillZeros(vars_[i], VAR_LEN);
   }
+
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  fillZeros(suppressed_, SUPPRESSED_LEN);  // FEAT-V10
+#endif
+
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  fillZeros(aggCount_, AGG_COUNT_LEN);  // FEAT-V18
+  for (uint8_t i = 0; i < AGG_VAR_COUNT; i++) {
+    for (uint8_t k = 0; k < 3; k++) {
+      fillZeros(agg_[i][k], VAR_LEN);
+    }
+  }
+#endif
 }
 
 void FormatModule::setIccid(const char* iccid) {
@@ -151,6 +164,70 @@ void FormatModule::setVar7(const char* value) {
   setVar(6, value);
 }
 
+// ============ [FEAT-V21 START] Muestra tipada ============
+void FormatModule::setSample(const Sample& sample) {
+  setIccid(sample.iccid);
+
+  char tmp[12];
+  snprintf(tmp, sizeof(tmp), "%lu", (unsigned long)sample.epoch);
+  copyRightAligned(epoch_, EPOCH_LEN, tmp);
+
+  for (uint8_t i = 0; i < VAR_COUNT; i++) {
+    snprintf(tmp, sizeof(tmp), "%ld", (long)sample.var[i]);
+    copyRightAligned(vars_[i], VAR_LEN, tmp);
+  }
+}
+// ============ [FEAT-V21 END] ============
+
+// ============ [FEAT-V10 START] Contador de muestras suprimidas ============
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+void FormatModule::setSuppressed(uint16_t count) {
+  // Saturar al máximo representable en el ancho fijo (ej: 9999)
+  uint32_t maxVal = 1;
+  for (uint8_t i = 0; i < SUPPRESSED_LEN; i++) {
+    maxVal *= 10;
+  }
+  if (count >= maxVal) {
+    count = static_cast<uint16_t>(maxVal - 1);
+  }
+
+  char tmp[8];
+  snprintf(tmp, sizeof(tmp), "%u", (unsigned)count);
+  copyRightAligned(suppressed_, SUPPRESSED_LEN, tmp);
+}
+#endif
+// ============ [FEAT-V10 END] ============
+
+// ============ [FEAT-V18 START] Campos de agregación por ventana ============
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+void FormatModule::setAggregateCount(uint16_t count) {
+  uint32_t maxVal = 1;
+  for (uint8_t i = 0; i < AGG_COUNT_LEN; i++) {
+    maxVal *= 10;
+  }
+  if (count >= maxVal) {
+    count = static_cast<uint16_t>(maxVal - 1);
+  }
+
+  char tmp[8];
+  snprintf(tmp, sizeof(tmp), "%u", (unsigned)count);
+  copyRightAligned(aggCount_, AGG_COUNT_LEN, tmp);
+}
+
+void FormatModule::setAggregate(uint8_t index, int32_t minV, int32_t maxV, int32_t meanV) {
+  if (index >= AGG_VAR_COUNT) {
+    return;
+  }
+  const int32_t values[3] = {minV, maxV, meanV};
+  char tmp[12];
+  for (uint8_t k = 0; k < 3; k++) {
+    snprintf(tmp, sizeof(tmp), "%ld", (long)values[k]);
+    copyRightAligned(agg_[index][k], VAR_LEN, tmp);
+  }
+}
+#endif
+// ============ [FEAT-V18 END] ============
+
 bool FormatModule::buildFrame(char* outBuffer, size_t outSize) const {
   if (outBuffer == nullptr) {
     return false;
@@ -191,6 +268,25 @@ bool FormatModule::buildFrame(char* outBuffer, size_t outSize) const {
     pos += VAR_LEN;
   }
 
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  outBuffer[pos++] = ',';  // FEAT-V10
+  memcpy(&outBuffer[pos], suppressed_, SUPPRESSED_LEN);
+  pos += SUPPRESSED_LEN;
+#endif
+
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  outBuffer[pos++] = ',';  // FEAT-V18
+  memcpy(&outBuffer[pos], aggCount_, AGG_COUNT_LEN);
+  pos += AGG_COUNT_LEN;
+  for (uint8_t i = 0; i < AGG_VAR_COUNT; i++) {
+    for (uint8_t k = 0; k < 3; k++) {
+      outBuffer[pos++] = ',';
+      memcpy(&outBuffer[pos], agg_[i][k], VAR_LEN);
+      pos += VAR_LEN;
+    }
+  }
+#endif
+
   outBuffer[pos++] = ',';
   outBuffer[pos++] = '#';
   outBuffer[pos] = '\0';
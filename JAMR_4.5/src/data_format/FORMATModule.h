@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "config_data_format.h"
+#include "Sample.h"
 
 /**
  * @file FORMATModule.h
@@ -13,6 +14,9 @@
  * @class FormatModule
  * @brief Módulo para formar la trama:
  * "$,<iccid>,<epoch>,<lat>,<lng>,<alt>,<var1>,<var2>,<var3>,<var4>,<var5>,<var6>,<var7>,#"
+ *
+ * Con FEAT-V10 se agrega el contador de muestras suprimidas antes del cierre:
+ * "$,...,<var7>,<supr>,#"
  */
 class FormatModule {
  public:
@@ -106,6 +110,39 @@ class FormatModule {
    */
   void setVar7(const char* value);
 
+  /**
+   * @brief Asigna ICCID, epoch y var1..var7 desde la muestra tipada (FEAT-V21).
+   *
+   * Convierte los enteros a texto directamente en los buffers fijos, sin String.
+   * @param sample Muestra del ciclo.
+   */
+  void setSample(const Sample& sample);
+
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  /**
+   * @brief Asigna el contador de muestras suprimidas (FEAT-V10).
+   * @param count Muestras no reportadas desde la última trama (satura en 9..9).
+   */
+  void setSuppressed(uint16_t count);
+#endif
+
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  /**
+   * @brief Asigna el número de muestras de la ventana (FEAT-V18).
+   * @param count Muestras agregadas (satura en 9..9).
+   */
+  void setAggregateCount(uint16_t count);
+
+  /**
+   * @brief Asigna min/max/media de una variable agregada (FEAT-V18).
+   * @param index Índice 0..AGG_VAR_COUNT-1 (0 = var5).
+   * @param minV Mínimo en unidades de trama.
+   * @param maxV Máximo en unidades de trama.
+   * @param meanV Media en unidades de trama.
+   */
+  void setAggregate(uint8_t index, int32_t minV, int32_t maxV, int32_t meanV);
+#endif
+
   /**
    * @brief Construye la trama en un buffer provisto por el usuario.
    * @param outBuffer Buffer destino.
@@ -166,6 +203,25 @@ class FormatModule {
    */
   char vars_[VAR_COUNT][VAR_LEN + 1];
 
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+  /**
+   * @brief Muestras suprimidas relleno a SUPPRESSED_LEN caracteres (más '\0').
+   */
+  char suppressed_[SUPPRESSED_LEN + 1];
+#endif
+
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+  /**
+   * @brief Muestras de la ventana relleno a AGG_COUNT_LEN caracteres (más '\0').
+   */
+  char aggCount_[AGG_COUNT_LEN + 1];
+
+  /**
+   * @brief min/max/media por variable agregada, relleno a 4 caracteres (más '\0').
+   */
+  char agg_[AGG_VAR_COUNT][3][VAR_LEN + 1];
+#endif
+
   static void fillZeros(char* dst, uint8_t width);
   static void copyRightAligned(char* dst, uint8_t width, const char* src);
   static void copyCoordAligned(char* dst, uint8_t width, const char* src);
@@ -0,0 +1,59 @@
+/**
+ * @file Sample.h
+ * @brief Muestra tipada del ciclo: del muestreo de sensores al formateador.
+ * @version FEAT-V21
+ * @date 2026-10-18
+ *
+ * Reemplaza los String por ciclo (ICCID, epoch y var1..var7). Los valores viajan
+ * como enteros en unidades de trama; el texto solo se produce en
+ * FormatModule::setSample(), sobre los buffers fijos de la trama.
+ */
+
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <Arduino.h>
+#include "config_data_format.h"
+
+/** @brief Índices de var1..var7 dentro de Sample::var */
+enum SampleVar : uint8_t {
+  SAMPLE_RS485_0 = 0,  ///< Registro Modbus 0
+  SAMPLE_RS485_1 = 1,  ///< Registro Modbus 1
+  SAMPLE_RS485_2 = 2,  ///< Registro Modbus 2
+  SAMPLE_RS485_3 = 3,  ///< Registro Modbus 3
+  SAMPLE_TEMP    = 4,  ///< Temperatura x100 (I2C)
+  SAMPLE_HUM     = 5,  ///< Humedad x100 (I2C)
+  SAMPLE_VBAT    = 6   ///< Batería x100 (ADC)
+};
+
+/**
+ * @struct Sample
+ * @brief Datos de un ciclo sin memoria dinámica.
+ */
+struct Sample {
+  uint32_t epoch;               ///< Unix epoch del RTC (0 = sin leer)
+  int32_t var[VAR_COUNT];       ///< var1..var7 en unidades de trama (0 si el sensor falló)
+  char iccid[ICCID_LEN + 1];    ///< ICCID ("" = no leído)
+
+  /** @brief Vacía la muestra (valores por defecto de la trama). */
+  void clear() {
+    epoch = 0;
+    for (uint8_t i = 0; i < VAR_COUNT; i++) var[i] = 0;
+    iccid[0] = '\0';
+  }
+
+  /**
+   * @brief Copia un ICCID truncando a ICCID_LEN.
+   * @param src Cadena origen (nullptr = vacío).
+   */
+  void setIccid(const char* src) {
+    if (src == nullptr) {
+      iccid[0] = '\0';
+      return;
+    }
+    strncpy(iccid, src, ICCID_LEN);
+    iccid[ICCID_LEN] = '\0';
+  }
+};
+
+#endif
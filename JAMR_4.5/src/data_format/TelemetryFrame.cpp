@@ -0,0 +1,226 @@
+/**
+ * @file TelemetryFrame.cpp
+ * @brief Implementación de la trama de telemetría (FEAT-V30)
+ * @version FEAT-V30
+ * @date 2026-10-18
+ */
+
+#include "TelemetryFrame.h"
+
+#if ENABLE_FEAT_V30_TELEMETRY_FRAME
+
+#include "FORMATModule.h"
+#include "../data_diagnostics/ProductionDiag.h"
+
+static_assert(FEAT_V30_EVERY_N_CYCLES > 0 && FEAT_V30_EVERY_N_CYCLES <= 255,
+              "FEAT_V30_EVERY_N_CYCLES debe caber en uint8_t");
+
+namespace Telemetry {
+
+/** @brief Cambia si cambia la forma de la ventana RTC (descarta copias viejas) */
+static const uint32_t RTC_MAGIC =
+    0x544C4D00UL ^ ((uint32_t)FEAT_V30_EVERY_N_CYCLES << 8) ^ TELEM_PHASE_COUNT;
+
+/** @brief Fases de CycleTiming en el orden de TELEM_PHASES */
+static unsigned long CycleTiming::* const PHASE_FIELDS[TELEM_PHASE_COUNT] = {
+#define TELEM_FIELD_(field, name) &CycleTiming::field,
+  TELEM_PHASES(TELEM_FIELD_)
+#undef TELEM_FIELD_
+};
+
+// Estado en RTC: sobrevive deep sleep y reinicios por software
+RTC_DATA_ATTR static uint32_t s_magic = 0;
+RTC_DATA_ATTR static uint16_t s_hist[FEAT_V30_EVERY_N_CYCLES][TELEM_PHASE_COUNT];  ///< ms (0 = no ejecutada)
+RTC_DATA_ATTR static uint8_t s_histHead = 0;
+RTC_DATA_ATTR static uint8_t s_histCount = 0;
+RTC_DATA_ATTR static bool s_hasTiming = false;
+RTC_DATA_ATTR static uint16_t s_cyclesSince = 0;
+RTC_DATA_ATTR static uint16_t s_seq = 0;
+RTC_DATA_ATTR static uint16_t s_sinceKey = 0;
+RTC_DATA_ATTR static bool s_baseValid = false;
+RTC_DATA_ATTR static uint32_t s_base[TELEM_COUNTER_COUNT];
+
+// Trama armada por build(), pendiente de commit()
+static uint32_t s_pending[TELEM_COUNTER_COUNT];
+static bool s_pendingValid = false;
+static bool s_pendingKey = false;
+
+static void ensureRtc() {
+  if (s_magic == RTC_MAGIC) return;
+  memset(s_hist, 0, sizeof(s_hist));
+  s_histHead = 0;
+  s_histCount = 0;
+  s_hasTiming = false;
+  s_cyclesSince = 0;
+  s_seq = 0;
+  s_sinceKey = 0;
+  s_baseValid = false;
+  s_magic = RTC_MAGIC;
+}
+
+// ============================================================
+// CODIFICACIÓN
+// ============================================================
+
+/** @brief Escritor acotado sobre el buffer binario */
+struct Writer {
+  uint8_t* buf;
+  size_t size;
+  size_t len;
+  bool ok;
+
+  void u8(uint8_t v) {
+    if (len < size) buf[len++] = v;
+    else ok = false;
+  }
+  void u16(uint16_t v) { u8(v & 0xFF); u8(v >> 8); }
+  void u32(uint32_t v) { u16(v & 0xFFFF); u16(v >> 16); }
+  void varint(uint32_t v) {
+    while (v >= 0x80) {
+      u8((uint8_t)(v | 0x80));
+      v >>= 7;
+    }
+    u8((uint8_t)v);
+  }
+};
+
+/** @brief ICCID a BCD (20 dígitos, nibble alto primero, 0xF = vacío) */
+static void writeIccid(Writer& w, const char* iccid) {
+  size_t len = iccid ? strlen(iccid) : 0;
+  for (uint8_t i = 0; i < TELEM_ICCID_BCD; i++) {
+    uint8_t b = 0;
+    for (uint8_t k = 0; k < 2; k++) {
+      size_t pos = (size_t)i * 2 + k;
+      char c = (pos < len) ? iccid[pos] : '\0';
+      uint8_t nib = (c >= '0' && c <= '9') ? (uint8_t)(c - '0') : 0x0F;
+      b = (uint8_t)((b << 4) | nib);
+    }
+    w.u8(b);
+  }
+}
+
+/** @brief Percentil por rango más cercano sobre valores ordenados */
+static inline uint16_t percentile(const uint16_t* sorted, uint8_t n, uint8_t pct) {
+  uint16_t rank = (uint16_t)(((uint16_t)pct * n + 99) / 100);
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void writePhases(Writer& w) {
+  w.u8(TELEM_PHASE_COUNT);
+  for (uint8_t p = 0; p < TELEM_PHASE_COUNT; p++) {
+    uint16_t v[FEAT_V30_EVERY_N_CYCLES];
+    uint8_t n = 0;
+    for (uint8_t c = 0; c < s_histCount; c++) {
+      uint16_t ms = s_hist[c][p];
+      if (ms == 0) continue;  // Fase no ejecutada en ese ciclo (ej. GPS)
+      // Inserción ordenada (n <= FEAT_V30_EVERY_N_CYCLES)
+      uint8_t j = n++;
+      while (j > 0 && v[j - 1] > ms) {
+        v[j] = v[j - 1];
+        j--;
+      }
+      v[j] = ms;
+    }
+    w.u8(n);
+    if (n == 0) continue;
+    w.varint(percentile(v, n, 50));
+    w.varint(percentile(v, n, 90));
+    w.varint(v[n - 1]);
+  }
+}
+
+// ============================================================
+// API
+// ============================================================
+
+void endCycle(const CycleTiming* timing) {
+  ensureRtc();
+  if (s_cyclesSince < 0xFFFF) s_cyclesSince++;
+  if (timing == nullptr) return;
+
+  uint16_t* row = s_hist[s_histHead];
+  for (uint8_t p = 0; p < TELEM_PHASE_COUNT; p++) {
+    unsigned long ms = timing->*PHASE_FIELDS[p];
+    row[p] = (ms > 0xFFFF) ? 0xFFFF : (uint16_t)ms;  // Satura en 65.5 s
+  }
+  s_histHead = (uint8_t)((s_histHead + 1) % FEAT_V30_EVERY_N_CYCLES);
+  if (s_histCount < FEAT_V30_EVERY_N_CYCLES) s_histCount++;
+  s_hasTiming = true;
+}
+
+bool due() {
+  ensureRtc();
+  // Tras un power-on, la primera sesión con un ciclo cerrado registra el equipo
+  if (!s_baseValid) return s_cyclesSince > 0;
+  return s_cyclesSince >= FEAT_V30_EVERY_N_CYCLES;
+}
+
+size_t build(const char* iccid, uint32_t epoch, char* out, size_t outSize) {
+  ensureRtc();
+  const ProductionStats& st = ProdDiag::getStats();
+
+  uint32_t cur[TELEM_COUNTER_COUNT] = {
+#define TELEM_VALUE_(field, name) (uint32_t)st.field,
+    TELEM_COUNTERS(TELEM_VALUE_)
+  };
+  uint32_t gauges[TELEM_GAUGE_COUNT] = {
+    TELEM_GAUGES(TELEM_VALUE_)
+#undef TELEM_VALUE_
+  };
+
+  bool key = !s_baseValid || s_sinceKey >= FEAT_V30_KEYFRAME_EVERY;
+  for (uint8_t i = 0; i < TELEM_COUNTER_COUNT && !key; i++) {
+    if (cur[i] < s_base[i]) key = true;  // CLEAR o stats.bin regenerado
+  }
+
+  uint8_t bin[TELEM_MAX_BYTES];
+  Writer w = {bin, sizeof(bin), 0, true};
+  w.u8(TELEM_MAGIC);
+  w.u8(TELEM_VERSION);
+  w.u8((uint8_t)((key ? TELEM_FLAG_KEYFRAME : 0) | (s_hasTiming ? TELEM_FLAG_TIMING : 0)));
+  w.u8(s_histCount);
+  writeIccid(w, iccid);
+  w.u32(epoch);
+  w.u16(s_seq);
+  w.u32(st.totalCycles);
+
+  w.u8(TELEM_COUNTER_COUNT);
+  for (uint8_t i = 0; i < TELEM_COUNTER_COUNT; i++) {
+    w.varint(key ? cur[i] : cur[i] - s_base[i]);
+  }
+  w.u8(TELEM_GAUGE_COUNT);
+  for (uint8_t i = 0; i < TELEM_GAUGE_COUNT; i++) {
+    w.varint(gauges[i]);
+  }
+  writePhases(w);
+  w.u16(ProdDiag::calculateCRC16(bin, w.len));
+  if (!w.ok) return 0;
+
+  size_t n = FormatModule::encodeBase64(bin, w.len, out, outSize);
+  if (n == 0) return 0;
+
+  memcpy(s_pending, cur, sizeof(s_pending));
+  s_pendingKey = key;
+  s_pendingValid = true;
+  Serial.printf("[FEAT-V30] Telemetría #%u: %u B (%u Base64), %u ciclos%s\n",
+                s_seq, (unsigned)w.len, (unsigned)n, s_histCount,
+                key ? ", KEYFRAME" : "");
+  return n;
+}
+
+void commit() {
+  if (!s_pendingValid) return;
+  memcpy(s_base, s_pending, sizeof(s_base));
+  s_baseValid = true;
+  s_sinceKey = s_pendingKey ? 1 : (uint16_t)(s_sinceKey + 1);
+  s_seq++;
+  s_cyclesSince = 0;
+  s_histCount = 0;
+  s_histHead = 0;
+  s_hasTiming = false;
+  s_pendingValid = false;
+}
+
+}  // namespace Telemetry
+
+#endif  // ENABLE_FEAT_V30_TELEMETRY_FRAME
@@ -0,0 +1,76 @@
+/**
+ * @file TelemetryFrame.h
+ * @brief Trama de telemetría de baja tasa: ProductionStats delta + percentiles de fases
+ * @version FEAT-V30
+ * @date 2026-10-18
+ *
+ * Cada FEAT_V30_EVERY_N_CYCLES ciclos se envía, en la misma sesión TCP que
+ * las tramas de datos, una trama binaria en Base64 con:
+ *   - Los contadores de ProductionStats como delta respecto de la última
+ *     trama aceptada por el modem (absolutos en las tramas KEYFRAME).
+ *   - p50 / p90 / máximo de cada fase de CycleTiming en la ventana de ciclos.
+ * Formato en TelemetryLayout.h; decodificador en tools/telemetry_decoder.cpp.
+ *
+ * La base de los deltas y la ventana de tiempos viven en RTC_DATA_ATTR.
+ * Tras un power-on (RTC perdida) o si un contador retrocede (CLEAR) la
+ * trama sale como KEYFRAME; también cada FEAT_V30_KEYFRAME_EVERY tramas,
+ * para que el servidor se resincronice si perdió alguna.
+ *
+ * USO:
+ *   Telemetry::endCycle(&g_timing);                  - En Cycle_Sleep
+ *   if (Telemetry::due()) {
+ *     size_t n = Telemetry::build(iccid, epoch, b64, sizeof(b64));
+ *     if (n && lte.sendTCPData(...)) Telemetry::commit();
+ *   }
+ */
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+#include "../CycleTiming.h"
+#include "TelemetryLayout.h"
+
+#if ENABLE_FEAT_V30_TELEMETRY_FRAME
+
+#if !ENABLE_FEAT_V7_PRODUCTION_DIAG
+#error "FEAT-V30 requiere FEAT-V7 (ProductionStats)"
+#endif
+
+namespace Telemetry {
+
+/** @brief Tamaño del buffer Base64 para build() (incluye '\0') */
+static const size_t BASE64_MAX = ((TELEM_MAX_BYTES + 2) / 3) * 4 + 1;
+
+/**
+ * @brief Registra los tiempos del ciclo en la ventana y avanza el contador.
+ * @param timing Tiempos del ciclo, o nullptr si FEAT-V2 está apagado.
+ */
+void endCycle(const CycleTiming* timing);
+
+/** @brief true si pasaron FEAT_V30_EVERY_N_CYCLES ciclos desde la última trama */
+bool due();
+
+/**
+ * @brief Arma la trama y la codifica en Base64.
+ * @param iccid ICCID del ciclo ("" si no se leyó).
+ * @param epoch Epoch del ciclo.
+ * @param out Buffer destino (al menos BASE64_MAX).
+ * @param outSize Tamaño de out.
+ * @return Caracteres escritos (sin '\0'); 0 si no cupo.
+ * @note No modifica el estado: la base solo avanza con commit().
+ */
+size_t build(const char* iccid, uint32_t epoch, char* out, size_t outSize);
+
+/**
+ * @brief Confirma la última trama armada: nueva base de deltas, ventana vacía.
+ * @note Llamar solo si sendTCPData() tuvo éxito.
+ */
+void commit();
+
+}  // namespace Telemetry
+
+#endif  // ENABLE_FEAT_V30_TELEMETRY_FRAME
+
+#endif  // TELEMETRY_FRAME_H
@@ -0,0 +1,91 @@
+/**
+ * @file TelemetryLayout.h
+ * @brief Disposición de la trama de telemetría (contadores y fases)
+ * @version FEAT-V30
+ * @date 2026-10-18
+ *
+ * Compartido entre el firmware (TelemetryFrame) y el decodificador host
+ * (tools/telemetry_decoder.cpp): no incluir Arduino.h ni nada del ESP32 aquí.
+ *
+ * REGLAS:
+ *   - Solo agregar al final de cada lista: la posición viaja implícita en el
+ *     binario. Un cambio de orden exige subir TELEM_VERSION.
+ *   - Contadores: campos monótonos de ProductionStats (delta entre tramas).
+ *   - Medidores: valores instantáneos (siempre absolutos).
+ *   - Fases: campos de CycleTiming en ms.
+ */
+
+#ifndef TELEMETRY_LAYOUT_H
+#define TELEMETRY_LAYOUT_H
+
+#include <stdint.h>
+
+/** @brief Contadores (campo de ProductionStats, nombre en el decodificador) */
+#define TELEM_COUNTERS(X) \
+  X(lteSendOk,         "lteOk") \
+  X(lteSendFail,       "lteFail") \
+  X(atTimeouts,        "atTimeouts") \
+  X(operatorFallbacks, "opFallbacks") \
+  X(lowBatteryCycles,  "lowBatCycles") \
+  X(lowBatteryEvents,  "lowBatEvents") \
+  X(feat4Restarts,     "restarts24h") \
+  X(crashCount,        "crashes") \
+  X(atCommandsTotal,   "atTotal") \
+  X(atCorrupted,       "atCorrupted") \
+  X(invalidCharsTotal, "invalidChars") \
+  X(emiEvents,         "emiEvents") \
+  X(gpsFails,          "gpsFails") \
+  X(memAlarms,         "memAlarms")
+
+/** @brief Medidores (campo de ProductionStats, nombre) */
+#define TELEM_GAUGES(X) \
+  X(worstCorruptPct,   "worstCorruptPct") \
+  X(lastResetReason,   "resetReason") \
+  X(memMinFreeHeap16,  "minHeap16") \
+  X(memMinStackFree,   "minStack")
+
+/** @brief Fases con percentiles (campo de CycleTiming, nombre) */
+#define TELEM_PHASES(X) \
+  X(sensorsTime,       "sensors") \
+  X(gpsTime,           "gps") \
+  X(iccidTime,         "iccid") \
+  X(bufferWriteTime,   "bufferWrite") \
+  X(sendLteTime,       "sendLte") \
+  X(lteAttach,         "lteAttach") \
+  X(lteSend,           "lteSend") \
+  X(compactBufferTime, "compactBuffer") \
+  X(cycleTotal,        "cycle")
+
+#define TELEM_COUNT_(field, name) +1
+static const uint8_t TELEM_COUNTER_COUNT = 0 TELEM_COUNTERS(TELEM_COUNT_);
+static const uint8_t TELEM_GAUGE_COUNT = 0 TELEM_GAUGES(TELEM_COUNT_);
+static const uint8_t TELEM_PHASE_COUNT = 0 TELEM_PHASES(TELEM_COUNT_);
+#undef TELEM_COUNT_
+
+/**
+ * FORMATO BINARIO (little endian, versión 1), enviado en Base64:
+ *   u8 'T' | u8 versión | u8 flags | u8 ciclos en la ventana
+ *   u8[10] ICCID en BCD (nibble alto primero, 0xF = sin dígito)
+ *   u32 epoch | u16 secuencia | u32 ciclos totales
+ *   u8 nContadores | varint contador[n]     (delta, o absoluto si KEYFRAME)
+ *   u8 nMedidores  | varint medidor[n]
+ *   u8 nFases      | por fase: u8 muestras, y si > 0: varint p50, p90, max (ms)
+ *   u16 CRC16 (MODBUS, el de ProdDiag) de todo lo anterior
+ *
+ * varint = LEB128 sin signo (7 bits por byte, bit 7 = continúa).
+ * La primera letra del Base64 es 'V' ('T' = 0x54); las tramas de datos
+ * ("$,") empiezan con 'J'.
+ */
+#define TELEM_MAGIC          'T'
+#define TELEM_VERSION        1
+#define TELEM_FLAG_KEYFRAME  0x01  ///< Contadores absolutos (reinicia la suma del servidor)
+#define TELEM_FLAG_TIMING    0x02  ///< Sección de fases con datos (FEAT-V2 activo)
+#define TELEM_ICCID_BCD      10
+#define TELEM_HEADER_BYTES   24
+
+/** @brief Peor caso: cabecera + varints de 5 bytes + 3 varints de 3 bytes por fase + CRC */
+#define TELEM_MAX_BYTES \
+  (TELEM_HEADER_BYTES + 3 + 5 * (TELEM_COUNTER_COUNT + TELEM_GAUGE_COUNT) + \
+   TELEM_PHASE_COUNT * (1 + 3 * 3) + 2)
+
+#endif  // TELEMETRY_LAYOUT_H
@@ -2,6 +2,7 @@
 #define CONFIG_DATA_FORMAT_H
 
 #include <Arduino.h>
+#include "../FeatureFlags.h"
 
 /**
  * @file config_data_format.h
@@ -26,10 +27,43 @@ static const uint8_t VAR_LEN = 4;
 /** @brief Número de variables var1..var7. */
 static const uint8_t VAR_COUNT = 7;
 
+// ============ [FEAT-V10 START] Campo de muestras suprimidas ============
+#if ENABLE_FEAT_V10_REPORT_BY_EXCEPTION
+/** @brief Longitud del contador de muestras suprimidas (sin terminador nulo). */
+static const uint8_t SUPPRESSED_LEN = FEAT_V10_SUPPRESSED_LEN;
+
+/** @brief Caracteres extra de ",<supr>". */
+static const uint8_t FRAME_SUPPRESSED_EXT = 1 + SUPPRESSED_LEN;
+#else
+static const uint8_t FRAME_SUPPRESSED_EXT = 0;
+#endif
+// ============ [FEAT-V10 END] ============
+
+// ============ [FEAT-V18 START] Campos de agregación por ventana ============
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+/** @brief Longitud del contador de muestras de la ventana (sin terminador nulo). */
+static const uint8_t AGG_COUNT_LEN = FEAT_V18_COUNT_LEN;
+
+/** @brief Primera variable agregada (índice 4 = var5) y cantidad (var5..var7). */
+static const uint8_t AGG_FIRST_VAR = 4;
+static const uint8_t AGG_VAR_COUNT = 3;
+
+/** @brief Caracteres extra de ",<n>" + ",<min>,<max>,<media>" por variable. */
+static const uint8_t FRAME_WINDOW_EXT = 1 + AGG_COUNT_LEN + AGG_VAR_COUNT * 3 * (1 + VAR_LEN);
+#else
+static const uint8_t FRAME_WINDOW_EXT = 0;
+#endif
+// ============ [FEAT-V18 END] ============
+
 /** @brief Longitud máxima de la trama completa incluyendo '\0'. */
-static const uint8_t FRAME_MAX_LEN = 102;
+static const uint8_t FRAME_MAX_LEN = 102 + FRAME_SUPPRESSED_EXT + FRAME_WINDOW_EXT;
 
+#if ENABLE_FEAT_V18_WINDOW_AGGREGATION
+/** @brief Longitud máxima de la trama Base64 incluyendo '\0' (FEAT-V18: 4*ceil(n/3)+1). */
+static const uint8_t FRAME_BASE64_MAX_LEN = ((FRAME_MAX_LEN - 1 + 2) / 3) * 4 + 1;
+#else
 /** @brief Longitud máxima de la trama Base64 incluyendo '\0'. */
 static const uint8_t FRAME_BASE64_MAX_LEN = 200;
+#endif
 
 #endif
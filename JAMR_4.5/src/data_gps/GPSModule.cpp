@@ -8,6 +8,7 @@
  */
 
 #include "GPSModule.h"
+#include "../TraceSpan.h"  // FEAT-V23
 #include <string.h>
 #include <stdlib.h>
 
@@ -15,6 +16,7 @@ GPSModule::GPSModule(Stream& serial, uint8_t pwrKeyPin)
     : serial_(serial), pwrKeyPin_(pwrKeyPin) {}
 
 bool GPSModule::powerOn(uint16_t attempts) {
+  TRACE_SPAN("gps.powerOn");
   DEBUG_INFO(GPS, "Iniciando encendido del modulo GPS...");
   pinMode(pwrKeyPin_, OUTPUT);
   setPwrKeyIdle();
@@ -36,6 +38,7 @@ bool GPSModule::powerOn(uint16_t attempts) {
 }
 
 bool GPSModule::powerOff() {
+  TRACE_SPAN("gps.powerOff");
   DEBUG_INFO(GPS, "Apagando modulo GPS...");
   (void)gnssPowerOff();
   flushInput();
@@ -45,6 +48,7 @@ bool GPSModule::powerOff() {
 }
 
 bool GPSModule::getCoordinatesAndShutdown(GpsFix& fix, uint16_t retries) {
+  TRACE_SPAN("gps.fix");
   DEBUG_INFO(GPS, "Iniciando obtencion de coordenadas GPS...");
   fix.hasFix = false;
   fix.latitude = 0.0f;
@@ -184,6 +188,7 @@ void GPSModule::flushInput() {
 }
 
 bool GPSModule::waitAtReady(uint32_t timeoutMs) {
+  TRACE_SPAN("gps.atReady");
   DEBUG_VERBOSE(GPS, "Esperando respuesta AT del modulo...");
   uint32_t start = millis();
   char line[64];
@@ -278,6 +283,7 @@ bool GPSModule::waitForOk(uint32_t timeoutMs) {
 }
 
 bool GPSModule::gnssPowerOn() {
+  TRACE_SPAN("gps.gnssOn");
   DEBUG_VERBOSE(GPS, "Encendiendo GNSS (AT+CGNSPWR=1)...");
   flushInput();
   if (!sendCommand("AT+CGNSPWR=1")) {
@@ -294,6 +300,7 @@ bool GPSModule::gnssPowerOn() {
 }
 
 bool GPSModule::gnssPowerOff() {
+  TRACE_SPAN("gps.gnssOff");
   DEBUG_VERBOSE(GPS, "Apagando GNSS (AT+CGNSPWR=0)...");
   flushInput();
   if (!sendCommand("AT+CGNSPWR=0")) {
@@ -310,6 +317,7 @@ bool GPSModule::gnssPowerOff() {
 }
 
 bool GPSModule::requestCgnsinf(GpsFix& fix) {
+  TRACE_SPAN("gps.cgnsinf");
   DEBUG_VERBOSE(GPS, "Solicitando informacion GNSS (AT+CGNSINF)...");
   flushInput();
   if (!sendCommand("AT+CGNSINF")) {
@@ -83,6 +83,14 @@ class GPSModule {
    */
   bool getAltitudeAsString(String& altStr, uint16_t retries = GPS_GNSS_MAX_RETRIES);
 
+  /**
+   * @brief Parsea una línea "+CGNSINF: ..." (sin E/S; público para FEAT-V33).
+   * @param line Línea terminada en '\0' (máx. 219 caracteres).
+   * @param[out] fix Resultado; sin fix, lat/lon/alt en 0.
+   * @return false si la línea no es CGNSINF o es demasiado larga.
+   */
+  bool parseCgnsinf(const char* line, GpsFix& fix);
+
  private:
   Stream& serial_;
   uint8_t pwrKeyPin_;
@@ -100,7 +108,6 @@ class GPSModule {
   bool gnssPowerOn();
   bool gnssPowerOff();
   bool requestCgnsinf(GpsFix& fix);
-  bool parseCgnsinf(const char* line, GpsFix& fix);
   bool isValidNumber(const char* s) const;
 };
 
@@ -9,6 +9,8 @@
 
 #include "LTEModule.h"
 #include "../FeatureFlags.h"  // FEAT-V1: Feature flags
+#include "../TraceSpan.h"     // FEAT-V23: Trazas por comando AT
+#include "../DeferredLog.h"   // FEAT-V27: DLOG
 #include <string.h>
 #include <stdlib.h>
 
@@ -150,7 +152,7 @@ void resetEMIDiagnosticStats() {
 #endif
 // ============ [DEBUG-EMI END] ============
 
-LTEModule::LTEModule(HardwareSerial& serial) : _serial(serial), _debugEnabled(false), _debugSerial(nullptr) {
+LTEModule::LTEModule(HardwareSerial& serial) : _serial(serial), _debugEnabled(false), _debugSerial(nullptr), _abort(false) {
 }
 
 void LTEModule::setDebug(bool enable, Stream* debugSerial) {
@@ -158,16 +160,36 @@ void LTEModule::setDebug(bool enable, Stream* debugSerial) {
     _debugSerial = debugSerial;
 }
 
+// ============ [FEAT-V12 START] Abortar esperas desde otra tarea ============
+#if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+void LTEModule::requestAbort(bool abort) {
+    _abort = abort;
+}
+
+bool LTEModule::abortRequested() const {
+    return _abort;
+}
+#endif
+// ============ [FEAT-V12 END] ============
+
 void LTEModule::debugPrint(const char* msg) {
     if (_debugEnabled && _debugSerial) {
+        #if ENABLE_FEAT_V27_DEFERRED_LOG
+        if (DLOG_ENABLED_(LTE, INFO)) DeferredLog::postLiteral(msg);  // FEAT-V27: msg es literal
+        #else
         _debugSerial->println(msg);
+        #endif
     }
 }
 
 void LTEModule::debugPrint(const char* msg, int value) {
     if (_debugEnabled && _debugSerial) {
+        #if ENABLE_FEAT_V27_DEFERRED_LOG
+        if (DLOG_ENABLED_(LTE, INFO)) DeferredLog::postLiteral(msg, value);  // FEAT-V27
+        #else
         _debugSerial->print(msg);
         _debugSerial->println(value);
+        #endif
     }
 }
 
@@ -180,6 +202,7 @@ void LTEModule::begin() {
 }
 
 bool LTEModule::powerOn() {
+    TRACE_SPAN("lte.powerOn");
 #if ENABLE_FIX_V7_ZOMBIE_MITIGATION
     // ============ [FIX-V7 START] Mitigación estado zombie (v1.1) ============
     CRASH_CHECKPOINT(CP_MODEM_POWER_ON_START);
@@ -324,7 +347,7 @@ bool LTEModule::powerOn() {
         
         CRASH_CHECKPOINT(CP_MODEM_POWER_ON_WAIT);  // FEAT-V3
         uint32_t startTime = millis();
-        while (millis() - startTime < LTE_AT_READY_TIMEOUT_MS) {
+        while (millis() - startTime < LTE_AT_READY_TIMEOUT_MS && !_abort) {
             if (isAlive()) {
                 debugPrint("SIM7080G encendido correctamente!");
                 CRASH_CHECKPOINT(CP_MODEM_POWER_ON_OK);  // FEAT-V3
@@ -341,6 +364,7 @@ bool LTEModule::powerOn() {
 }
 
 bool LTEModule::powerOff() {
+    TRACE_SPAN("lte.powerOff");
     debugPrint("Apagando SIM7080G...");
     
 #if ENABLE_FIX_V6_MODEM_POWER_SEQUENCE
@@ -436,6 +460,7 @@ bool LTEModule::powerOff() {
 }
 
 bool LTEModule::isAlive() {
+    TRACE_SPAN("lte.isAlive");
     clearBuffer();
     
     for (int i = 0; i < 3; i++) {
@@ -449,8 +474,12 @@ bool LTEModule::isAlive() {
 }
 
 bool LTEModule::sendATCommand(const char* cmd, uint32_t timeout) {
+    TRACE_SPAN_TAG("at", cmd);
     clearBuffer();
     _serial.println(cmd);
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    CRASH_LOG_AT(cmd);  // FEAT-V26: solo RTC, sin costo de flash
+    #endif
     
     #if DEBUG_EMI_DIAGNOSTIC_ENABLED
     g_emiStats.totalATCommands++;
@@ -476,7 +505,7 @@ bool LTEModule::waitForOK(uint32_t timeout) {
     String response = "";
     uint32_t startTime = millis();
     
-    while (millis() - startTime < timeout) {
+    while (millis() - startTime < timeout && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -504,6 +533,10 @@ bool LTEModule::waitForOK(uint32_t timeout) {
                 #endif
                 // ============ [FEAT-V7 END] ============
                 
+                #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+                CRASH_LOG_RESPONSE(response.c_str());  // FEAT-V26
+                #endif
+                
                 return true;
             }
             
@@ -521,6 +554,10 @@ bool LTEModule::waitForOK(uint32_t timeout) {
                 #endif
                 // ============ [FEAT-V7 END] ============
                 
+                #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+                CRASH_LOG_RESPONSE(response.c_str());  // FEAT-V26
+                #endif
+                
                 return false;
             }
         }
@@ -543,6 +580,10 @@ bool LTEModule::waitForOK(uint32_t timeout) {
     #endif
     // ============ [FEAT-V7 END] ============
     
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    CRASH_LOG_RESPONSE(response.c_str());  // FEAT-V26: respuesta parcial del timeout
+    #endif
+    
     return false;
 }
 
@@ -553,6 +594,7 @@ void LTEModule::clearBuffer() {
 }
 
 bool LTEModule::resetModem() {
+    TRACE_SPAN("lte.reset");
     debugPrint("Reiniciando funcionalidad del modem...");
     
     bool cfunSuccess = false;
@@ -600,29 +642,40 @@ bool LTEModule::resetModem() {
 }
 
 String LTEModule::sendATCommandWithResponse(const char* cmd, uint32_t timeout) {
+    TRACE_SPAN_TAG("at", cmd);
     clearBuffer();
     _serial.println(cmd);
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    CRASH_LOG_AT(cmd);  // FEAT-V26
+    #endif
     
     String response = "";
     uint32_t startTime = millis();
     
-    while (millis() - startTime < timeout) {
+    while (millis() - startTime < timeout && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
         }
         
         if (response.indexOf("OK") != -1 || response.indexOf("ERROR") != -1) {
+            #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+            CRASH_LOG_RESPONSE(response.c_str());  // FEAT-V26
+            #endif
             return response;
         }
         
         delay(10);
     }
     
+    #if ENABLE_FEAT_V26_CRASH_RTC_LAZY
+    CRASH_LOG_RESPONSE(response.c_str());  // FEAT-V26: respuesta parcial del timeout
+    #endif
     return response;
 }
 
 String LTEModule::getICCID() {
+    TRACE_SPAN("lte.iccid");
     debugPrint("Obteniendo ICCID...");
     
     String response = sendATCommandWithResponse("AT+CCID", 3000);
@@ -723,6 +776,7 @@ uint8_t LTEModule::getICCIDBytes(uint8_t* buffer, uint8_t maxLen) {
 
 #if ENABLE_FIX_V1_SKIP_RESET_PDP
 bool LTEModule::configureOperator(Operadora operadora, bool skipReset) {
+    TRACE_SPAN("lte.config");
     // ============ [FIX-V1 START] Skip reset cuando hay operadora guardada ============
     if (!skipReset) {
         resetModem();
@@ -732,6 +786,7 @@ bool LTEModule::configureOperator(Operadora operadora, bool skipReset) {
     // ============ [FIX-V1 END] ============
 #else
 bool LTEModule::configureOperator(Operadora operadora) {
+    TRACE_SPAN("lte.config");
     resetModem();
 #endif
     if (operadora >= NUM_OPERADORAS) {
@@ -779,7 +834,7 @@ bool LTEModule::configureOperator(Operadora operadora) {
     
     String response = "";
     uint32_t startTime = millis();
-    while (millis() - startTime < 5000) {
+    while (millis() - startTime < 5000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -829,7 +884,7 @@ bool LTEModule::configureOperator(Operadora operadora) {
     uint32_t copsStartTime = millis();
     bool copsSuccess = false;
     
-    while (millis() - copsStartTime < 120000) {
+    while (millis() - copsStartTime < 120000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             copsResponse += c;
@@ -879,6 +934,7 @@ bool LTEModule::configureOperator(Operadora operadora) {
 }
 
 bool LTEModule::attachNetwork() {
+    TRACE_SPAN("lte.attach");
     debugPrint("Attach a red...");
     
     clearBuffer();
@@ -888,7 +944,7 @@ bool LTEModule::attachNetwork() {
     uint32_t startTime = millis();
     bool success = false;
     
-    while (millis() - startTime < 75000) {
+    while (millis() - startTime < 75000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -922,6 +978,7 @@ bool LTEModule::attachNetwork() {
 }
 
 bool LTEModule::activatePDP() {
+    TRACE_SPAN("lte.pdp");
     debugPrint("Activando PDP context...");
     
     if (!sendATCommand("AT+CNACT=0,1", 10000)) {
@@ -935,6 +992,7 @@ bool LTEModule::activatePDP() {
 }
 
 bool LTEModule::deactivatePDP() {
+    TRACE_SPAN("lte.pdpOff");
     debugPrint("Desactivando PDP context...");
     
     if (!sendATCommand("AT+CNACT=0,0", 5000)) {
@@ -947,6 +1005,7 @@ bool LTEModule::deactivatePDP() {
 }
 
 bool LTEModule::detachNetwork() {
+    TRACE_SPAN("lte.detach");
     debugPrint("Detach de red...");
     
     bool detachSuccess = false;
@@ -966,7 +1025,7 @@ bool LTEModule::detachNetwork() {
         String response = "";
         uint32_t startTime = millis();
         
-        while (millis() - startTime < 15000) {
+        while (millis() - startTime < 15000 && !_abort) {
             while (_serial.available()) {
                 char c = _serial.read();
                 response += c;
@@ -1013,6 +1072,7 @@ String LTEModule::getNetworkInfo() {
 }
 
 bool LTEModule::testOperator(Operadora operadora) {
+    TRACE_SPAN("lte.testOp");
     if (operadora >= NUM_OPERADORAS) {
         debugPrint("Error: Operadora invalida");
         return false;
@@ -1149,6 +1209,7 @@ String LTEModule::getSMSService() {
 }
 
 bool LTEModule::sendSMS(const char* phoneNumber, const char* message) {
+    TRACE_SPAN("lte.sms");
     debugPrint("Enviando SMS...");
     
     if (_debugEnabled && _debugSerial) {
@@ -1173,7 +1234,7 @@ bool LTEModule::sendSMS(const char* phoneNumber, const char* message) {
     uint32_t startTime = millis();
     bool promptReceived = false;
     
-    while (millis() - startTime < 5000) {
+    while (millis() - startTime < 5000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -1203,7 +1264,7 @@ bool LTEModule::sendSMS(const char* phoneNumber, const char* message) {
     startTime = millis();
     bool success = false;
     
-    while (millis() - startTime < 30000) {
+    while (millis() - startTime < 30000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -1354,6 +1415,7 @@ int LTEModule::getOperatorScore(Operadora operadora) {
 }
 
 bool LTEModule::openTCPConnection() {
+    TRACE_SPAN("lte.caopen");
     CRASH_CHECKPOINT(CP_MODEM_TCP_CONNECT_START);  // FEAT-V3
     debugPrint("Abriendo conexion TCP...");
     
@@ -1389,7 +1451,7 @@ bool LTEModule::openTCPConnection() {
         String response = "";
         uint32_t startTime = millis();
         
-        while (millis() - startTime < 75000) {
+        while (millis() - startTime < 75000 && !_abort) {
             while (_serial.available()) {
                 char c = _serial.read();
                 response += c;
@@ -1431,6 +1493,7 @@ bool LTEModule::openTCPConnection() {
 }
 
 bool LTEModule::closeTCPConnection() {
+    TRACE_SPAN("lte.caclose");
     debugPrint("Cerrando conexion TCP...");
     
     if (!sendATCommand("AT+CACLOSE=0", 10000)) {
@@ -1463,6 +1526,7 @@ bool LTEModule::sendTCPData(String data) {
 }
 
 bool LTEModule::sendTCPData(const uint8_t* data, size_t length) {
+    TRACE_SPAN("lte.casend");
     CRASH_CHECKPOINT(CP_MODEM_TCP_SEND_START);  // FEAT-V3
     debugPrint("Enviando datos por TCP...");
     
@@ -1481,16 +1545,9 @@ bool LTEModule::sendTCPData(const uint8_t* data, size_t length) {
     CRASH_SYNC_NVS();  // FEAT-V3: Guardar antes de operación crítica
     
     if (_debugEnabled && _debugSerial) {
-        _debugSerial->print("Enviando: ");
-        _debugSerial->println(casendCmd);
-        _debugSerial->print("Datos (");
-        _debugSerial->print(length);
-        _debugSerial->print(" bytes): ");
-        for (size_t i = 0; i < length && i < 50; i++) {
-            _debugSerial->print((char)data[i]);
-        }
-        if (length > 50) _debugSerial->print("...");
-        _debugSerial->println();
+        // FEAT-V27: comando y primeros 50 bytes vía DLOG (diferido, sin bloquear CASEND)
+        DLOG(LTE, INFO, LTE_CASEND_CMD, (uint32_t)length);
+        DLOG_BYTES(LTE, VERBOSE, LTE_CASEND_DATA, (uint32_t)length, data, length, 50);
     }
     
     clearBuffer();
@@ -1502,7 +1559,7 @@ bool LTEModule::sendTCPData(const uint8_t* data, size_t length) {
     uint32_t startTime = millis();
     bool promptReceived = false;
     
-    while (millis() - startTime < 5000) {
+    while (millis() - startTime < 5000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -1532,7 +1589,7 @@ bool LTEModule::sendTCPData(const uint8_t* data, size_t length) {
     startTime = millis();
     bool success = false;
     
-    while (millis() - startTime < 10000) {
+    while (millis() - startTime < 10000 && !_abort) {
         while (_serial.available()) {
             char c = _serial.read();
             response += c;
@@ -1551,8 +1608,13 @@ bool LTEModule::sendTCPData(const uint8_t* data, size_t length) {
     }
     
     if (_debugEnabled && _debugSerial) {
+        #if ENABLE_FEAT_V27_DEFERRED_LOG
+        DLOG_BYTES(LTE, INFO, LTE_CASEND_RESP, 0, (const uint8_t*)response.c_str(),
+                   response.length(), FEAT_V27_BYTES_MAX);
+        #else
         _debugSerial->print("Respuesta CASEND: ");
         _debugSerial->println(response);
+        #endif
     }
     
     if (success) {
@@ -250,10 +250,27 @@ public:
      */
     bool sendTCPData(const uint8_t* data, size_t length);
 
+#if ENABLE_FEAT_V12_DUAL_CORE_PIPELINE
+    /**
+     * @brief Abort pending AT waits from another task  // FEAT-V12
+     * @param abort true to abort, false to clear before using the modem again
+     * @details Every response wait ends as a timeout within ~10 ms, so the
+     *          bring-up task unwinds and exits instead of being deleted mid-AT.
+     */
+    void requestAbort(bool abort);
+
+    /**
+     * @brief Check whether an abort is pending  // FEAT-V12
+     * @return true between requestAbort(true) and requestAbort(false)
+     */
+    bool abortRequested() const;
+#endif
+
 private:
     HardwareSerial& _serial;
     bool _debugEnabled;
     Stream* _debugSerial;
+    volatile bool _abort;  ///< FEAT-V12: set by requestAbort() from core 1
     SignalQuality _signalQualities[NUM_OPERADORAS];
     
     /**
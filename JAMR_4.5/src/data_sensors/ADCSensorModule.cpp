@@ -35,6 +35,49 @@ bool ADCSensorModule::readSensor() {
   return true;
 }
 
+// ============ [FEAT-V14 START] Ráfaga sobremuestreada calibrada ============
+#if ENABLE_FEAT_V14_FAST_ADC
+bool ADCSensorModule::readOversampled() {
+  // Descartar primeras lecturas (carga del capacitor de muestreo / mux)
+  for (uint8_t i = 0; i < FEAT_V14_ADC_DISCARD; i++) {
+    (void)analogReadMilliVolts(ADC_PIN);
+  }
+
+#if ENABLE_FEAT_V17_ROBUST_STATS
+  // FEAT-V17: ráfaga adaptativa (corta si la señal es estable) + media recortada
+  SampleStats::Stream<FEAT_V14_ADC_OVERSAMPLE, SampleStats::TrimmedMean> s;
+  while (!s.full()) {
+    s.add((int32_t)analogReadMilliVolts(ADC_PIN));
+    if (s.count() >= FEAT_V17_ADC_BURST_MIN && (s.count() % 8) == 0 &&
+        s.stable(FEAT_V17_TOL_ADC_MV)) {
+      break;
+    }
+  }
+  pinMilliVolts_ = (uint32_t)s.reduce();
+#else
+  uint32_t sumMv = 0;
+  for (uint16_t i = 0; i < FEAT_V14_ADC_OVERSAMPLE; i++) {
+    sumMv += analogReadMilliVolts(ADC_PIN);
+  }
+  pinMilliVolts_ = (sumMv + (FEAT_V14_ADC_OVERSAMPLE / 2)) / FEAT_V14_ADC_OVERSAMPLE;
+#endif
+
+  voltage_ = pinMilliVolts_ / 1000.0f;
+  rawValue_ = (uint16_t)((voltage_ * ADC_RESOLUTION) / ADC_VREF);
+
+  // Fórmula de readSensor() con el ajuste de la lectura calibrada: el
+  // ADC_ADJUSTMENT empírico corrige analogRead() sin calibrar, no estos mV
+  value_ = ((voltage_ * 2) + FEAT_V14_ADC_ADJUSTMENT) * ADC_MULTIPLIER;
+
+  return true;
+}
+
+uint32_t ADCSensorModule::getPinMilliVolts() const {
+  return pinMilliVolts_;
+}
+#endif
+// ============ [FEAT-V14 END] ============
+
 uint16_t ADCSensorModule::getRawValue() const {
   return rawValue_;
 }
@@ -3,6 +3,10 @@
 
 #include <Arduino.h>
 #include "config_data_sensors.h"
+#include "../FeatureFlags.h"
+#if ENABLE_FEAT_V17_ROBUST_STATS
+#include "SampleStats.h"
+#endif
 
 /**
  * @brief Módulo ADC para lectura de sensores analógicos en ESP32-S3.
@@ -21,6 +25,24 @@ class ADCSensorModule {
    */
   bool readSensor();
 
+#if ENABLE_FEAT_V14_FAST_ADC
+  /**
+   * @brief Lectura rápida: ráfaga sobremuestreada con calibración eFuse.
+   * @details FEAT-V14. N lecturas consecutivas de analogReadMilliVolts() (curve
+   *          fitting del core) sin delay; descarta las primeras y promedia en mV.
+   *          Deja getRawValue()/getVoltage()/getValue() igual que readSensor(),
+   *          con FEAT_V14_ADC_ADJUSTMENT en lugar de ADC_ADJUSTMENT.
+   * @return true si la lectura fue exitosa.
+   */
+  bool readOversampled();
+
+  /**
+   * @brief Promedio en mV de la última readOversampled() (tensión en el pin).
+   * @return Milivoltios calibrados.
+   */
+  uint32_t getPinMilliVolts() const;
+#endif
+
   /**
    * @brief Obtiene el valor ADC en crudo (0-4095).
    * @return Valor ADC en crudo.
@@ -49,6 +71,9 @@ class ADCSensorModule {
   uint16_t rawValue_;
   float voltage_;
   float value_;
+#if ENABLE_FEAT_V14_FAST_ADC
+  uint32_t pinMilliVolts_ = 0;
+#endif
 };
 
 #endif
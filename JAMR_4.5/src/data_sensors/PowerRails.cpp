@@ -0,0 +1,86 @@
+/**
+ * @file PowerRails.cpp
+ * @brief Implementación del planificador de rieles de sonda
+ * @version FEAT-V15
+ * @date 2026-10-18
+ */
+
+#include "PowerRails.h"
+#include <driver/gpio.h>
+
+namespace PowerRails {
+
+/** @brief Descripción estática de un riel */
+struct RailDef {
+  int8_t pin;          ///< Pin de enable (-1 = alimentación permanente)
+  const char* name;
+};
+
+static const RailDef kRails[RAIL_COUNT] = {
+  { ENPOWER, "RS485" },
+  { -1,      "I2C"   },
+};
+
+static uint32_t s_settleMs[RAIL_COUNT] = { FEAT_V15_RS485_SETTLE_MS, FEAT_V15_I2C_SETTLE_MS };  // Ajustable (FEAT-V16)
+static bool s_on[RAIL_COUNT] = { false, true };     // I2C energizado desde boot
+static uint32_t s_onAtMs[RAIL_COUNT] = { 0, 0 };     // millis() al encender
+
+void powerOn(Rail rail) {
+  if (rail >= RAIL_COUNT || s_on[rail]) return;
+
+  const RailDef& def = kRails[rail];
+  if (def.pin >= 0) {
+    // SleepModule mantiene el pin en LOW con hold durante deep sleep
+    gpio_hold_dis((gpio_num_t)def.pin);
+    pinMode(def.pin, OUTPUT);
+    digitalWrite(def.pin, HIGH);
+  }
+  s_on[rail] = true;
+  s_onAtMs[rail] = millis();
+}
+
+void powerOff(Rail rail) {
+  if (rail >= RAIL_COUNT) return;
+
+  const RailDef& def = kRails[rail];
+  if (def.pin < 0) return;  // Sin enable: siempre alimentado
+  digitalWrite(def.pin, LOW);
+  s_on[rail] = false;
+}
+
+void setSettleMs(Rail rail, uint32_t settleMs) {
+  if (rail < RAIL_COUNT) s_settleMs[rail] = settleMs;
+}
+
+uint32_t remainingMs(Rail rail) {
+  if (rail >= RAIL_COUNT) return 0;
+  if (!s_on[rail]) return UINT32_MAX;
+
+  uint32_t elapsed = millis() - s_onAtMs[rail];
+  uint32_t settle = s_settleMs[rail];
+  return (elapsed >= settle) ? 0 : (settle - elapsed);
+}
+
+bool waitReady(Rail rail, uint32_t untilMs, uint32_t* waitedMs) {
+  uint32_t t0 = millis();
+  uint32_t rem = remainingMs(rail);
+
+  while (rem > 0) {
+    int32_t budget = (int32_t)(untilMs - millis());
+    if (budget <= 0 || rem == UINT32_MAX) {
+      if (waitedMs) *waitedMs = millis() - t0;
+      return false;
+    }
+    delay(min(rem, (uint32_t)budget));
+    rem = remainingMs(rail);
+  }
+
+  if (waitedMs) *waitedMs = millis() - t0;
+  return true;
+}
+
+const char* name(Rail rail) {
+  return (rail < RAIL_COUNT) ? kRails[rail].name : "?";
+}
+
+}  // namespace PowerRails
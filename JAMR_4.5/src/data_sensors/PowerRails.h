@@ -0,0 +1,75 @@
+/**
+ * @file PowerRails.h
+ * @brief Planificador de rieles de alimentación de sondas con tiempo de asentamiento.
+ * @version FEAT-V15
+ * @date 2026-10-18
+ *
+ * Cada sonda tiene un riel (pin de enable o alimentación permanente) y un tiempo
+ * de asentamiento propio. Los rieles se encienden lo antes posible tras el wakeup
+ * y el lector solo espera lo que falte del asentamiento, en lugar de descartar
+ * lecturas a ciegas.
+ */
+
+#ifndef POWERRAILS_H
+#define POWERRAILS_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+#include "config_data_sensors.h"
+
+namespace PowerRails {
+
+/**
+ * @brief Rieles de sonda conocidos.
+ */
+enum Rail : uint8_t {
+  RAIL_RS485 = 0,  ///< Sonda Modbus (ENPOWER)
+  RAIL_I2C,        ///< AHT20 (alimentación permanente, asentamiento desde boot)
+  RAIL_COUNT
+};
+
+/**
+ * @brief Enciende un riel y registra el instante (idempotente).
+ * @param rail Riel a encender.
+ */
+void powerOn(Rail rail);
+
+/**
+ * @brief Apaga un riel (si tiene pin de enable).
+ * @param rail Riel a apagar.
+ */
+void powerOff(Rail rail);
+
+/**
+ * @brief Cambia el asentamiento de un riel (ej. máximo de sondas detectadas).
+ * @param rail Riel.
+ * @param settleMs Nuevo asentamiento en ms.
+ */
+void setSettleMs(Rail rail, uint32_t settleMs);
+
+/**
+ * @brief Milisegundos que faltan para que el riel esté asentado.
+ * @param rail Riel a consultar.
+ * @return 0 si ya está listo; UINT32_MAX si está apagado.
+ */
+uint32_t remainingMs(Rail rail);
+
+/**
+ * @brief Espera hasta que el riel esté asentado o venza el límite.
+ * @param rail Riel a esperar.
+ * @param untilMs Límite absoluto en millis().
+ * @param[out] waitedMs Tiempo efectivamente esperado (opcional).
+ * @return true si el riel quedó listo antes del límite.
+ */
+bool waitReady(Rail rail, uint32_t untilMs, uint32_t* waitedMs = nullptr);
+
+/**
+ * @brief Nombre corto del riel para logs.
+ * @param rail Riel.
+ * @return Cadena estática.
+ */
+const char* name(Rail rail);
+
+}  // namespace PowerRails
+
+#endif
@@ -0,0 +1,374 @@
+/**
+ * @file ProbeRegistry.cpp
+ * @brief Implementación del registro de sondas Modbus
+ * @version FEAT-V16
+ * @date 2026-10-18
+ */
+
+#include "ProbeRegistry.h"
+
+#if ENABLE_FEAT_V16_PROBE_REGISTRY
+
+#include <Preferences.h>
+
+namespace ProbeRegistry {
+
+// ============================================================
+// TABLA DE DRIVERS - agregar sondas nuevas aquí
+// ============================================================
+// Orden = prioridad de detección. Un slave ID lo reclama el primer driver
+// que responde (DFRobot EC/pH antes que EC: el de 3 registros también
+// respondería en un equipo EC/pH).
+
+/** @brief Sonda RS485 de JAMR 4.5 (slave 18, holding 0..3, valores crudos) */
+static const ProbeRegister kRegsJamr45[] = {
+  { 0x0000, 0, 1, 1, false },
+  { 0x0001, 1, 1, 1, false },
+  { 0x0002, 2, 1, 1, false },
+  { 0x0003, 3, 1, 1, false },
+};
+
+/** @brief DFRobot EC/pH (4.4 read_dfrobot_sonda_ecph): hum, temp, EC, pH */
+static const ProbeRegister kRegsDfrobotEcPh[] = {
+  { 0x0000, 1, 1, 1, false },
+  { 0x0001, 0, 1, 1, true  },
+  { 0x0002, 2, 1, 1, false },
+  { 0x0003, 3, 1, 1, false },
+};
+
+/** @brief DFRobot EC (4.4 read_dfrobot_sonda_ec): hum, temp, EC */
+static const ProbeRegister kRegsDfrobotEc[] = {
+  { 0x0000, 1, 1, 1, false },
+  { 0x0001, 0, 1, 1, true  },
+  { 0x0002, 2, 1, 1, false },
+};
+
+/** @brief Seeed EC (4.4 read_seed_sonda_ec, input regs): temp, hum, EC */
+static const ProbeRegister kRegsSeedEc[] = {
+  { 0x0000, 0, 1, 1, true  },
+  { 0x0001, 1, 1, 1, false },
+  { 0x0002, 2, 1, 1, false },
+};
+
+#define PROBE_REGS(a) a, (uint8_t)(sizeof(a) / sizeof(a[0]))
+
+static const ProbeDriver kDrivers[] = {
+  { "JAMR45-RS485",  MODBUS_SLAVE_ID, RS485_FN_HOLDING, PROBE_REGS(kRegsJamr45),      1500 },
+  { "DFROBOT-ECPH",  0x01,            RS485_FN_HOLDING, PROBE_REGS(kRegsDfrobotEcPh), 2000 },
+  { "DFROBOT-EC",    0x01,            RS485_FN_HOLDING, PROBE_REGS(kRegsDfrobotEc),   2000 },
+  { "SEEED-EC",      0x12,            RS485_FN_INPUT,   PROBE_REGS(kRegsSeedEc),      2000 },
+};
+
+static const uint8_t kDriverCount = sizeof(kDrivers) / sizeof(kDrivers[0]);
+static_assert(sizeof(kDrivers) / sizeof(kDrivers[0]) <= 32, "presentMask es de 32 bits");
+
+// ============================================================
+// ESTADO
+// ============================================================
+
+/** @brief Petición Modbus del plan (rango fusionado de un driver) */
+struct Block {
+  uint8_t driver;
+  uint16_t start;
+  uint8_t count;
+};
+
+// Espejo RTC del resultado persistido: evita abrir NVS en cada wakeup
+RTC_DATA_ATTR static uint32_t s_rtcSig = 0;
+RTC_DATA_ATTR static uint32_t s_rtcMask = 0;
+// Detección sin resultado o sondeo caído: re-detectar en el próximo wakeup
+RTC_DATA_ATTR static bool s_rtcRedetect = false;
+RTC_DATA_ATTR static uint8_t s_rtcFailCycles = 0;
+RTC_DATA_ATTR static uint8_t s_rtcEmptyDetects = 0;  // Detecciones vacías seguidas
+RTC_DATA_ATTR static uint8_t s_rtcRedetectWait = 0;  // Ciclos hasta el próximo intento
+
+static RS485Module* s_bus = nullptr;
+static uint32_t s_mask = 0;
+static bool s_pending = true;
+static bool s_triedThisBoot = false;    // Una detección por boot como máximo
+static bool s_failCounted = false;      // Ciclo ya contado en s_rtcFailCycles
+static Block s_blocks[FEAT_V16_MAX_BLOCKS];
+static uint8_t s_blockCount = 0;
+
+// ============================================================
+// FUNCIONES AUXILIARES INTERNAS
+// ============================================================
+
+/**
+ * @brief Firma FNV-1a de la tabla: si cambia el firmware, se re-detecta
+ */
+static uint32_t tableSignature() {
+  uint32_t h = 2166136261UL;
+  auto mix = [&h](uint32_t v) {
+    for (uint8_t i = 0; i < 4; i++) {
+      h ^= (v >> (8 * i)) & 0xFF;
+      h *= 16777619UL;
+    }
+  };
+  mix(kDriverCount);
+  for (uint8_t d = 0; d < kDriverCount; d++) {
+    mix(kDrivers[d].slaveId);
+    mix(kDrivers[d].function);
+    for (uint8_t r = 0; r < kDrivers[d].regCount; r++) {
+      mix(kDrivers[d].regs[r].address);
+      mix(kDrivers[d].regs[r].slot);
+    }
+  }
+  return h | 1u;  // 0 = espejo RTC vacío
+}
+
+/**
+ * @brief Fusiona los registros de un driver en bloques contiguos
+ * @return Bloques agregados (0 si no hay espacio en el plan)
+ */
+static uint8_t planDriver(uint8_t d) {
+  const ProbeDriver& drv = kDrivers[d];
+  uint8_t added = 0;
+  uint8_t r = 0;
+
+  while (r < drv.regCount) {
+    if (s_blockCount >= FEAT_V16_MAX_BLOCKS) {
+      Serial.printf("[FEAT-V16] Plan lleno, %s incompleto\n", drv.name);
+      break;
+    }
+    Block& b = s_blocks[s_blockCount];
+    b.driver = d;
+    b.start = drv.regs[r].address;
+    uint16_t end = b.start;  // Último registro incluido
+
+    // Fusionar mientras el hueco sea pequeño y quepa en el buffer de respuesta
+    while (++r < drv.regCount) {
+      uint16_t next = drv.regs[r].address;
+      if (next - end > FEAT_V16_MERGE_GAP + 1) break;
+      if (next - b.start + 1 > RS485_MAX_BLOCK_REGS) break;
+      end = next;
+    }
+    b.count = (uint8_t)(end - b.start + 1);
+    s_blockCount++;
+    added++;
+  }
+  return added;
+}
+
+/**
+ * @brief Máscara a sondear sin detección válida: la última detectada o, sin
+ *        nada previo, la sonda de JAMR 4.5 (lo que lee el equipo sin FEAT-V16)
+ */
+static uint32_t fallbackMask() {
+  return s_rtcMask ? s_rtcMask : 1UL;
+}
+
+/**
+ * @brief Reconstruye el plan de peticiones a partir de s_mask
+ */
+static void buildPlan() {
+  s_blockCount = 0;
+  for (uint8_t d = 0; d < kDriverCount; d++) {
+    if (s_mask & (1UL << d)) (void)planDriver(d);
+  }
+}
+
+/**
+ * @brief Ejecuta los bloques del plan y vuelca valores escalados en out
+ * @param onlyDriver Limitar a un driver (0xFF = todos)
+ * @param slotTaken Slots ya asignados (colisión entre sondas: gana la primera)
+ */
+static bool runBlocks(uint8_t onlyDriver, int32_t out[PROBE_SLOT_COUNT], bool slotTaken[PROBE_SLOT_COUNT]) {
+  bool allOk = true;
+  uint16_t buf[RS485_MAX_BLOCK_REGS];
+
+  for (uint8_t i = 0; i < s_blockCount; i++) {
+    const Block& b = s_blocks[i];
+    if (onlyDriver != 0xFF && b.driver != onlyDriver) continue;
+
+    const ProbeDriver& drv = kDrivers[b.driver];
+    if (!s_bus->readRegisters(drv.slaveId, drv.function, b.start, b.count, buf)) {
+      allOk = false;
+      continue;
+    }
+
+    for (uint8_t r = 0; r < drv.regCount; r++) {
+      const ProbeRegister& reg = drv.regs[r];
+      if (reg.address < b.start || reg.address >= b.start + b.count) continue;
+      if (reg.slot >= PROBE_SLOT_COUNT || slotTaken[reg.slot]) continue;
+
+      uint16_t raw = buf[reg.address - b.start];
+      int32_t v = reg.isSigned ? (int32_t)(int16_t)raw : (int32_t)raw;
+      if (reg.scaleDen != 0) v = (v * reg.scaleNum) / reg.scaleDen;
+      out[reg.slot] = v;
+      slotTaken[reg.slot] = true;
+    }
+  }
+  return allOk;
+}
+
+// ============================================================
+// API PÚBLICA
+// ============================================================
+
+void detect() {
+  uint32_t mask = 0;
+  uint32_t t0 = millis();
+  Serial.println(F("[FEAT-V16] Detectando sondas Modbus..."));
+
+  for (uint8_t d = 0; d < kDriverCount; d++) {
+    // Un slave ID pertenece al primer driver que respondió
+    bool claimed = false;
+    for (uint8_t p = 0; p < d; p++) {
+      if ((mask & (1UL << p)) && kDrivers[p].slaveId == kDrivers[d].slaveId) claimed = true;
+    }
+    if (claimed) continue;
+
+    s_mask = 1UL << d;
+    buildPlan();
+
+    int32_t scratch[PROBE_SLOT_COUNT] = {0};
+    bool ok = false;
+    for (uint8_t t = 0; t < FEAT_V16_DETECT_TRIES && !ok; t++) {
+      bool taken[PROBE_SLOT_COUNT] = {false};
+      ok = runBlocks(d, scratch, taken);
+    }
+    Serial.printf("[FEAT-V16]   %-14s id=%3u fn=0x%02X : %s\n", kDrivers[d].name,
+                  (unsigned)kDrivers[d].slaveId, (unsigned)kDrivers[d].function,
+                  ok ? "PRESENTE" : "-");
+    if (ok) mask |= 1UL << d;
+  }
+
+  s_triedThisBoot = true;
+  if (mask == 0) {
+    // Nadie respondió (cable, calentamiento, EMI): no se persiste y se
+    // reintenta tras 0, 1, 3, 7... ciclos (un equipo sin sonda no paga la
+    // detección en cada ciclo). Mientras tanto se sondea fallbackMask().
+    s_mask = fallbackMask();
+    s_rtcRedetect = true;
+    if (s_rtcEmptyDetects < 8) s_rtcEmptyDetects++;
+    uint32_t wait = (1UL << (s_rtcEmptyDetects - 1)) - 1;
+    s_rtcRedetectWait = (uint8_t)min(wait, (uint32_t)FEAT_V16_REDETECT_MAX_WAIT);
+    buildPlan();
+    Serial.printf("[FEAT-V16] Ninguna sonda respondió en %lu ms: nuevo intento en %u ciclos\n",
+                  (unsigned long)(millis() - t0), (unsigned)s_rtcRedetectWait + 1);
+    return;
+  }
+
+  s_mask = mask;
+  s_pending = false;
+  s_rtcRedetect = false;
+  s_rtcFailCycles = 0;
+  s_rtcEmptyDetects = 0;
+  s_rtcRedetectWait = 0;
+  buildPlan();
+
+  uint32_t sig = tableSignature();
+  s_rtcSig = sig;
+  s_rtcMask = mask;
+
+  Preferences prefs;
+  if (prefs.begin(FEAT_V16_NVS_NAMESPACE, false)) {
+    prefs.putUInt("sig", sig);
+    prefs.putUInt("mask", mask);
+    prefs.end();
+  }
+  Serial.printf("[FEAT-V16] Detección: mask=0x%08lX en %lu ms\n",
+                (unsigned long)mask, (unsigned long)(millis() - t0));
+}
+
+void begin(RS485Module& bus, bool coldBoot) {
+  s_bus = &bus;
+  uint32_t sig = tableSignature();
+
+  if (coldBoot) {
+    s_pending = true;  // Hardware pudo cambiar con el equipo apagado
+  } else if (s_rtcRedetect) {
+    s_pending = true;  // Última detección vacía o sondeo caído varios ciclos
+    if (s_rtcRedetectWait > 0) {
+      // Espera entre detecciones vacías: este boot solo sondea
+      s_rtcRedetectWait--;
+      s_triedThisBoot = true;
+      s_mask = fallbackMask();
+    }
+  } else if (s_rtcSig == sig) {
+    s_mask = s_rtcMask;
+    s_pending = false;
+  } else {
+    Preferences prefs;
+    s_pending = true;
+    if (prefs.begin(FEAT_V16_NVS_NAMESPACE, true)) {
+      if (prefs.getUInt("sig", 0) == sig) {
+        s_mask = prefs.getUInt("mask", 0);
+        s_rtcSig = sig;
+        s_rtcMask = s_mask;
+        s_pending = false;
+      }
+      prefs.end();
+    }
+  }
+
+  if (!detectionPending()) {
+    buildPlan();
+    Serial.printf("[FEAT-V16] Sondas: mask=0x%08lX, %u peticiones por ciclo\n",
+                  (unsigned long)s_mask, (unsigned)s_blockCount);
+  } else {
+    Serial.println(F("[FEAT-V16] Detección de sondas pendiente (primer sondeo)"));
+  }
+}
+
+bool poll(int32_t out[PROBE_SLOT_COUNT]) {
+  if (s_bus == nullptr) return false;
+  if (detectionPending()) detect();
+
+  for (uint8_t i = 0; i < PROBE_SLOT_COUNT; i++) out[i] = 0;
+  if (s_blockCount == 0) return false;
+
+  bool taken[PROBE_SLOT_COUNT] = {false};
+  bool ok = runBlocks(0xFF, out, taken);
+  if (ok) {
+    s_rtcFailCycles = 0;
+  } else if (!s_failCounted) {
+    // Un ciclo cuenta una vez aunque el muestreo sondee varias veces
+    s_failCounted = true;
+    if (++s_rtcFailCycles >= FEAT_V16_REDETECT_FAILS && !s_rtcRedetect) {
+      s_rtcRedetect = true;
+      Serial.printf("[FEAT-V16] %u ciclos sin respuesta: re-detección en el próximo wakeup\n",
+                    (unsigned)s_rtcFailCycles);
+    }
+  }
+  return ok;
+}
+
+uint16_t warmupMs() {
+  uint16_t w = 0;
+  for (uint8_t d = 0; d < kDriverCount; d++) {
+    if (s_pending || (s_mask & (1UL << d))) w = max(w, kDrivers[d].warmupMs);
+  }
+  return w;
+}
+
+bool detectionPending() {
+  return s_pending && !s_triedThisBoot;
+}
+
+uint32_t presentMask() {
+  return s_mask;
+}
+
+void printStatus() {
+  Serial.println(F("\n=== SONDAS MODBUS (FEAT-V16) ==="));
+  for (uint8_t d = 0; d < kDriverCount; d++) {
+    Serial.printf("  [%c] %-14s id=%3u fn=0x%02X regs=%u warmup=%u ms\n",
+                  (s_mask & (1UL << d)) ? 'X' : ' ', kDrivers[d].name,
+                  (unsigned)kDrivers[d].slaveId, (unsigned)kDrivers[d].function,
+                  (unsigned)kDrivers[d].regCount, (unsigned)kDrivers[d].warmupMs);
+  }
+  for (uint8_t i = 0; i < s_blockCount; i++) {
+    const ProbeDriver& drv = kDrivers[s_blocks[i].driver];
+    Serial.printf("  Petición %u: id=%u fn=0x%02X addr=0x%04X n=%u\n", (unsigned)i,
+                  (unsigned)drv.slaveId, (unsigned)drv.function,
+                  (unsigned)s_blocks[i].start, (unsigned)s_blocks[i].count);
+  }
+  if (s_pending) Serial.println(F("  (detección pendiente)"));
+  Serial.println(F("================================"));
+}
+
+}  // namespace ProbeRegistry
+
+#endif  // ENABLE_FEAT_V16_PROBE_REGISTRY
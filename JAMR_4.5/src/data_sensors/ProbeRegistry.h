@@ -0,0 +1,104 @@
+/**
+ * @file ProbeRegistry.h
+ * @brief Registro de drivers de sondas Modbus con autodetección y sondeo agrupado.
+ * @version FEAT-V16
+ * @date 2026-10-18
+ *
+ * Cada driver declara su slave ID, función Modbus, mapa de registros (con
+ * escalado y slot de trama) y tiempo de calentamiento. La detección corre una
+ * vez en boot en frío y se persiste en NVS (espejo en RTC); los wakeups solo
+ * sondean las sondas presentes, fusionando rangos de registros adyacentes en
+ * una sola petición.
+ *
+ * Slots de trama (var1..var4), mismo orden que la trama JAMR 4.4:
+ *   0 = temperatura suelo, 1 = humedad suelo, 2 = conductividad, 3 = pH
+ */
+
+#ifndef PROBEREGISTRY_H
+#define PROBEREGISTRY_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+#include "config_data_sensors.h"
+#include "RS485Module.h"
+
+/** @brief Slots de sonda en la trama (var1..var4). */
+static const uint8_t PROBE_SLOT_COUNT = MODBUS_REGISTER_COUNT;
+
+/**
+ * @brief Registro individual de un driver.
+ */
+struct ProbeRegister {
+  uint16_t address;   ///< Dirección Modbus (base 0)
+  uint8_t slot;       ///< Slot de trama destino (0..PROBE_SLOT_COUNT-1)
+  int16_t scaleNum;   ///< Escalado: valor = raw * num / den
+  int16_t scaleDen;
+  bool isSigned;      ///< Interpretar raw como int16
+};
+
+/**
+ * @brief Descripción estática de una sonda Modbus.
+ */
+struct ProbeDriver {
+  const char* name;
+  uint8_t slaveId;
+  uint8_t function;             ///< RS485_FN_HOLDING (0x03) o RS485_FN_INPUT (0x04)
+  const ProbeRegister* regs;    ///< Ordenados por dirección ascendente
+  uint8_t regCount;
+  uint16_t warmupMs;            ///< Calentamiento tras energizar
+};
+
+namespace ProbeRegistry {
+
+/**
+ * @brief Carga el resultado de detección (RTC o NVS) y arma el plan de sondeo.
+ * @param bus Módulo RS485 ya inicializado.
+ * @param coldBoot true en boot en frío: fuerza nueva detección en el primer poll().
+ */
+void begin(RS485Module& bus, bool coldBoot);
+
+/**
+ * @brief Prueba cada driver (DETECT_TRIES intentos) y persiste los presentes.
+ * @note Requiere la sonda energizada y asentada. Puede tardar varios
+ *       timeouts Modbus por driver ausente: solo en boot en frío, tras una
+ *       detección vacía (espera creciente, tope FEAT_V16_REDETECT_MAX_WAIT
+ *       ciclos) o tras FEAT_V16_REDETECT_FAILS ciclos de sondeo fallido. Si ninguna sonda responde no persiste nada
+ *       y sondea lo último detectado (o la sonda de JAMR 4.5).
+ */
+void detect();
+
+/**
+ * @brief true si falta detectar en este boot (sin resultado válido y sin
+ *        intento todavía).
+ * @return Estado de detección.
+ */
+bool detectionPending();
+
+/**
+ * @brief Sondea las sondas presentes (detecta antes si está pendiente).
+ * @param[out] out Valores escalados por slot (0 en slots sin sonda).
+ * @return true si todas las peticiones del plan respondieron.
+ */
+bool poll(int32_t out[PROBE_SLOT_COUNT]);
+
+/**
+ * @brief Calentamiento requerido: máximo de las sondas presentes
+ *        (o de todas si la detección está pendiente).
+ * @return Milisegundos.
+ */
+uint16_t warmupMs();
+
+/**
+ * @brief Máscara de drivers detectados (bit i = driver i).
+ * @return Máscara.
+ */
+uint32_t presentMask();
+
+/**
+ * @brief Imprime drivers, presencia y plan de peticiones.
+ */
+void printStatus();
+
+}  // namespace ProbeRegistry
+
+#endif
@@ -47,6 +47,32 @@ bool RS485Module::writeRegister(uint16_t address, uint16_t value) {
   return (result == node_.ku8MBSuccess);
 }
 
+// ============ [FEAT-V16 START] Lectura genérica para el registro de sondas ============
+#if ENABLE_FEAT_V16_PROBE_REGISTRY
+bool RS485Module::readRegisters(uint8_t slaveId, uint8_t function, uint16_t address,
+                                uint16_t count, uint16_t* out) {
+  if (count == 0 || count > RS485_MAX_BLOCK_REGS || out == nullptr) {
+    return false;
+  }
+
+  node_.begin(slaveId, *serialPort_);
+  uint8_t result = (function == RS485_FN_INPUT)
+                       ? node_.readInputRegisters(address, count)
+                       : node_.readHoldingRegisters(address, count);
+  node_.begin(MODBUS_SLAVE_ID, *serialPort_);  // readSensor() sigue en el slave por defecto
+
+  if (result != node_.ku8MBSuccess) {
+    return false;
+  }
+
+  for (uint16_t i = 0; i < count; i++) {
+    out[i] = node_.getResponseBuffer(i);
+  }
+  return true;
+}
+#endif
+// ============ [FEAT-V16 END] ============
+
 void RS485Module::enablePow() {
   pinMode(ENPOWER, OUTPUT);
   digitalWrite(ENPOWER, HIGH);
@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <ModbusMaster.h>
 #include "config_data_sensors.h"
+#include "../FeatureFlags.h"
 
 /**
  * @brief Módulo RS485 Modbus RTU para ESP32-S3.
@@ -44,6 +45,20 @@ class RS485Module {
    */
   bool writeRegister(uint16_t address, uint16_t value);
 
+#if ENABLE_FEAT_V16_PROBE_REGISTRY
+  /**
+   * @brief Lee un bloque de registros de cualquier slave (FEAT-V16).
+   * @param slaveId Dirección Modbus del equipo.
+   * @param function RS485_FN_HOLDING (0x03) o RS485_FN_INPUT (0x04).
+   * @param address Primer registro (base 0).
+   * @param count Cantidad (1..RS485_MAX_BLOCK_REGS).
+   * @param[out] out Buffer de al menos count registros.
+   * @return true si la lectura fue correcta.
+   */
+  bool readRegisters(uint8_t slaveId, uint8_t function, uint16_t address,
+                     uint16_t count, uint16_t* out);
+#endif
+
   /**
    * @brief Habilita la alimentación del sensor.
    */
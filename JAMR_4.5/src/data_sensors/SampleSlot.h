@@ -0,0 +1,73 @@
+/**
+ * @file SampleSlot.h
+ * @brief Slot lock-free de un solo productor para publicar resultados entre tareas.
+ * @version FEAT-V13
+ * @date 2026-10-18
+ *
+ * Implementa un seqlock: el productor incrementa la secuencia a impar antes de
+ * escribir y a par al terminar. El consumidor reintenta si la secuencia cambió
+ * o es impar durante la copia. Sin mutex, sin bloqueo del productor.
+ *
+ * Restricción: UN solo productor por slot. Cualquier número de lectores.
+ */
+
+#ifndef SAMPLESLOT_H
+#define SAMPLESLOT_H
+
+#include <Arduino.h>
+#include <atomic>
+
+template <typename T>
+class SampleSlot {
+ public:
+  SampleSlot() : seq_(0) {}
+
+  /**
+   * @brief Vacía el slot (solo cuando el productor no está activo).
+   */
+  void reset() {
+    seq_.store(0, std::memory_order_release);
+  }
+
+  /**
+   * @brief Publica un valor (solo el productor).
+   * @param value Valor a publicar.
+   */
+  void publish(const T& value) {
+    uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    value_ = value;
+    seq_.store(s + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Intenta leer el último valor publicado.
+   * @param out Destino de la copia.
+   * @return true si había un valor estable; false si vacío o en escritura.
+   */
+  bool tryRead(T& out) const {
+    uint32_t s1 = seq_.load(std::memory_order_acquire);
+    if (s1 == 0 || (s1 & 1u)) {
+      return false;
+    }
+    out = value_;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint32_t s2 = seq_.load(std::memory_order_relaxed);
+    return s1 == s2;
+  }
+
+  /**
+   * @brief Número de publicaciones realizadas desde reset().
+   * @return Publicaciones completas.
+   */
+  uint32_t publications() const {
+    return seq_.load(std::memory_order_acquire) / 2;
+  }
+
+ private:
+  std::atomic<uint32_t> seq_;
+  T value_;
+};
+
+#endif
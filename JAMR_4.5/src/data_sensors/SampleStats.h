@@ -0,0 +1,206 @@
+/**
+ * @file SampleStats.h
+ * @brief Estadística en streaming de punto fijo para muestras de sensores.
+ * @version FEAT-V17
+ * @date 2026-10-18
+ *
+ * Acumula hasta N muestras enteras (unidades de trama: V x100, °C x100,
+ * registro crudo, mV) y ofrece min/max/count, mediana, MAD y una reducción
+ * final con rechazo de outliers por MAD seguida de una política elegida en
+ * compilación (media, mediana o media recortada). Sin float ni heap.
+ *
+ * Uso típico (muestreo adaptativo):
+ * @code
+ *   SampleStats::Stream<8, SampleStats::TrimmedMean> s;
+ *   while (s.count() < 8) {
+ *     s.add(leer());
+ *     if (s.count() >= 3 && s.stable(TOL)) break;   // señal estable: cortar
+ *   }
+ *   int32_t v = s.reduce();
+ * @endcode
+ */
+
+#ifndef SAMPLESTATS_H
+#define SAMPLESTATS_H
+
+#include <Arduino.h>
+#include "../FeatureFlags.h"
+
+namespace SampleStats {
+
+/**
+ * @brief División entera con redondeo al más cercano (simétrico en signo).
+ */
+static inline int32_t divRound(int64_t num, int32_t den) {
+  if (den <= 0) return 0;
+  return (int32_t)((num >= 0) ? (num + den / 2) / den : (num - den / 2) / den);
+}
+
+/**
+ * @brief Ordena in-place (inserción; N pequeño).
+ */
+static inline void sortInPlace(int32_t* v, uint8_t n) {
+  for (uint8_t i = 1; i < n; i++) {
+    int32_t x = v[i];
+    int16_t j = i - 1;
+    while (j >= 0 && v[j] > x) {
+      v[j + 1] = v[j];
+      j--;
+    }
+    v[j + 1] = x;
+  }
+}
+
+/**
+ * @brief Mediana de un arreglo ya ordenado (promedio de centrales si n par).
+ */
+static inline int32_t sortedMedian(const int32_t* v, uint8_t n) {
+  if (n == 0) return 0;
+  if (n & 1u) return v[n / 2];
+  return divRound((int64_t)v[n / 2 - 1] + v[n / 2], 2);
+}
+
+// ============================================================
+// POLÍTICAS DE REDUCCIÓN (reciben el subconjunto ordenado sin outliers)
+// ============================================================
+
+/** @brief Media aritmética */
+struct Mean {
+  static int32_t reduce(const int32_t* sorted, uint8_t n) {
+    int64_t sum = 0;
+    for (uint8_t i = 0; i < n; i++) sum += sorted[i];
+    return divRound(sum, n);
+  }
+};
+
+/** @brief Mediana (valores discretos, ej. registros Modbus) */
+struct Median {
+  static int32_t reduce(const int32_t* sorted, uint8_t n) {
+    return sortedMedian(sorted, n);
+  }
+};
+
+/** @brief Media recortada: descarta n/FEAT_V17_TRIM_DIV por extremo */
+struct TrimmedMean {
+  static int32_t reduce(const int32_t* sorted, uint8_t n) {
+    uint8_t trim = n / FEAT_V17_TRIM_DIV;
+    return Mean::reduce(sorted + trim, n - 2 * trim);
+  }
+};
+
+// ============================================================
+// ACUMULADOR
+// ============================================================
+
+/**
+ * @brief Acumulador de hasta N muestras con reducción robusta.
+ * @tparam N Capacidad (máximo de muestras).
+ * @tparam Policy Política aplicada tras el rechazo MAD.
+ */
+template <uint8_t N, typename Policy>
+class Stream {
+ public:
+  Stream() { reset(); }
+
+  /** @brief Vacía el acumulador */
+  void reset() {
+    count_ = 0;
+    min_ = INT32_MAX;
+    max_ = INT32_MIN;
+    rejected_ = 0;
+  }
+
+  /**
+   * @brief Agrega una muestra.
+   * @return false si ya está lleno (la muestra se ignora).
+   */
+  bool add(int32_t x) {
+    if (count_ >= N) return false;
+    samples_[count_++] = x;
+    if (x < min_) min_ = x;
+    if (x > max_) max_ = x;
+    return true;
+  }
+
+  uint8_t count() const { return count_; }
+  bool full() const { return count_ >= N; }
+  int32_t min() const { return count_ ? min_ : 0; }
+  int32_t max() const { return count_ ? max_ : 0; }
+
+  /** @brief Muestras rechazadas en la última reduce() */
+  uint8_t rejected() const { return rejected_; }
+
+  /** @brief Mediana de las muestras actuales */
+  int32_t median() const {
+    int32_t s[N];
+    copySorted(s);
+    return sortedMedian(s, count_);
+  }
+
+  /** @brief Desviación absoluta mediana (MAD) */
+  int32_t mad() const {
+    int32_t s[N];
+    copySorted(s);
+    return madOfSorted(s, count_, sortedMedian(s, count_));
+  }
+
+  /**
+   * @brief true si la dispersión robusta (MAD) no supera la tolerancia.
+   * @param tol Tolerancia en las mismas unidades que las muestras.
+   */
+  bool stable(int32_t tol) const {
+    return count_ >= 2 && mad() <= tol;
+  }
+
+  /**
+   * @brief Rechaza outliers (|x - mediana| > K * 1.5 * MAD) y aplica Policy.
+   * @return Valor reducido (0 si no hay muestras).
+   */
+  int32_t reduce() {
+    rejected_ = 0;
+    if (count_ == 0) return 0;
+
+    int32_t s[N];
+    copySorted(s);
+    int32_t med = sortedMedian(s, count_);
+    int32_t mad = madOfSorted(s, count_, med);
+    if (mad < 1) mad = 1;  // Señal cuantizada: tolerar 1 LSB
+
+    // Umbral: 2*|x - med| > 3*K*MAD  (1.4826 ≈ 3/2, sin float)
+    int64_t limit = (int64_t)3 * FEAT_V17_MAD_K * mad;
+    uint8_t lo = 0, hi = count_;  // Tras ordenar, lo aceptado es contiguo
+    while (lo < hi && 2 * (int64_t)(med - s[lo]) > limit) lo++;
+    while (hi > lo && 2 * (int64_t)(s[hi - 1] - med) > limit) hi--;
+
+    rejected_ = count_ - (hi - lo);
+    if (hi == lo) return med;
+    return Policy::reduce(s + lo, hi - lo);
+  }
+
+ private:
+  void copySorted(int32_t* dst) const {
+    memcpy(dst, samples_, count_ * sizeof(int32_t));
+    sortInPlace(dst, count_);
+  }
+
+  static int32_t madOfSorted(const int32_t* s, uint8_t n, int32_t med) {
+    if (n == 0) return 0;
+    int32_t dev[N];
+    for (uint8_t i = 0; i < n; i++) {
+      int32_t d = s[i] - med;
+      dev[i] = (d < 0) ? -d : d;
+    }
+    sortInPlace(dev, n);
+    return sortedMedian(dev, n);
+  }
+
+  int32_t samples_[N];
+  uint8_t count_;
+  int32_t min_;
+  int32_t max_;
+  uint8_t rejected_;
+};
+
+}  // namespace SampleStats
+
+#endif
@@ -0,0 +1,89 @@
+/**
+ * @file SensorSampler.cpp
+ * @brief Implementación del muestreo concurrente por bus
+ * @version FEAT-V13
+ * @date 2026-10-18
+ */
+
+#include "SensorSampler.h"
+
+static const char* const kTaskNames[] = {"smp_adc", "smp_i2c", "smp_rs485"};
+
+SensorSampler::SensorSampler() {
+  for (uint8_t i = 0; i < static_cast<uint8_t>(SensorBus::COUNT); i++) {
+    jobs_[i].owner = this;
+    jobs_[i].bus = static_cast<SensorBus>(i);
+    jobs_[i].fn = nullptr;
+    jobs_[i].deadlineMs = 0;
+    jobs_[i].running.store(false);
+  }
+}
+
+bool SensorSampler::start(SensorBus bus, SampleJobFn fn, uint32_t deadlineMs) {
+  uint8_t idx = static_cast<uint8_t>(bus);
+  if (idx >= static_cast<uint8_t>(SensorBus::COUNT) || fn == nullptr) {
+    return false;
+  }
+
+  Job& job = jobs_[idx];
+  if (job.running.load()) {
+    // Trabajo del ciclo anterior aún colgado (ej. Modbus sin respuesta)
+    return false;
+  }
+
+  job.fn = fn;
+  job.deadlineMs = deadlineMs;
+  job.slot.reset();
+  job.running.store(true);
+
+  BaseType_t ok = xTaskCreatePinnedToCore(taskEntry, kTaskNames[idx],
+                                          FEAT_V13_TASK_STACK, &job,
+                                          FEAT_V13_TASK_PRIORITY, NULL,
+                                          FEAT_V13_SAMPLER_CORE);
+  if (ok != pdPASS) {
+    job.running.store(false);
+    return false;
+  }
+  return true;
+}
+
+bool SensorSampler::waitFor(SensorBus bus, SensorResult& out, uint32_t untilMs) {
+  uint8_t idx = static_cast<uint8_t>(bus);
+  if (idx >= static_cast<uint8_t>(SensorBus::COUNT)) {
+    return false;
+  }
+
+  Job& job = jobs_[idx];
+  while (true) {
+    if (job.slot.tryRead(out)) {
+      return true;
+    }
+    if ((int32_t)(millis() - untilMs) >= 0) {
+      return false;
+    }
+    vTaskDelay(pdMS_TO_TICKS(2));
+  }
+}
+
+bool SensorSampler::isBusy(SensorBus bus) const {
+  uint8_t idx = static_cast<uint8_t>(bus);
+  if (idx >= static_cast<uint8_t>(SensorBus::COUNT)) {
+    return false;
+  }
+  return jobs_[idx].running.load();
+}
+
+void SensorSampler::taskEntry(void* arg) {
+  Job* job = static_cast<Job*>(arg);
+
+  SensorResult result;
+  memset(&result, 0, sizeof(result));
+
+  uint32_t t0 = millis();
+  job->fn(result, job->deadlineMs);
+  result.latencyMs = millis() - t0;
+
+  job->slot.publish(result);
+  job->running.store(false);
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file SensorSampler.h
+ * @brief Muestreo concurrente por bus (ADC, I2C, RS485) con deadline compartido.
+ * @version FEAT-V13
+ * @date 2026-10-18
+ *
+ * Cada bus corre su lazo de muestreo en una tarea FreeRTOS propia. El resultado
+ * se publica en un SampleSlot (lock-free, un productor). El orquestador espera
+ * los slots hasta el deadline; un bus lento ya no retrasa a los demás.
+ */
+
+#ifndef SENSORSAMPLER_H
+#define SENSORSAMPLER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "../FeatureFlags.h"
+#include "SampleSlot.h"
+
+/** @brief Máximo de valores enteros por resultado (RS485 = 4 registros). */
+static const uint8_t SENSOR_RESULT_MAX_VALUES = 4;
+
+/**
+ * @brief Buses muestreados en paralelo.
+ */
+enum class SensorBus : uint8_t {
+  ADC = 0,
+  I2C,
+  RS485,
+  COUNT
+};
+
+/**
+ * @brief Resultado de un trabajo de muestreo (enteros en unidades de trama).
+ */
+struct SensorResult {
+  bool ok;                                   ///< Al menos una muestra válida
+  uint8_t samples;                           ///< Muestras válidas usadas
+  int32_t values[SENSOR_RESULT_MAX_VALUES];  ///< Valores reducidos
+  uint32_t latencyMs;                        ///< Duración del trabajo
+  bool deadlineHit;                          ///< Se cortó por deadline
+};
+
+/**
+ * @brief Función de muestreo de un bus.
+ * @param out Resultado (pre-inicializado en cero).
+ * @param deadlineMs millis() límite; el trabajo no debe iniciar muestras después.
+ */
+typedef void (*SampleJobFn)(SensorResult& out, uint32_t deadlineMs);
+
+/**
+ * @brief Planificador de trabajos de muestreo, una tarea por bus.
+ */
+class SensorSampler {
+ public:
+  SensorSampler();
+
+  /**
+   * @brief Lanza el trabajo de un bus en su propia tarea.
+   * @param bus Bus a muestrear.
+   * @param fn Función de muestreo (corre en la tarea).
+   * @param deadlineMs millis() límite compartido.
+   * @return false si el bus sigue ocupado por un trabajo anterior o falló xTaskCreate.
+   */
+  bool start(SensorBus bus, SampleJobFn fn, uint32_t deadlineMs);
+
+  /**
+   * @brief Espera el resultado de un bus.
+   * @param bus Bus a esperar.
+   * @param out Resultado (intacto si no llegó).
+   * @param untilMs millis() máximo de espera.
+   * @return true si el resultado llegó a tiempo.
+   */
+  bool waitFor(SensorBus bus, SensorResult& out, uint32_t untilMs);
+
+  /**
+   * @brief Indica si la tarea de un bus sigue viva.
+   * @param bus Bus a consultar.
+   * @return true si hay un trabajo corriendo.
+   */
+  bool isBusy(SensorBus bus) const;
+
+ private:
+  struct Job {
+    SensorSampler* owner;
+    SensorBus bus;
+    SampleJobFn fn;
+    uint32_t deadlineMs;
+    std::atomic<bool> running;
+    SampleSlot<SensorResult> slot;
+  };
+
+  static void taskEntry(void* arg);
+
+  Job jobs_[static_cast<uint8_t>(SensorBus::COUNT)];
+};
+
+#endif
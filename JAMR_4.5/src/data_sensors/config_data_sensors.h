@@ -15,6 +15,9 @@
 #define MODBUS_START_ADDRESS 0x0000
 #define MODBUS_REGISTER_COUNT 4
 #define MODBUS_TIMEOUT_MS 1200
+#define RS485_FN_HOLDING 0x03
+#define RS485_FN_INPUT 0x04
+#define RS485_MAX_BLOCK_REGS 16
 
 /* I2C */
 #define I2C_SDA 6
@@ -53,3 +53,46 @@ const char* SleepModule::wakeupCauseToString(esp_sleep_wakeup_cause_t cause) con
       return "UNDEFINED";
   }
 }
+
+// ============ [FEAT-V11 START] Wakeup alineado a reloj ============
+#if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+uint32_t SleepModule::secondsToNextSlot(uint32_t nowEpoch, uint32_t periodS,
+                                        uint32_t offsetS, uint32_t minSleepS) {
+  if (periodS == 0) {
+    return 0;
+  }
+  offsetS %= periodS;
+
+  // Posición dentro del slot actual (relativa al offset del dispositivo)
+  uint32_t phase = (nowEpoch + periodS - offsetS) % periodS;
+  uint32_t wait = periodS - phase;
+
+  if (wait < minSleepS) {
+    wait += periodS;
+  }
+  return wait;
+}
+
+uint64_t SleepModule::compensateDriftUs(uint32_t wallSeconds, int32_t driftPpm) {
+  // timer_us * (1 + drift) = wall_us  =>  timer_us = wall_us / (1 + drift)
+  uint64_t wallUs = (uint64_t)wallSeconds * 1000000ULL;
+  int64_t denom = 1000000LL + (int64_t)driftPpm;
+  if (denom <= 0) {
+    return wallUs;
+  }
+  return (wallUs * 1000000ULL) / (uint64_t)denom;
+}
+
+uint32_t SleepModule::hashOffsetS(const char* iccid, uint32_t windowS) {
+  if (iccid == nullptr || iccid[0] == '\0' || windowS == 0) {
+    return 0;
+  }
+  uint32_t h = 2166136261UL;  // FNV-1a 32 bits
+  for (const char* p = iccid; *p; p++) {
+    h ^= (uint8_t)*p;
+    h *= 16777619UL;
+  }
+  return h % windowS;
+}
+#endif
+// ============ [FEAT-V11 END] ============
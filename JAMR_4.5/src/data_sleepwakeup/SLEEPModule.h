@@ -5,6 +5,7 @@
 #include <esp_sleep.h>
 #include "esp_system.h"
 #include "config_data_sleepwakeup.h"
+#include "../FeatureFlags.h"
 
 /**
  * @file SLEEPModule.h
@@ -51,6 +52,37 @@ public:
    * @return Cadena descriptiva.
    */
   const char* wakeupCauseToString(esp_sleep_wakeup_cause_t cause) const;
+
+#if ENABLE_FEAT_V11_ALIGNED_WAKEUP
+  /**
+   * @brief Calcula los segundos de reloj hasta el próximo slot alineado (FEAT-V11).
+   * Slots: k*periodS + offsetS (epoch UTC). Si faltan menos de minSleepS,
+   * se salta al slot siguiente.
+   * @param nowEpoch Epoch actual del RTC.
+   * @param periodS Periodo de muestreo en segundos (> 0).
+   * @param offsetS Desfase dentro del slot (se aplica módulo periodS).
+   * @param minSleepS Sleep mínimo aceptable en segundos.
+   * @return Segundos de reloj hasta el slot objetivo.
+   */
+  static uint32_t secondsToNextSlot(uint32_t nowEpoch, uint32_t periodS,
+                                    uint32_t offsetS, uint32_t minSleepS);
+
+  /**
+   * @brief Convierte segundos de reloj a µs del timer compensando deriva.
+   * @param wallSeconds Segundos de reloj (RTC) deseados.
+   * @param driftPpm Deriva estimada del timer de sleep (+ = timer lento).
+   * @return Microsegundos a programar en esp_sleep_enable_timer_wakeup().
+   */
+  static uint64_t compensateDriftUs(uint32_t wallSeconds, int32_t driftPpm);
+
+  /**
+   * @brief Desfase determinista por dispositivo a partir del ICCID (FNV-1a).
+   * @param iccid ICCID como cadena (nullptr o vacío → 0).
+   * @param windowS Ventana de dispersión en segundos (0 → 0).
+   * @return Desfase en segundos dentro de [0, windowS).
+   */
+  static uint32_t hashOffsetS(const char* iccid, uint32_t windowS);
+#endif
 };
 
 #endif
@@ -16,9 +16,9 @@
  * VERSIÓN ACTIVA - MODIFICAR SOLO ESTA SECCIÓN
  ******************************************************************************/
 
-#define FW_VERSION_STRING   "v2.9.0"
-#define FW_VERSION_DATE     "2026-02-03"
-#define FW_VERSION_NAME     "zombie-mitigation"
+#define FW_VERSION_STRING   "v2.34.2"
+#define FW_VERSION_DATE     "2026-10-19"
+#define FW_VERSION_NAME     "field-fixes"
 
 /*******************************************************************************
  * HISTORIAL DE VERSIONES (más reciente arriba)
@@ -27,6 +27,206 @@
  *          Cambios: archivo(línea), archivo(línea)
  ******************************************************************************/
 
+// v2.34.2 | 2026-10-19 | field-fixes             | Correcciones de campo sobre FEAT-V10..V34
+//         |            |                         | - FEAT-V16: detección vacía no persiste mask=0 y se reintenta con
+//         |            |                         |   espera creciente; re-detección tras FEAT_V16_REDETECT_FAILS
+//         |            |                         |   ciclos de sondeo fallido
+//         |            |                         | - FEAT-V32: directiva xfail; los hallazgos afirman el comportamiento correcto
+//         |            |                         | - FEAT-V27: texto por defecto (BINARY_WIRE=0); muestra suprimida y
+//         |            |                         |   logs/banner de stateSleep vía DLOG
+//         |            |                         | - g_timing se declara siempre: compila con FEAT-V2 en 0 (V19/V28/V12/V13/V15/V20)
+//         |            |                         | - FEAT-V21 sin flag: ENABLE_FEAT_V21_TYPED_SAMPLE no restauraba String (no reversible)
+//         |            |                         | - FEAT-V34: guard del token = CRC16 de [0, offset), no de los primeros 64 bytes;
+//         |            |                         |   'D' y 'E' llevan guard:u16
+//         |            |                         | - FEAT-V10: muestra suprimida con tramas pendientes va a Cycle_SendLTE;
+//         |            |                         |   recovery <= 20m en los escenarios con pendientes
+//         |            |                         | Cambios: src/data_sensors/ProbeRegistry.h/.cpp, FeatureFlags.h, LogCatalog.h,
+//         |            |                         |          AppController.cpp, tools/sim/SimFault.h/.cpp, jamr_sim.cpp, scenarios/*.scn,
+//         |            |                         |          src/data_buffer/BLEModule.cpp, src/data_diagnostics/ProductionDiag.h/.cpp
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V16_PROBE_REGISTRY.md, fixs-feats/feats/FEAT_V32_FAULT_SCENARIOS.md,
+//         |            |                         |       fixs-feats/feats/FEAT_V27_DEFERRED_LOG.md, fixs-feats/feats/FEAT_V19_STATE_SCHEDULER.md,
+//         |            |                         |       fixs-feats/feats/FEAT_V28_MEM_WATERMARKS.md, fixs-feats/feats/FEAT_V21_TYPED_SAMPLE.md,
+//         |            |                         |       fixs-feats/feats/FEAT_V34_BLE_BULK_DOWNLOAD.md, src/data_buffer/README_BLE.md,
+//         |            |                         |       fixs-feats/feats/FEAT_V10_REPORT_BY_EXCEPTION.md
+// v2.34.1 | 2026-10-19 | vbat-units              | FIX-V8: Unidades de vBat en FIX-V3
+//         |            |                         | - readVBatFiltered() divide por ADC_MULTIPLIER en las dos rutas (V x100 -> V)
+//         |            |                         | - FEAT-V14: FEAT_V14_ADC_ADJUSTMENT (0.0) en lugar del ADC_ADJUSTMENT empírico
+//         |            |                         | - FEAT-V18 deshabilitado por defecto (+17 % de energía, trama de v2.17.0)
+//         |            |                         | - FEAT-V19 en 0: vuelve el switch de AppLoop(); sin -Wunused con V13/V19 activos
+//         |            |                         | - FEAT-V34: notificación BULK rechazada por el stack (onStatus) se reenvía
+//         |            |                         | Cambios: AppController.cpp, ADCSensorModule.h/.cpp, FeatureFlags.h, tools/sim/SimDevices.cpp,
+//         |            |                         |          BLEModule.h/.cpp, tools/sim/shim/ble_sim.h
+//         |            |                         | Docs: fixs-feats/fixs/FIX_V8_VBAT_UNIDADES.md, fixs-feats/feats/FEAT_V14_FAST_ADC.md,
+//         |            |                         |       fixs-feats/feats/FEAT_V18_WINDOW_AGGREGATION.md,
+//         |            |                         |       fixs-feats/feats/FEAT_V19_STATE_SCHEDULER.md, fixs-feats/feats/FEAT_V34_BLE_BULK_DOWNLOAD.md
+// v2.34.0 | 2026-10-19 | ble-bulk                | FEAT-V34: Descarga masiva del buffer por BLE
+//         |            |                         | - Comando BULK[:token]: todo buffer.txt por offset, sin tope de 50 líneas
+//         |            |                         | - Registros binarios empaquetados por notificación, MTU hasta 517
+//         |            |                         | - Control de flujo por créditos (CREDIT:n) en lugar de delay(50)
+//         |            |                         | - Token de reanudación; tras una desconexión a mitad, se vuelve a anunciar
+//         |            |                         | - KB/s, offset y token en la característica de estado
+//         |            |                         | Cambios: BLEModule.h/.cpp, BUFFERModule.h/.cpp, README_BLE.md
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V34_BLE_BULK_DOWNLOAD.md
+// v2.33.0 | 2026-10-18 | micro-bench             | FEAT-V33: Micro-benchmarks de los caminos calientes
+//         |            |                         | - Kernels: buildFrame, Base64, parseSignalQuality, parseCgnsinf, CRC16, buffer
+//         |            |                         | - Comando Serial BENCH: ns/op y ciclos/byte en el equipo
+//         |            |                         | - tools/bench/jamr_bench: mismos kernels en el host, B/op y línea base
+//         |            |                         | - GPSModule::parseCgnsinf() público; BUFFERModule(path)
+//         |            |                         | Cambios: MicroBench.h/.cpp(nuevo), tools/bench/(nuevo), AppController.cpp
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V33_MICRO_BENCH.md
+// v2.32.0 | 2026-10-18 | fault-scenarios         | FEAT-V32: Escenarios de inyección de fallas en el simulador host
+//         |            |                         | - DSL .scn: fault <tipo> [at/until/count/skip] + expect <métrica> <op> <valor>
+//         |            |                         | - Fallas: brownout en escritura, AT ignorado, modem mudo, CAOPEN sin respuesta, PDP, red, SIM, EMI UART, RTC sin pila
+//         |            |                         | - Métricas: pérdida/corrupción de tramas (frames.log vs server.log), awake.fault, recovery
+//         |            |                         | - Hallazgos: markLineAsProcessed() pierde el backlog ante un corte; RTC sin resincronía
+//         |            |                         | Cambios: tools/sim/SimFault.*, tools/sim/scenarios/, ganchos en SimModem/SimDevices/SimCore. Firmware sin cambios
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V32_FAULT_SCENARIOS.md
+// v2.31.0 | 2026-10-18 | host-simulator          | FEAT-V31: Simulador host del firmware completo (tools/sim/)
+//         |            |                         | - AppController.cpp + src/ sin cambios contra shims de Arduino/FreeRTOS/ESP-IDF/LittleFS/NVS/RTC/sensores
+//         |            |                         | - Un fork() por boot; RTC_DATA_ATTR y estado del modem entre boots; tareas como corrutinas en tiempo virtual
+//         |            |                         | - Modelos: UART con FIFO, GPIO hold, ADC de batería, SIM7080G (PWRKEY, registro, CA*, GNSS), Modbus, AHT20
+//         |            |                         | - Reporte: energía por riel, tiempo activo, flash por archivo, NVS, tramas entregadas y latencia; --json
+//         |            |                         | Cambios: tools/sim/ (nuevo). Firmware sin cambios
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V31_HOST_SIMULATOR.md
+// v2.30.0 | 2026-10-18 | telemetry-frame         | FEAT-V30: Trama de telemetría in-band (ProductionStats + tiempos)
+//         |            |                         | - Telemetry::build(): 'T' + ICCID BCD + 14 contadores delta + 4 medidores + p50/p90/máx de 9 fases
+//         |            |                         | - Base de deltas y ventana de tiempos en RTC; KEYFRAME tras power-on, CLEAR o cada 24 tramas
+//         |            |                         | - Se envía tras las tramas de datos en la misma sesión TCP; commit() solo si CASEND OK
+//         |            |                         | - tools/telemetry_decoder.cpp: Base64 -> JSON por línea, acumula deltas por ICCID
+//         |            |                         | Cambios: TelemetryLayout.h, TelemetryFrame.h/.cpp (nuevos), AppController.cpp, FeatureFlags.h, tools/telemetry_decoder.cpp
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V30_TELEMETRY_FRAME.md
+// v2.29.0 | 2026-10-18 | flash-wear              | FEAT-V29: Contabilidad de desgaste de flash por subsistema
+//         |            |                         | - FlashWear::FileSession (RAII) cuenta bytes por sesión de archivo; "w" = reescritura
+//         |            |                         | - Borrado estimado: ceil(bytes/4 KB) + commit de metadatos (LittleFS), entradas/126 (NVS)
+//         |            |                         | - Subsistemas: buffer, stats, events, crashlog, nvsCrash, nvsApp
+//         |            |                         | - Línea [FEAT-V29] por ciclo antes del deep sleep; acumulados en RTC (sin escrituras propias)
+//         |            |                         | - Sección FLASH en STATS: último ciclo, promedio y vida proyectada LittleFS/NVS
+//         |            |                         | Cambios: FlashWear.h/.cpp (nuevo), BUFFERModule.cpp, ProductionDiag.cpp, CrashDiagnostics.cpp, PersistState.cpp, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V29_FLASH_WEAR.md
+// v2.28.0 | 2026-10-18 | mem-watermarks          | FEAT-V28: Marcas de heap y stack por fase del ciclo
+//         |            |                         | - CycleTiming::mem[]: heap mín, bloque máx mín, stack libre por estado (0 = AppInit)
+//         |            |                         | - Pico exacto por fase vía ESP.getMinFreeHeap() (cada despertar es un boot)
+//         |            |                         | - Tabla [FEAT-V28] por fase y fase con el pico al cerrar el ciclo
+//         |            |                         | - ProductionStats: peores valores en el antiguo reserved[8] (sin migración)
+//         |            |                         | - EVT_MEM_ALARM 'M' bajo umbral de heap, bloque o stack; sección MEMORIA en STATS
+//         |            |                         | Cambios: CycleTiming.h, StateScheduler.h/.cpp, ProductionDiag.h/.cpp, config_production_diag.h, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V28_MEM_WATERMARKS.md
+// v2.27.0 | 2026-10-18 | deferred-log            | FEAT-V27: Log diferido con codificación binaria
+//         |            |                         | - Anillo MPSC sin locks (24 B/registro), nunca bloquea: lleno = descarte contado
+//         |            |                         | - Tarea de baja prioridad en core 0 vacía a Serial (texto o binario)
+//         |            |                         | - LogCatalog.h: ID -> formato compartido con tools/log_decoder.cpp
+//         |            |                         | - DEBUG_<MÓDULO>_LEVEL en DebugConfig.h: filtrado en compilación
+//         |            |                         | - Convertidos: envío por trama, CASEND (cmd/datos/respuesta), LTEModule::debugPrint
+//         |            |                         | - Flush y estadísticas antes de deep sleep / esp_restart
+//         |            |                         | Cambios: DeferredLog.h/.cpp, LogCatalog.h, DebugConfig.h, AppController.cpp, LTEModule.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V27_DEFERRED_LOG.md
+// v2.26.0 | 2026-10-18 | crash-rtc-lazy          | FEAT-V26: Contexto de crash en RTC con promoción diferida a NVS
+//         |            |                         | - CRASH_SYNC_NVS(): escribe solo si cambió el checkpoint y (1er sync / 60 s / SLEEP_ENTER)
+//         |            |                         | - Último comando/respuesta AT registrados en RTC en cada sendATCommand*()
+//         |            |                         | - Boot tras crash: checkpoint, razón, AT cmd/resp promovidos a NVS
+//         |            |                         | - printReport() usa la copia del contexto previo (antes se veía vacío)
+//         |            |                         | - markCycleSuccess() sin escrituras en régimen normal
+//         |            |                         | - Reporte [FEAT-V26] de escrituras NVS hechas/evitadas por ciclo
+//         |            |                         | Cambios: CrashDiagnostics.h/.cpp, config_crash_diagnostics.h, LTEModule.cpp, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V26_CRASH_RTC_LAZY.md
+// v2.25.0 | 2026-10-18 | event-ring              | FEAT-V25: Ring binario O(1) para eventos de ProdDiag
+//         |            |                         | - /diag/events.bin preasignado: cabecera 16 B + 128 slots de 8 B
+//         |            |                         | - logEvent(): seek + write de un slot y la cabecera, sin readString()
+//         |            |                         | - printEventLog() conserva el formato "epoch,código,dato"
+//         |            |                         | - events.txt existente se migra al ring en init()
+//         |            |                         | Cambios: ProductionDiag.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V25_EVENT_RING.md
+// v2.23.0 | 2026-10-18 | trace-spans             | FEAT-V23: Spans jerárquicos en µs con ring en memoria RTC
+//         |            |                         | - TRACE_SPAN / TRACE_SPAN_TAG (RAII) con profundidad por core
+//         |            |                         | - Spans en handlers FEAT-V19, comandos AT, GPS y LittleFS
+//         |            |                         | - Ring RTC_DATA_ATTR de 96 registros, invalidado al cambiar firmware
+//         |            |                         | - Comandos TRACE / TRACE BIN / TRACE CLEAR (Serial) y TRACE (BLE)
+//         |            |                         | Cambios: TraceSpan.h/.cpp, StateScheduler.cpp, LTEModule.cpp, GPSModule.cpp,
+//         |            |                         |          BUFFERModule.cpp, ProductionDiag.cpp, BLEModule.cpp, AppController.cpp
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V23_TRACE_SPANS.md
+// v2.22.0 | 2026-10-18 | persist-cache           | FEAT-V22: Caché write-back en RTC del estado NVS "sensores"
+//         |            |                         | - lastOperator / skipScanCycles / gps_* en RTC_DATA_ATTR (CRC32)
+//         |            |                         | - NVS leído solo con copia RTC inválida (boot en frío)
+//         |            |                         | - Un flush() antes del sleep, solo claves cambiadas
+//         |            |                         | - skipScanCycles write-through (anti-bucle FIX-V2)
+//         |            |                         | Cambios: PersistState.h/.cpp, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V22_PERSIST_CACHE.md
+// v2.21.0 | 2026-10-18 | typed-sample            | FEAT-V21: Muestra tipada sin String en la ruta del ciclo
+//         |            |                         | - Sample {epoch, var[7], iccid[21]} reemplaza g_iccid/g_epoch/g_varStr
+//         |            |                         | - FormatModule::setSample() convierte a texto en buffers fijos
+//         |            |                         | - BUFFERModule::appendLine(const char*) sin copia a String
+//         |            |                         | - Stress: heap y mayor bloque de la ruta sensores -> buffer
+//         |            |                         | Cambios: Sample.h, FORMATModule.h/.cpp, BUFFERModule.h/.cpp, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V21_TYPED_SAMPLE.md
+// v2.20.0 | 2026-10-18 | lazy-init               | FEAT-V20: Inicialización diferida del modem
+//         |            |                         | - SerialLTE/PWRKEY solo en el primer uso (GPS, ICCID, envío)
+//         |            |                         | - Sleep omite sondeo AT si el modem no se usó y estaba apagado
+//         |            |                         | - Latencias wake->primera muestra y wake->sleep en CycleTiming
+//         |            |                         | Cambios: AppController.cpp, CycleTiming.h, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V20_LAZY_INIT.md
+// v2.19.0 | 2026-10-18 | state-scheduler         | FEAT-V19: Planificador de estados dirigido por tabla
+//         |            |                         | - AppLoop() sin switch: handler + deadline + transiciones por estado
+//         |            |                         | - Duración registrada en CycleTiming automáticamente (incluye BLE)
+//         |            |                         | - Estados ceden (Yield) esperando I/O; ruta crítica por ciclo
+//         |            |                         | - Nuevo estado Cycle_GpsNvs (antes dentro de Cycle_ReadSensors)
+//         |            |                         | Cambios: StateScheduler.h/.cpp, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V19_STATE_SCHEDULER.md
+// v2.18.0 | 2026-10-18 | window-aggregation      | FEAT-V18: Agregación por ventana con sub-muestreo en light sleep
+//         |            |                         | - ADC/I2C cada 60 s en light sleep durante el intervalo
+//         |            |                         | - min/max/suma/count de var5..var7 en RTC
+//         |            |                         | - Trama: ,<n>,<min>,<max>,<media> x3 antes de '#'
+//         |            |                         | Cambios: AppController.cpp, FORMATModule.h/.cpp, config_data_format.h, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V18_WINDOW_AGGREGATION.md
+// v2.17.0 | 2026-10-18 | robust-stats            | FEAT-V17: Estadística robusta en streaming (punto fijo)
+//         |            |                         | - Mediana, MAD, media recortada, min/max/count
+//         |            |                         | - Política por ruta en compilación; rechazo de outliers por MAD
+//         |            |                         | - Número de muestras adaptativo según ruido
+//         |            |                         | Cambios: SampleStats.h, AppController.cpp, ADCSensorModule.h/.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V17_ROBUST_STATS.md
+// v2.16.0 | 2026-10-18 | probe-registry          | FEAT-V16: Registro de drivers de sondas Modbus
+//         |            |                         | - Drivers: JAMR 4.5, DFRobot EC / EC-pH, Seeed EC (de 4.4)
+//         |            |                         | - Detección en boot en frío, persistida en NVS + RTC
+//         |            |                         | - Rangos adyacentes fusionados en una sola petición
+//         |            |                         | Cambios: ProbeRegistry.h/.cpp, RS485Module.h/.cpp, PowerRails.h/.cpp, AppController.cpp
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V16_PROBE_REGISTRY.md
+// v2.15.0 | 2026-10-18 | probe-power-rails       | FEAT-V15: Rieles de sonda con encendido temprano y asentamiento
+//         |            |                         | - ENPOWER al inicio de AppInit (solapa NVS/RTC/LittleFS/modem)
+//         |            |                         | - Espera solo lo que falte; 1 lectura Modbus en vez de 10
+//         |            |                         | Cambios: PowerRails.h/.cpp, AppController.cpp, CycleTiming.h, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V15_POWER_RAILS.md
+// v2.14.0 | 2026-10-18 | fast-adc                | FEAT-V14: vBat por ráfaga sobremuestreada calibrada (eFuse)
+//         |            |                         | - analogReadMilliVolts() x64 sin delay (pocos ms vs ~2 s)
+//         |            |                         | - Una medición por ciclo compartida por trama y FIX-V3
+//         |            |                         | Cambios: ADCSensorModule.h/.cpp, AppController.cpp, FeatureFlags.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V14_FAST_ADC.md
+// v2.13.0 | 2026-10-18 | concurrent-sampling     | FEAT-V13: Muestreo concurrente ADC / I2C / RS485
+//         |            |                         | - Una tarea FreeRTOS por bus con deadline compartido
+//         |            |                         | - Resultados vía SampleSlot (seqlock, un productor)
+//         |            |                         | - Latencia por sensor en CycleTiming
+//         |            |                         | Cambios: SensorSampler.h/.cpp, SampleSlot.h, AppController.cpp, CycleTiming.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V13_CONCURRENT_SAMPLING.md
+// v2.12.0 | 2026-10-18 | dual-core-pipeline      | FEAT-V12: Bring-up LTE en core 0 en paralelo con sensores
+//         |            |                         | - Tarea FreeRTOS: powerOn, ICCID, operadora, attach, PDP, TCP
+//         |            |                         | - AppLoop: sensores, trama, buffer; join antes de transmitir
+//         |            |                         | - Un solo power-on del modem por ciclo (ICCID + envío)
+//         |            |                         | - Refactor: lteConnect() extraído de sendBufferOverLTE
+//         |            |                         | Cambios: FeatureFlags.h, AppController.cpp, CycleTiming.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V12_DUAL_CORE_PIPELINE.md
+// v2.11.0 | 2026-10-18 | aligned-wakeup          | FEAT-V11: Wakeup alineado a slots de reloj (RTC epoch)
+//         |            |                         | - Sleep = segundos hasta próximo slot k*P + offset
+//         |            |                         | - Deriva del timer estimada con epochs sucesivos (EMA, ppm)
+//         |            |                         | - Desfase por dispositivo: FNV-1a(ICCID) % ventana
+//         |            |                         | - Fallback a sleep fijo si RTC sin hora válida
+//         |            |                         | Cambios: FeatureFlags.h, AppController.cpp, SLEEPModule.h/cpp
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V11_ALIGNED_WAKEUP.md
+// v2.10.0 | 2026-10-18 | report-by-exception     | FEAT-V10: Reporte solo por excepción (deadband + heartbeat)
+//         |            |                         | - Deadband por variable var1..var7 (unidades de trama)
+//         |            |                         | - Heartbeat: trama obligatoria cada FEAT_V10_HEARTBEAT_S
+//         |            |                         | - Ciclo suprimido: sensores -> sleep (sin modem, sin buffer)
+//         |            |                         | - Contador de suprimidas en trama: ",<supr>,#"
+//         |            |                         | Cambios: FeatureFlags.h, AppController.cpp, FORMATModule.h/cpp,
+//         |            |                         |          config_data_format.h
+//         |            |                         | Docs: fixs-feats/feats/FEAT_V10_REPORT_BY_EXCEPTION.md
 // v2.9.0  | 2026-02-03 | zombie-mitigation       | FIX-V7: Mitigación estado zombie del modem SIM7080G
 //         |            |                         | Estrategia por capas en powerOn():
 //         |            |                         | - Intentos PWRKEY (3x) con isAlive() entre cada uno
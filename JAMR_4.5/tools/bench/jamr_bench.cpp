@@ -0,0 +1,297 @@
+/**
+ * @file jamr_bench.cpp
+ * @brief Micro-benchmarks de FEAT-V33 en el host, con conteo de heap y línea base
+ * @version FEAT-V33
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * Corre los kernels de src/data_diagnostics/MicroBench.cpp (los mismos del
+ * comando Serial BENCH) dentro de un boot del simulador de FEAT-V31, sin
+ * AppInit(). Sobre lo que mide el equipo agrega:
+ *   B/op, allocs/op   operator new del host (el String del shim es std::string)
+ *   sim µs/op         micros() virtual: costo de flash modelado, determinista
+ *
+ * COMPILAR (desde JAMR_4.5/):
+ *   g++ -std=gnu++17 -O2 -pthread -Itools/sim/shim -iquote tools/sim/shim \
+ *       -o jamr_bench tools/bench/jamr_bench.cpp \
+ *       $(find tools/sim -maxdepth 1 -name '*.cpp' ! -name jamr_sim.cpp) AppController.cpp \
+ *       $(find src -name '*.cpp')
+ *
+ * USO:
+ *   jamr_bench [opciones]
+ *
+ *   --repeat N        Repeticiones por kernel, se informa la mediana (default
+ *                     FEAT_V33_REPEATS, máx 15)
+ *   --baseline ARCH   Compara contra una línea base; código de salida 1 si
+ *                     algún kernel empeora
+ *   --write ARCH      Escribe los resultados como nueva línea base
+ *   --tolerance PCT   Margen de ns/op antes de contar como regresión (default 30)
+ *   --dir RUTA        Directorio del LittleFS simulado (default bench_out; se vacía)
+ *
+ * REGRESIÓN (--baseline):
+ *   B/op, allocs/op y sim µs/op son deterministas: cualquier aumento cuenta.
+ *   ns/op y cyc/B dependen de la máquina y de la carga: solo cuenta un aumento
+ *   de ns/op mayor a --tolerance, y la línea base debe ser de la misma máquina.
+ *   En los kernels de buffer (sim µs/op >= 1) ns/op mide la E/S del host y no
+ *   cuenta; ahí manda sim µs/op.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../sim/SimCore.h"
+#include "../../src/data_diagnostics/MicroBench.h"
+#include "../../src/version_info.h"
+
+#if !ENABLE_FEAT_V33_MICRO_BENCH
+#error "jamr_bench requiere ENABLE_FEAT_V33_MICRO_BENCH"
+#endif
+
+using MicroBench::Result;
+
+// ============================================================
+// CONTEO DE HEAP (operator new global del proceso)
+// ============================================================
+
+static uint64_t g_allocBytes = 0;
+static uint64_t g_allocCount = 0;
+
+static void* countedAlloc(size_t n) {
+  g_allocBytes += n;
+  g_allocCount++;
+  void* p = malloc(n ? n : 1);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(size_t n) { return countedAlloc(n); }
+void* operator new[](size_t n) { return countedAlloc(n); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+  g_allocBytes += n;
+  g_allocCount++;
+  return malloc(n ? n : 1);
+}
+void* operator new[](size_t n, const std::nothrow_t& t) noexcept { return operator new(n, t); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ============================================================
+// PROBES DEL HOST
+// ============================================================
+
+static uint64_t hostNs() {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+/** @brief TSC en x86 (ciclos de referencia, no de núcleo); en otras arquitecturas, ns */
+static uint32_t hostCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__rdtsc();
+#else
+  return (uint32_t)hostNs();
+#endif
+}
+
+static uint64_t hostAllocBytes() { return g_allocBytes; }
+static uint64_t hostAllocCount() { return g_allocCount; }
+
+// ============================================================
+// LÍNEA BASE
+// ============================================================
+
+static const char* const COLUMNS = "kernel                    B  iters        ns/op     cyc/B      B/op allocs/op  sim_us/op";
+
+static std::string hostCpu() {
+  std::ifstream f("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(f, line)) {
+    if (line.compare(0, 10, "model name") == 0) {
+      size_t c = line.find(':');
+      return c == std::string::npos ? line : line.substr(line.find_first_not_of(' ', c + 1));
+    }
+  }
+  return "?";
+}
+
+static void printRow(FILE* out, const Result& r) {
+  if (!r.ok) {
+    fprintf(out, "%-20s FALLÓ\n", r.name);
+    return;
+  }
+  fprintf(out, "%-20s %6u %6u %12.1f %9.2f %9.1f %9.2f %10.3f\n", r.name, r.bytes, r.iters, r.nsPerOp,
+          r.cyclesPerByte, r.allocBytesPerOp, r.allocsPerOp, r.microsPerOp);
+}
+
+static bool writeBaseline(const char* file, const Result* res, size_t n, uint8_t repeats) {
+  FILE* f = fopen(file, "w");
+  if (!f) return false;
+  fprintf(f, "# Línea base de jamr_bench (FEAT-V33), firmware %s, %u repeticiones\n", FW_VERSION_STRING,
+          (unsigned)repeats);
+  fprintf(f, "# host: %s\n", hostCpu().c_str());
+  fprintf(f, "# %s\n", COLUMNS);
+  for (size_t i = 0; i < n; i++) printRow(f, res[i]);
+  fclose(f);
+  return true;
+}
+
+static bool readBaseline(const char* file, std::map<std::string, Result>& base, std::string& host) {
+  std::ifstream f(file);
+  if (!f) return false;
+  std::string line;
+  while (std::getline(f, line)) {
+    if (line.compare(0, 8, "# host: ") == 0) host = line.substr(8);
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream in(line);
+    std::string name;
+    Result r = {};
+    in >> name >> r.bytes >> r.iters >> r.nsPerOp >> r.cyclesPerByte >> r.allocBytesPerOp >> r.allocsPerOp >>
+        r.microsPerOp;
+    r.ok = !in.fail();
+    base[name] = r;
+  }
+  return true;
+}
+
+/** @brief Variación relativa en % (0 si la base es 0) */
+static double pct(double now, double before) { return before > 0.0 ? (now - before) * 100.0 / before : 0.0; }
+
+/** @return Kernels que empeoraron */
+static int compare(const Result* res, size_t n, const std::map<std::string, Result>& base, double tolerance) {
+  static const double EPS = 1e-6;
+  int regressions = 0;
+  printf("\nComparación con la línea base (ns/op: margen %.0f %%)\n", tolerance);
+  printf("%-20s %28s %15s %13s %17s\n", "kernel", "ns/op", "B/op", "allocs/op", "sim_us/op");
+  for (size_t i = 0; i < n; i++) {
+    const Result& r = res[i];
+    auto it = base.find(r.name);
+    if (it == base.end() || !it->second.ok) {
+      printf("%-20s nuevo\n", r.name);
+      continue;
+    }
+    const Result& b = it->second;
+    std::string why;
+    if (!r.ok) why = "falló";
+    if (r.allocBytesPerOp > b.allocBytesPerOp + EPS) why += why.empty() ? "B/op" : ", B/op";
+    if (r.allocsPerOp > b.allocsPerOp + EPS) why += why.empty() ? "allocs/op" : ", allocs/op";
+    if (r.microsPerOp > b.microsPerOp * 1.001 + EPS) why += why.empty() ? "sim_us/op" : ", sim_us/op";
+    bool io = b.microsPerOp >= 1.0;  // Kernel de flash: ns/op es E/S del host, manda sim_us/op
+    if (!io && pct(r.nsPerOp, b.nsPerOp) > tolerance) why += why.empty() ? "ns/op" : ", ns/op";
+    printf("%-20s %9.1f → %9.1f %+5.0f%% %6.1f → %6.1f %5.2f → %5.2f %7.3f → %7.3f  %s\n", r.name, b.nsPerOp,
+           r.nsPerOp, pct(r.nsPerOp, b.nsPerOp), b.allocBytesPerOp, r.allocBytesPerOp, b.allocsPerOp,
+           r.allocsPerOp, b.microsPerOp, r.microsPerOp, why.empty() ? "ok" : ("REGRESIÓN: " + why).c_str());
+    if (!why.empty()) regressions++;
+  }
+  for (const auto& kv : base) {
+    bool found = false;
+    for (size_t i = 0; i < n; i++) found = found || kv.first == res[i].name;
+    if (!found) printf("%-20s ya no existe\n", kv.first.c_str());
+  }
+  return regressions;
+}
+
+// ============================================================
+// MAIN
+// ============================================================
+
+/** @brief Ruta relativa al directorio de arranque (main hace chdir a --dir) */
+static std::string absolute(const char* p) {
+  if (p == nullptr || p[0] == '/') return p ? p : "";
+  char cwd[4096];
+  return getcwd(cwd, sizeof(cwd)) ? std::string(cwd) + "/" + p : p;
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "uso: %s [--repeat N] [--baseline ARCH] [--write ARCH] [--tolerance PCT] [--dir RUTA]\n", argv0);
+  exit(2);
+}
+
+int main(int argc, char** argv) {
+  sim::Config cfg;
+  cfg.dir = "bench_out";
+  cfg.awakeCapUs = UINT64_MAX;  // Sin límite de boot: el benchmark no duerme
+  int repeats = FEAT_V33_REPEATS;
+  const char* baseline = nullptr;
+  const char* write = nullptr;
+  double tolerance = 30.0;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* {
+      if (i + 1 >= argc) usage(argv[0]);
+      return argv[++i];
+    };
+    if (a == "--repeat") repeats = atoi(next());
+    else if (a == "--baseline") baseline = next();
+    else if (a == "--write") write = next();
+    else if (a == "--tolerance") tolerance = atof(next());
+    else if (a == "--dir") cfg.dir = next();
+    else usage(argv[0]);
+  }
+  if (repeats < 1 || repeats > 15 || tolerance < 0.0) usage(argv[0]);
+
+  std::string cmd = "rm -rf '" + cfg.dir + "' && mkdir -p '" + cfg.dir + "/fs' '" + cfg.dir + "/nvs'";
+  if (system(cmd.c_str()) != 0) {
+    fprintf(stderr, "no se pudo preparar %s\n", cfg.dir.c_str());
+    return 1;
+  }
+  // Las rutas del shim tienen largo fijo, y con ellas las asignaciones de std::string que cuenta B/op
+  std::string baselinePath = absolute(baseline), writePath = absolute(write);
+  if (chdir(cfg.dir.c_str()) != 0) {
+    perror(cfg.dir.c_str());
+    return 1;
+  }
+  cfg.dir = ".";
+  sim::setConfig(cfg);
+  sim::initShared();
+  sim::hostedBoot();
+
+  MicroBench::Probes probes = {hostNs, hostCycles, hostAllocBytes, hostAllocCount};
+  Result res[MicroBench::KERNEL_COUNT];
+  size_t n = MicroBench::run(probes, res, (uint8_t)repeats);
+
+  printf("jamr_bench: firmware %s, %d repeticiones, host %s\n", FW_VERSION_STRING, repeats, hostCpu().c_str());
+  printf("%s\n", COLUMNS);
+  bool allOk = true;
+  for (size_t i = 0; i < n; i++) {
+    printRow(stdout, res[i]);
+    allOk = allOk && res[i].ok;
+  }
+
+  int rc = allOk ? 0 : 1;
+  if (baseline) {
+    std::map<std::string, Result> base;
+    std::string host;
+    if (!readBaseline(baselinePath.c_str(), base, host)) {
+      fprintf(stderr, "%s: no se pudo leer\n", baseline);
+      return 2;
+    }
+    if (!host.empty() && host != hostCpu()) {
+      printf("\nAVISO: la línea base es de otro host (%s): ns/op y cyc/B no son comparables\n", host.c_str());
+    }
+    if (compare(res, n, base, tolerance) > 0) rc = 1;
+  }
+  if (write && !writeBaseline(writePath.c_str(), res, n, (uint8_t)repeats)) {
+    fprintf(stderr, "%s: no se pudo escribir\n", write);
+    return 2;
+  }
+  return rc;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file log_decoder.cpp
+ * @brief Decodificador host del log diferido binario (tramas DLOG intercaladas con texto)
+ * @version FEAT-V27
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * COMPILAR:
+ *   g++ -std=c++17 -O2 -o log_decoder tools/log_decoder.cpp
+ *
+ * USO:
+ *   log_decoder [--ts] [--only] [--stats] captura.txt [...]   (o "-" para stdin)
+ *
+ *   --ts      Antepone "[t_ms]" (esp_timer del equipo) a cada línea decodificada
+ *   --only    Solo líneas decodificadas (descarta el texto Serial directo)
+ *   --stats   Al final, registros por ID y tramas corruptas (a stderr)
+ *
+ * El texto Serial normal se copia tal cual; cada trama 0xA5 0x4C válida
+ * (ver LogCatalog.h) se reemplaza por la línea formateada con el mismo
+ * catálogo que usa el firmware. Tramas con checksum o ID inválido se tratan
+ * como texto.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/LogCatalog.h"
+
+// ============================================================
+// ESTADO DE SALIDA
+// ============================================================
+
+struct Options {
+  bool ts = false;
+  bool only = false;
+  bool stats = false;
+};
+
+static Options g_opt;
+static bool g_lineOpen = false;       ///< Línea decodificada sin cerrar (posibles BYTES)
+static bool g_textAtBol = true;       ///< El texto directo terminó en '\n'
+static std::map<uint16_t, uint32_t> g_countById;
+static uint32_t g_badFrames = 0;
+
+static bool readFile(const std::string& path, std::string& out) {
+  if (path == "-") {
+    out.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    return true;
+  }
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  return true;
+}
+
+static uint16_t rdU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rdU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void closeLine() {
+  if (g_lineOpen) {
+    fputc('\n', stdout);
+    g_lineOpen = false;
+  }
+}
+
+static void emitText(char c) {
+  closeLine();
+  if (g_opt.only) return;
+  fputc(c, stdout);
+  g_textAtBol = (c == '\n');
+}
+
+// ============================================================
+// TRAMAS
+// ============================================================
+
+/** @brief Igual que renderBytes() del firmware: imprimibles, CR/LF como espacio */
+static void renderBytes(const uint32_t* args) {
+  uint8_t n = args[0] & 0x7F;
+  if (n > DLOG_BYTES_PER_RECORD) n = DLOG_BYTES_PER_RECORD;
+  uint8_t b[DLOG_BYTES_PER_RECORD];
+  memcpy(b, &args[1], sizeof(b));
+  for (uint8_t i = 0; i < n; i++) {
+    uint8_t c = b[i];
+    fputc((c == '\r' || c == '\n') ? ' ' : ((c >= 0x20 && c < 0x7F) ? (char)c : '.'), stdout);
+  }
+  if (args[0] & 0x80) fputs("...", stdout);
+}
+
+static void renderRecord(uint32_t tUs, uint16_t id, const uint32_t* args) {
+  g_countById[id]++;
+  if (id == DLOG_BYTES) {
+    if (g_lineOpen) renderBytes(args);
+    return;  // Continuación huérfana (encabezado perdido): se descarta
+  }
+  closeLine();
+  if (!g_textAtBol && !g_opt.only) {
+    fputc('\n', stdout);
+    g_textAtBol = true;
+  }
+  if (g_opt.ts) printf("[%10.3f] ", tUs / 1000.0);
+  printf(DLOG_FORMATS[id], args[0], args[1], args[2], args[3]);
+  g_lineOpen = true;
+}
+
+/**
+ * @brief Intenta decodificar una trama en pos.
+ * @return Bytes consumidos, 0 si no es una trama válida.
+ */
+static size_t tryFrame(const std::string& data, size_t pos) {
+  const uint8_t* p = (const uint8_t*)data.data() + pos;
+  size_t avail = data.size() - pos;
+  if (avail < 4 || p[0] != DLOG_SYNC0 || p[1] != DLOG_SYNC1) return 0;
+  uint8_t len = p[2];
+  if (len < 6 || len > 6 + 16 || (len - 6) % 4 != 0) return 0;
+  if (avail < (size_t)len + 4) return 0;
+  uint8_t x = 0;
+  for (size_t i = 2; i < 3 + (size_t)len; i++) x ^= p[i];
+  uint16_t id = rdU16(p + 7);
+  if (x != p[3 + len] || id >= DLOG_COUNT || id == DLOG_LITERAL || id == DLOG_LITERAL_INT) {
+    g_badFrames++;
+    return 0;
+  }
+  uint32_t args[4] = {0, 0, 0, 0};
+  uint8_t nargs = (len - 6) / 4;
+  for (uint8_t i = 0; i < nargs; i++) args[i] = rdU32(p + 9 + 4 * i);
+  renderRecord(rdU32(p + 3), id, args);
+  return 4 + len;
+}
+
+static void decode(const std::string& data) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    size_t used = ((uint8_t)data[pos] == DLOG_SYNC0) ? tryFrame(data, pos) : 0;
+    if (used) {
+      pos += used;
+    } else {
+      emitText(data[pos++]);
+    }
+  }
+  closeLine();
+}
+
+// ============================================================
+// MAIN
+// ============================================================
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "Uso: %s [--ts] [--only] [--stats] archivo... (\"-\" = stdin)\n"
+          "  Reconstruye el texto de las tramas DLOG (FEAT-V27) en una captura Serial\n", argv0);
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--ts") {
+      g_opt.ts = true;
+    } else if (a == "--only") {
+      g_opt.only = true;
+    } else if (a == "--stats") {
+      g_opt.stats = true;
+    } else if (a == "-h" || a == "--help") {
+      usage(argv[0]);
+      return 0;
+    } else if (a.size() > 1 && a[0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      files.push_back(a);
+    }
+  }
+  if (files.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  for (const std::string& file : files) {
+    std::string data;
+    if (!readFile(file, data)) {
+      perror(file.c_str());
+      return 1;
+    }
+    decode(data);
+  }
+
+  if (g_opt.stats) {
+    uint32_t total = 0;
+    for (const auto& kv : g_countById) {
+      fprintf(stderr, "  %5u  id %-3u %s\n", (unsigned)kv.second, (unsigned)kv.first,
+              kv.first == DLOG_BYTES ? "(bytes)" : DLOG_FORMATS[kv.first]);
+      total += kv.second;
+    }
+    fprintf(stderr, "%u registros, %u tramas descartadas\n", (unsigned)total, (unsigned)g_badFrames);
+  }
+  return 0;
+}
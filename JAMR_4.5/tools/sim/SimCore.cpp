@@ -0,0 +1,577 @@
+/**
+ * @file SimCore.cpp
+ * @brief Reloj virtual, planificador cooperativo, energía y ciclo de vida
+ * @version FEAT-V31
+ * @date 2026-10-18
+ */
+
+#include "SimCore.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include <Arduino.h>
+#include <esp_task_wdt.h>
+#include <freertos/event_groups.h>
+
+#include "../../AppController.h"
+
+// Límites de las secciones RTC (ld los define para "rtc_data_sim" y "rtc_noinit_sim")
+extern "C" {
+extern uint8_t __start_rtc_data_sim[] __attribute__((weak));
+extern uint8_t __stop_rtc_data_sim[] __attribute__((weak));
+extern uint8_t __start_rtc_noinit_sim[] __attribute__((weak));
+extern uint8_t __stop_rtc_noinit_sim[] __attribute__((weak));
+}
+
+/** @brief Tarea FreeRTOS simulada como corrutina (el loopTask es la tarea 0, en el stack de main) */
+struct SimTask {
+  int id;
+  std::string name;
+  TaskFunction_t fn;
+  void* arg;
+  int core;
+  ucontext_t ctx;
+  uint64_t wakeAt;
+  uint64_t order;             ///< Desempate FIFO entre tareas con el mismo wakeAt
+  bool done;
+  EventGroupHandle_t waitGroup;
+  EventBits_t waitBits;
+  bool waitAll;
+};
+
+struct SimEventGroup {
+  EventBits_t bits;
+};
+
+namespace sim {
+
+static const uint64_t NEVER = UINT64_MAX;
+static const uint64_t BOOT_OVERHEAD_US = 200000;   ///< ROM + bootloader, fuera de millis()
+static const size_t TASK_STACK_BYTES = 512 * 1024;  ///< Holgado: el host no mide el stack de la tarea
+static const double CPU_ACTIVE_MA = 40.0;
+static const double CPU_LIGHT_SLEEP_MA = 0.24;
+static const double CPU_DEEP_SLEEP_MA = 0.025;
+
+static Config g_cfg;
+static Shared* g_shared = nullptr;
+
+// Estado del boot actual (proceso hijo)
+static uint64_t g_now = 0;
+static uint64_t g_wallBase = 0;
+static uint64_t g_sleepTimerUs = 0;
+static std::vector<SimTask*> g_tasks;
+static SimTask* g_cur = nullptr;
+static uint64_t g_seq = 0;
+static int g_critical = 0;
+static uint32_t g_wdtTimeoutMs = 0;
+static uint64_t g_wdtLastFeed = 0;
+static uint32_t g_firedAtBoot = 0;   ///< Disparos de fallas al inicio del boot (FEAT-V32)
+
+const Config& config() { return g_cfg; }
+void setConfig(const Config& cfg) { g_cfg = cfg; }
+Shared* shared() { return g_shared; }
+
+void initShared() {
+  void* p = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) {
+    perror("mmap");
+    exit(1);
+  }
+  g_shared = static_cast<Shared*>(p);
+  memset(g_shared, 0, sizeof(Shared));
+  g_shared->nextReset = ESP_RST_POWERON;
+  g_shared->nextWakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+std::string path(const char* rel) { return g_cfg.dir + "/" + rel; }
+
+// ============================================================
+// PLANIFICADOR
+// ============================================================
+
+uint64_t now() { return g_now; }
+uint64_t wall() { return g_wallBase + g_now; }
+uint64_t wallAt(uint64_t bootUs) { return g_wallBase + bootUs; }
+
+static void checkLimits() {
+  if (g_now > g_cfg.awakeCapUs) {
+    endBoot(EXIT_HANG, 0, "boot despierto más del límite (--awake-cap-s)");
+  }
+  if (g_wdtTimeoutMs && g_now - g_wdtLastFeed > (uint64_t)g_wdtTimeoutMs * 1000ULL) {
+    endBoot(EXIT_HANG, 0, "task watchdog sin alimentar");
+  }
+}
+
+/** @brief Tarea no terminada con menor (wakeAt, order) */
+static SimTask* pickNext() {
+  SimTask* best = nullptr;
+  for (SimTask* t : g_tasks) {
+    if (t->done) continue;
+    if (!best || t->wakeAt < best->wakeAt || (t->wakeAt == best->wakeAt && t->order < best->order)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Cede el turno; me->wakeAt ya está fijado. Retorna cuando vuelve a correr.
+ *
+ * Cambio de contexto en espacio de usuario (swapcontext): un solo hilo del
+ * host, sin futex por cada delay() de cada tarea.
+ */
+static void reschedule(SimTask* me) {
+  SimTask* next = pickNext();
+  if (next == nullptr || next->wakeAt == NEVER) {
+    endBoot(EXIT_HANG, 0, "deadlock: todas las tareas bloqueadas sin timeout");
+  }
+  if (g_now < next->wakeAt) g_now = next->wakeAt;
+  checkLimits();
+  if (next == me) return;
+  g_cur = next;
+  swapcontext(&me->ctx, &next->ctx);
+}
+
+void blockUntil(uint64_t t) {
+  if (t < g_now) t = g_now;
+  SimTask* me = g_cur;
+  me->wakeAt = t;
+  me->order = ++g_seq;
+  reschedule(me);
+}
+
+void advance(uint64_t us) {
+  uint64_t t = g_now + us;
+  if (g_critical == 0) {
+    for (SimTask* o : g_tasks) {
+      if (o != g_cur && !o->done && o->wakeAt < t) {
+        blockUntil(t);
+        return;
+      }
+    }
+  }
+  g_now = t;
+  checkLimits();
+}
+
+void criticalEnter() { g_critical++; }
+void criticalExit() { if (g_critical > 0) g_critical--; }
+
+void wdtConfigure(uint32_t timeoutMs) {
+  g_wdtTimeoutMs = timeoutMs;
+  g_wdtLastFeed = g_now;
+}
+
+void wdtFeed() { g_wdtLastFeed = g_now; }
+
+static void taskFinish(SimTask* me) {
+  me->done = true;
+  reschedule(me);  // No vuelve: una tarea terminada no se elige
+}
+
+static void taskTrampoline() {
+  SimTask* me = g_cur;
+  me->fn(me->arg);
+  taskFinish(me);  // Una tarea FreeRTOS no debe retornar; se trata como vTaskDelete(NULL)
+}
+
+static SimTask* newTask(const char* name, TaskFunction_t fn, void* arg, int core) {
+  SimTask* t = new SimTask();
+  t->id = (int)g_tasks.size();
+  t->name = name ? name : "";
+  t->fn = fn;
+  t->arg = arg;
+  t->core = core;
+  t->wakeAt = g_now;
+  t->order = ++g_seq;
+  t->done = false;
+  t->waitGroup = nullptr;
+  g_tasks.push_back(t);
+  return t;
+}
+
+// ============================================================
+// ENERGÍA
+// ============================================================
+
+static void railIntegrate(Rail r, uint64_t atWall) {
+  Shared* s = g_shared;
+  if (atWall > s->railSinceWall[r]) {
+    s->railMaUs[r] += s->railMa[r] * (double)(atWall - s->railSinceWall[r]);
+    s->railSinceWall[r] = atWall;
+  }
+}
+
+void railSetAt(Rail r, double mA, uint64_t atWall) {
+  railIntegrate(r, atWall);
+  g_shared->railMa[r] = mA;
+}
+
+void railSet(Rail rail, double mA) { railSetAt(rail, mA, wall()); }
+double railGet(Rail rail) { return g_shared->railMa[rail]; }
+
+double consumedMah(uint64_t atWall) {
+  double maUs = 0.0;
+  for (int r = 0; r < RAIL_COUNT; r++) {
+    maUs += g_shared->railMaUs[r];
+    if (atWall > g_shared->railSinceWall[r]) {
+      maUs += g_shared->railMa[r] * (double)(atWall - g_shared->railSinceWall[r]);
+    }
+  }
+  return maUs / 3.6e9;
+}
+
+double batteryVolts() {
+  double used = consumedMah(wall()) / g_cfg.batteryMah;
+  if (used > 1.0) used = 1.0;
+  return 4.2 - 0.9 * used;
+}
+
+void lightSleep(uint64_t us) {
+  railSet(RAIL_CPU, CPU_LIGHT_SLEEP_MA);
+  // Ninguna tarea corre en light sleep: las vencidas corren al despertar
+  criticalEnter();
+  advance(us);
+  criticalExit();
+  railSet(RAIL_CPU, CPU_ACTIVE_MA);
+  g_shared->lightSleepUs += us;
+}
+
+// ============================================================
+// CICLO DE VIDA
+// ============================================================
+
+uint64_t sleepTimerUs() { return g_sleepTimerUs; }
+void setSleepTimerUs(uint64_t us) { g_sleepTimerUs = us; }
+
+static size_t rtcLen(const uint8_t* start, const uint8_t* stop) {
+  if (start == nullptr || stop == nullptr) return 0;
+  return (size_t)(stop - start);
+}
+
+static void rtcSave(RtcImage& img, uint8_t* start, uint8_t* stop, const char* name) {
+  size_t n = rtcLen(start, stop);
+  if (n > RTC_IMAGE_MAX) {
+    fprintf(stderr, "[SIM] %s ocupa %zu B (> %zu)\n", name, n, RTC_IMAGE_MAX);
+    n = 0;
+  }
+  if (n > 0) memcpy(img.data, start, n);
+  img.len = (uint32_t)n;
+  img.valid = true;
+}
+
+static void rtcRestore(const RtcImage& img, uint8_t* start, uint8_t* stop) {
+  size_t n = rtcLen(start, stop);
+  if (img.valid && img.len == n && n > 0) {
+    memcpy(start, img.data, n);
+  }
+}
+
+/**
+ * @brief Panic del firmware (abort, SIGSEGV): el hijo muere sin endBoot(), así
+ *        que RTC_NOINIT_ATTR se guarda acá, como la conserva el ESP32 tras un panic
+ */
+static void onPanicSignal(int sig) {
+  rtcSave(g_shared->rtcNoinit, __start_rtc_noinit_sim, __stop_rtc_noinit_sim, "RTC_NOINIT_ATTR");
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static uint32_t faultsFired() {
+  uint32_t n = 0;
+  for (const FaultRuntime& f : g_shared->faults) n += f.fired;
+  return n;
+}
+
+void runBoot() {
+  Shared* s = g_shared;
+  g_firedAtBoot = faultsFired();
+  uint64_t bootWall = s->nextBootWallUs;
+  s->boots++;
+  s->lastExit = EXIT_NONE;
+  s->lastHang[0] = '\0';
+
+  // RTC_DATA_ATTR solo sobrevive al deep sleep: en cualquier otro reset el
+  // bootloader la recarga desde la imagen. RTC_NOINIT_ATTR se pierde sin energía.
+  if (s->nextReset != ESP_RST_DEEPSLEEP) {
+    s->rtcData.valid = false;
+  }
+  if (s->nextReset == ESP_RST_POWERON || s->nextReset == ESP_RST_BROWNOUT) {
+    s->rtcNoinit.valid = false;
+  }
+  rtcRestore(s->rtcData, __start_rtc_data_sim, __stop_rtc_data_sim);
+  rtcRestore(s->rtcNoinit, __start_rtc_noinit_sim, __stop_rtc_noinit_sim);
+  for (int sig : {SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL}) signal(sig, onPanicSignal);
+
+  // ROM + bootloader + arranque de Arduino: consumo sin millis()
+  railSetAt(RAIL_CPU, CPU_ACTIVE_MA, bootWall);
+  g_wallBase = bootWall + BOOT_OVERHEAD_US;
+  g_now = 0;
+
+  SimTask* loopTask = newTask("loopTask", nullptr, nullptr, 1);
+  g_cur = loopTask;
+
+  devicesBoot();
+  modemBoot();
+
+  AppConfig cfg;
+  cfg.sleep_time_us = g_cfg.sleepUs;
+  AppInit(cfg);
+  for (;;) {
+    AppLoop();
+    advance(5);  // yieldIfNecessary() entre vueltas de loop()
+  }
+}
+
+void hostedBoot() {
+  Shared* s = g_shared;
+  s->boots++;
+  railSetAt(RAIL_CPU, CPU_ACTIVE_MA, s->nextBootWallUs);
+  g_wallBase = s->nextBootWallUs + BOOT_OVERHEAD_US;
+  g_now = 0;
+  g_cur = newTask("loopTask", nullptr, nullptr, 1);
+  devicesBoot();
+  modemBoot();
+}
+
+void endBoot(BootExit how, uint64_t sleepUs, const char* why) {
+  Shared* s = g_shared;
+  uint64_t endWall = wall();
+  s->awakeUs += g_now;
+  if (g_now > s->maxAwakeUs) s->maxAwakeUs = g_now;
+  if (faultsFired() != g_firedAtBoot && g_now > s->maxFaultAwakeUs) s->maxFaultAwakeUs = g_now;
+  s->lastExit = how;
+
+  devicesExit(how);
+  // Se guardan las dos; runBoot decide según el tipo de reset qué se restaura
+  rtcSave(s->rtcData, __start_rtc_data_sim, __stop_rtc_data_sim, "RTC_DATA_ATTR");
+  rtcSave(s->rtcNoinit, __start_rtc_noinit_sim, __stop_rtc_noinit_sim, "RTC_NOINIT_ATTR");
+
+  switch (how) {
+    case EXIT_DEEP_SLEEP: {
+      s->deepSleeps++;
+      railSetAt(RAIL_CPU, CPU_DEEP_SLEEP_MA, endWall);
+      double drift = 1.0 + g_cfg.driftPpm / 1e6;
+      s->nextBootWallUs = endWall + (uint64_t)((double)sleepUs * drift);
+      s->nextReset = ESP_RST_DEEPSLEEP;
+      s->nextWakeCause = ESP_SLEEP_WAKEUP_TIMER;
+      break;
+    }
+    case EXIT_RESTART:
+      s->restarts++;
+      s->nextBootWallUs = endWall;
+      s->nextReset = ESP_RST_SW;
+      s->nextWakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+      break;
+    case EXIT_BROWNOUT:
+      // Sin alimentación hasta que vuelve la energía; runBoot descarta la RTC
+      s->brownouts++;
+      railSetAt(RAIL_CPU, 0.0, endWall);
+      s->nextBootWallUs = endWall + sleepUs;
+      s->nextReset = ESP_RST_BROWNOUT;
+      s->nextWakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+      break;
+    case EXIT_HANG:
+    default:
+      s->hangs++;
+      snprintf(s->lastHang, sizeof(s->lastHang), "%s", why ? why : "?");
+      s->nextBootWallUs = endWall;
+      s->nextReset = ESP_RST_TASK_WDT;
+      s->nextWakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+      break;
+  }
+  fflush(nullptr);
+  _exit(0);
+}
+
+// ============================================================
+// ALEATORIEDAD
+// ============================================================
+
+uint64_t mix64(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+uint64_t Rng::next() {
+  s_ += 0x9E3779B97F4A7C15ULL;
+  return mix64(s_);
+}
+
+double Rng::uniform() { return (double)(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+double Rng::normal() {
+  double u1 = uniform(), u2 = uniform();
+  if (u1 < 1e-300) u1 = 1e-300;
+  return sqrt(-2.0 * log(u1)) * cos(6.283185307179586 * u2);
+}
+
+Rng rngFor(RngStream stream, uint64_t salt) {
+  uint64_t boot = g_shared ? g_shared->bootIndex : 0;
+  return Rng(mix64(g_cfg.seed ^ mix64(boot * 0x100000001B3ULL + stream) ^ mix64(salt + 0x5851F42DULL)));
+}
+
+}  // namespace sim
+
+// ============================================================
+// FreeRTOS
+// ============================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+  (void)stackDepth;
+  (void)priority;
+  sim::advance(150);  // Creación de tarea + asignación de stack
+  SimTask* t = sim::newTask(name, fn, arg, core == tskNO_AFFINITY ? 0 : core);
+  getcontext(&t->ctx);
+  t->ctx.uc_stack.ss_sp = malloc(sim::TASK_STACK_BYTES);
+  t->ctx.uc_stack.ss_size = sim::TASK_STACK_BYTES;
+  t->ctx.uc_link = nullptr;
+  makecontext(&t->ctx, sim::taskTrampoline, 0);
+  if (handle) *handle = t;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, arg, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr || task == sim::g_cur) {
+    sim::taskFinish(sim::g_cur);
+    return;
+  }
+  task->done = true;
+}
+
+void vTaskDelay(TickType_t ticks) { sim::blockUntil(sim::now() + (uint64_t)ticks * 1000ULL); }
+
+TickType_t xTaskGetTickCount(void) { return (TickType_t)(sim::now() / 1000ULL); }
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) { return sim::g_cur; }
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  (void)task;
+  return 4096;  // El host no mide el stack de la tarea
+}
+
+BaseType_t xPortGetCoreID(void) { return sim::g_cur ? sim::g_cur->core : 1; }
+
+void portENTER_CRITICAL(portMUX_TYPE* mux) {
+  (void)mux;
+  sim::criticalEnter();
+}
+
+void portEXIT_CRITICAL(portMUX_TYPE* mux) {
+  (void)mux;
+  sim::criticalExit();
+}
+
+EventGroupHandle_t xEventGroupCreate(void) { return new SimEventGroup{0}; }
+
+void vEventGroupDelete(EventGroupHandle_t group) { delete group; }
+
+static bool groupSatisfied(EventBits_t have, EventBits_t want, bool all) {
+  return all ? (have & want) == want : (have & want) != 0;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+  group->bits |= bits;
+  for (SimTask* t : sim::g_tasks) {
+    if (!t->done && t->waitGroup == group && groupSatisfied(group->bits, t->waitBits, t->waitAll)) {
+      t->waitGroup = nullptr;
+      t->wakeAt = sim::now();
+      t->order = ++sim::g_seq;
+    }
+  }
+  return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+  EventBits_t before = group->bits;
+  group->bits &= ~bits;
+  return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) { return group->bits; }
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+  if (!groupSatisfied(group->bits, bits, waitForAll) && ticks > 0) {
+    SimTask* me = sim::g_cur;
+    me->waitGroup = group;
+    me->waitBits = bits;
+    me->waitAll = waitForAll;
+    uint64_t until = (ticks == portMAX_DELAY) ? sim::NEVER : sim::now() + (uint64_t)ticks * 1000ULL;
+    sim::blockUntil(until);
+    me->waitGroup = nullptr;
+  }
+  EventBits_t result = group->bits;
+  if (clearOnExit && groupSatisfied(result, bits, waitForAll)) group->bits &= ~bits;
+  return result;
+}
+
+// ============================================================
+// ESP-IDF: tiempo, sleep, reset, watchdog
+// ============================================================
+
+int64_t esp_timer_get_time(void) {
+  sim::advance(1);
+  return (int64_t)sim::now();
+}
+
+esp_reset_reason_t esp_reset_reason(void) { return sim::shared()->nextReset; }
+
+void esp_restart(void) { sim::endBoot(sim::EXIT_RESTART, 0); }
+
+uint32_t esp_random(void) {
+  static sim::Rng rng = sim::rngFor(sim::RNG_SENSORS, 0xE5);
+  return (uint32_t)rng.next();
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+  sim::setSleepTimerUs(time_in_us);
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+  if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_TIMER) sim::setSleepTimerUs(0);
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) { return sim::shared()->nextWakeCause; }
+
+void esp_deep_sleep_start(void) {
+  if (sim::sleepTimerUs() == 0) {
+    sim::endBoot(sim::EXIT_HANG, 0, "deep sleep sin fuente de wakeup");
+  }
+  sim::endBoot(sim::EXIT_DEEP_SLEEP, sim::sleepTimerUs());
+}
+
+esp_err_t esp_light_sleep_start(void) {
+  if (sim::sleepTimerUs() == 0) return ESP_ERR_INVALID_STATE;
+  sim::lightSleep(sim::sleepTimerUs());
+  return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t* config) {
+  sim::wdtConfigure(config ? config->timeout_ms : 0);
+  return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t* config) { return esp_task_wdt_init(config); }
+esp_err_t esp_task_wdt_add(TaskHandle_t task) { (void)task; return ESP_OK; }
+esp_err_t esp_task_wdt_delete(TaskHandle_t task) { (void)task; return ESP_OK; }
+
+esp_err_t esp_task_wdt_reset(void) {
+  sim::wdtFeed();
+  return ESP_OK;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file SimCore.h
+ * @brief Reloj virtual, planificador, energía y ciclo de vida del simulador host
+ * @version FEAT-V31
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * MODELO:
+ *   - Un proceso hijo (fork) por boot del ESP32: las variables globales y
+ *     estáticas arrancan limpias como tras un reset. RTC_DATA_ATTR se copia
+ *     a memoria compartida en deep sleep / esp_restart y se restaura en el
+ *     siguiente boot; un power-on la descarta.
+ *   - Tiempo virtual en µs desde el boot. Las tareas FreeRTOS son corrutinas
+ *     (ucontext) en un solo hilo del host: corre la de menor instante de
+ *     despertar (eventos discretos). delay() no consume tiempo real del host.
+ *   - Lo que sobrevive entre boots (reloj de pared, modem, pines retenidos,
+ *     energía, contadores) vive en Shared, mapeado MAP_SHARED antes del fork.
+ */
+
+#ifndef SIM_CORE_H
+#define SIM_CORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#include <esp_sleep.h>
+#include <esp_system.h>
+
+namespace sim {
+
+// ============================================================
+// CONFIGURACIÓN DE LA CORRIDA
+// ============================================================
+
+struct Config {
+  std::string dir = "sim_out";      ///< fs/, nvs/, server.log, console.log
+  uint64_t seed = 1;
+  uint64_t startEpoch = 1792281600ULL;  ///< 2026-10-18 00:00:00 UTC
+  uint64_t sleepUs = 10ULL * 60ULL * 1000000ULL;  ///< AppConfig::sleep_time_us
+  double driftPpm = 0.0;            ///< Error del timer RTC del ESP32 en deep sleep
+  double batteryMah = 3000.0;
+  bool console = false;             ///< UART0 a <dir>/console.log
+  uint64_t awakeCapUs = 30ULL * 60ULL * 1000000ULL;  ///< Boot colgado: reset por WDT
+};
+
+const Config& config();
+void setConfig(const Config& cfg);
+
+// ============================================================
+// ESTADO COMPARTIDO ENTRE BOOTS
+// ============================================================
+
+/** @brief Consumidores del modelo de energía (a 3.7 V nominales) */
+enum Rail : uint8_t { RAIL_CPU, RAIL_MODEM, RAIL_GNSS, RAIL_RS485, RAIL_COUNT };
+
+/** @brief Cómo terminó un boot */
+enum BootExit : uint8_t { EXIT_NONE, EXIT_DEEP_SLEEP, EXIT_RESTART, EXIT_HANG, EXIT_CRASH, EXIT_BROWNOUT };
+
+static const size_t RTC_IMAGE_MAX = 16384;  ///< Holgura sobre los 8 KB de RTC slow memory
+static const size_t FILE_STATS_MAX = 24;
+static const uint8_t GPIO_COUNT = 49;
+static const size_t FAULT_MAX = 16;       ///< Fallas por escenario (FEAT-V32)
+
+/** @brief Estado del SIM7080G que persiste entre boots del ESP32 (µs de pared) */
+struct ModemPersist {
+  bool powered;
+  uint64_t readyAtWall;      ///< Responde AT desde este instante
+  bool pwrkeyDown;
+  uint64_t pwrkeyDownWall;
+  bool registered;
+  char operatorCode[8];      ///< MCC+MNC seleccionado con AT+COPS
+  bool attached;
+  bool pdpActive;
+  bool tcpOpen;
+  bool gnssOn;
+  uint64_t gnssOnWall;       ///< Inicio de la adquisición (TTFF)
+  bool gnssHadFix;           ///< Efemérides vigentes: próximo arranque es warm
+  uint64_t gnssOffWall;
+  uint64_t gnssTtffUs;       ///< TTFF sorteado al encender el GNSS
+  uint64_t busyUntilWall;    ///< Fin de la última operación en curso (TX, registro)
+  uint32_t atIgnored;        ///< "AT" ignorados desde el encendido (FEAT-V32)
+};
+
+/** @brief Desgaste por archivo de LittleFS */
+struct FileStats {
+  char path[48];
+  uint64_t bytes;            ///< Bytes programados
+  uint32_t writeOpens;
+  uint32_t truncates;        ///< Aperturas "w" sobre un archivo con datos
+};
+
+/** @brief Disparos de una falla del escenario (FEAT-V32) */
+struct FaultRuntime {
+  uint32_t fired;
+  uint32_t skipped;
+  uint64_t firstWall;
+  uint64_t lastWall;
+};
+
+/** @brief Copia de una sección RTC entre boots */
+struct RtcImage {
+  bool valid;
+  uint32_t len;
+  uint8_t data[RTC_IMAGE_MAX];
+};
+
+struct Shared {
+  // Reloj de pared y próximo boot
+  uint64_t nextBootWallUs;   ///< Inicio del próximo boot (pared)
+  uint32_t bootIndex;
+  esp_reset_reason_t nextReset;
+  esp_sleep_wakeup_cause_t nextWakeCause;
+  BootExit lastExit;
+  char lastHang[96];
+
+  // RTC slow memory (ver shim/esp_attr.h)
+  RtcImage rtcData;          ///< RTC_DATA_ATTR: solo entre deep sleeps
+  RtcImage rtcNoinit;        ///< RTC_NOINIT_ATTR: también tras esp_restart, WDT y panic
+
+  // DS1307: desfase fijado con adjust() respecto del reloj de pared
+  int64_t rtcClockOffsetS;
+  bool rtcHalted;            ///< Pila agotada: detenido en 2000-01-01 hasta adjust()
+
+  // Pines (nivel y retención sobreviven al deep sleep si hay hold)
+  uint8_t pinLevel[GPIO_COUNT];
+  bool pinHold[GPIO_COUNT];
+
+  // Energía: integración por riel en mA·µs
+  double railMa[RAIL_COUNT];
+  uint64_t railSinceWall[RAIL_COUNT];
+  double railMaUs[RAIL_COUNT];
+
+  // Ciclo de vida
+  uint32_t boots, deepSleeps, restarts, hangs, crashes, brownouts;
+  uint64_t awakeUs, maxAwakeUs, lightSleepUs;
+
+  // Flash
+  FileStats files[FILE_STATS_MAX];
+  uint32_t fileCount;
+  uint64_t fsBytes;
+  uint32_t nvsPuts, nvsChanged;
+
+  // Modem
+  ModemPersist modem;
+  uint64_t atCommands, atUnknown, tcpSends, tcpBytes;
+  uint32_t gnssFixes;
+
+  // Escenario (FEAT-V32)
+  FaultRuntime faults[FAULT_MAX];
+  uint64_t maxFaultAwakeUs;  ///< Boot más largo con algún disparo de falla
+};
+
+Shared* shared();
+
+/** @brief Crea el estado compartido (padre, antes del primer fork) */
+void initShared();
+
+// ============================================================
+// TIEMPO VIRTUAL Y PLANIFICADOR
+// ============================================================
+
+/** @brief µs desde el boot (esp_timer_get_time, millis, micros) */
+uint64_t now();
+
+/** @brief µs de pared desde el inicio de la simulación */
+uint64_t wall();
+
+/** @brief Instante de pared de un instante del boot actual */
+uint64_t wallAt(uint64_t bootUs);
+
+/** @brief Consume CPU: avanza el reloj; cede si otra tarea despierta antes */
+void advance(uint64_t us);
+
+/** @brief Bloquea la tarea actual hasta el instante t (delay, vTaskDelay) */
+void blockUntil(uint64_t t);
+
+/** @brief Entra/sale de sección crítica (sin cambio de tarea) */
+void criticalEnter();
+void criticalExit();
+
+/** @brief Consumo de la tarea del watchdog (FIX-V5) */
+void wdtConfigure(uint32_t timeoutMs);
+void wdtFeed();
+
+// ============================================================
+// ENERGÍA
+// ============================================================
+
+/** @brief Fija la corriente de un riel desde el instante de pared actual */
+void railSet(Rail rail, double mA);
+
+/** @brief Igual, desde un instante de pared dado (no anterior al último cambio del riel) */
+void railSetAt(Rail rail, double mA, uint64_t atWall);
+
+/** @brief Corriente actual del riel */
+double railGet(Rail rail);
+
+/** @brief mAh consumidos hasta el instante de pared dado */
+double consumedMah(uint64_t atWall);
+
+/** @brief Tensión de batería (descarga lineal 4.2 V -> 3.3 V sobre batteryMah) */
+double batteryVolts();
+
+/** @brief Cuenta tiempo en light sleep (la CPU baja a ~0.24 mA) */
+void lightSleep(uint64_t us);
+
+// ============================================================
+// CICLO DE VIDA
+// ============================================================
+
+/** @brief Ejecuta un boot completo en el proceso actual (hijo); no retorna */
+void runBoot() __attribute__((noreturn));
+
+/**
+ * @brief Prepara un boot sin AppInit() en el proceso actual y retorna.
+ *
+ * Tarea loopTask, periféricos y modem listos para llamar módulos de src/
+ * sueltos (tools/bench, FEAT-V33). Sin endBoot(): el proceso sale solo.
+ */
+void hostedBoot();
+
+/**
+ * @brief Termina el boot actual y el proceso hijo.
+ * @param how Motivo.
+ * @param sleepUs Duración del deep sleep (EXIT_DEEP_SLEEP) o del corte (EXIT_BROWNOUT).
+ * @param why Texto del cuelgue (EXIT_HANG).
+ */
+void endBoot(BootExit how, uint64_t sleepUs, const char* why = nullptr) __attribute__((noreturn));
+
+/** @brief Temporizador programado con esp_sleep_enable_timer_wakeup() */
+uint64_t sleepTimerUs();
+void setSleepTimerUs(uint64_t us);
+
+// Ganchos de boot de los modelos (SimDevices.cpp, SimModem.cpp)
+void devicesBoot();                 ///< Pines retenidos, UARTs, base del heap
+void devicesExit(BootExit how);     ///< Pines sin hold a LOW, archivos abiertos
+void modemBoot();                   ///< Cola RX vacía; el estado del modem persiste
+
+// ============================================================
+// ALEATORIEDAD DETERMINISTA
+// ============================================================
+
+enum RngStream : uint32_t { RNG_MODEM = 1, RNG_SENSORS = 2, RNG_MODBUS = 3, RNG_GNSS = 4, RNG_FAULT = 5 };
+
+/** @brief splitmix64 sembrado por (semilla, boot, flujo) */
+class Rng {
+ public:
+  explicit Rng(uint64_t key) : s_(key) {}
+  uint64_t next();
+  double uniform();                         ///< [0, 1)
+  double range(double lo, double hi) { return lo + (hi - lo) * uniform(); }
+  double normal();                          ///< N(0, 1)
+
+ private:
+  uint64_t s_;
+};
+
+Rng rngFor(RngStream stream, uint64_t salt = 0);
+
+/** @brief Mezcla de 64 bits (finalizador de splitmix64) */
+uint64_t mix64(uint64_t x);
+
+// ============================================================
+// SALIDA
+// ============================================================
+
+/** @brief Ruta dentro del directorio de la corrida */
+std::string path(const char* rel);
+
+}  // namespace sim
+
+#endif  // SIM_CORE_H
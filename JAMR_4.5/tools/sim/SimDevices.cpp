@@ -0,0 +1,1044 @@
+/**
+ * @file SimDevices.cpp
+ * @brief Periféricos del ESP32-S3 y de la placa sobre tiempo virtual
+ * @version FEAT-V31
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * UART con FIFO de TX de 128 B a la velocidad configurada; GPIO con hold;
+ * ADC de batería; LittleFS y NVS persistidos en el directorio de la corrida;
+ * DS1307, AHT20 y sonda Modbus (esclavo 18 en RS485, alimentada por ENPOWER).
+ * Los costos de tiempo son órdenes de magnitud medidos en el equipo real,
+ * suficientes para comparar versiones del firmware, no para validar timing fino.
+ */
+
+#include <errno.h>
+#include <malloc.h>
+#include <math.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include <AHT20.h>
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <ModbusMaster.h>
+#include <Preferences.h>
+#include <RTClib.h>
+#include <Wire.h>
+#include <driver/gpio.h>
+#include <esp_app_desc.h>
+
+#include "SimCore.h"
+#include "SimDevices.h"
+#include "SimFault.h"
+
+namespace sim {
+
+static const uint8_t PIN_ENPOWER = 3;
+static const uint8_t PIN_PWRKEY = 9;
+static const uint8_t PIN_VBAT = 13;
+static const double RS485_PROBE_MA = 25.0;
+
+static const size_t UART_COUNT = 3;
+static const size_t UART_TX_FIFO = 128;
+
+/** @brief Estado de un puerto: SerialLTE(1) y Serial1 comparten el UART1 */
+struct Uart {
+  bool begun = false;
+  uint32_t baud = 115200;
+  uint64_t txFreeNs = 0;                            ///< Fin del último byte en el shift register
+  uint64_t rxLastNs = 0;                            ///< Llegada del último byte recibido
+  std::deque<std::pair<uint64_t, uint8_t>> rx;      ///< (llegada en µs, byte)
+  std::string consoleLine;
+};
+
+static Uart g_uart[UART_COUNT];
+static FILE* g_console = nullptr;
+static size_t g_heapBase = 0;
+static uint32_t g_heapMinFree = 0;
+static double g_costNs = 0.0;  ///< Costos fraccionarios de CPU acumulados
+
+static uint64_t byteNs(const Uart& u) { return 10ULL * 1000000000ULL / (u.baud ? u.baud : 115200); }
+
+/** @brief Consume CPU en ns; el reloj avanza en µs enteros */
+static void costNs(double ns) {
+  g_costNs += ns;
+  if (g_costNs >= 1000.0) {
+    uint64_t us = (uint64_t)(g_costNs / 1000.0);
+    g_costNs -= (double)us * 1000.0;
+    advance(us);
+  }
+}
+
+// ============================================================
+// UART
+// ============================================================
+
+/** @brief EMI sobre la línea del modem: un bit cambiado con probabilidad rate (FEAT-V32) */
+static uint8_t lineNoise(uint8_t c, uint64_t atUs) {
+  uint64_t w = wallAt(atUs);
+  const Fault* f = faultDue(FAULT_UART_NOISE, w);
+  if (f == nullptr) return c;
+  Rng rng = rngFor(RNG_FAULT, w * 256 + c);
+  if (rng.uniform() >= f->rate) return c;
+  faultFire(f, w);
+  return (uint8_t)(c ^ (1u << (rng.next() % 8)));
+}
+
+void uartDeliver(int uart, const std::string& bytes, uint64_t atUs) {
+  Uart& u = g_uart[uart];
+  uint64_t bt = byteNs(u);
+  uint64_t t = atUs * 1000ULL;
+  if (u.rxLastNs > t) t = u.rxLastNs;
+  for (char c : bytes) {
+    t += bt;
+    uint64_t at = (t + 999) / 1000;
+    u.rx.emplace_back(at, uart == 1 ? lineNoise((uint8_t)c, at) : (uint8_t)c);
+  }
+  u.rxLastNs = t;
+}
+
+void uartPurgeAfter(int uart, uint64_t fromUs) {
+  Uart& u = g_uart[uart];
+  while (!u.rx.empty() && u.rx.back().first > fromUs) u.rx.pop_back();
+  if (u.rxLastNs > fromUs * 1000ULL) u.rxLastNs = fromUs * 1000ULL;
+}
+
+/**
+ * @brief Sondeo sin datos: avanza hasta el próximo byte, con tope de 100 µs.
+ *
+ * Los bucles de espera del firmware (available()/read() + millis()) cuestan
+ * así a lo sumo 100 µs de error en sus timeouts y no millones de vueltas.
+ */
+static void idlePoll(const Uart& u) {
+  uint64_t t = now();
+  uint64_t step = 100;
+  if (u.begun && !u.rx.empty() && u.rx.front().first > t && u.rx.front().first - t < step) {
+    step = u.rx.front().first - t;
+  }
+  advance(step < 2 ? 2 : step);
+}
+
+static void consoleByte(Uart& u, uint8_t c, uint64_t atUs) {
+  if (g_console == nullptr) return;
+  if (c == '\n') {
+    uint64_t w = wallAt(atUs);
+    fprintf(g_console, "[%7u %10.3f] %s\n", shared()->boots, (double)w / 1e6, u.consoleLine.c_str());
+    u.consoleLine.clear();
+  } else if (c != '\r' && u.consoleLine.size() < 4096) {
+    u.consoleLine += (char)c;
+  }
+}
+
+}  // namespace sim
+
+using sim::g_uart;
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin, bool invert,
+                           unsigned long timeoutMs) {
+  (void)config;
+  (void)rxPin;
+  (void)txPin;
+  (void)invert;
+  (void)timeoutMs;
+  sim::Uart& u = g_uart[uart_];
+  u.baud = (uint32_t)baud;
+  u.begun = true;
+  // Lo que llegó con el puerto cerrado se perdió
+  while (!u.rx.empty() && u.rx.front().first <= sim::now()) u.rx.pop_front();
+  sim::advance(50);
+}
+
+void HardwareSerial::end() {
+  flush();
+  g_uart[uart_].begun = false;
+}
+
+int HardwareSerial::available() {
+  sim::Uart& u = g_uart[uart_];
+  uint64_t t = sim::now();
+  int n = 0;
+  if (u.begun) {
+    for (const auto& e : u.rx) {
+      if (e.first > t) break;
+      n++;
+    }
+  }
+  if (n == 0) sim::idlePoll(u);
+  return n;
+}
+
+int HardwareSerial::read() {
+  sim::Uart& u = g_uart[uart_];
+  sim::costNs(500);
+  if (!u.begun || u.rx.empty() || u.rx.front().first > sim::now()) {
+    sim::idlePoll(u);  // timedRead() de Stream sondea read() sin available()
+    return -1;
+  }
+  uint8_t c = u.rx.front().second;
+  u.rx.pop_front();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  sim::Uart& u = g_uart[uart_];
+  if (!u.begun || u.rx.empty() || u.rx.front().first > sim::now()) return -1;
+  return u.rx.front().second;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  sim::Uart& u = g_uart[uart_];
+  uint64_t bt = sim::byteNs(u);
+  uint64_t nowNs = sim::now() * 1000ULL;
+  // FIFO de TX llena: la tarea espera a que drene
+  if (u.txFreeNs > nowNs + sim::UART_TX_FIFO * bt) {
+    sim::blockUntil((u.txFreeNs - sim::UART_TX_FIFO * bt) / 1000ULL);
+    nowNs = sim::now() * 1000ULL;
+  }
+  uint64_t start = u.txFreeNs > nowNs ? u.txFreeNs : nowNs;
+  u.txFreeNs = start + bt;
+  uint64_t doneUs = (u.txFreeNs + 999) / 1000ULL;
+  sim::costNs(200);
+
+  if (uart_ == 1) {
+    if (u.begun) sim::modemRxByte(sim::lineNoise(c, doneUs), doneUs);
+  } else if (uart_ == 0) {
+    sim::consoleByte(u, c, doneUs);
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  for (size_t i = 0; i < n; i++) write(buf[i]);
+  return n;
+}
+
+void HardwareSerial::flush() {
+  uint64_t doneUs = (g_uart[uart_].txFreeNs + 999) / 1000ULL;
+  if (doneUs > sim::now()) sim::blockUntil(doneUs);
+}
+
+int HardwareSerial::availableForWrite() {
+  sim::Uart& u = g_uart[uart_];
+  uint64_t nowNs = sim::now() * 1000ULL;
+  if (u.txFreeNs <= nowNs) return (int)sim::UART_TX_FIFO;
+  uint64_t queued = (u.txFreeNs - nowNs) / sim::byteNs(u);
+  return queued >= sim::UART_TX_FIFO ? 0 : (int)(sim::UART_TX_FIFO - queued);
+}
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+// ============================================================
+// TIEMPO
+// ============================================================
+
+unsigned long millis() {
+  sim::advance(1);
+  return (unsigned long)(sim::now() / 1000ULL);
+}
+
+unsigned long micros() {
+  sim::advance(1);
+  return (unsigned long)sim::now();
+}
+
+void delay(unsigned long ms) { sim::blockUntil(sim::now() + (uint64_t)ms * 1000ULL); }
+
+void delayMicroseconds(unsigned int us) { sim::advance(us); }
+
+void yield() { sim::advance(1); }
+
+// ============================================================
+// GPIO
+// ============================================================
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+static void pinEffect(uint8_t pin, uint8_t level) {
+  if (pin == sim::PIN_ENPOWER) sim::railSet(sim::RAIL_RS485, level ? sim::RS485_PROBE_MA : 0.0);
+  if (pin == sim::PIN_PWRKEY) sim::modemPwrkey(level == HIGH);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= sim::GPIO_COUNT) return;
+  sim::Shared* s = sim::shared();
+  if (s->pinHold[pin]) return;  // El pad retenido ignora escrituras
+  uint8_t level = val ? HIGH : LOW;
+  if (s->pinLevel[pin] == level) return;
+  s->pinLevel[pin] = level;
+  pinEffect(pin, level);
+}
+
+int digitalRead(uint8_t pin) { return pin < sim::GPIO_COUNT ? sim::shared()->pinLevel[pin] : LOW; }
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num) {
+  if (gpio_num < 0 || gpio_num >= sim::GPIO_COUNT) return ESP_ERR_INVALID_ARG;
+  sim::shared()->pinHold[gpio_num] = true;
+  return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num) {
+  if (gpio_num < 0 || gpio_num >= sim::GPIO_COUNT) return ESP_ERR_INVALID_ARG;
+  sim::shared()->pinHold[gpio_num] = false;
+  return ESP_OK;
+}
+
+void gpio_deep_sleep_hold_en(void) {}
+void gpio_deep_sleep_hold_dis(void) {}
+
+// ============================================================
+// ADC, aleatorios, ESP
+// ============================================================
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+  static sim::Rng rng = sim::rngFor(sim::RNG_SENSORS, 0xADC);
+  sim::advance(20);
+  if (pin != sim::PIN_VBAT) return 0;
+  // Divisor 1:2 de la placa; mV calibrados (curva eFuse)
+  double mv = sim::batteryVolts() / 2.0 * 1000.0 + rng.normal() * 3.0;
+  if (mv < 0) mv = 0;
+  if (mv > 3300) mv = 3300;
+  return (uint32_t)lround(mv);
+}
+
+// Sin calibrar, el ADC lee ~150 mV bajo en el pin: lo que ADC_ADJUSTMENT
+// (0.3 V en batería) compensa en readSensor()
+uint16_t analogRead(uint8_t pin) {
+  uint32_t mv = analogReadMilliVolts(pin);
+  mv = mv > 150 ? mv - 150 : 0;
+  return (uint16_t)(mv * 4095UL / 3300UL);
+}
+
+void analogReadResolution(uint8_t bits) { (void)bits; }
+void analogSetAttenuation(int atten) { (void)atten; }
+void analogSetPinAttenuation(uint8_t pin, int atten) {
+  (void)pin;
+  (void)atten;
+}
+
+static sim::Rng& arduinoRng() {
+  static sim::Rng rng = sim::rngFor(sim::RNG_SENSORS, 0x4A4D);
+  return rng;
+}
+
+long random(long maxVal) { return maxVal > 0 ? (long)(arduinoRng().next() % (uint64_t)maxVal) : 0; }
+long random(long minVal, long maxVal) { return maxVal > minVal ? minVal + random(maxVal - minVal) : minVal; }
+void randomSeed(unsigned long seed) { (void)seed; }
+
+static const uint32_t SIM_HEAP_SIZE = 320UL * 1024UL;
+
+uint32_t EspClass::getFreeHeap() {
+  // mallinfo2() recorre las arenas: se muestrea como mucho una vez por ms virtual
+  static uint64_t sampledAt = UINT64_MAX;
+  static uint32_t freeB = SIM_HEAP_SIZE;
+  sim::advance(2);
+  if (sampledAt != sim::now() / 1000ULL) {
+    sampledAt = sim::now() / 1000ULL;
+    struct mallinfo2 mi = mallinfo2();
+    size_t used = mi.uordblks > sim::g_heapBase ? mi.uordblks - sim::g_heapBase : 0;
+    freeB = used < SIM_HEAP_SIZE ? (uint32_t)(SIM_HEAP_SIZE - used) : 0;
+    if (freeB < sim::g_heapMinFree) sim::g_heapMinFree = freeB;
+  }
+  return freeB;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  getFreeHeap();
+  return sim::g_heapMinFree;
+}
+
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap() * 9 / 10; }
+uint32_t EspClass::getHeapSize() { return SIM_HEAP_SIZE; }
+uint32_t EspClass::getCycleCount() { return (uint32_t)(sim::now() * 240ULL); }
+uint64_t EspClass::getEfuseMac() { return sim::mix64(sim::config().seed ^ 0xEF05E) & 0xFFFFFFFFFFFFULL; }
+
+EspClass ESP;
+
+const esp_app_desc_t* esp_app_get_description(void) {
+  static esp_app_desc_t desc = [] {
+    esp_app_desc_t d;
+    memset(&d, 0, sizeof(d));
+    d.magic_word = 0xABCD5432;
+    snprintf(d.version, sizeof(d.version), "host-sim");
+    snprintf(d.project_name, sizeof(d.project_name), "JAMR_4.5");
+    snprintf(d.time, sizeof(d.time), "%s", __TIME__);
+    snprintf(d.date, sizeof(d.date), "%s", __DATE__);
+    snprintf(d.idf_ver, sizeof(d.idf_ver), "sim");
+    return d;
+  }();
+  return &desc;
+}
+
+// ============================================================
+// LittleFS
+// ============================================================
+
+namespace sim {
+
+static const size_t FS_TOTAL_BYTES = 1536UL * 1024UL;
+static const size_t FS_BLOCK = 4096;
+static const double FS_PROGRAM_NS_PER_BYTE = 1600.0;
+static const double FS_READ_NS_PER_BYTE = 250.0;
+static const uint64_t FS_ERASE_US = 35000;
+static const uint64_t FS_COMMIT_US = 2000;
+static const char* const BUFFER_PATH = "/buffer.txt";  ///< BUFFER_FILE_PATH del firmware
+
+static std::string hostPath(const char* p) {
+  std::string rel = p ? p : "";
+  while (!rel.empty() && rel[0] == '/') rel.erase(0, 1);
+  return path("fs") + "/" + rel;
+}
+
+static void mkdirs(const std::string& file) {
+  for (size_t i = path("fs").size() + 1; i < file.size(); i++) {
+    if (file[i] == '/') ::mkdir(file.substr(0, i).c_str(), 0755);
+  }
+}
+
+static FileStats* fileStats(const std::string& p) {
+  Shared* s = shared();
+  for (uint32_t i = 0; i < s->fileCount; i++) {
+    if (p == s->files[i].path) return &s->files[i];
+  }
+  if (s->fileCount >= FILE_STATS_MAX) return nullptr;
+  FileStats* f = &s->files[s->fileCount++];
+  snprintf(f->path, sizeof(f->path), "%s", p.c_str());
+  return f;
+}
+
+/** @brief Bytes programados: cada bloque nuevo cuesta un borrado */
+static void programmed(const std::string& p, size_t n) {
+  Shared* s = shared();
+  uint64_t before = s->fsBytes / FS_BLOCK;
+  s->fsBytes += n;
+  FileStats* f = fileStats(p);
+  if (f) f->bytes += n;
+  costNs(FS_PROGRAM_NS_PER_BYTE * (double)n);
+  for (uint64_t b = before; b < s->fsBytes / FS_BLOCK; b++) advance(FS_ERASE_US);
+}
+
+/** @brief Trama que el firmware agregó al buffer, persista o no (frames.log, FEAT-V32) */
+static void frameWritten(std::string line) {
+  while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.pop_back();
+  if (line.empty()) return;
+  FILE* f = fopen(path("frames.log").c_str(), "a");
+  if (f) {
+    fprintf(f, "%llu %s\n", (unsigned long long)wall(), line.c_str());
+    fclose(f);
+  }
+}
+
+/** @brief Archivo abierto al que apunta un brownout: ruta y modo de apertura */
+struct OpenFile {
+  const std::string& path;
+  const std::string& mode;
+};
+
+static bool brownoutMatches(const Fault& f, const void* ctx) {
+  const OpenFile* o = static_cast<const OpenFile*>(ctx);
+  return (f.file.empty() || f.file == o->path) && (f.mode.empty() || f.mode == o->mode);
+}
+
+static bool slurp(const std::string& host, std::string& out) {
+  FILE* f = fopen(host.c_str(), "rb");
+  if (!f) return false;
+  out.clear();
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+}  // namespace sim
+
+namespace fs {
+
+struct FileImpl {
+  std::string path;
+  std::string host;
+  std::string data;
+  size_t pos = 0;
+  bool writable = false;
+  bool append = false;
+  bool dirty = false;
+  bool open = true;
+  std::string mode;     ///< Modo de apertura (FEAT-V32)
+  std::string lineAcc;  ///< Línea en curso de un append a buffer.txt (FEAT-V32)
+
+  void commit() {
+    if (!open || !dirty) return;
+    sim::mkdirs(host);
+    FILE* f = fopen(host.c_str(), "wb");
+    if (f) {
+      fwrite(data.data(), 1, data.size(), f);
+      fclose(f);
+    }
+    dirty = false;
+    sim::advance(sim::FS_COMMIT_US);
+  }
+
+  ~FileImpl() { commit(); }
+};
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+
+size_t File::write(const uint8_t* buf, size_t n) {
+  if (!impl_ || !impl_->open || !impl_->writable || n == 0) return 0;
+  FileImpl& f = *impl_;
+  bool frame = f.append && f.path == sim::BUFFER_PATH;
+  if (frame) {
+    for (size_t i = 0; i < n; i++) {
+      f.lineAcc += (char)buf[i];
+      if (buf[i] == '\n') {
+        sim::frameWritten(f.lineAcc);
+        f.lineAcc.clear();
+      }
+    }
+  }
+
+  // FEAT-V32: corte a mitad de la escritura; lo no cerrado nunca llega a flash
+  sim::OpenFile target{f.path, f.mode};
+  const sim::Fault* bo = sim::faultDue(sim::FAULT_BROWNOUT, sim::wall(), sim::brownoutMatches, &target);
+  if (bo) {
+    sim::programmed(f.path, n / 2);
+    sim::faultFire(bo, sim::wall());
+    if (frame) sim::frameWritten(f.lineAcc);
+    sim::endBoot(sim::EXIT_BROWNOUT, bo->offUs);
+  }
+
+  if (f.append) f.pos = f.data.size();
+  if (f.pos + n > f.data.size()) f.data.resize(f.pos + n);
+  memcpy(&f.data[f.pos], buf, n);
+  f.pos += n;
+  f.dirty = true;
+  sim::programmed(f.path, n);
+  return n;
+}
+
+int File::available() {
+  if (!impl_ || !impl_->open) return 0;
+  return (int)(impl_->data.size() - impl_->pos);
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  if (!impl_ || !impl_->open || impl_->pos >= impl_->data.size()) return -1;
+  return (uint8_t)impl_->data[impl_->pos];
+}
+
+size_t File::read(uint8_t* buf, size_t n) {
+  if (!impl_ || !impl_->open) return 0;
+  FileImpl& f = *impl_;
+  size_t k = f.pos < f.data.size() ? std::min(n, f.data.size() - f.pos) : 0;
+  memcpy(buf, f.data.data() + f.pos, k);
+  f.pos += k;
+  sim::costNs(sim::FS_READ_NS_PER_BYTE * (double)k + 100.0);
+  return k;
+}
+
+void File::flush() {
+  if (impl_) impl_->commit();
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl_ || !impl_->open) return false;
+  int64_t target = (int64_t)pos;
+  if (mode == SeekCur) target = (int64_t)impl_->pos + (int32_t)pos;
+  if (mode == SeekEnd) target = (int64_t)impl_->data.size() + (int32_t)pos;
+  if (target < 0 || (size_t)target > impl_->data.size()) return false;
+  impl_->pos = (size_t)target;
+  return true;
+}
+
+size_t File::position() const { return impl_ ? impl_->pos : 0; }
+size_t File::size() const { return impl_ ? impl_->data.size() : 0; }
+
+void File::close() {
+  if (!impl_) return;
+  impl_->commit();
+  impl_->open = false;
+  impl_.reset();
+}
+
+const char* File::path() const { return impl_ ? impl_->path.c_str() : ""; }
+
+const char* File::name() const {
+  if (!impl_) return "";
+  size_t slash = impl_->path.rfind('/');
+  return impl_->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+
+File::operator bool() const { return impl_ && impl_->open; }
+
+File FS::open(const char* path, const char* mode, bool create) {
+  (void)create;
+  auto f = std::make_shared<FileImpl>();
+  f->path = path;
+  if (f->path.empty() || f->path[0] != '/') f->path.insert(0, "/");
+  f->host = sim::hostPath(path);
+  bool exists = sim::slurp(f->host, f->data);
+  std::string m = mode ? mode : "r";
+  f->mode = m;
+  bool write = m != "r";
+  sim::advance(write ? 1500 : 500);
+
+  if (m == "r" || m == "r+") {
+    if (!exists) return File();
+    f->writable = (m == "r+");
+  } else if (m == "w" || m == "w+") {
+    if (exists && !f->data.empty()) {
+      sim::FileStats* st = sim::fileStats(f->path);
+      if (st) st->truncates++;
+    }
+    f->data.clear();
+    f->writable = true;
+    f->dirty = true;  // Crea o trunca en disco aunque no se escriba nada
+  } else if (m == "a" || m == "a+") {
+    f->writable = true;
+    f->append = true;
+    f->pos = f->data.size();
+    f->dirty = !exists;
+  } else {
+    return File();
+  }
+  if (write) {
+    sim::FileStats* st = sim::fileStats(f->path);
+    if (st) st->writeOpens++;
+  }
+  sim::costNs(sim::FS_READ_NS_PER_BYTE * (double)f->data.size() / 8.0);  // Lectura de metadatos/CTZ
+  return File(f);
+}
+
+bool FS::exists(const char* path) {
+  struct stat st;
+  sim::advance(300);
+  return ::stat(sim::hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char* path) {
+  sim::advance(1000);
+  return ::unlink(sim::hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  sim::advance(1500);
+  std::string dst = sim::hostPath(to);
+  sim::mkdirs(dst);
+  return ::rename(sim::hostPath(from).c_str(), dst.c_str()) == 0;
+}
+
+bool FS::mkdir(const char* path) {
+  sim::advance(1000);
+  std::string p = sim::hostPath(path);
+  return ::mkdir(p.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool FS::rmdir(const char* path) {
+  sim::advance(1000);
+  return ::rmdir(sim::hostPath(path).c_str()) == 0;
+}
+
+}  // namespace fs
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+  (void)formatOnFail;
+  (void)basePath;
+  (void)maxOpenFiles;
+  (void)partitionLabel;
+  sim::advance(25000);  // Montaje: lectura de superbloques
+  ::mkdir(sim::path("fs").c_str(), 0755);
+  return true;
+}
+
+bool LittleFSFS::format() {
+  std::string cmd = "rm -rf '" + sim::path("fs") + "'/*";
+  if (system(cmd.c_str()) != 0) return false;
+  sim::advance(2000000);
+  return true;
+}
+
+size_t LittleFSFS::totalBytes() { return sim::FS_TOTAL_BYTES; }
+
+size_t LittleFSFS::usedBytes() {
+  std::string cmd = "find '" + sim::path("fs") + "' -type f -printf '%s\\n' 2>/dev/null";
+  FILE* p = popen(cmd.c_str(), "r");
+  size_t used = 2 * sim::FS_BLOCK;  // Superbloques
+  if (p) {
+    unsigned long long sz;
+    while (fscanf(p, "%llu", &sz) == 1) used += (sz + sim::FS_BLOCK - 1) / sim::FS_BLOCK * sim::FS_BLOCK;
+    pclose(p);
+  }
+  return used;
+}
+
+LittleFSFS LittleFS;
+
+// ============================================================
+// Preferences (NVS)
+// ============================================================
+
+namespace sim {
+
+typedef std::map<std::string, std::string> NvsNamespace;
+
+static std::map<std::string, NvsNamespace> g_nvs;
+
+static std::string nvsFile(const std::string& ns) { return path("nvs") + "/" + ns + ".bin"; }
+
+static bool nvsLoad(const std::string& ns) {
+  if (g_nvs.count(ns)) return true;
+  std::string raw;
+  if (!slurp(nvsFile(ns), raw)) return false;
+  NvsNamespace& m = g_nvs[ns];
+  size_t i = 0;
+  while (i < raw.size()) {
+    uint8_t klen = (uint8_t)raw[i++];
+    if (i + klen + 4 > raw.size()) break;
+    std::string key = raw.substr(i, klen);
+    i += klen;
+    uint32_t vlen;
+    memcpy(&vlen, raw.data() + i, 4);
+    i += 4;
+    if (i + vlen > raw.size()) break;
+    m[key] = raw.substr(i, vlen);
+    i += vlen;
+  }
+  return true;
+}
+
+static void nvsStore(const std::string& ns) {
+  std::string raw;
+  for (const auto& kv : g_nvs[ns]) {
+    raw += (char)(uint8_t)kv.first.size();
+    raw += kv.first;
+    uint32_t vlen = (uint32_t)kv.second.size();
+    raw.append((const char*)&vlen, 4);
+    raw += kv.second;
+  }
+  FILE* f = fopen(nvsFile(ns).c_str(), "wb");
+  if (f) {
+    fwrite(raw.data(), 1, raw.size(), f);
+    fclose(f);
+  }
+  advance(2000);  // Escritura de entrada + página de estado
+}
+
+}  // namespace sim
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition) {
+  (void)partition;
+  sim::advance(200);
+  ns_ = name ? name : "";
+  readOnly_ = readOnly;
+  // Como nvs_open(): en solo lectura un namespace inexistente es error
+  if (!sim::nvsLoad(ns_)) {
+    if (readOnly) return false;
+    sim::g_nvs[ns_];
+  }
+  open_ = true;
+  return true;
+}
+
+void Preferences::end() { open_ = false; }
+
+bool Preferences::clear() {
+  if (!open_ || readOnly_) return false;
+  sim::g_nvs[ns_].clear();
+  sim::nvsStore(ns_);
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!open_ || readOnly_) return false;
+  if (sim::g_nvs[ns_].erase(key) == 0) return false;
+  sim::nvsStore(ns_);
+  return true;
+}
+
+bool Preferences::isKey(const char* key) { return find(key) != nullptr; }
+
+size_t Preferences::freeEntries() {
+  size_t used = 0;
+  for (const auto& ns : sim::g_nvs) {
+    for (const auto& kv : ns.second) used += 1 + kv.second.size() / 32;
+  }
+  return used < 630 ? 630 - used : 0;
+}
+
+const std::string* Preferences::find(const char* key) {
+  if (!open_ || key == nullptr) return nullptr;
+  sim::advance(20);
+  auto& m = sim::g_nvs[ns_];
+  auto it = m.find(key);
+  return it == m.end() ? nullptr : &it->second;
+}
+
+size_t Preferences::putRaw(const char* key, const void* data, size_t n) {
+  if (!open_ || readOnly_ || key == nullptr) return 0;
+  sim::Shared* s = sim::shared();
+  s->nvsPuts++;
+  std::string v((const char*)data, n);
+  sim::NvsNamespace& m = sim::g_nvs[ns_];
+  auto it = m.find(key);
+  if (it != m.end() && it->second == v) {
+    sim::advance(300);  // nvs_set_* compara y no reescribe
+    return n;
+  }
+  m[key] = v;
+  s->nvsChanged++;
+  sim::nvsStore(ns_);
+  return n;
+}
+
+String Preferences::getString(const char* key, const String& d) {
+  const std::string* v = find(key);
+  return v ? String(v->c_str()) : d;
+}
+
+size_t Preferences::getString(const char* key, char* buf, size_t maxLen) {
+  const std::string* v = find(key);
+  if (v == nullptr || buf == nullptr || v->size() + 1 > maxLen) return 0;
+  memcpy(buf, v->data(), v->size());
+  buf[v->size()] = '\0';
+  return v->size() + 1;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  const std::string* v = find(key);
+  return v ? v->size() : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  const std::string* v = find(key);
+  if (v == nullptr || buf == nullptr || v->size() > maxLen) return 0;
+  memcpy(buf, v->data(), v->size());
+  return v->size();
+}
+
+// ============================================================
+// DS1307, AHT20, Modbus
+// ============================================================
+
+static int64_t daysFromCivil(int y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned)(y - era * 400);
+  unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int64_t)doe - 719468;
+}
+
+DateTime::DateTime(uint32_t t) : t_(t) { split(); }
+
+DateTime::DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t min, uint8_t sec) {
+  if (year < 100) year += 2000;
+  t_ = (uint32_t)(daysFromCivil(year, month, day) * 86400 + hour * 3600 + min * 60 + sec);
+  split();
+}
+
+DateTime::DateTime(const char* date, const char* time) {
+  static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  char mon[4] = {0};
+  int d = 1, y = 2000, h = 0, mi = 0, s = 0;
+  sscanf(date, "%3s %d %d", mon, &d, &y);
+  sscanf(time, "%d:%d:%d", &h, &mi, &s);
+  const char* p = strstr(MONTHS, mon);
+  unsigned m = p ? (unsigned)((p - MONTHS) / 3 + 1) : 1;
+  t_ = (uint32_t)(daysFromCivil(y, m, (unsigned)d) * 86400 + h * 3600 + mi * 60 + s);
+  split();
+}
+
+void DateTime::split() {
+  int64_t z = t_ / 86400 + 719468;
+  uint32_t secs = t_ % 86400;
+  int64_t era = z / 146097;
+  unsigned doe = (unsigned)(z - era * 146097);
+  unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  unsigned mp = (5 * doy + 2) / 153;
+  day_ = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+  month_ = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+  year_ = (uint16_t)(yoe + era * 400 + (month_ <= 2));
+  hour_ = (uint8_t)(secs / 3600);
+  minute_ = (uint8_t)(secs / 60 % 60);
+  second_ = (uint8_t)(secs % 60);
+}
+
+static int64_t simEpoch() { return (int64_t)sim::config().startEpoch + (int64_t)(sim::wall() / 1000000ULL); }
+
+static const uint32_t DS1307_RESET_EPOCH = 946684800UL;  ///< 2000-01-01 00:00:00, registros tras perder la pila
+
+/** @brief FEAT-V32: la pila se agota; el oscilador queda detenido (bit CH) hasta adjust() */
+static void rtcBatteryCheck() {
+  const sim::Fault* f = sim::faultDue(sim::FAULT_RTC_LOST, sim::wall());
+  if (f == nullptr) return;
+  sim::faultFire(f, sim::wall());
+  sim::shared()->rtcHalted = true;
+}
+
+bool RTC_DS1307::begin(TwoWire* wire) {
+  (void)wire;
+  sim::advance(500);
+  return true;
+}
+
+bool RTC_DS1307::isrunning() {
+  sim::advance(500);
+  rtcBatteryCheck();
+  return !sim::shared()->rtcHalted;
+}
+
+void RTC_DS1307::adjust(const DateTime& dt) {
+  sim::advance(800);
+  sim::shared()->rtcHalted = false;
+  sim::shared()->rtcClockOffsetS = (int64_t)dt.unixtime() - simEpoch();
+}
+
+DateTime RTC_DS1307::now() {
+  sim::advance(500);
+  rtcBatteryCheck();
+  if (sim::shared()->rtcHalted) return DateTime(DS1307_RESET_EPOCH);
+  return DateTime((uint32_t)(simEpoch() + sim::shared()->rtcClockOffsetS));
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  (void)sda;
+  (void)scl;
+  (void)frequency;
+  sim::advance(100);
+  return true;
+}
+
+TwoWire Wire;
+
+/** @brief Hora local del sitio (UTC-6) en horas, para el ciclo diurno */
+static double localHour() {
+  int64_t t = simEpoch() - 6 * 3600;
+  return (double)(t % 86400) / 3600.0;
+}
+
+bool AHT20::begin() {
+  sim::advance(20000);  // Calibración inicial
+  return true;
+}
+
+float AHT20::getTemperature() {
+  static sim::Rng rng = sim::rngFor(sim::RNG_SENSORS, 0xA420);
+  sim::blockUntil(sim::now() + 80000);  // Conversión
+  double diurnal = sin(2.0 * M_PI * (localHour() - 9.0) / 24.0);
+  return (float)(24.0 + 6.0 * diurnal + rng.normal() * 0.1);
+}
+
+float AHT20::getHumidity() {
+  static sim::Rng rng = sim::rngFor(sim::RNG_SENSORS, 0xA421);
+  sim::blockUntil(sim::now() + 80000);
+  double diurnal = sin(2.0 * M_PI * (localHour() - 9.0) / 24.0);
+  return (float)(55.0 - 15.0 * diurnal + rng.normal() * 0.5);
+}
+
+static const uint8_t SIM_MODBUS_SLAVE = 18;
+
+/** @brief Duración de una transacción RTU a 9600 8N1 (1.04 ms/byte) + retardo del esclavo */
+static uint64_t modbusUs(size_t reqBytes, size_t respBytes) { return (reqBytes + respBytes) * 1042ULL + 5000ULL; }
+
+uint8_t ModbusMaster::transact(uint8_t function, uint16_t address, uint16_t count) {
+  bool present = slave_ == SIM_MODBUS_SLAVE && sim::shared()->pinLevel[sim::PIN_ENPOWER] == HIGH;
+  if (present) {
+    const sim::Fault* mute = sim::faultDue(sim::FAULT_PROBE_MUTE, sim::wall());  // FEAT-V32
+    if (mute != nullptr) {
+      sim::faultFire(mute, sim::wall());
+      present = false;
+    }
+  }
+  if (!present || count == 0 || count > 64) {
+    sim::blockUntil(sim::now() + 2000000ULL);  // Timeout de la librería
+    return ku8MBResponseTimedOut;
+  }
+  sim::blockUntil(sim::now() + modbusUs(8, 5 + 2 * (size_t)count));
+  for (uint16_t i = 0; i < count; i++) {
+    // Valor estable por registro con deriva lenta (±2 % en el día)
+    uint64_t base = sim::mix64(sim::config().seed ^ ((uint64_t)function << 16) ^ (uint64_t)(address + i));
+    double level = 200.0 + (double)(base % 800);
+    double wobble = 1.0 + 0.02 * sin(2.0 * M_PI * localHour() / 24.0 + (double)(base % 7));
+    response_[i] = (uint16_t)(level * wobble);
+  }
+  return ku8MBSuccess;
+}
+
+uint8_t ModbusMaster::writeSingleRegister(uint16_t address, uint16_t value) {
+  (void)address;
+  (void)value;
+  bool present = slave_ == SIM_MODBUS_SLAVE && sim::shared()->pinLevel[sim::PIN_ENPOWER] == HIGH;
+  if (!present) {
+    sim::blockUntil(sim::now() + 2000000ULL);
+    return ku8MBResponseTimedOut;
+  }
+  sim::blockUntil(sim::now() + modbusUs(8, 8));
+  return ku8MBSuccess;
+}
+
+// ============================================================
+// CICLO DE VIDA
+// ============================================================
+
+namespace sim {
+
+void devicesBoot() {
+  Shared* s = shared();
+  if (s->nextReset == ESP_RST_POWERON || s->nextReset == ESP_RST_BROWNOUT) {
+    // Sin alimentación no hay pads retenidos
+    for (uint8_t p = 0; p < GPIO_COUNT; p++) {
+      if (s->pinLevel[p]) {
+        s->pinLevel[p] = LOW;
+        pinEffect(p, LOW);
+      }
+      s->pinHold[p] = false;
+    }
+  }
+  for (Uart& u : g_uart) u = Uart();
+  if (g_console) fclose(g_console);
+  g_console = config().console ? fopen(path("console.log").c_str(), "a") : nullptr;
+  g_heapBase = mallinfo2().uordblks;
+  g_heapMinFree = SIM_HEAP_SIZE;
+  g_nvs.clear();
+}
+
+void devicesExit(BootExit how) {
+  Shared* s = shared();
+  bool powerLoss = how == EXIT_BROWNOUT;
+  // Deep sleep y reset sueltan los pads sin hold (pull-down / alta impedancia);
+  // un corte de alimentación suelta todos
+  for (uint8_t p = 0; p < GPIO_COUNT; p++) {
+    if (powerLoss) s->pinHold[p] = false;
+    if (!s->pinHold[p] && s->pinLevel[p]) {
+      s->pinLevel[p] = LOW;
+      pinEffect(p, LOW);
+    }
+  }
+  if (powerLoss) modemPowerLoss();
+  modemFlush();
+  if (g_console) {
+    for (Uart& u : g_uart) {
+      if (!u.consoleLine.empty()) consoleByte(u, '\n', now());
+    }
+    fflush(g_console);
+  }
+}
+
+}  // namespace sim
@@ -0,0 +1,50 @@
+/**
+ * @file SimDevices.h
+ * @brief Enlaces internos entre los modelos de periféricos del simulador host
+ * @version FEAT-V31
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ */
+
+#ifndef SIM_DEVICES_H
+#define SIM_DEVICES_H
+
+#include <stdint.h>
+#include <string>
+
+namespace sim {
+
+// ============================================================
+// UART (SimDevices.cpp)
+// ============================================================
+
+/** @brief Entrega bytes al RX del ESP32 a partir del instante atUs del boot (a la velocidad del puerto) */
+void uartDeliver(int uart, const std::string& bytes, uint64_t atUs);
+
+/** @brief Descarta lo que aún no llegó al RX (el emisor se apagó) */
+void uartPurgeAfter(int uart, uint64_t fromUs);
+
+// ============================================================
+// SIM7080G (SimModem.cpp)
+// ============================================================
+
+/** @brief Byte del TX del ESP32 que termina de llegar al modem en atUs */
+void modemRxByte(uint8_t c, uint64_t atUs);
+
+/** @brief Cambio de nivel de PWRKEY (GPIO 9, activo en alto) en el instante actual */
+void modemPwrkey(bool pressed);
+
+/** @brief Aplica los eventos pendientes del modem (fin del boot) */
+void modemFlush();
+
+/** @brief Corte de alimentación de la placa: el modem se apaga sin POWER DOWN (FEAT-V32) */
+void modemPowerLoss();
+
+/** @brief ICCID del SIM simulado (20 dígitos, depende de la semilla) */
+std::string modemIccid();
+
+}  // namespace sim
+
+#endif  // SIM_DEVICES_H
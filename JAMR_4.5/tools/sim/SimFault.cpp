@@ -0,0 +1,251 @@
+/**
+ * @file SimFault.cpp
+ * @brief Lectura de escenarios .scn, disparo de fallas y evaluación de aserciones
+ * @version FEAT-V32
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ */
+
+#include "SimFault.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace sim {
+
+static Scenario g_scenario;
+
+static const char* const KIND_NAMES[FAULT_KIND_COUNT] = {
+  "brownout", "modem-ignore-at", "modem-mute", "caopen-silent", "pdp-reject",
+  "network-down", "sim-not-ready", "uart-noise", "rtc-lost", "probe-mute",
+};
+
+const char* faultKindName(FaultKind kind) { return kind < FAULT_KIND_COUNT ? KIND_NAMES[kind] : "?"; }
+
+const Scenario& scenario() { return g_scenario; }
+void setScenario(const Scenario& sc) { g_scenario = sc; }
+
+// ============================================================
+// LECTURA
+// ============================================================
+
+/** @brief "1d6h", "90s", "2.5m" -> µs; false si no es un tiempo */
+static bool parseDuration(const std::string& s, uint64_t& us) {
+  const char* p = s.c_str();
+  double total = 0.0;
+  bool any = false;
+  while (*p) {
+    char* end = nullptr;
+    double v = strtod(p, &end);
+    if (end == p || v < 0.0) return false;
+    double unit;
+    switch (*end) {
+      case 's': unit = 1.0; break;
+      case 'm': unit = 60.0; break;
+      case 'h': unit = 3600.0; break;
+      case 'd': unit = 86400.0; break;
+      default: return false;
+    }
+    total += v * unit;
+    p = end + 1;
+    any = true;
+  }
+  if (!any) return false;
+  us = (uint64_t)(total * 1e6 + 0.5);
+  return true;
+}
+
+/** @brief Número con unidad de tiempo opcional; las métricas de tiempo van en segundos */
+static bool parseValue(const std::string& s, double& v) {
+  uint64_t us;
+  if (parseDuration(s, us)) {
+    v = (double)us / 1e6;
+    return true;
+  }
+  char* end = nullptr;
+  v = strtod(s.c_str(), &end);
+  return end != s.c_str() && *end == '\0';
+}
+
+/** @brief Aplica una opción de jamr_sim ("days", "seed"...); false si no existe */
+static bool applyOption(const std::string& key, const std::string& val, Config& cfg, double& days) {
+  if (key == "days") days = atof(val.c_str());
+  else if (key == "seed") cfg.seed = strtoull(val.c_str(), nullptr, 10);
+  else if (key == "sleep-min") cfg.sleepUs = (uint64_t)(atof(val.c_str()) * 60e6);
+  else if (key == "drift-ppm") cfg.driftPpm = atof(val.c_str());
+  else if (key == "battery-mah") cfg.batteryMah = atof(val.c_str());
+  else if (key == "awake-cap-s") cfg.awakeCapUs = (uint64_t)(atof(val.c_str()) * 1e6);
+  else return false;
+  return true;
+}
+
+static bool parseFault(std::istringstream& in, Fault& f, std::string& why) {
+  std::string kind;
+  in >> kind;
+  int k = 0;
+  while (k < FAULT_KIND_COUNT && kind != KIND_NAMES[k]) k++;
+  if (k == FAULT_KIND_COUNT) {
+    why = "tipo de falla desconocido '" + kind + "'";
+    return false;
+  }
+  f.kind = (FaultKind)k;
+  if (f.kind == FAULT_BROWNOUT || f.kind == FAULT_RTC_LOST) f.count = 1;
+
+  std::string key, val;
+  while (in >> key) {
+    if (!(in >> val)) {
+      why = "falta el valor de '" + key + "'";
+      return false;
+    }
+    bool ok = true;
+    if (key == "at") ok = parseDuration(val, f.fromWall);
+    else if (key == "until") ok = parseDuration(val, f.untilWall);
+    else if (key == "count") f.count = (uint32_t)strtoul(val.c_str(), nullptr, 10);
+    else if (key == "skip") f.skip = (uint32_t)strtoul(val.c_str(), nullptr, 10);
+    else if (key == "file" && f.kind == FAULT_BROWNOUT) f.file = val;
+    else if (key == "open" && f.kind == FAULT_BROWNOUT) f.mode = val;
+    else if (key == "off" && f.kind == FAULT_BROWNOUT) ok = parseDuration(val, f.offUs);
+    else if (key == "n" && f.kind == FAULT_MODEM_IGNORE_AT) f.n = (uint32_t)strtoul(val.c_str(), nullptr, 10);
+    else if (key == "op" && f.kind == FAULT_NETWORK_DOWN) f.op = val;
+    else if (key == "rate" && f.kind == FAULT_UART_NOISE) f.rate = atof(val.c_str());
+    else {
+      why = "parámetro '" + key + "' no válido para " + kind;
+      return false;
+    }
+    if (!ok) {
+      why = "tiempo no válido '" + val + "'";
+      return false;
+    }
+  }
+  if (f.untilWall <= f.fromWall) {
+    why = "until debe ser posterior a at";
+    return false;
+  }
+  return true;
+}
+
+static bool parseExpect(std::istringstream& in, Expect& e, std::string& why) {
+  std::string val;
+  if (!(in >> e.metric >> e.op >> val)) {
+    why = "se espera: " + std::string(e.xfail ? "xfail" : "expect") + " <métrica> <op> <valor>";
+    return false;
+  }
+  static const char* const OPS[] = {"<", "<=", "==", "!=", ">=", ">"};
+  bool known = false;
+  for (const char* op : OPS) known = known || e.op == op;
+  if (!known) {
+    why = "operador no válido '" + e.op + "'";
+    return false;
+  }
+  if (!parseValue(val, e.value)) {
+    why = "valor no válido '" + val + "'";
+    return false;
+  }
+  return true;
+}
+
+bool loadScenario(const char* file, Scenario& sc, Config& cfg, double& days, std::string& err) {
+  std::ifstream f(file);
+  if (!f) {
+    err = std::string(file) + ": no se pudo abrir";
+    return false;
+  }
+  std::string base = file;
+  size_t slash = base.rfind('/');
+  if (slash != std::string::npos) base.erase(0, slash + 1);
+  size_t dot = base.rfind('.');
+  sc = Scenario();
+  sc.name = dot == std::string::npos ? base : base.substr(0, dot);
+
+  std::string raw;
+  int lineNo = 0;
+  while (std::getline(f, raw)) {
+    lineNo++;
+    std::string line = raw.substr(0, raw.find('#'));
+    std::istringstream in(line);
+    std::string word;
+    if (!(in >> word)) continue;
+
+    std::string why;
+    if (word == "fault") {
+      Fault ft;
+      ft.line = lineNo;
+      if (sc.faults.size() >= FAULT_MAX) why = "más de " + std::to_string(FAULT_MAX) + " fallas";
+      else if (parseFault(in, ft, why)) sc.faults.push_back(ft);
+    } else if (word == "expect" || word == "xfail") {
+      Expect e;
+      e.line = lineNo;
+      e.xfail = word == "xfail";
+      if (parseExpect(in, e, why)) {
+        size_t a = line.find_first_not_of(" \t", line.find(word) + word.size());
+        size_t b = line.find_last_not_of(" \t\r");
+        e.text = line.substr(a, b - a + 1);
+        sc.expects.push_back(e);
+      }
+    } else {
+      std::string val;
+      if (!(in >> val) || !applyOption(word, val, cfg, days)) why = "directiva desconocida '" + word + "'";
+    }
+    if (!why.empty()) {
+      err = std::string(file) + ":" + std::to_string(lineNo) + ": " + why;
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================
+// DISPARO (procesos hijo; contadores en memoria compartida)
+// ============================================================
+
+const Fault* faultDue(FaultKind kind, uint64_t w, bool (*match)(const Fault&, const void*), const void* ctx) {
+  for (size_t i = 0; i < g_scenario.faults.size(); i++) {
+    const Fault& f = g_scenario.faults[i];
+    if (f.kind != kind || w < f.fromWall || w >= f.untilWall) continue;
+    FaultRuntime& rt = shared()->faults[i];
+    if (f.count && rt.fired >= f.count) continue;
+    if (match && !match(f, ctx)) continue;
+    if (rt.skipped < f.skip) {
+      rt.skipped++;
+      continue;
+    }
+    return &f;
+  }
+  return nullptr;
+}
+
+void faultFire(const Fault* f, uint64_t w) {
+  size_t i = (size_t)(f - g_scenario.faults.data());
+  FaultRuntime& rt = shared()->faults[i];
+  if (rt.fired++ == 0) rt.firstWall = w;
+  rt.lastWall = w;
+}
+
+// ============================================================
+// ASERCIONES
+// ============================================================
+
+bool expectHolds(const Expect& e, const std::map<std::string, double>& metrics, double& actual) {
+  auto it = metrics.find(e.metric);
+  actual = it == metrics.end() ? NAN : it->second;
+  if (isnan(actual)) return false;
+  if (e.op == "<") return actual < e.value;
+  if (e.op == "<=") return actual <= e.value;
+  if (e.op == "==") return actual == e.value;
+  if (e.op == "!=") return actual != e.value;
+  if (e.op == ">=") return actual >= e.value;
+  return actual > e.value;
+}
+
+bool expectPasses(const Expect& e, bool holds, double actual) {
+  if (isnan(actual)) return false;
+  return e.xfail ? !holds : holds;
+}
+
+}  // namespace sim
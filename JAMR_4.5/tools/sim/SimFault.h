@@ -0,0 +1,170 @@
+/**
+ * @file SimFault.h
+ * @brief Escenarios de inyección de fallas del simulador host (DSL y ganchos)
+ * @version FEAT-V32
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * FORMATO (.scn, una directiva por línea, '#' comenta hasta el fin de línea):
+ *
+ *   days 2                      # Cualquier opción de jamr_sim sin "--"
+ *   seed 7
+ *
+ *   fault <tipo> [at T] [until T] [count N] [skip N] [parámetros...]
+ *
+ *   expect <métrica> <op> <valor>     # op: < <= == != >= >
+ *   xfail <métrica> <op> <valor>      # Comportamiento correcto, defecto conocido
+ *
+ * Tiempos: número con unidad s, m, h o d, concatenables ("1d6h", "90s").
+ * at/until son tiempo de pared desde el inicio de la corrida; sin until la
+ * ventana queda abierta hasta el final. count limita los disparos (0 = sin
+ * límite; brownout y rtc-lost disparan una vez por defecto). skip deja pasar
+ * las primeras N oportunidades dentro de la ventana.
+ *
+ * xfail afirma lo que el firmware debería cumplir y hoy no cumple (HALLAZGO).
+ * Mientras el defecto exista se reporta XFALLA y el escenario pasa; si la
+ * aserción se cumple se reporta XPASA y el escenario falla, para que quien
+ * corrija el firmware la convierta en expect.
+ *
+ * TIPOS:
+ *   brownout [file RUTA] [open M] [off T]
+ *                                  Corte de alimentación dentro de una escritura
+ *                                  de LittleFS (RUTA o cualquiera; abierta con
+ *                                  modo M: a, w, r+...): nada sin cerrar llega a
+ *                                  flash. El modem también se apaga; vuelve la
+ *                                  energía tras off (default 2s), ESP_RST_BROWNOUT
+ *   modem-ignore-at [n N]          Tras cada encendido el modem ignora los
+ *                                  primeros N "AT" (default 1; PSM, FIX-V7)
+ *   modem-mute                     El modem no contesta nada (zombie tipo B)
+ *   caopen-silent                  AT+CAOPEN no recibe respuesta alguna
+ *   pdp-reject                     AT+CNACT=0,1 responde ERROR (FIX-V1)
+ *   network-down [op MCCMNC]       AT+COPS= de esa operadora (o todas) da ERROR
+ *                                  a los 30 s (FIX-V2)
+ *   sim-not-ready                  AT+CPIN? responde NOT READY; sin registro
+ *   uart-noise [rate P]            Cada byte de UART1, en ambos sentidos, cambia
+ *                                  un bit con probabilidad P (default 0.001)
+ *   rtc-lost                       La pila del DS1307 se agota en at: vuelve a
+ *                                  2000-01-01 y se detiene hasta adjust()
+ *   probe-mute                     La sonda Modbus no responde (cable suelto,
+ *                                  calentamiento lento, EMI en RS485)
+ *
+ * MÉTRICAS (expect, xfail):
+ *   loss         Tramas escritas al buffer que ni llegaron al servidor ni siguen
+ *                pendientes en buffer.txt
+ *   corrupt      Envíos con forma de trama que no coinciden con ninguna escrita
+ *   duplicates   Tramas recibidas más de una vez
+ *   delivered    Tramas únicas recibidas
+ *   pending      Tramas sin enviar en buffer.txt al final
+ *   epoch.bad    Tramas escritas con epoch a más de 60 s de la hora real
+ *   probe.zero   Tramas escritas con var1..var4 (sonda Modbus) en cero
+ *   awake.max    Boot más largo (s); awake.avg: promedio activo por boot (s)
+ *   awake.fault  Boot más largo en el que disparó alguna falla (s)
+ *   recovery     Mayor latencia (s) entre el último disparo de una falla y la
+ *                primera trama recibida después; infinito si no hubo ninguna.
+ *                Incluye la espera a la próxima trama: el firmware solo
+ *                transmite cuando persiste una (FEAT-V10/V18)
+ *   hangs, crashes, restarts, brownouts, boots, mAh
+ *   fired        Disparos totales de las fallas del escenario
+ */
+
+#ifndef SIM_FAULT_H
+#define SIM_FAULT_H
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+
+namespace sim {
+
+enum FaultKind : uint8_t {
+  FAULT_BROWNOUT,
+  FAULT_MODEM_IGNORE_AT,
+  FAULT_MODEM_MUTE,
+  FAULT_CAOPEN_SILENT,
+  FAULT_PDP_REJECT,
+  FAULT_NETWORK_DOWN,
+  FAULT_SIM_NOT_READY,
+  FAULT_UART_NOISE,
+  FAULT_RTC_LOST,
+  FAULT_PROBE_MUTE,
+  FAULT_KIND_COUNT
+};
+
+static const uint64_t FAULT_OPEN = UINT64_MAX;  ///< Ventana sin until
+
+/** @brief Falla declarada en el escenario (inmutable durante la corrida) */
+struct Fault {
+  FaultKind kind;
+  uint64_t fromWall = 0;
+  uint64_t untilWall = FAULT_OPEN;
+  uint32_t count = 0;          ///< 0 = sin límite
+  uint32_t skip = 0;
+  std::string file;            ///< brownout
+  std::string mode;            ///< brownout: modo de apertura del archivo
+  std::string op;              ///< network-down
+  uint32_t n = 1;              ///< modem-ignore-at
+  double rate = 0.001;         ///< uart-noise
+  uint64_t offUs = 2000000;    ///< brownout
+  int line = 0;                ///< Línea del .scn
+};
+
+/** @brief Aserción sobre el reporte final */
+struct Expect {
+  std::string metric;
+  std::string op;
+  double value;
+  std::string text;            ///< Línea original, para el reporte
+  int line;
+  bool xfail = false;          ///< Defecto conocido: se espera que no se cumpla
+};
+
+struct Scenario {
+  std::string name;            ///< Archivo sin directorio ni extensión
+  std::vector<Fault> faults;
+  std::vector<Expect> expects;
+};
+
+/**
+ * @brief Lee un .scn. Las opciones (days, seed...) se aplican sobre cfg/days.
+ * @return false con err = "archivo:línea: motivo" si hay un error de sintaxis.
+ */
+bool loadScenario(const char* file, Scenario& sc, Config& cfg, double& days, std::string& err);
+
+/** @brief Escenario activo (el padre lo fija antes del primer fork) */
+const Scenario& scenario();
+void setScenario(const Scenario& sc);
+
+/**
+ * @brief Falla de ese tipo aplicable en el instante de pared w.
+ *
+ * Ventana abierta, cupo de count disponible y, si se da, predicado match.
+ * Cada llamada que encuentra la falla cuenta como una oportunidad para skip,
+ * así que solo se llama en el punto exacto donde la falla actuaría.
+ */
+const Fault* faultDue(FaultKind kind, uint64_t w, bool (*match)(const Fault&, const void*) = nullptr,
+                      const void* ctx = nullptr);
+
+/** @brief Registra un disparo (contadores en Shared::faults) */
+void faultFire(const Fault* f, uint64_t w);
+
+/** @brief Evalúa una aserción contra las métricas; NaN o métrica ausente = falla */
+bool expectHolds(const Expect& e, const std::map<std::string, double>& metrics, double& actual);
+
+/**
+ * @brief Resultado de la aserción para el escenario: expect debe cumplirse,
+ *        xfail no debe cumplirse. Una métrica desconocida siempre falla.
+ */
+bool expectPasses(const Expect& e, bool holds, double actual);
+
+/** @brief Nombre del tipo en el DSL */
+const char* faultKindName(FaultKind kind);
+
+}  // namespace sim
+
+#endif  // SIM_FAULT_H
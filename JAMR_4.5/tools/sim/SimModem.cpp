@@ -0,0 +1,485 @@
+/**
+ * @file SimModem.cpp
+ * @brief Modelo del SIM7080G: AT, PWRKEY, registro, PDP, TCP (CA*) y GNSS
+ * @version FEAT-V31
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * El modem es un proceso aparte del ESP32: su estado (encendido, registro,
+ * PDP, socket, GNSS) vive en Shared::modem y sobrevive a los boots. Los
+ * cambios de estado y de corriente que ocurren en el futuro se encolan por
+ * instante de pared y se aplican en orden antes de cada comando, pulso de
+ * PWRKEY y al final del boot. Las respuestas van directo al RX de UART1 con
+ * su instante de llegada.
+ *
+ * Red simulada: TELCEL (334020), AT&T (334050) y MOVISTAR (334030) registran
+ * con distinta señal; el resto de las operadoras responde ERROR a AT+COPS
+ * tras 30 s. El servidor TCP acepta todo y anota cada CASEND en server.log.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include "SimCore.h"
+#include "SimDevices.h"
+#include "SimFault.h"
+
+namespace sim {
+
+static const uint64_t MS = 1000ULL;
+static const uint64_t S = 1000000ULL;
+
+static const double MODEM_IDLE_MA = 12.0;
+static const double MODEM_REG_MA = 50.0;
+static const double MODEM_TX_MA = 120.0;
+static const double GNSS_MA = 30.0;
+
+static const uint64_t PWRKEY_ON_US = 1000 * MS;      ///< Pulso mínimo de encendido
+static const uint64_t PWRKEY_OFF_US = 1200 * MS;     ///< Pulso mínimo de apagado
+static const uint64_t PWRKEY_RESET_US = 12600 * MS;  ///< Pulso de reset forzado
+static const uint64_t BOOT_TO_AT_US = 1800 * MS;     ///< Liberar PWRKEY -> responde AT
+static const uint64_t GNSS_WARM_VALID_US = 2ULL * 3600ULL * S;  ///< Vigencia de efemérides
+
+/** @brief Operadora presente en la red simulada */
+struct Network {
+  const char* code;
+  const char* plmn;      ///< Formato de AT+CPSI ("334-020")
+  int rsrq, rsrp, rssi, sinr;
+  int csq;
+};
+
+static const Network NETWORKS[] = {
+  {"334020", "334-020", -9, -95, -65, 10, 20},
+  {"334050", "334-050", -11, -103, -71, 6, 15},
+  {"334030", "334-030", -12, -108, -75, 3, 12},
+};
+
+// Estado del boot actual
+static std::multimap<uint64_t, std::function<void()>> g_events;
+static std::string g_line;
+static bool g_dataMode = false;
+static size_t g_dataLeft = 0;
+static uint64_t g_dataFromWall = 0;   ///< Bytes anteriores al prompt '>' (el LF del comando) se ignoran
+static std::string g_data;
+static double g_burstMa = 0.0;
+static uint64_t g_burstUntil = 0;
+
+static ModemPersist& M() { return shared()->modem; }
+
+/** @brief Instante del boot correspondiente a un instante de pared */
+static uint64_t toBoot(uint64_t w) {
+  uint64_t base = wall() - now();
+  return w > base ? w - base : 0;
+}
+
+static void at(uint64_t w, std::function<void()> fn) { g_events.emplace(w, std::move(fn)); }
+
+static void sync(uint64_t w) {
+  while (!g_events.empty() && g_events.begin()->first <= w) {
+    auto fn = std::move(g_events.begin()->second);
+    g_events.erase(g_events.begin());
+    fn();
+  }
+}
+
+static void reply(uint64_t w, const std::string& text) { uartDeliver(1, text, toBoot(w)); }
+
+static void ok(uint64_t w) { reply(w, "\r\nOK\r\n"); }
+static void error(uint64_t w) { reply(w, "\r\nERROR\r\n"); }
+
+static const Network* network(const char* code) {
+  for (const Network& n : NETWORKS) {
+    if (strcmp(n.code, code) == 0) return &n;
+  }
+  return nullptr;
+}
+
+// ============================================================
+// ENERGÍA
+// ============================================================
+
+static void railUpdate(uint64_t w) {
+  double mA = 0.0;
+  if (M().powered) mA = (w < g_burstUntil && g_burstMa > MODEM_IDLE_MA) ? g_burstMa : MODEM_IDLE_MA;
+  railSetAt(RAIL_MODEM, mA, w);
+}
+
+/** @brief Consumo elevado entre w y w + dur (registro, TX) */
+static void burst(uint64_t w, uint64_t dur, double mA) {
+  at(w, [w, dur, mA]() {
+    g_burstMa = mA;
+    g_burstUntil = w + dur;
+    railUpdate(w);
+  });
+  at(w + dur, [w, dur]() { railUpdate(w + dur); });
+}
+
+// ============================================================
+// ENCENDIDO
+// ============================================================
+
+static void gnssStop(uint64_t w) {
+  ModemPersist& m = M();
+  if (!m.gnssOn) return;
+  m.gnssOn = false;
+  m.gnssOffWall = w;
+  railSetAt(RAIL_GNSS, 0.0, w);
+}
+
+static void powerDown(uint64_t w) {
+  ModemPersist& m = M();
+  gnssStop(w);
+  m.powered = false;
+  m.registered = m.attached = m.pdpActive = m.tcpOpen = false;
+  g_dataMode = false;
+  g_line.clear();
+  railUpdate(w);
+  uartPurgeAfter(1, toBoot(w));
+}
+
+static void powerUp(uint64_t w) {
+  ModemPersist& m = M();
+  m.powered = true;
+  m.readyAtWall = w + BOOT_TO_AT_US;
+  m.registered = m.attached = m.pdpActive = m.tcpOpen = false;
+  m.operatorCode[0] = '\0';
+  m.atIgnored = 0;
+  railUpdate(w);
+}
+
+void modemPwrkey(bool pressed) {
+  uint64_t w = wall();
+  sync(w);
+  ModemPersist& m = M();
+  if (!pressed) {
+    // Zombie tipo B: ni el reset de 12.6 s lo saca (FEAT-V32)
+    const Fault* mute = faultDue(FAULT_MODEM_MUTE, w);
+    if (mute) {
+      faultFire(mute, w);
+      m.pwrkeyDown = false;
+      return;
+    }
+  }
+  if (pressed) {
+    if (!m.pwrkeyDown) {
+      m.pwrkeyDown = true;
+      m.pwrkeyDownWall = w;
+    }
+    return;
+  }
+  if (!m.pwrkeyDown) return;
+  m.pwrkeyDown = false;
+  uint64_t held = w - m.pwrkeyDownWall;
+  if (!m.powered) {
+    if (held >= PWRKEY_ON_US) powerUp(w);
+  } else if (held >= PWRKEY_RESET_US) {
+    powerDown(w);
+    powerUp(w);
+  } else if (held >= PWRKEY_OFF_US) {
+    reply(w + 1500 * MS, "\r\nNORMAL POWER DOWN\r\n");
+    at(w + 1500 * MS, [w]() { powerDown(w + 1500 * MS); });
+  }
+}
+
+// ============================================================
+// COMANDOS AT
+// ============================================================
+
+static void logUnknown(const std::string& cmd) {
+  FILE* f = fopen(path("modem_unknown.log").c_str(), "a");
+  if (f) {
+    fprintf(f, "%llu %s\n", (unsigned long long)wall(), cmd.c_str());
+    fclose(f);
+  }
+}
+
+static std::string cgnsinf(uint64_t w) {
+  ModemPersist& m = M();
+  if (!m.gnssOn) return "+CGNSINF: 0,,,,,,,,,,,,,,,,,,,,";
+  if (w - m.gnssOnWall < m.gnssTtffUs) return "+CGNSINF: 1,0,,,,,,,,,,,,,,,,,,,";
+  m.gnssHadFix = true;
+  shared()->gnssFixes++;
+
+  time_t t = (time_t)(config().startEpoch + w / S);
+  struct tm u;
+  gmtime_r(&t, &u);
+  Rng rng = rngFor(RNG_GNSS, w);
+  char buf[160];
+  snprintf(buf, sizeof(buf),
+           "+CGNSINF: 1,1,%04d%02d%02d%02d%02d%02d.000,%.6f,%.6f,%.1f,0.00,0.0,1,,1.1,1.4,0.9,,9,7,,,38,,",
+           u.tm_year + 1900, u.tm_mon + 1, u.tm_mday, u.tm_hour, u.tm_min, u.tm_sec,
+           20.670000 + rng.normal() * 0.00002, -103.350000 + rng.normal() * 0.00002,
+           1560.0 + rng.normal() * 3.0);
+  return buf;
+}
+
+static std::string cpsi() {
+  ModemPersist& m = M();
+  const Network* n = m.registered ? network(m.operatorCode) : nullptr;
+  if (n == nullptr) return "+CPSI: NO SERVICE,Online";
+  Rng rng = rngFor(RNG_MODEM, wall() ^ 0xC951);
+  char buf[160];
+  snprintf(buf, sizeof(buf), "+CPSI: LTE CAT-M1,Online,%s,0x2A1F,27446%03u,318,EUTRAN-BAND2,900,5,5,%d,%d,%d,%d",
+           n->plmn, (unsigned)(rng.next() % 1000), n->rsrq + (int)(rng.normal() * 1.0),
+           n->rsrp + (int)(rng.normal() * 2.0), n->rssi + (int)(rng.normal() * 2.0),
+           n->sinr + (int)(rng.normal() * 1.5));
+  return buf;
+}
+
+static bool startsWith(const std::string& s, const char* p) { return s.compare(0, strlen(p), p) == 0; }
+
+// ============================================================
+// FALLAS DEL ESCENARIO (FEAT-V32)
+// ============================================================
+
+static bool ignoreAtLeft(const Fault& f, const void* ctx) {
+  return static_cast<const ModemPersist*>(ctx)->atIgnored < f.n;
+}
+
+static bool networkMatches(const Fault& f, const void* ctx) {
+  return f.op.empty() || f.op == static_cast<const char*>(ctx);
+}
+
+/** @brief Falla que afecta a este comando; la registra como disparada */
+static bool faultHits(FaultKind kind, uint64_t w, bool (*match)(const Fault&, const void*) = nullptr,
+                      const void* ctx = nullptr) {
+  const Fault* f = faultDue(kind, w, match, ctx);
+  if (f) faultFire(f, w);
+  return f != nullptr;
+}
+
+static void command(const std::string& raw, uint64_t w) {
+  ModemPersist& m = M();
+  Shared* sh = shared();
+  std::string cmd = raw;
+  for (char& c : cmd) {
+    if (c >= 'a' && c <= 'z') c = (char)(c - 'a' + 'A');
+  }
+  if (!startsWith(cmd, "AT")) return;  // Ruido de línea
+  sh->atCommands++;
+  Rng rng = rngFor(RNG_MODEM, w);
+
+  if (cmd == "AT" && faultHits(FAULT_MODEM_IGNORE_AT, w, ignoreAtLeft, &m)) {
+    m.atIgnored++;  // Recién despertado: el primer AT se pierde (PSM, FIX-V7)
+    return;
+  }
+  bool needsSim = cmd == "AT+CPIN?" || startsWith(cmd, "AT+COPS=") || cmd == "AT+CGATT=1" || cmd == "AT+CCID";
+  bool simMissing = needsSim && faultHits(FAULT_SIM_NOT_READY, w);
+
+  if (cmd == "AT" || startsWith(cmd, "ATE")) {
+    ok(w + 2 * MS);
+  } else if (cmd == "AT+CPSMS?") {
+    reply(w + 5 * MS, "\r\n+CPSMS: 0,,,\"01011111\",\"00000001\"\r\n\r\nOK\r\n");
+  } else if (cmd == "AT+CPIN?") {
+    reply(w + 5 * MS, simMissing ? "\r\n+CPIN: NOT READY\r\n\r\nOK\r\n" : "\r\n+CPIN: READY\r\n\r\nOK\r\n");
+  } else if (simMissing && (startsWith(cmd, "AT+COPS=") || cmd == "AT+CGATT=1" || cmd == "AT+CCID")) {
+    reply(w + 1 * S, "\r\n+CME ERROR: SIM not inserted\r\n");
+  } else if (cmd == "AT+CFUN=1,1") {
+    ok(w + 100 * MS);
+    at(w + 100 * MS, [w]() {
+      ModemPersist& mm = M();
+      gnssStop(w + 100 * MS);
+      mm.registered = mm.attached = mm.pdpActive = mm.tcpOpen = false;
+      mm.readyAtWall = w + 2600 * MS;
+    });
+  } else if (startsWith(cmd, "AT+COPS=")) {
+    char code[8] = {0};
+    const char* q = strchr(raw.c_str(), '"');
+    if (q) sscanf(q + 1, "%7[0-9]", code);
+    const Network* n = network(code);
+    if (n && faultHits(FAULT_NETWORK_DOWN, w, networkMatches, code)) n = nullptr;
+    uint64_t dur = n ? (uint64_t)(rng.range(3.0, 8.0) * S) : 30 * S;
+    burst(w, dur, MODEM_REG_MA);
+    snprintf(m.operatorCode, sizeof(m.operatorCode), "%s", code);
+    m.registered = m.attached = m.pdpActive = m.tcpOpen = false;
+    if (n) {
+      at(w + dur, []() { M().registered = true; });
+      ok(w + dur);
+    } else {
+      error(w + dur);
+    }
+  } else if (cmd == "AT+COPS?") {
+    char buf[64];
+    if (m.registered) snprintf(buf, sizeof(buf), "\r\n+COPS: 1,2,\"%s\",9\r\n\r\nOK\r\n", m.operatorCode);
+    else snprintf(buf, sizeof(buf), "\r\n+COPS: 1\r\n\r\nOK\r\n");
+    reply(w + 10 * MS, buf);
+  } else if (cmd == "AT+CPSI?") {
+    reply(w + 20 * MS, "\r\n" + cpsi() + "\r\n\r\nOK\r\n");
+  } else if (cmd == "AT+CSQ") {
+    const Network* n = m.registered ? network(m.operatorCode) : nullptr;
+    reply(w + 10 * MS, "\r\n+CSQ: " + std::to_string(n ? n->csq : 99) + ",99\r\n\r\nOK\r\n");
+  } else if (cmd == "AT+CGATT=1") {
+    if (!m.registered) {
+      error(w + 10 * S);
+    } else {
+      uint64_t dur = (uint64_t)(rng.range(1.0, 3.0) * S);
+      burst(w, dur, MODEM_REG_MA);
+      at(w + dur, []() { M().attached = true; });
+      ok(w + dur);
+    }
+  } else if (cmd == "AT+CGATT=0") {
+    m.attached = m.pdpActive = m.tcpOpen = false;
+    ok(w + 300 * MS);
+  } else if (cmd == "AT+CGATT?") {
+    reply(w + 5 * MS, std::string("\r\n+CGATT: ") + (m.attached ? "1" : "0") + "\r\n\r\nOK\r\n");
+  } else if (cmd == "AT+CNACT=0,1") {
+    if (!m.registered || faultHits(FAULT_PDP_REJECT, w)) {
+      error(w + 50 * MS);
+    } else {
+      m.pdpActive = true;
+      reply(w + 200 * MS, "\r\nOK\r\n\r\n+APP PDP: 0,ACTIVE\r\n");
+    }
+  } else if (cmd == "AT+CNACT=0,0") {
+    m.pdpActive = m.tcpOpen = false;
+    reply(w + 100 * MS, "\r\nOK\r\n\r\n+APP PDP: 0,DEACTIVE\r\n");
+  } else if (cmd == "AT+CNACT?") {
+    reply(w + 5 * MS, std::string("\r\n+CNACT: 0,") + (m.pdpActive ? "1,\"10.64.12.7\"" : "0,\"0.0.0.0\"") +
+                          "\r\n\r\nOK\r\n");
+  } else if (startsWith(cmd, "AT+CAOPEN=")) {
+    if (faultHits(FAULT_CAOPEN_SILENT, w)) {
+      // Sin respuesta: ni OK, ni +CAOPEN, ni ERROR
+    } else if (m.pdpActive && !m.tcpOpen) {
+      uint64_t dur = (uint64_t)(rng.range(0.8, 2.0) * S);
+      m.tcpOpen = true;
+      reply(w + dur, "\r\n+CAOPEN: 0,0\r\n\r\nOK\r\n");
+    } else {
+      // Sin PDP el SIM7080G rechaza el socket (27 = red no disponible)
+      reply(w + 200 * MS, m.tcpOpen ? "\r\n+CAOPEN: 0,4\r\n\r\nOK\r\n" : "\r\n+CAOPEN: 0,27\r\n\r\nOK\r\n");
+    }
+  } else if (startsWith(cmd, "AT+CACLOSE=")) {
+    if (m.tcpOpen) {
+      m.tcpOpen = false;
+      ok(w + 150 * MS);
+    } else {
+      error(w + 20 * MS);
+    }
+  } else if (cmd == "AT+CASTATE?") {
+    reply(w + 10 * MS, m.tcpOpen ? "\r\n+CASTATE: 0,1\r\n\r\nOK\r\n" : "\r\nOK\r\n");
+  } else if (startsWith(cmd, "AT+CASEND=")) {
+    int cid = -1, len = 0;
+    if (!m.tcpOpen || sscanf(cmd.c_str(), "AT+CASEND=%d,%d", &cid, &len) != 2 || len <= 0 || len > 1460) {
+      error(w + 20 * MS);
+    } else {
+      g_dataMode = true;
+      g_dataLeft = (size_t)len;
+      g_dataFromWall = w + 20 * MS;
+      g_data.clear();
+      reply(w + 20 * MS, "\r\n> ");
+    }
+  } else if (cmd == "AT+CPOWD=1") {
+    reply(w + 1500 * MS, "\r\nNORMAL POWER DOWN\r\n");
+    at(w + 1500 * MS, [w]() { powerDown(w + 1500 * MS); });
+  } else if (cmd == "AT+CCID") {
+    reply(w + 20 * MS, "\r\n" + modemIccid() + "\r\n\r\nOK\r\n");
+  } else if (cmd == "AT+CGNSPWR=1") {
+    if (!m.gnssOn) {
+      bool warm = m.gnssHadFix && w - m.gnssOffWall < GNSS_WARM_VALID_US;
+      double ttff = warm ? 8.0 + 3.0 * rng.normal() : 35.0 + 10.0 * rng.normal();
+      if (ttff < 2.0) ttff = 2.0;
+      m.gnssOn = true;
+      m.gnssOnWall = w;
+      m.gnssTtffUs = (uint64_t)(ttff * S);
+      railSetAt(RAIL_GNSS, GNSS_MA, w);
+    }
+    ok(w + 30 * MS);
+  } else if (cmd == "AT+CGNSPWR=0") {
+    gnssStop(w);
+    ok(w + 30 * MS);
+  } else if (cmd == "AT+CGNSINF") {
+    reply(w + 15 * MS, "\r\n" + cgnsinf(w) + "\r\n\r\nOK\r\n");
+  } else {
+    // Configuración sin efecto en el modelo (CNMP, CMNB, CBANDCFG, CGDCONT...)
+    if (!startsWith(cmd, "AT+CNMP") && !startsWith(cmd, "AT+CMNB") && !startsWith(cmd, "AT+CBANDCFG") &&
+        !startsWith(cmd, "AT+CGDCONT") && !startsWith(cmd, "AT+CPSMS=") && !startsWith(cmd, "AT+CFUN")) {
+      sh->atUnknown++;
+      logUnknown(raw);
+    }
+    ok(w + 20 * MS);
+  }
+}
+
+/** @brief Fin del bloque de datos de AT+CASEND: el servidor lo recibe */
+static void dataComplete(uint64_t w) {
+  Shared* sh = shared();
+  Rng rng = rngFor(RNG_MODEM, w ^ 0xDA7A);
+  uint64_t dur = (uint64_t)(rng.range(0.3, 0.8) * S);
+  burst(w, dur, MODEM_TX_MA);
+  sh->tcpSends++;
+  sh->tcpBytes += g_data.size();
+
+  std::string payload = g_data;
+  while (!payload.empty() && (payload.back() == '\r' || payload.back() == '\n')) payload.pop_back();
+  FILE* f = fopen(path("server.log").c_str(), "a");
+  if (f) {
+    fprintf(f, "%llu %s\n", (unsigned long long)(w + dur), payload.c_str());
+    fclose(f);
+  }
+  ok(w + dur);
+}
+
+void modemRxByte(uint8_t c, uint64_t atUs) {
+  uint64_t w = wallAt(atUs);
+  sync(w);
+  ModemPersist& m = M();
+  if (!m.powered || w < m.readyAtWall) return;
+  const Fault* mute = faultDue(FAULT_MODEM_MUTE, w);
+  if (mute) {
+    if (c == '\r') faultFire(mute, w);  // Un disparo por comando perdido
+    g_line.clear();
+    return;
+  }
+
+  if (g_dataMode) {
+    if (w < g_dataFromWall) return;
+    g_data += (char)c;
+    if (--g_dataLeft == 0) {
+      g_dataMode = false;
+      dataComplete(w);
+    }
+    return;
+  }
+
+  reply(w, std::string(1, (char)c));  // ATE1 (default del SIM7080G)
+  if (c == '\r') {
+    std::string line;
+    line.swap(g_line);
+    if (!line.empty()) command(line, w);
+  } else if (c != '\n') {
+    if (g_line.size() < 2048) g_line += (char)c;
+  }
+}
+
+void modemBoot() {
+  g_events.clear();
+  g_line.clear();
+  g_dataMode = false;
+  g_burstMa = 0.0;
+  g_burstUntil = 0;
+}
+
+void modemFlush() { sync(UINT64_MAX); }
+
+void modemPowerLoss() {
+  g_events.clear();  // Lo que iba a pasar con el modem encendido ya no pasa
+  M().pwrkeyDown = false;
+  powerDown(wall());
+}
+
+std::string modemIccid() {
+  uint64_t h = mix64(config().seed ^ 0x1CC1D);
+  std::string id = "8952";
+  for (int i = 0; i < 16; i++) {
+    id += (char)('0' + h % 10);
+    h = (i == 7) ? mix64(h) : h / 10;
+  }
+  return id;
+}
+
+}  // namespace sim
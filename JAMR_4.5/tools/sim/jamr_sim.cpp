@@ -0,0 +1,497 @@
+/**
+ * @file jamr_sim.cpp
+ * @brief Simulador host del firmware completo: semanas de ciclos en segundos
+ * @version FEAT-V31
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * Compila AppController.cpp y todo src/ sin cambios contra los encabezados de
+ * tools/sim/shim/ (Arduino, FreeRTOS, ESP-IDF, LittleFS, Preferences, RTClib,
+ * AHT20, ModbusMaster, BLE) y corre boot tras boot con tiempo virtual: un
+ * deep sleep de 10 min no cuesta tiempo real. Cada boot es un proceso hijo
+ * (fork) para que las variables globales arranquen limpias como en el ESP32.
+ *
+ * COMPILAR (desde JAMR_4.5/):
+ *   g++ -std=gnu++17 -O2 -pthread -Itools/sim/shim -iquote tools/sim/shim \
+ *       -o jamr_sim $(find tools/sim -maxdepth 1 -name '*.cpp') AppController.cpp \
+ *       $(find src -name '*.cpp')
+ *
+ * USO:
+ *   jamr_sim [opciones]
+ *
+ *   --days N          Días simulados (default 30)
+ *   --seed N          Semilla de red, sensores y GNSS (default 1)
+ *   --dir RUTA        Directorio de la corrida (default sim_out; se vacía)
+ *   --sleep-min N     AppConfig::sleep_time_us en minutos (default 10)
+ *   --drift-ppm X     Error del timer de deep sleep (default 0)
+ *   --battery-mah X   Capacidad para la curva de tensión (default 3000)
+ *   --awake-cap-s N   Boot despierto más de N s = cuelgue, reset por WDT (default 1800)
+ *   --log             Consola (UART0) en <dir>/console.log
+ *   --json            Reporte en JSON en lugar de texto
+ *   --scenario ARCH   Fallas y aserciones (.scn, ver SimFault.h); las opciones
+ *                     que siguen en la línea de comandos pisan las del archivo.
+ *                     Código de salida 1 si falla alguna aserción (FEAT-V32)
+ *
+ * SALIDA (<dir>/):
+ *   fs/, nvs/          LittleFS y NVS del equipo al final de la corrida
+ *   server.log         Cada AT+CASEND recibido: "<µs de pared> <payload>"
+ *   frames.log         Cada trama agregada a buffer.txt, persista o no
+ *   console.log        Con --log
+ *   modem_unknown.log  Comandos AT que el modelo no reconoce
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimFault.h"
+
+using namespace sim;
+
+static const uint64_t S = 1000000ULL;
+static const uint64_t RTC_SLOW_MEM_BYTES = 8192;
+
+/** @brief Resumen de lo que recibió el servidor */
+struct Delivery {
+  uint32_t dataFrames = 0;        ///< CASEND con trama de datos (Base64 'J')
+  uint32_t uniqueFrames = 0;
+  uint32_t duplicates = 0;
+  uint32_t telemetryFrames = 0;   ///< FEAT-V30 (Base64 'V')
+  uint32_t otherSends = 0;
+  std::vector<double> latencyS;   ///< Recepción - epoch de la trama
+  std::vector<std::pair<uint64_t, std::string>> sends;  ///< (pared, payload) salvo telemetría
+};
+
+/** @brief Tramas escritas contra recibidas (FEAT-V32) */
+struct Integrity {
+  uint32_t written = 0;           ///< Únicas en frames.log
+  uint32_t lost = 0;              ///< Ni recibidas ni pendientes
+  uint32_t corrupt = 0;           ///< Recibidas que no coinciden con ninguna escrita
+  uint32_t badEpoch = 0;          ///< Epoch a más de 60 s de la hora real al escribirla
+  uint32_t probeZero = 0;         ///< var1..var4 (sonda Modbus) en cero
+  std::vector<uint64_t> goodRx;   ///< Recepciones de tramas escritas, en orden
+};
+
+// ============================================================
+// DECODIFICACIÓN DEL LOG DEL SERVIDOR
+// ============================================================
+
+static int b64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return -1;
+}
+
+static std::string decodeBase64(const std::string& in) {
+  std::string out;
+  uint32_t acc = 0;
+  int bits = 0;
+  for (char c : in) {
+    int v = b64Value(c);
+    if (v < 0) break;
+    acc = (acc << 6) | (uint32_t)v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out += (char)(uint8_t)(acc >> bits);
+    }
+  }
+  return out;
+}
+
+static Delivery readServerLog() {
+  Delivery d;
+  std::set<std::string> seen;
+  std::ifstream f(path("server.log"));
+  std::string line;
+  while (std::getline(f, line)) {
+    size_t sp = line.find(' ');
+    if (sp == std::string::npos) continue;
+    uint64_t atWall = strtoull(line.c_str(), nullptr, 10);
+    std::string payload = line.substr(sp + 1);
+    if (payload.empty()) continue;
+    if (payload[0] == 'V') {
+      d.telemetryFrames++;
+      continue;
+    }
+    d.sends.emplace_back(atWall, payload);
+    std::string plain = payload[0] == 'J' ? decodeBase64(payload) : payload;
+    if (plain.compare(0, 2, "$,") != 0) {
+      d.otherSends++;
+      continue;
+    }
+    d.dataFrames++;
+    if (!seen.insert(plain).second) {
+      d.duplicates++;
+      continue;
+    }
+    d.uniqueFrames++;
+    // "$,ICCID,EPOCH,..."
+    size_t c1 = plain.find(',', 2);
+    if (c1 != std::string::npos) {
+      uint64_t epoch = strtoull(plain.c_str() + c1 + 1, nullptr, 10);
+      double rx = (double)config().startEpoch + (double)atWall / 1e6;
+      if (epoch > 0) d.latencyS.push_back(rx - (double)epoch);
+    }
+  }
+  return d;
+}
+
+/** @brief Líneas del buffer de LittleFS que aún no se enviaron */
+static std::vector<std::string> pendingLines() {
+  std::ifstream f(path("fs/buffer.txt"));
+  std::string line;
+  std::vector<std::string> out;
+  while (std::getline(f, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!line.empty() && line.compare(0, 3, "[P]") != 0) out.push_back(line);
+  }
+  return out;
+}
+
+/** @brief Epoch de una trama "$,ICCID,EPOCH,..." (en claro o Base64); 0 si no lo tiene */
+static uint64_t frameEpoch(const std::string& payload) {
+  std::string plain = payload[0] == 'J' ? decodeBase64(payload) : payload;
+  if (plain.compare(0, 2, "$,") != 0) return 0;
+  size_t c1 = plain.find(',', 2);
+  return c1 == std::string::npos ? 0 : strtoull(plain.c_str() + c1 + 1, nullptr, 10);
+}
+
+/** @brief true si var1..var4 de la trama (campos 6..9 tras "$") son todos cero */
+static bool probeVarsZero(const std::string& payload) {
+  std::string plain = payload[0] == 'J' ? decodeBase64(payload) : payload;
+  if (plain.compare(0, 2, "$,") != 0) return false;
+  size_t p = 0;
+  for (int field = 0; field < 6; field++) {
+    p = plain.find(',', p);
+    if (p == std::string::npos) return false;
+    p++;
+  }
+  for (int v = 0; v < 4; v++) {
+    size_t e = plain.find(',', p);
+    if (e == std::string::npos || strtol(plain.substr(p, e - p).c_str(), nullptr, 10) != 0) return false;
+    p = e + 1;
+  }
+  return true;
+}
+
+static Integrity checkIntegrity(const Delivery& d, const std::vector<std::string>& pending) {
+  Integrity in;
+  std::set<std::string> written;
+  std::ifstream f(path("frames.log"));
+  std::string line;
+  while (std::getline(f, line)) {
+    size_t sp = line.find(' ');
+    if (sp == std::string::npos || !written.insert(line.substr(sp + 1)).second) continue;
+    uint64_t epoch = frameEpoch(line.substr(sp + 1));
+    double real = (double)config().startEpoch + (double)strtoull(line.c_str(), nullptr, 10) / 1e6;
+    if (epoch == 0 || fabs((double)epoch - real) > 60.0) in.badEpoch++;
+    if (probeVarsZero(line.substr(sp + 1))) in.probeZero++;
+  }
+  in.written = (uint32_t)written.size();
+
+  std::set<std::string> received;
+  for (const auto& s : d.sends) {
+    if (written.count(s.second)) {
+      in.goodRx.push_back(s.first);
+      received.insert(s.second);
+    } else if (received.insert(s.second).second) {
+      in.corrupt++;
+    }
+  }
+  std::set<std::string> waiting(pending.begin(), pending.end());
+  for (const std::string& w : written) {
+    if (!received.count(w) && !waiting.count(w)) in.lost++;
+  }
+  std::sort(in.goodRx.begin(), in.goodRx.end());
+  return in;
+}
+
+/** @brief Número para el reporte: entero si lo es, "null" si es infinito o NaN */
+static std::string jsonNumber(double v) {
+  if (std::isnan(v) || std::isinf(v)) return "null";
+  char buf[32];
+  snprintf(buf, sizeof(buf), v == floor(v) && fabs(v) < 1e15 ? "%.0f" : "%.3f", v);
+  return buf;
+}
+
+static double percentile(std::vector<double> v, double p) {
+  if (v.empty()) return 0.0;
+  std::sort(v.begin(), v.end());
+  size_t idx = (size_t)(p * (double)(v.size() - 1) + 0.5);
+  return v[idx];
+}
+
+// ============================================================
+// CORRIDA
+// ============================================================
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "uso: %s [--days N] [--seed N] [--dir RUTA] [--sleep-min N] [--drift-ppm X]\n"
+          "          [--battery-mah X] [--awake-cap-s N] [--log] [--json] [--scenario ARCH]\n",
+          argv0);
+  exit(2);
+}
+
+static void prepareDir(const std::string& dir) {
+  std::string cmd = "rm -rf '" + dir + "' && mkdir -p '" + dir + "/fs' '" + dir + "/nvs'";
+  if (system(cmd.c_str()) != 0) {
+    fprintf(stderr, "no se pudo preparar %s\n", dir.c_str());
+    exit(1);
+  }
+}
+
+static const char* exitName(BootExit e) {
+  switch (e) {
+    case EXIT_DEEP_SLEEP: return "deep sleep";
+    case EXIT_RESTART: return "esp_restart";
+    case EXIT_HANG: return "cuelgue";
+    case EXIT_CRASH: return "crash";
+    case EXIT_BROWNOUT: return "brownout";
+    default: return "?";
+  }
+}
+
+int main(int argc, char** argv) {
+  Config cfg;
+  double days = 30.0;
+  bool json = false;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* {
+      if (i + 1 >= argc) usage(argv[0]);
+      return argv[++i];
+    };
+    if (a == "--days") days = atof(next());
+    else if (a == "--seed") cfg.seed = strtoull(next(), nullptr, 10);
+    else if (a == "--dir") cfg.dir = next();
+    else if (a == "--sleep-min") cfg.sleepUs = (uint64_t)(atof(next()) * 60.0 * S);
+    else if (a == "--drift-ppm") cfg.driftPpm = atof(next());
+    else if (a == "--battery-mah") cfg.batteryMah = atof(next());
+    else if (a == "--awake-cap-s") cfg.awakeCapUs = (uint64_t)(atof(next()) * S);
+    else if (a == "--log") cfg.console = true;
+    else if (a == "--json") json = true;
+    else if (a == "--scenario") {
+      Scenario sc;
+      std::string err;
+      if (!loadScenario(next(), sc, cfg, days, err)) {
+        fprintf(stderr, "%s\n", err.c_str());
+        return 2;
+      }
+      setScenario(sc);
+    } else usage(argv[0]);
+  }
+  if (days <= 0.0 || cfg.sleepUs == 0) usage(argv[0]);
+
+  prepareDir(cfg.dir);
+  setConfig(cfg);
+  initShared();
+  Shared* s = shared();
+  uint64_t endWall = (uint64_t)(days * 86400.0 * S);
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  while (s->nextBootWallUs < endWall) {
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      return 1;
+    }
+    if (pid == 0) runBoot();
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (s->lastExit == EXIT_NONE) {
+      // El hijo murió sin pasar por endBoot(): excepción, abort, SIGSEGV
+      s->crashes++;
+      s->lastExit = EXIT_CRASH;
+      s->nextReset = ESP_RST_PANIC;
+      s->nextWakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+      s->nextBootWallUs += 1 * S;
+      fprintf(stderr, "[SIM] boot %u terminó sin endBoot (status 0x%x)\n", s->bootIndex, status);
+    }
+    if (s->lastExit == EXIT_HANG) {
+      fprintf(stderr, "[SIM] boot %u: %s\n", s->bootIndex, s->lastHang);
+    }
+    s->bootIndex++;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double hostS = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+  // ============================================================
+  // REPORTE
+  // ============================================================
+
+  double simS = (double)endWall / 1e6;
+  double mah = consumedMah(endWall);
+  double railMah[RAIL_COUNT];
+  for (int r = 0; r < RAIL_COUNT; r++) {
+    double maUs = s->railMaUs[r];
+    if (endWall > s->railSinceWall[r]) maUs += s->railMa[r] * (double)(endWall - s->railSinceWall[r]);
+    railMah[r] = maUs / 3.6e9;
+  }
+  static const char* const RAIL_NAMES[RAIL_COUNT] = {"cpu", "modem", "gnss", "rs485"};
+  Delivery d = readServerLog();
+  std::vector<std::string> pendingList = pendingLines();
+  uint32_t pending = (uint32_t)pendingList.size();
+  Integrity integ = checkIntegrity(d, pendingList);
+  uint32_t expected = (uint32_t)(endWall / (cfg.sleepUs + 1));
+  // Activo = despierto sin el light sleep (FEAT-V18 sub-muestrea dentro del boot)
+  double awakeAvgS = s->boots ? (double)(s->awakeUs - s->lightSleepUs) / 1e6 / s->boots : 0.0;
+
+  // FEAT-V32: recuperación por falla = primera trama recibida tras su último disparo
+  const Scenario& sc = scenario();
+  std::vector<double> recoveryS(sc.faults.size(), NAN);
+  double worstRecoveryS = 0.0;
+  uint32_t fired = 0;
+  for (size_t i = 0; i < sc.faults.size(); i++) {
+    fired += s->faults[i].fired;
+    if (s->faults[i].fired == 0) continue;
+    uint64_t clear = s->faults[i].lastWall;
+    auto it = std::lower_bound(integ.goodRx.begin(), integ.goodRx.end(), clear);
+    recoveryS[i] = it == integ.goodRx.end() ? INFINITY : (double)(*it - clear) / 1e6;
+    worstRecoveryS = std::max(worstRecoveryS, recoveryS[i]);
+  }
+  std::map<std::string, double> metrics = {
+    {"loss", integ.lost}, {"corrupt", integ.corrupt}, {"duplicates", d.duplicates},
+    {"delivered", d.uniqueFrames}, {"pending", pending}, {"epoch.bad", integ.badEpoch},
+    {"probe.zero", integ.probeZero},
+    {"awake.max", (double)s->maxAwakeUs / 1e6}, {"awake.avg", awakeAvgS},
+    {"awake.fault", (double)s->maxFaultAwakeUs / 1e6}, {"recovery", worstRecoveryS},
+    {"hangs", s->hangs}, {"crashes", s->crashes}, {"restarts", s->restarts}, {"brownouts", s->brownouts},
+    {"boots", s->boots}, {"mAh", mah}, {"fired", fired},
+  };
+  std::vector<double> actual(sc.expects.size());
+  std::vector<bool> holds(sc.expects.size());
+  std::vector<bool> passed(sc.expects.size());
+  bool allPassed = true;
+  for (size_t i = 0; i < sc.expects.size(); i++) {
+    double v;
+    holds[i] = expectHolds(sc.expects[i], metrics, v);
+    passed[i] = expectPasses(sc.expects[i], holds[i], v);
+    actual[i] = v;
+    allPassed = allPassed && passed[i];
+  }
+  int exitCode = allPassed ? 0 : 1;
+
+  if (json) {
+    printf("{\"days\":%.2f,\"seed\":%llu,\"boots\":%u,\"deepSleeps\":%u,\"restarts\":%u,\"hangs\":%u,"
+           "\"crashes\":%u,\"brownouts\":%u,",
+           days, (unsigned long long)cfg.seed, s->boots, s->deepSleeps, s->restarts, s->hangs, s->crashes,
+           s->brownouts);
+    printf("\"energy\":{\"mAh\":%.3f,\"avgUa\":%.1f", mah, mah / (simS / 3600.0) * 1000.0);
+    for (int r = 0; r < RAIL_COUNT; r++) printf(",\"%s\":%.3f", RAIL_NAMES[r], railMah[r]);
+    printf("},\"awake\":{\"avgS\":%.3f,\"maxS\":%.3f,\"lightSleepS\":%.3f},", awakeAvgS,
+           (double)s->maxAwakeUs / 1e6, (double)s->lightSleepUs / 1e6);
+    printf("\"rtcBytes\":%u,\"flash\":{\"programmedBytes\":%llu,\"nvsPuts\":%u,\"nvsChanged\":%u,\"files\":[",
+           s->rtcData.len + s->rtcNoinit.len, (unsigned long long)s->fsBytes, s->nvsPuts, s->nvsChanged);
+    for (uint32_t i = 0; i < s->fileCount; i++) {
+      printf("%s{\"path\":\"%s\",\"bytes\":%llu,\"writeOpens\":%u,\"truncates\":%u}", i ? "," : "",
+             s->files[i].path, (unsigned long long)s->files[i].bytes, s->files[i].writeOpens, s->files[i].truncates);
+    }
+    printf("]},\"modem\":{\"atCommands\":%llu,\"atUnknown\":%llu,\"tcpSends\":%llu,\"tcpBytes\":%llu,"
+           "\"gnssFixes\":%u},",
+           (unsigned long long)s->atCommands, (unsigned long long)s->atUnknown, (unsigned long long)s->tcpSends,
+           (unsigned long long)s->tcpBytes, s->gnssFixes);
+    printf("\"frames\":{\"expected\":%u,\"delivered\":%u,\"unique\":%u,\"duplicates\":%u,\"pending\":%u,"
+           "\"telemetry\":%u,\"latencyP50S\":%.1f,\"latencyP90S\":%.1f,\"latencyMaxS\":%.1f},",
+           expected, d.dataFrames, d.uniqueFrames, d.duplicates, pending, d.telemetryFrames,
+           percentile(d.latencyS, 0.5), percentile(d.latencyS, 0.9), percentile(d.latencyS, 1.0));
+    printf("\"integrity\":{\"written\":%u,\"lost\":%u,\"corrupt\":%u,\"badEpoch\":%u,\"probeZero\":%u},",
+           integ.written, integ.lost, integ.corrupt, integ.badEpoch, integ.probeZero);
+    if (!sc.name.empty()) {
+      printf("\"scenario\":{\"name\":\"%s\",\"passed\":%s,\"faults\":[", sc.name.c_str(),
+             allPassed ? "true" : "false");
+      for (size_t i = 0; i < sc.faults.size(); i++) {
+        printf("%s{\"line\":%d,\"kind\":\"%s\",\"fired\":%u,\"recoveryS\":%s}", i ? "," : "",
+               sc.faults[i].line, faultKindName(sc.faults[i].kind), s->faults[i].fired,
+               jsonNumber(recoveryS[i]).c_str());
+      }
+      printf("],\"expects\":[");
+      for (size_t i = 0; i < sc.expects.size(); i++) {
+        printf("%s{\"line\":%d,\"expect\":\"%s\",\"xfail\":%s,\"actual\":%s,\"holds\":%s,\"passed\":%s}",
+               i ? "," : "", sc.expects[i].line, sc.expects[i].text.c_str(), sc.expects[i].xfail ? "true" : "false",
+               jsonNumber(actual[i]).c_str(), holds[i] ? "true" : "false", passed[i] ? "true" : "false");
+      }
+      printf("]},");
+    }
+    printf("\"hostS\":%.2f}\n", hostS);
+    return exitCode;
+  }
+
+  printf("=== JAMR_4.5 simulado: %.1f días, semilla %llu, ciclo %.1f min ===\n", days,
+         (unsigned long long)cfg.seed, (double)cfg.sleepUs / 60e6);
+  printf("Boots          %u (deep sleep %u, esp_restart %u, cuelgues %u, crashes %u, brownouts %u)\n", s->boots,
+         s->deepSleeps, s->restarts, s->hangs, s->crashes, s->brownouts);
+  if (s->hangs && s->lastHang[0]) printf("Último cuelgue  %s\n", s->lastHang);
+  printf("Activo         prom %.2f s por boot; boot más largo %.2f s; light sleep %.1f s en total\n", awakeAvgS,
+         (double)s->maxAwakeUs / 1e6, (double)s->lightSleepUs / 1e6);
+  printf("Energía        %.1f mAh (%.0f µA prom; %.1f %% de %.0f mAh)\n", mah, mah / (simS / 3600.0) * 1000.0,
+         100.0 * mah / cfg.batteryMah, cfg.batteryMah);
+  for (int r = 0; r < RAIL_COUNT; r++) {
+    printf("  %-12s %9.2f mAh (%4.1f %%)\n", RAIL_NAMES[r], railMah[r], mah > 0 ? 100.0 * railMah[r] / mah : 0.0);
+  }
+  printf("RTC            %u B de RTC_DATA_ATTR + %u B de RTC_NOINIT_ATTR (%.0f %% de %llu B)\n",
+         s->rtcData.len, s->rtcNoinit.len, 100.0 * (s->rtcData.len + s->rtcNoinit.len) / RTC_SLOW_MEM_BYTES,
+         (unsigned long long)RTC_SLOW_MEM_BYTES);
+  printf("Flash          %llu B programados (%.1f KB/día); NVS %u put, %u con cambio\n",
+         (unsigned long long)s->fsBytes, (double)s->fsBytes / 1024.0 / days, s->nvsPuts, s->nvsChanged);
+  for (uint32_t i = 0; i < s->fileCount; i++) {
+    const FileStats& f = s->files[i];
+    printf("  %-24s %10llu B  %6u aperturas esc.  %5u truncados\n", f.path, (unsigned long long)f.bytes,
+           f.writeOpens, f.truncates);
+  }
+  printf("Modem          %llu comandos AT (%llu desconocidos), %llu CASEND (%llu B), %u fixes GNSS\n",
+         (unsigned long long)s->atCommands, (unsigned long long)s->atUnknown, (unsigned long long)s->tcpSends,
+         (unsigned long long)s->tcpBytes, s->gnssFixes);
+  printf("Tramas         %u esperadas, %u únicas recibidas, %u duplicadas, %u pendientes en buffer\n", expected,
+         d.uniqueFrames, d.duplicates, pending);
+  printf("Latencia       p50 %.0f s, p90 %.0f s, máx %.0f s (recepción - epoch de la trama)\n",
+         percentile(d.latencyS, 0.5), percentile(d.latencyS, 0.9), percentile(d.latencyS, 1.0));
+  printf("Telemetría     %u tramas FEAT-V30; %u envíos no reconocidos\n", d.telemetryFrames, d.otherSends);
+  printf("Integridad     %u escritas, %u perdidas, %u corruptas, %u con epoch a más de 60 s\n", integ.written,
+         integ.lost, integ.corrupt, integ.badEpoch);
+  printf("Host           %.2f s (%.0fx tiempo real); último boot: %s\n", hostS, simS / (hostS > 0 ? hostS : 1e-9),
+         exitName(s->lastExit));
+
+  if (sc.name.empty()) return 0;
+  printf("\n=== Escenario %s: %s ===\n", sc.name.c_str(), allPassed ? "OK" : "FALLA");
+  for (size_t i = 0; i < sc.faults.size(); i++) {
+    const FaultRuntime& rt = s->faults[i];
+    printf("  L%-3d %-16s %6u disparos", sc.faults[i].line, faultKindName(sc.faults[i].kind), rt.fired);
+    if (rt.fired) {
+      printf(" (%.2f h .. %.2f h), recuperación ", (double)rt.firstWall / 3.6e9, (double)rt.lastWall / 3.6e9);
+      if (std::isinf(recoveryS[i])) printf("nunca");
+      else printf("%.0f s", recoveryS[i]);
+    }
+    printf("\n");
+  }
+  for (size_t i = 0; i < sc.expects.size(); i++) {
+    const char* verdict = passed[i] ? (sc.expects[i].xfail ? "XFALLA" : "OK")
+                                    : (sc.expects[i].xfail && holds[i]) ? "XPASA" : "FALLA";
+    printf("  L%-3d %-6s %-32s (%s)\n", sc.expects[i].line, verdict, sc.expects[i].text.c_str(),
+           std::isnan(actual[i]) ? "métrica desconocida" : std::isinf(actual[i]) ? "nunca" : jsonNumber(actual[i]).c_str());
+  }
+  return exitCode;
+}
@@ -0,0 +1,23 @@
+/**
+ * @file AHT20.h
+ * @brief Sensor AHT20 con modelo diurno sembrado (FEAT-V31)
+ *
+ * Cada lectura cuesta ~80 ms de conversión; la temperatura y humedad siguen
+ * un ciclo diario más ruido determinista por semilla.
+ */
+
+#ifndef SIM_AHT20_H
+#define SIM_AHT20_H
+
+#include "Arduino.h"
+
+class AHT20 {
+ public:
+  bool begin();
+  bool available() { return true; }
+  bool isConnected() { return true; }
+  float getTemperature();
+  float getHumidity();
+};
+
+#endif  // SIM_AHT20_H
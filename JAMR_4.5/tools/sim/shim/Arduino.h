@@ -0,0 +1,416 @@
+/**
+ * @file Arduino.h
+ * @brief Núcleo Arduino-ESP32 mínimo para el simulador host (FEAT-V31)
+ * @version FEAT-V31
+ * @date 2026-10-18
+ *
+ * Solo lo que usa el firmware de JAMR_4.5. El tiempo (millis, delay,
+ * esp_timer) es virtual y los puertos serie se enrutan a los modelos de
+ * tools/sim/ (UART0 = consola, UART1 = SIM7080G, UART2 = RS485).
+ */
+
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+#include "build_time_sim.h"
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(x) (x)
+#define PROGMEM
+typedef const char __FlashStringHelper;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define ADC_0db 0
+#define ADC_2_5db 1
+#define ADC_6db 2
+#define ADC_11db 3
+
+#define SERIAL_8N1 0x800001c
+
+using std::min;
+using std::max;
+
+template <typename T>
+T constrain(T x, T a, T b) { return x < a ? a : (x > b ? b : x); }
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isAlpha(char c) { return isalpha((unsigned char)c) != 0; }
+inline bool isAlphaNumeric(char c) { return isalnum((unsigned char)c) != 0; }
+inline bool isPrintable(char c) { return isprint((unsigned char)c) != 0; }
+inline bool isWhitespace(char c) { return c == ' ' || c == '\t'; }
+inline bool isHexadecimalDigit(char c) { return isxdigit((unsigned char)c) != 0; }
+
+// ============================================================
+// String
+// ============================================================
+
+class String {
+ public:
+  String() {}
+  String(const char* c) : s_(c ? c : "") {}
+  String(const std::string& x) : s_(x) {}
+  explicit String(char c) : s_(1, c) {}
+  String(unsigned char v, unsigned char base = 10) { fromUnsigned(v, base); }
+  String(int v, unsigned char base = 10) { fromSigned(v, base); }
+  String(unsigned int v, unsigned char base = 10) { fromUnsigned(v, base); }
+  String(long v, unsigned char base = 10) { fromSigned(v, base); }
+  String(unsigned long v, unsigned char base = 10) { fromUnsigned(v, base); }
+  String(long long v, unsigned char base = 10) { fromSigned(v, base); }
+  String(unsigned long long v, unsigned char base = 10) { fromUnsigned(v, base); }
+  String(float v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+  String(double v, unsigned int decimals = 2) { fromDouble(v, decimals); }
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char* c_str() const { return s_.c_str(); }
+  bool isEmpty() const { return s_.empty(); }
+  bool reserve(unsigned int n) { s_.reserve(n); return true; }
+
+  long toInt() const { return atol(s_.c_str()); }
+  float toFloat() const { return (float)atof(s_.c_str()); }
+  double toDouble() const { return atof(s_.c_str()); }
+
+  void trim() {
+    size_t a = s_.find_first_not_of(" \t\r\n\f\v");
+    size_t b = s_.find_last_not_of(" \t\r\n\f\v");
+    s_ = (a == std::string::npos) ? std::string() : s_.substr(a, b - a + 1);
+  }
+  void toUpperCase() { for (auto& c : s_) c = (char)toupper((unsigned char)c); }
+  void toLowerCase() { for (auto& c : s_) c = (char)tolower((unsigned char)c); }
+
+  int indexOf(char c, unsigned int from = 0) const { return pos(s_.find(c, from)); }
+  int indexOf(const String& x, unsigned int from = 0) const { return pos(s_.find(x.s_, from)); }
+  int indexOf(const char* x, unsigned int from = 0) const { return pos(s_.find(x, from)); }
+  int lastIndexOf(char c) const { return pos(s_.rfind(c)); }
+  int lastIndexOf(const String& x) const { return pos(s_.rfind(x.s_)); }
+
+  String substring(unsigned int a) const { return a >= s_.size() ? String() : String(s_.substr(a)); }
+  String substring(unsigned int a, unsigned int b) const {
+    if (a > b) std::swap(a, b);
+    if (a >= s_.size()) return String();
+    return String(s_.substr(a, b - a));
+  }
+  bool startsWith(const String& x) const { return s_.compare(0, x.s_.size(), x.s_) == 0; }
+  bool endsWith(const String& x) const {
+    return s_.size() >= x.s_.size() && s_.compare(s_.size() - x.s_.size(), x.s_.size(), x.s_) == 0;
+  }
+  bool equals(const String& o) const { return s_ == o.s_; }
+  bool equalsIgnoreCase(const String& o) const { return strcasecmp(s_.c_str(), o.s_.c_str()) == 0; }
+
+  char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  void setCharAt(unsigned int i, char c) { if (i < s_.size()) s_[i] = c; }
+  char operator[](unsigned int i) const { return charAt(i); }
+  char& operator[](unsigned int i) { return s_[i]; }
+
+  void replace(const String& a, const String& b) {
+    if (a.s_.empty()) return;
+    size_t p = 0;
+    while ((p = s_.find(a.s_, p)) != std::string::npos) {
+      s_.replace(p, a.s_.size(), b.s_);
+      p += b.s_.size();
+    }
+  }
+  void remove(unsigned int i, unsigned int n = (unsigned int)-1) { if (i < s_.size()) s_.erase(i, n); }
+  void toCharArray(char* buf, unsigned int n, unsigned int from = 0) const {
+    if (n == 0) return;
+    size_t k = 0;
+    for (size_t i = from; i < s_.size() && k + 1 < n; i++) buf[k++] = s_[i];
+    buf[k] = '\0';
+  }
+  void getBytes(unsigned char* buf, unsigned int n, unsigned int from = 0) const {
+    toCharArray((char*)buf, n, from);
+  }
+
+  bool concat(const String& o) { s_ += o.s_; return true; }
+  bool concat(const char* o) { if (o) s_ += o; return true; }
+  bool concat(char c) { s_ += c; return true; }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o) { if (o) s_ += o; return *this; }
+  String& operator+=(char o) { s_ += o; return *this; }
+  String& operator+=(unsigned char o) { return *this += String(o); }
+  String& operator+=(int o) { return *this += String(o); }
+  String& operator+=(unsigned int o) { return *this += String(o); }
+  String& operator+=(long o) { return *this += String(o); }
+  String& operator+=(unsigned long o) { return *this += String(o); }
+  String& operator+=(float o) { return *this += String(o); }
+  String& operator+=(double o) { return *this += String(o); }
+
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator==(const char* o) const { return s_ == (o ? o : ""); }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool operator<(const String& o) const { return s_ < o.s_; }
+  bool operator>(const String& o) const { return s_ > o.s_; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String& a, const char* b) { return String(a.s_ + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s_); }
+  friend String operator+(const String& a, char b) { return String(a.s_ + b); }
+  friend String operator+(const String& a, unsigned char b) { return a + String(b); }
+  friend String operator+(const String& a, int b) { return a + String(b); }
+  friend String operator+(const String& a, unsigned int b) { return a + String(b); }
+  friend String operator+(const String& a, long b) { return a + String(b); }
+  friend String operator+(const String& a, unsigned long b) { return a + String(b); }
+  friend String operator+(const String& a, float b) { return a + String(b); }
+  friend String operator+(const String& a, double b) { return a + String(b); }
+
+ private:
+  std::string s_;
+
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  void fromUnsigned(unsigned long long v, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char buf[66];
+    int i = 65;
+    buf[i] = '\0';
+    do {
+      unsigned d = (unsigned)(v % base);
+      buf[--i] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+      v /= base;
+    } while (v);
+    s_ = &buf[i];
+  }
+  void fromSigned(long long v, unsigned char base) {
+    if (base == 10 && v < 0) {
+      fromUnsigned((unsigned long long)(-(v + 1)) + 1, 10);
+      s_.insert(s_.begin(), '-');
+    } else {
+      fromUnsigned((unsigned long long)v, base);
+    }
+  }
+  void fromDouble(double v, unsigned int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    s_ = buf;
+  }
+};
+
+// ============================================================
+// Print / Stream
+// ============================================================
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (n--) k += write(*buf++);
+    return k;
+  }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+  size_t write(const char* s, size_t n) { return write((const uint8_t*)s, n); }
+  virtual void flush() {}
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return printNumber(v, base); }
+  size_t print(int v, int base = DEC) { return printSigned(v, base); }
+  size_t print(unsigned int v, int base = DEC) { return printNumber(v, base); }
+  size_t print(long v, int base = DEC) { return printSigned(v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printNumber(v, base); }
+  size_t print(long long v, int base = DEC) { return printSigned(v, base); }
+  size_t print(unsigned long long v, int base = DEC) { return printNumber(v, base); }
+  size_t print(double v, int digits = 2) { return print(String(v, (unsigned)digits)); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  template <typename T>
+  size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char stackBuf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(stackBuf, sizeof(stackBuf), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(stackBuf)) return write((const uint8_t*)stackBuf, (size_t)n);
+    std::string big((size_t)n + 1, '\0');
+    va_start(ap, fmt);
+    vsnprintf(&big[0], big.size(), fmt, ap);
+    va_end(ap);
+    return write((const uint8_t*)big.data(), (size_t)n);
+  }
+
+ private:
+  size_t printNumber(unsigned long long v, int base) {
+    if (base == 0) return write((uint8_t)v);
+    return print(String(v, (unsigned char)base));
+  }
+  size_t printSigned(long long v, int base) {
+    if (base == 0) return write((uint8_t)v);
+    if (base == DEC) return print(String(v));
+    return printNumber((unsigned long)v, base);  // Como Arduino: complemento a 2 de 32 bits
+  }
+};
+
+unsigned long millis();
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long ms) { timeout_ = ms; }
+  unsigned long getTimeout() const { return timeout_; }
+
+  String readStringUntil(char terminator) {
+    std::string out;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) out += (char)c;
+    return String(out);
+  }
+  String readString() {
+    std::string out;
+    int c;
+    while ((c = timedRead()) >= 0) out += (char)c;
+    return String(out);
+  }
+  size_t readBytes(uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n) {
+      int c = timedRead();
+      if (c < 0) break;
+      buf[k++] = (uint8_t)c;
+    }
+    return k;
+  }
+  size_t readBytes(char* buf, size_t n) { return readBytes((uint8_t*)buf, n); }
+  size_t readBytesUntil(char terminator, char* buf, size_t n) {
+    size_t k = 0;
+    while (k < n) {
+      int c = timedRead();
+      if (c < 0 || c == terminator) break;
+      buf[k++] = (char)c;
+    }
+    return k;
+  }
+  bool find(const char* target) {
+    size_t len = strlen(target), idx = 0;
+    int c;
+    while ((c = timedRead()) >= 0) {
+      idx = (c == target[idx]) ? idx + 1 : (c == target[0] ? 1 : 0);
+      if (idx == len) return true;
+    }
+    return false;
+  }
+
+ protected:
+  /** @brief Como Arduino: reintenta hasta el timeout (tiempo virtual) */
+  int timedRead() {
+    unsigned long start = millis();
+    do {
+      int c = read();
+      if (c >= 0) return c;
+    } while (millis() - start < timeout_);
+    return -1;
+  }
+
+ private:
+  unsigned long timeout_ = 1000;
+};
+
+// ============================================================
+// HardwareSerial: UART0 consola, UART1 modem, UART2 RS485
+// ============================================================
+
+class HardwareSerial : public Stream {
+ public:
+  explicit HardwareSerial(int uart = 0) : uart_(uart) {}
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1,
+             int8_t txPin = -1, bool invert = false, unsigned long timeoutMs = 20000UL);
+  void end();
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+  void flush() override;
+  int availableForWrite();
+  size_t setRxBufferSize(size_t n) { return n; }
+  size_t setTxBufferSize(size_t n) { return n; }
+  operator bool() const { return true; }
+
+ private:
+  int uart_;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+// ============================================================
+// Tiempo, GPIO, ADC
+// ============================================================
+
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+void analogReadResolution(uint8_t bits);
+void analogSetAttenuation(int atten);
+void analogSetPinAttenuation(uint8_t pin, int atten);
+
+long random(long maxVal);
+long random(long minVal, long maxVal);
+void randomSeed(unsigned long seed);
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getHeapSize();
+  uint64_t getEfuseMac();
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getCycleCount();  ///< Ciclos virtuales: µs del boot × 240 (FEAT-V33)
+  uint32_t getFlashChipSize() { return 8UL * 1024UL * 1024UL; }
+  void restart() { esp_restart(); }
+};
+
+extern EspClass ESP;
+
+#endif  // SIM_ARDUINO_H
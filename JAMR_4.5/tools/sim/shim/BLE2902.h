@@ -0,0 +1,11 @@
+/**
+ * @file BLE2902.h
+ * @brief Ver ble_sim.h (FEAT-V31)
+ */
+
+#ifndef SIM_BLE2902_H
+#define SIM_BLE2902_H
+
+#include "ble_sim.h"
+
+#endif  // SIM_BLE2902_H
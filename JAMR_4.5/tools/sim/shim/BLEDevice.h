@@ -0,0 +1,11 @@
+/**
+ * @file BLEDevice.h
+ * @brief Ver ble_sim.h (FEAT-V31)
+ */
+
+#ifndef SIM_BLEDEVICE_H
+#define SIM_BLEDEVICE_H
+
+#include "ble_sim.h"
+
+#endif  // SIM_BLEDEVICE_H
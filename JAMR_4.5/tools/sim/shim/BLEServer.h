@@ -0,0 +1,11 @@
+/**
+ * @file BLEServer.h
+ * @brief Ver ble_sim.h (FEAT-V31)
+ */
+
+#ifndef SIM_BLESERVER_H
+#define SIM_BLESERVER_H
+
+#include "ble_sim.h"
+
+#endif  // SIM_BLESERVER_H
@@ -0,0 +1,11 @@
+/**
+ * @file BLEUtils.h
+ * @brief Ver ble_sim.h (FEAT-V31)
+ */
+
+#ifndef SIM_BLEUTILS_H
+#define SIM_BLEUTILS_H
+
+#include "ble_sim.h"
+
+#endif  // SIM_BLEUTILS_H
@@ -0,0 +1,11 @@
+/**
+ * @file HardwareSerial.h
+ * @brief HardwareSerial vive en Arduino.h del simulador (FEAT-V31)
+ */
+
+#ifndef SIM_HARDWARE_SERIAL_H
+#define SIM_HARDWARE_SERIAL_H
+
+#include "Arduino.h"
+
+#endif  // SIM_HARDWARE_SERIAL_H
@@ -0,0 +1,42 @@
+/**
+ * @file ModbusMaster.h
+ * @brief Maestro Modbus RTU contra las sondas simuladas del bus RS485 (FEAT-V31)
+ *
+ * La sonda solo responde con el riel RS485 (GPIO 3) encendido; el tiempo
+ * de cada transacción es el de la trama a 9600 baud. Sin respuesta, espera
+ * el timeout de la librería (2000 ms) y devuelve ku8MBResponseTimedOut.
+ */
+
+#ifndef SIM_MODBUS_MASTER_H
+#define SIM_MODBUS_MASTER_H
+
+#include "Arduino.h"
+
+class ModbusMaster {
+ public:
+  static const uint8_t ku8MBSuccess = 0x00;
+  static const uint8_t ku8MBIllegalDataAddress = 0x02;
+  static const uint8_t ku8MBInvalidSlaveID = 0xE0;
+  static const uint8_t ku8MBInvalidFunction = 0xE1;
+  static const uint8_t ku8MBResponseTimedOut = 0xE2;
+  static const uint8_t ku8MBInvalidCRC = 0xE3;
+
+  void begin(uint8_t slave, Stream& serial) { slave_ = slave; serial_ = &serial; }
+  void preTransmission(void (*fn)()) { (void)fn; }
+  void postTransmission(void (*fn)()) { (void)fn; }
+
+  uint8_t readHoldingRegisters(uint16_t address, uint16_t count) { return transact(0x03, address, count); }
+  uint8_t readInputRegisters(uint16_t address, uint16_t count) { return transact(0x04, address, count); }
+  uint8_t writeSingleRegister(uint16_t address, uint16_t value);
+  uint16_t getResponseBuffer(uint8_t index) { return index < 64 ? response_[index] : 0xFFFF; }
+  void clearResponseBuffer() { memset(response_, 0, sizeof(response_)); }
+
+ private:
+  uint8_t slave_ = 1;
+  Stream* serial_ = nullptr;
+  uint16_t response_[64] = {};
+
+  uint8_t transact(uint8_t function, uint16_t address, uint16_t count);
+};
+
+#endif  // SIM_MODBUS_MASTER_H
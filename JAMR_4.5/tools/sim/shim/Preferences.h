@@ -0,0 +1,78 @@
+/**
+ * @file Preferences.h
+ * @brief NVS (Preferences) persistido en <dir>/nvs por namespace (FEAT-V31)
+ *
+ * Como nvs_set_*, un put con el mismo valor no reescribe flash; el
+ * simulador cuenta los put totales y los que cambiaron el valor.
+ */
+
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <map>
+#include <string>
+#include "Arduino.h"
+
+class Preferences {
+ public:
+  bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+  size_t freeEntries();
+
+  size_t putChar(const char* key, int8_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putUChar(const char* key, uint8_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putShort(const char* key, int16_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putUShort(const char* key, uint16_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putInt(const char* key, int32_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putUInt(const char* key, uint32_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putLong(const char* key, int32_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putULong(const char* key, uint32_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putLong64(const char* key, int64_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putULong64(const char* key, uint64_t v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putFloat(const char* key, float v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putDouble(const char* key, double v) { return putRaw(key, &v, sizeof(v)); }
+  size_t putBool(const char* key, bool v) { uint8_t b = v ? 1 : 0; return putRaw(key, &b, 1); }
+  size_t putString(const char* key, const char* v) { return putRaw(key, v, strlen(v)) ? strlen(v) : 0; }
+  size_t putString(const char* key, const String& v) { return putString(key, v.c_str()); }
+  size_t putBytes(const char* key, const void* v, size_t n) { return putRaw(key, v, n); }
+
+  int8_t getChar(const char* key, int8_t d = 0) { return getRaw(key, d); }
+  uint8_t getUChar(const char* key, uint8_t d = 0) { return getRaw(key, d); }
+  int16_t getShort(const char* key, int16_t d = 0) { return getRaw(key, d); }
+  uint16_t getUShort(const char* key, uint16_t d = 0) { return getRaw(key, d); }
+  int32_t getInt(const char* key, int32_t d = 0) { return getRaw(key, d); }
+  uint32_t getUInt(const char* key, uint32_t d = 0) { return getRaw(key, d); }
+  int32_t getLong(const char* key, int32_t d = 0) { return getRaw(key, d); }
+  uint32_t getULong(const char* key, uint32_t d = 0) { return getRaw(key, d); }
+  int64_t getLong64(const char* key, int64_t d = 0) { return getRaw(key, d); }
+  uint64_t getULong64(const char* key, uint64_t d = 0) { return getRaw(key, d); }
+  float getFloat(const char* key, float d = 0) { return getRaw(key, d); }
+  double getDouble(const char* key, double d = 0) { return getRaw(key, d); }
+  bool getBool(const char* key, bool d = false) { return getRaw<uint8_t>(key, d ? 1 : 0) != 0; }
+  String getString(const char* key, const String& d = String());
+  size_t getString(const char* key, char* buf, size_t maxLen);
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+ private:
+  std::string ns_;
+  bool open_ = false;
+  bool readOnly_ = false;
+
+  size_t putRaw(const char* key, const void* data, size_t n);
+  const std::string* find(const char* key);
+
+  template <typename T>
+  T getRaw(const char* key, T d) {
+    const std::string* v = find(key);
+    if (v == nullptr || v->size() != sizeof(T)) return d;
+    T out;
+    memcpy(&out, v->data(), sizeof(T));
+    return out;
+  }
+};
+
+#endif  // SIM_PREFERENCES_H
@@ -0,0 +1,46 @@
+/**
+ * @file RTClib.h
+ * @brief DS1307 sobre el reloj de pared simulado (FEAT-V31)
+ *
+ * now() = epoch inicial de la simulación + tiempo de pared transcurrido.
+ * El DS1307 tiene batería propia: sigue corriendo en deep sleep y reinicios.
+ */
+
+#ifndef SIM_RTCLIB_H
+#define SIM_RTCLIB_H
+
+#include "Arduino.h"
+
+class TwoWire;
+
+class DateTime {
+ public:
+  DateTime(uint32_t t = 0);
+  DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0,
+           uint8_t sec = 0);
+  DateTime(const char* date, const char* time);
+
+  uint32_t unixtime() const { return t_; }
+  uint16_t year() const { return year_; }
+  uint8_t month() const { return month_; }
+  uint8_t day() const { return day_; }
+  uint8_t hour() const { return hour_; }
+  uint8_t minute() const { return minute_; }
+  uint8_t second() const { return second_; }
+
+ private:
+  uint32_t t_;
+  uint16_t year_;
+  uint8_t month_, day_, hour_, minute_, second_;
+  void split();
+};
+
+class RTC_DS1307 {
+ public:
+  bool begin(TwoWire* wire = nullptr);
+  bool isrunning();
+  void adjust(const DateTime& dt);
+  DateTime now();
+};
+
+#endif  // SIM_RTCLIB_H
@@ -0,0 +1,26 @@
+/**
+ * @file Wire.h
+ * @brief Bus I2C del simulador host (FEAT-V31); AHT20 y DS1307 se modelan aparte
+ */
+
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire {
+ public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool end() { return true; }
+  void setClock(uint32_t frequency) { (void)frequency; }
+  void beginTransmission(uint8_t address) { (void)address; }
+  uint8_t endTransmission(bool stop = true) { (void)stop; return 0; }
+  size_t write(uint8_t data) { (void)data; return 1; }
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) { (void)address; return quantity; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif  // SIM_WIRE_H
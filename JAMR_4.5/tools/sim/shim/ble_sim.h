@@ -0,0 +1,153 @@
+/**
+ * @file ble_sim.h
+ * @brief Pila BLE mínima para el simulador host (FEAT-V31)
+ *
+ * Sin cliente: el servidor anuncia y nadie se conecta, así BLEModule sigue
+ * su camino de timeout. Las notificaciones solo se cuentan y, como en la
+ * pila de Arduino sin conexiones, onStatus las informa con ERROR_NO_CLIENT.
+ */
+
+#ifndef SIM_BLE_SIM_H
+#define SIM_BLE_SIM_H
+
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+class BLEServer;
+class BLECharacteristic;
+
+class BLEServerCallbacks {
+ public:
+  virtual ~BLEServerCallbacks() {}
+  virtual void onConnect(BLEServer* server) { (void)server; }
+  virtual void onDisconnect(BLEServer* server) { (void)server; }
+};
+
+class BLECharacteristicCallbacks {
+ public:
+  typedef enum {
+    SUCCESS_INDICATE,
+    SUCCESS_NOTIFY,
+    ERROR_INDICATE_DISABLED,
+    ERROR_NOTIFY_DISABLED,
+    ERROR_GATT,
+    ERROR_NO_CLIENT,
+    ERROR_INDICATE_TIMEOUT,
+    ERROR_INDICATE_FAILURE
+  } Status;
+
+  virtual ~BLECharacteristicCallbacks() {}
+  virtual void onWrite(BLECharacteristic* ch) { (void)ch; }
+  virtual void onRead(BLECharacteristic* ch) { (void)ch; }
+  virtual void onStatus(BLECharacteristic* ch, Status s, uint32_t code) {
+    (void)ch;
+    (void)s;
+    (void)code;
+  }
+};
+
+class BLEDescriptor {
+ public:
+  virtual ~BLEDescriptor() {}
+};
+
+class BLE2902 : public BLEDescriptor {
+ public:
+  void setNotifications(bool on) { (void)on; }
+};
+
+class BLECharacteristic {
+ public:
+  static const uint32_t PROPERTY_READ = 1 << 0;
+  static const uint32_t PROPERTY_WRITE = 1 << 1;
+  static const uint32_t PROPERTY_NOTIFY = 1 << 2;
+  static const uint32_t PROPERTY_INDICATE = 1 << 3;
+  static const uint32_t PROPERTY_WRITE_NR = 1 << 4;
+
+  void setCallbacks(BLECharacteristicCallbacks* cb) { cb_ = cb; }
+  void addDescriptor(BLEDescriptor* d) { descriptors_.push_back(d); }
+  void setValue(const uint8_t* data, size_t len) { value_.assign((const char*)data, len); }
+  void setValue(uint8_t* data, size_t len) { value_.assign((const char*)data, len); }
+  void setValue(const std::string& v) { value_ = v; }
+  void setValue(const String& v) { value_ = v.c_str(); }
+  void setValue(const char* v) { value_ = v ? v : ""; }
+  void notify(bool isNotification = true) {
+    (void)isNotification;
+    notifyCount_++;
+    if (cb_) cb_->onStatus(this, BLECharacteristicCallbacks::ERROR_NO_CLIENT, 0);
+  }
+  void indicate() { notify(false); }
+  std::string getValue() const { return value_; }
+  uint8_t* getData() { return (uint8_t*)value_.data(); }
+  size_t getLength() const { return value_.size(); }
+  uint32_t notifyCount() const { return notifyCount_; }
+
+ private:
+  BLECharacteristicCallbacks* cb_ = nullptr;
+  std::vector<BLEDescriptor*> descriptors_;
+  std::string value_;
+  uint32_t notifyCount_ = 0;
+};
+
+class BLEService {
+ public:
+  BLECharacteristic* createCharacteristic(const char* uuid, uint32_t properties) {
+    (void)uuid;
+    (void)properties;
+    chars_.push_back(new BLECharacteristic());
+    return chars_.back();
+  }
+  void start() {}
+  void stop() {}
+
+ private:
+  std::vector<BLECharacteristic*> chars_;
+};
+
+class BLEAdvertising {
+ public:
+  void addServiceUUID(const char* uuid) { (void)uuid; }
+  void setScanResponse(bool on) { (void)on; }
+  void setMinPreferred(uint16_t v) { (void)v; }
+  void setMaxPreferred(uint16_t v) { (void)v; }
+  void start() {}
+  void stop() {}
+};
+
+class BLEServer {
+ public:
+  void setCallbacks(BLEServerCallbacks* cb) { cb_ = cb; }
+  BLEService* createService(const char* uuid) {
+    (void)uuid;
+    services_.push_back(new BLEService());
+    return services_.back();
+  }
+  BLEAdvertising* getAdvertising() { return &adv_; }
+  void startAdvertising() {}
+  uint32_t getConnectedCount() { return 0; }
+  void disconnect(uint16_t connId) { (void)connId; }
+  uint16_t getConnId() { return 0; }
+  uint16_t getPeerMTU(uint16_t connId) { (void)connId; return 23; }
+
+ private:
+  BLEServerCallbacks* cb_ = nullptr;
+  std::vector<BLEService*> services_;
+  BLEAdvertising adv_;
+};
+
+class BLEDevice {
+ public:
+  static void init(const std::string& name) { (void)name; }
+  static BLEServer* createServer() { return new BLEServer(); }
+  static void deinit(bool releaseMemory = false) { (void)releaseMemory; }
+  static BLEAdvertising* getAdvertising() { static BLEAdvertising adv; return &adv; }
+  static void startAdvertising() {}
+  static esp_err_t setMTU(uint16_t mtu) { s_mtu() = mtu; return ESP_OK; }
+  static uint16_t getMTU() { return s_mtu(); }
+
+ private:
+  static uint16_t& s_mtu() { static uint16_t mtu = 23; return mtu; }
+};
+
+#endif  // SIM_BLE_SIM_H
@@ -0,0 +1,25 @@
+/**
+ * @file build_time_sim.h
+ * @brief Fecha de compilación fija para el simulador host (FEAT-V32)
+ *
+ * initializeRTC() ajusta el DS1307 a __DATE__ __TIME__ cuando lo encuentra
+ * detenido (rtc-lost). Con la hora real de compilación, el epoch de las
+ * tramas y los tiempos de reintento cambian de un build a otro, y los
+ * escenarios dejan de ser reproducibles. Se fija 6 h antes de
+ * SimConfig::startEpoch (2026-10-18 00:00:00 UTC).
+ *
+ * system_header: redefinir __DATE__/__TIME__ no emite
+ * -Wbuiltin-macro-redefined en cada unidad que incluye Arduino.h.
+ */
+
+#ifndef SIM_BUILD_TIME_SIM_H
+#define SIM_BUILD_TIME_SIM_H
+
+#pragma GCC system_header
+
+#undef __DATE__
+#undef __TIME__
+#define __DATE__ "Oct 17 2026"
+#define __TIME__ "18:00:00"
+
+#endif // SIM_BUILD_TIME_SIM_H
@@ -0,0 +1,26 @@
+/**
+ * @file esp_attr.h
+ * @brief RTC_DATA_ATTR y RTC_NOINIT_ATTR del simulador host (FEAT-V31)
+ *
+ * Las variables RTC_DATA_ATTR van a la sección "rtc_data_sim" y las
+ * RTC_NOINIT_ATTR a "rtc_noinit_sim". El simulador copia cada sección a
+ * memoria compartida al terminar un boot y la restaura en el siguiente (ver
+ * SimCore.cpp), con las reglas de la RTC slow memory del ESP32-S3:
+ *
+ *   Reset                    RTC_DATA_ATTR        RTC_NOINIT_ATTR
+ *   Wake de deep sleep       se conserva          se conserva
+ *   esp_restart, WDT, panic  valor inicial        se conserva
+ *   Power-on, brownout       valor inicial        valor inicial (en el
+ *                                                 ESP32, contenido aleatorio)
+ */
+
+#ifndef SIM_ESP_ATTR_H
+#define SIM_ESP_ATTR_H
+
+#define RTC_DATA_ATTR __attribute__((section("rtc_data_sim")))
+#define RTC_NOINIT_ATTR __attribute__((section("rtc_noinit_sim")))
+#define RTC_SLOW_ATTR RTC_DATA_ATTR
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif  // SIM_ESP_ATTR_H
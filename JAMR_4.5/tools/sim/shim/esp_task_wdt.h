@@ -0,0 +1,28 @@
+/**
+ * @file esp_task_wdt.h
+ * @brief Task watchdog para el simulador host (FEAT-V31)
+ *
+ * Con el watchdog configurado, una tarea que no lo alimenta en timeout_ms
+ * de tiempo virtual provoca un reset ESP_RST_TASK_WDT simulado.
+ */
+
+#ifndef SIM_ESP_TASK_WDT_H
+#define SIM_ESP_TASK_WDT_H
+
+#include <stdint.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+
+typedef struct {
+  uint32_t timeout_ms;
+  uint32_t idle_core_mask;
+  bool trigger_panic;
+} esp_task_wdt_config_t;
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t* config);
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t* config);
+esp_err_t esp_task_wdt_add(TaskHandle_t task);
+esp_err_t esp_task_wdt_delete(TaskHandle_t task);
+esp_err_t esp_task_wdt_reset(void);
+
+#endif  // SIM_ESP_TASK_WDT_H
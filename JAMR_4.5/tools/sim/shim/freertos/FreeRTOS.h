@@ -0,0 +1,60 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Tipos FreeRTOS del simulador host (FEAT-V31)
+ *
+ * Las tareas son hilos del host bajo un planificador cooperativo de eventos
+ * discretos: solo corre una a la vez y cada una avanza el reloj virtual
+ * (ver SimCore.h). Un tick = 1 ms, como CONFIG_FREERTOS_HZ=1000.
+ */
+
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t EventBits_t;
+typedef uint32_t StackType_t;
+
+typedef struct SimTask* TaskHandle_t;
+typedef struct SimEventGroup* EventGroupHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY (-1)
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#define BIT0 0x00000001
+#define BIT1 0x00000002
+#define BIT2 0x00000004
+#define BIT3 0x00000008
+#define BIT4 0x00000010
+#define BIT5 0x00000020
+#define BIT6 0x00000040
+#define BIT7 0x00000080
+
+/** @brief Sección crítica: suspende el cambio de tarea mientras dure */
+typedef struct {
+  volatile uint32_t owner;
+  volatile uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+
+void portENTER_CRITICAL(portMUX_TYPE* mux);
+void portEXIT_CRITICAL(portMUX_TYPE* mux);
+#define portENTER_CRITICAL_ISR(m) portENTER_CRITICAL(m)
+#define portEXIT_CRITICAL_ISR(m) portEXIT_CRITICAL(m)
+
+BaseType_t xPortGetCoreID(void);
+
+#endif  // SIM_FREERTOS_H
@@ -0,0 +1,22 @@
+/**
+ * @file TestModule.h
+ * @brief Sustituto de FEAT-V8 para el simulador host (FEAT-V31)
+ *
+ * src/data_tests/TestModule.h/.cpp no están en este árbol aunque
+ * ENABLE_FEAT_V8_TESTING está en 1; AppController.cpp lo incluye con
+ * comillas y -iquote tools/sim/shim resuelve aquí. No consume comandos.
+ */
+
+#ifndef SIM_TEST_MODULE_H
+#define SIM_TEST_MODULE_H
+
+#include <Arduino.h>
+
+namespace TestModule {
+inline bool processCommand(Stream* stream) {
+  (void)stream;
+  return false;
+}
+}  // namespace TestModule
+
+#endif  // SIM_TEST_MODULE_H
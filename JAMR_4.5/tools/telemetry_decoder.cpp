@@ -0,0 +1,266 @@
+/**
+ * @file telemetry_decoder.cpp
+ * @brief Decodificador host de la trama de telemetría in-band (Base64 -> JSON)
+ * @version FEAT-V30
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * COMPILAR:
+ *   g++ -std=c++17 -O2 -o telemetry_decoder tools/telemetry_decoder.cpp
+ *
+ * USO:
+ *   telemetry_decoder [--raw] captura.txt [...]   (o "-" para stdin)
+ *
+ *   --raw   Contadores tal como viajan (delta o absoluto) en lugar del total
+ *
+ * Busca en cada línea palabras Base64 que decodifican a una trama 'T' con
+ * CRC válido (ver src/data_format/TelemetryLayout.h); el resto (tramas de
+ * datos "$,", texto del servidor) se ignora. Imprime un objeto JSON por
+ * trama. Los contadores se acumulan por ICCID: un KEYFRAME fija el total,
+ * las demás suman su delta. Un salto de secuencia marca "gap" hasta el
+ * próximo KEYFRAME.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/data_format/TelemetryLayout.h"
+
+static const char* const COUNTER_NAMES[TELEM_COUNTER_COUNT] = {
+#define NAME_(field, name) name,
+  TELEM_COUNTERS(NAME_)
+};
+static const char* const GAUGE_NAMES[TELEM_GAUGE_COUNT] = {
+  TELEM_GAUGES(NAME_)
+};
+static const char* const PHASE_NAMES[TELEM_PHASE_COUNT] = {
+  TELEM_PHASES(NAME_)
+#undef NAME_
+};
+
+/** @brief Totales reconstruidos de un equipo */
+struct Device {
+  bool synced = false;   ///< Hubo un KEYFRAME y no se perdió ninguna trama después
+  uint16_t nextSeq = 0;
+  uint64_t totals[TELEM_COUNTER_COUNT] = {};
+};
+
+static std::map<std::string, Device> g_devices;
+static bool g_raw = false;
+
+// ============================================================
+// DECODIFICACIÓN
+// ============================================================
+
+static int b64Value(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+  if (c >= '0' && c <= '9') return c - '0' + 52;
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return -1;
+}
+
+static bool decodeBase64(const std::string& in, std::vector<uint8_t>& out) {
+  out.clear();
+  uint32_t acc = 0;
+  int bits = 0;
+  for (char c : in) {
+    if (c == '=') break;
+    int v = b64Value(c);
+    if (v < 0) return false;
+    acc = (acc << 6) | (uint32_t)v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out.push_back((uint8_t)(acc >> bits));
+    }
+  }
+  return !out.empty();
+}
+
+/** @brief CRC16 MODBUS (igual a ProdDiag::calculateCRC16) */
+static uint16_t crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (uint8_t j = 0; j < 8; j++) {
+      crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0xA001) : (uint16_t)(crc >> 1);
+    }
+  }
+  return crc;
+}
+
+/** @brief Lector acotado; cualquier lectura fuera de rango invalida la trama */
+struct Reader {
+  const uint8_t* p;
+  size_t len;
+  size_t pos = 0;
+  bool ok = true;
+
+  uint8_t u8() {
+    if (pos >= len) { ok = false; return 0; }
+    return p[pos++];
+  }
+  uint16_t u16() { uint16_t lo = u8(); return (uint16_t)(lo | (u8() << 8)); }
+  uint32_t u32() { uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+  uint32_t varint() {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t b = u8();
+      v |= (uint32_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) return v;
+    }
+    ok = false;
+    return 0;
+  }
+};
+
+static bool decodeFrame(const std::vector<uint8_t>& bin) {
+  if (bin.size() < TELEM_HEADER_BYTES + 5 || bin[0] != TELEM_MAGIC) return false;
+  size_t body = bin.size() - 2;
+  uint16_t crc = (uint16_t)(bin[body] | (bin[body + 1] << 8));
+  if (crc16(bin.data(), body) != crc) return false;
+
+  Reader r{bin.data(), body};
+  r.u8();  // magic
+  uint8_t version = r.u8();
+  if (version != TELEM_VERSION) {
+    fprintf(stderr, "trama versión %u no soportada\n", version);
+    return false;
+  }
+  uint8_t flags = r.u8();
+  uint8_t cycles = r.u8();
+
+  std::string iccid;
+  for (int i = 0; i < TELEM_ICCID_BCD; i++) {
+    uint8_t b = r.u8();
+    for (uint8_t nib : {(uint8_t)(b >> 4), (uint8_t)(b & 0x0F)}) {
+      if (nib <= 9) iccid += (char)('0' + nib);
+    }
+  }
+  uint32_t epoch = r.u32();
+  uint16_t seq = r.u16();
+  uint32_t totalCycles = r.u32();
+
+  std::vector<uint32_t> counters(r.u8());
+  for (auto& c : counters) c = r.varint();
+  std::vector<uint32_t> gauges(r.u8());
+  for (auto& g : gauges) g = r.varint();
+  struct Phase { uint8_t n; uint32_t p50, p90, max; };
+  std::vector<Phase> phases(r.u8());
+  for (auto& ph : phases) {
+    ph.n = r.u8();
+    ph.p50 = ph.p90 = ph.max = 0;
+    if (ph.n) {
+      ph.p50 = r.varint();
+      ph.p90 = r.varint();
+      ph.max = r.varint();
+    }
+  }
+  if (!r.ok || r.pos != body) return false;
+
+  bool key = flags & TELEM_FLAG_KEYFRAME;
+  Device& dev = g_devices[iccid];
+  bool gap = dev.synced && seq != dev.nextSeq;
+  if (key) dev.synced = true;
+  else if (gap) dev.synced = false;
+  dev.nextSeq = (uint16_t)(seq + 1);
+
+  std::ostringstream js;
+  js << "{\"iccid\":\"" << iccid << "\",\"epoch\":" << epoch << ",\"seq\":" << seq
+     << ",\"keyframe\":" << (key ? "true" : "false") << ",\"gap\":" << (gap ? "true" : "false")
+     << ",\"synced\":" << (dev.synced ? "true" : "false")
+     << ",\"totalCycles\":" << totalCycles << ",\"windowCycles\":" << (unsigned)cycles;
+
+  js << ",\"counters\":{";
+  for (size_t i = 0; i < counters.size(); i++) {
+    uint64_t v = counters[i];
+    if (i < TELEM_COUNTER_COUNT) {
+      dev.totals[i] = key ? v : dev.totals[i] + v;
+      if (!g_raw) v = dev.totals[i];
+    }
+    js << (i ? "," : "") << "\""
+       << (i < TELEM_COUNTER_COUNT ? COUNTER_NAMES[i] : ("c" + std::to_string(i)).c_str())
+       << "\":" << v;
+  }
+  js << "},\"gauges\":{";
+  for (size_t i = 0; i < gauges.size(); i++) {
+    js << (i ? "," : "") << "\""
+       << (i < TELEM_GAUGE_COUNT ? GAUGE_NAMES[i] : ("g" + std::to_string(i)).c_str())
+       << "\":" << gauges[i];
+  }
+  js << "}";
+  if (flags & TELEM_FLAG_TIMING) {
+    js << ",\"phases\":{";
+    bool first = true;
+    for (size_t i = 0; i < phases.size(); i++) {
+      if (!phases[i].n) continue;
+      js << (first ? "" : ",") << "\""
+         << (i < TELEM_PHASE_COUNT ? PHASE_NAMES[i] : ("p" + std::to_string(i)).c_str())
+         << "\":{\"n\":" << (unsigned)phases[i].n << ",\"p50\":" << phases[i].p50
+         << ",\"p90\":" << phases[i].p90 << ",\"max\":" << phases[i].max << "}";
+      first = false;
+    }
+    js << "}";
+  }
+  js << "}";
+  std::cout << js.str() << "\n";
+  return true;
+}
+
+static void scanLine(const std::string& line, uint32_t& frames) {
+  std::string word;
+  std::vector<uint8_t> bin;
+  for (size_t i = 0; i <= line.size(); i++) {
+    char c = (i < line.size()) ? line[i] : ' ';
+    if (b64Value(c) >= 0 || c == '=') {
+      word += c;
+      continue;
+    }
+    if (word.size() >= 4 && word[0] == 'V' && decodeBase64(word, bin) && decodeFrame(bin)) {
+      frames++;
+    }
+    word.clear();
+  }
+}
+
+int main(int argc, char** argv) {
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "--raw") g_raw = true;
+    else files.push_back(a);
+  }
+  if (files.empty()) {
+    fprintf(stderr, "uso: %s [--raw] captura.txt [...] (o - para stdin)\n", argv[0]);
+    return 2;
+  }
+
+  uint32_t frames = 0;
+  for (const auto& path : files) {
+    std::ifstream f;
+    std::istream* in = &std::cin;
+    if (path != "-") {
+      f.open(path);
+      if (!f) {
+        fprintf(stderr, "no se pudo abrir %s\n", path.c_str());
+        return 1;
+      }
+      in = &f;
+    }
+    std::string line;
+    while (std::getline(*in, line)) scanLine(line, frames);
+  }
+  fprintf(stderr, "%u tramas de telemetría\n", frames);
+  return frames ? 0 : 1;
+}
@@ -0,0 +1,581 @@
+/**
+ * @file trace_decoder.cpp
+ * @brief Decodificador host de trazas del equipo a Chrome trace-event JSON (Perfetto)
+ * @version FEAT-V24
+ * @date 2026-10-18
+ *
+ * Herramienta de PC (Linux), NO forma parte del firmware: Arduino solo compila
+ * la raíz del sketch y src/, no tools/.
+ *
+ * COMPILAR:
+ *   g++ -std=c++17 -O2 -o trace_decoder tools/trace_decoder.cpp
+ *
+ * USO:
+ *   trace_decoder [-o trace.json] [--stats] [--top N] captura.txt [dump.bin ...]
+ *
+ *   -o FILE   Escribe Chrome trace-event JSON (abrir en ui.perfetto.dev o chrome://tracing)
+ *   --stats   Percentiles por fase/comando (por defecto si no se pasa -o)
+ *   --top N   Lista los N eventos individuales más lentos con su origen
+ *
+ * ENTRADAS RECONOCIDAS (se pueden mezclar en el mismo archivo):
+ *   1. "[TIMING] <fase>: N ms"                 (FEAT-V2 / FEAT-V19)
+ *   2. Recuadro "CYCLE TIMING SUMMARY"         (FEAT-V2, cierra el ciclo)
+ *   3. "[Nms] ... Enviando comando AT: +CMD"   (logger JAMR_4.4, capturas fixs/<fix>/logs)
+ *      seguido de "Comando AT exitoso|falló: +CMD"
+ *   4. Volcados binarios JTRC (FEAT-V23, "TRACE BIN" por Serial o "TRACE" por BLE),
+ *      sueltos o incrustados en una captura de CoolTerm
+ */
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// ============================================================
+// MODELO
+// ============================================================
+
+/** @brief Origen de un evento (define pid/tid en el JSON) */
+enum class Source : uint8_t {
+  Binary = 1,  ///< Volcado JTRC (µs reales)
+  Text = 2     ///< Log de texto (ms, tiempos reconstruidos)
+};
+
+/** @brief Evento de duración normalizado */
+struct Event {
+  std::string name;      ///< Nombre del span / fase / comando
+  std::string cat;       ///< Categoría (prefijo antes de '.', "phase", "at")
+  std::string tag;       ///< Etiqueta (comando AT) o vacío
+  uint64_t tsUs = 0;     ///< Inicio en la línea de tiempo global
+  uint64_t durUs = 0;    ///< Duración
+  Source src = Source::Text;
+  uint8_t tid = 1;       ///< Núcleo (binario) o pista de texto
+  uint8_t depth = 0;
+  uint32_t cycle = 0;    ///< Despertar (binario) o ciclo (texto)
+  bool timeline = true;  ///< false = solo estadística (métricas sin posición)
+  bool ok = true;        ///< Resultado de comando AT (logger 4.4)
+  std::string origin;    ///< archivo:línea o archivo@offset
+};
+
+/** @brief Registro JTRC tal como viene del equipo */
+struct RawRecord {
+  std::string name;
+  uint16_t wake;
+  uint32_t startUs;
+  uint32_t durUs;
+  uint8_t depth;  ///< bits 0..6 profundidad, bit 7 núcleo
+  std::string tag;
+  std::string origin;
+
+  bool operator<(const RawRecord& o) const {
+    return std::tie(wake, startUs, durUs, name, depth, tag) <
+           std::tie(o.wake, o.startUs, o.durUs, o.name, o.depth, o.tag);
+  }
+};
+
+static const uint64_t WAKE_GAP_US = 1000000u;  ///< Separación visual entre despertares/ciclos
+
+// ============================================================
+// UTILIDADES
+// ============================================================
+
+static bool readFile(const std::string& path, std::string& out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  return true;
+}
+
+static std::string trim(const std::string& s) {
+  size_t a = s.find_first_not_of(" \t\r\n");
+  if (a == std::string::npos) return "";
+  size_t b = s.find_last_not_of(" \t\r\n");
+  return s.substr(a, b - a + 1);
+}
+
+/** @brief Categoría a partir del nombre ("lte.attach" -> "lte") */
+static std::string categoryOf(const std::string& name) {
+  size_t dot = name.find('.');
+  if (name == "at") return "at";
+  return (dot == std::string::npos) ? "phase" : name.substr(0, dot);
+}
+
+/** @brief Clave de comando AT: "+CAOPEN=0,0,..." -> "CAOPEN" */
+static std::string atKey(const std::string& cmd) {
+  std::string s = trim(cmd);
+  if (s.compare(0, 2, "AT") == 0) s = s.substr(2);
+  if (!s.empty() && (s[0] == '+' || s[0] == '&')) s = s.substr(1);
+  size_t end = 0;
+  while (end < s.size() && (isalnum((unsigned char)s[end]))) end++;
+  return end == 0 ? std::string("AT") : s.substr(0, end);
+}
+
+/** @brief Nombre de estadística: los comandos AT se agrupan por etiqueta */
+static std::string statName(const Event& e) {
+  if (e.name == "at" && !e.tag.empty()) return "at[" + e.tag + "]";
+  return e.name;
+}
+
+static std::string jsonEscape(const std::string& s) {
+  std::string o;
+  for (unsigned char c : s) {
+    switch (c) {
+      case '"': o += "\\\""; break;
+      case '\\': o += "\\\\"; break;
+      case '\n': o += "\\n"; break;
+      case '\r': o += "\\r"; break;
+      case '\t': o += "\\t"; break;
+      default:
+        if (c < 0x20) {
+          char b[8];
+          snprintf(b, sizeof(b), "\\u%04x", c);
+          o += b;
+        } else {
+          o += (char)c;
+        }
+    }
+  }
+  return o;
+}
+
+// ============================================================
+// VOLCADO BINARIO JTRC (FEAT-V23)
+// ============================================================
+
+static uint16_t rdU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rdU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Decodifica un volcado JTRC que empieza en data[pos].
+ * @return Bytes consumidos (0 si el bloque está truncado o no es válido).
+ */
+static size_t parseJtrc(const std::string& data, size_t pos, const std::string& file,
+                        std::set<RawRecord>& out) {
+  const uint8_t* p = (const uint8_t*)data.data() + pos;
+  size_t avail = data.size() - pos;
+  const size_t HDR = 4 + 1 + 1 + 2 + 2 + 2;
+  const size_t REC = 2 + 2 + 4 + 4 + 1 + 4;
+  if (avail < HDR || memcmp(p, "JTRC", 4) != 0) return 0;
+  if (p[4] != 1) {
+    fprintf(stderr, "%s@%zu: JTRC versión %u no soportada\n", file.c_str(), pos, p[4]);
+    return 0;
+  }
+  uint16_t nameCount = rdU16(p + 8);
+  uint16_t recCount = rdU16(p + 10);
+  size_t off = HDR;
+
+  std::vector<std::string> names;
+  for (uint16_t k = 0; k < nameCount; k++) {
+    if (off + 1 > avail) return 0;
+    uint8_t len = p[off++];
+    if (off + len > avail) return 0;
+    names.emplace_back((const char*)p + off, len);
+    off += len;
+  }
+  if (off + (size_t)recCount * REC > avail) {
+    fprintf(stderr, "%s@%zu: JTRC truncado (%u registros declarados)\n", file.c_str(), pos, recCount);
+    return 0;
+  }
+
+  char origin[64];
+  snprintf(origin, sizeof(origin), "@%zu", pos);
+  for (uint16_t i = 0; i < recCount; i++, off += REC) {
+    const uint8_t* r = p + off;
+    uint16_t idx = rdU16(r);
+    RawRecord rr;
+    rr.name = (idx < names.size()) ? names[idx] : std::string("?");
+    rr.wake = rdU16(r + 2);
+    rr.startUs = rdU32(r + 4);
+    rr.durUs = rdU32(r + 8);
+    rr.depth = r[12];
+    rr.tag.assign((const char*)r + 13, strnlen((const char*)r + 13, 4));
+    rr.origin = file + origin;
+    out.insert(rr);  // Volcados sucesivos se solapan: el set deduplica
+  }
+  return off;
+}
+
+/** @brief Busca y decodifica todos los volcados JTRC de un archivo */
+static size_t scanBinary(const std::string& data, const std::string& file, std::set<RawRecord>& out) {
+  size_t dumps = 0;
+  size_t pos = 0;
+  while ((pos = data.find("JTRC", pos)) != std::string::npos) {
+    size_t used = parseJtrc(data, pos, file, out);
+    if (used > 0) dumps++;
+    pos += (used > 0) ? used : 4;
+  }
+  return dumps;
+}
+
+/**
+ * @brief Ubica los despertares en una línea de tiempo común.
+ * @details start_us es relativo al boot de cada despertar; se encadenan en
+ *          orden de número de despertar con WAKE_GAP_US entre ellos.
+ */
+static void binaryToEvents(const std::set<RawRecord>& recs, std::vector<Event>& out) {
+  std::map<uint16_t, uint64_t> wakeEnd;
+  for (const RawRecord& r : recs) {
+    uint64_t end = (uint64_t)r.startUs + r.durUs;
+    uint64_t& e = wakeEnd[r.wake];
+    e = std::max(e, end);
+  }
+  std::map<uint16_t, uint64_t> base;
+  uint64_t cursor = 0;
+  for (const auto& w : wakeEnd) {
+    base[w.first] = cursor;
+    cursor += w.second + WAKE_GAP_US;
+  }
+  for (const RawRecord& r : recs) {
+    Event e;
+    e.name = r.name;
+    e.cat = categoryOf(r.name);
+    e.tag = r.tag;
+    e.tsUs = base[r.wake] + r.startUs;
+    e.durUs = r.durUs;
+    e.src = Source::Binary;
+    e.tid = (r.depth & 0x80) ? 0 : 1;
+    e.depth = r.depth & 0x7F;
+    e.cycle = r.wake;
+    e.origin = r.origin;
+    out.push_back(e);
+  }
+}
+
+// ============================================================
+// TEXTO: [TIMING], CYCLE TIMING SUMMARY, logger AT de JAMR_4.4
+// ============================================================
+
+/** @brief Estado del parser de texto de un archivo */
+struct TextCycle {
+  uint32_t index = 0;
+  uint64_t base = 0;     ///< Inicio del ciclo en la línea de tiempo de texto
+  uint64_t cursor = 0;   ///< Fin de la última fase (relativo a base)
+  uint64_t totalUs = 0;  ///< "CYCLE TOTAL" del recuadro, si apareció
+  bool open = false;
+};
+
+/** @brief Pistas de texto: 1 = fases, 2 = comandos AT con timestamp */
+static const uint8_t TID_PHASES = 1;
+static const uint8_t TID_AT = 2;
+
+static uint64_t g_textBase = 0;  ///< Siguiente base libre entre archivos
+
+static void closeCycle(TextCycle& c, std::vector<Event>& out, const std::string& origin) {
+  if (!c.open) return;
+  uint64_t span = std::max(c.cursor, c.totalUs);
+  if (span > 0) {
+    Event e;
+    e.name = "cycle";
+    e.cat = "cycle";
+    e.tsUs = c.base;
+    e.durUs = span;
+    e.tid = TID_PHASES;
+    e.cycle = c.index;
+    e.origin = origin;
+    out.push_back(e);
+  }
+  g_textBase = std::max(g_textBase, c.base + span + WAKE_GAP_US);
+  c.open = false;
+}
+
+static void openCycle(TextCycle& c) {
+  if (c.open) return;
+  c.index++;
+  c.base = g_textBase;
+  c.cursor = 0;
+  c.totalUs = 0;
+  c.open = true;
+}
+
+/** @brief "[123456ms] ..." -> 123456 */
+static bool lineMillis(const std::string& line, uint64_t& ms) {
+  size_t a = line.find('[');
+  if (a == std::string::npos) return false;
+  char* end = nullptr;
+  unsigned long long v = strtoull(line.c_str() + a + 1, &end, 10);
+  if (end == line.c_str() + a + 1 || strncmp(end, "ms]", 3) != 0) return false;
+  ms = v;
+  return true;
+}
+
+/** @brief Fila del recuadro: "║  Send LTE:     18230 ms ..." -> ("Send LTE", 18230) */
+static bool summaryRow(const std::string& line, std::string& label, uint64_t& ms) {
+  static const char* BAR = "\xE2\x95\x91";  // ║
+  size_t a = line.find(BAR);
+  if (a == std::string::npos) return false;
+  size_t colon = line.find(':', a);
+  size_t msPos = line.find(" ms", colon == std::string::npos ? a : colon);
+  if (colon == std::string::npos || msPos == std::string::npos) return false;
+  label = trim(line.substr(a + 3, colon - a - 3));
+  if (label.compare(0, 2, "- ") == 0) label = trim(label.substr(2));
+  std::string num = trim(line.substr(colon + 1, msPos - colon - 1));
+  if (num.empty() || num.find_first_not_of("0123456789") != std::string::npos) return false;
+  ms = strtoull(num.c_str(), nullptr, 10);
+  return !label.empty();
+}
+
+static void scanText(const std::string& data, const std::string& file, std::vector<Event>& out) {
+  TextCycle cyc;
+  bool inSummary = false;
+  std::string pendingCmd;
+  uint64_t pendingMs = 0;
+  uint64_t atBase = g_textBase;  // Comandos AT con reloj propio (millis del equipo)
+  uint64_t atMaxMs = 0;
+
+  std::istringstream in(data);
+  std::string line;
+  size_t lineNo = 0;
+  while (std::getline(in, line)) {
+    lineNo++;
+    std::string origin = file + ":" + std::to_string(lineNo);
+
+    // Reset del equipo: cierra el ciclo y reinicia el reloj de los comandos AT
+    if (line.compare(0, 4, "rst:") == 0 || line.find("ESP-ROM:") != std::string::npos) {
+      closeCycle(cyc, out, origin);
+      atBase = std::max(g_textBase, atBase + atMaxMs * 1000u + WAKE_GAP_US);
+      g_textBase = std::max(g_textBase, atBase);
+      atMaxMs = 0;
+      pendingCmd.clear();
+      continue;
+    }
+
+    // 1. [TIMING] <fase>: N ms
+    size_t t = line.find("[TIMING] ");
+    if (t != std::string::npos) {
+      std::string rest = line.substr(t + 9);
+      size_t colon = rest.find(':');
+      if (colon != std::string::npos) {
+        std::string name = trim(rest.substr(0, colon));
+        uint64_t ms = strtoull(rest.c_str() + colon + 1, nullptr, 10);
+        openCycle(cyc);
+        Event e;
+        e.name = name;
+        e.cat = "phase";
+        e.durUs = ms * 1000u;
+        e.tid = TID_PHASES;
+        e.cycle = cyc.index;
+        e.origin = origin;
+        // wakeToSample / wakeToSleep son métricas desde el boot, no fases encadenadas
+        if (name == "wakeToSample" || name == "wakeToSleep") {
+          e.cat = "metric";
+          e.timeline = false;
+        } else {
+          e.tsUs = cyc.base + cyc.cursor;
+          e.depth = 1;
+          cyc.cursor += e.durUs;
+        }
+        out.push_back(e);
+      }
+      continue;
+    }
+
+    // 2. Recuadro CYCLE TIMING SUMMARY
+    if (line.find("CYCLE TIMING SUMMARY") != std::string::npos) {
+      openCycle(cyc);
+      inSummary = true;
+      continue;
+    }
+    if (inSummary) {
+      if (line.find("\xE2\x95\x9A") != std::string::npos) {  // ╚ cierre
+        inSummary = false;
+        closeCycle(cyc, out, origin);
+        continue;
+      }
+      std::string label;
+      uint64_t ms;
+      if (summaryRow(line, label, ms)) {
+        if (label == "CYCLE TOTAL") cyc.totalUs = ms * 1000u;
+        Event e;
+        e.name = "summary." + label;
+        e.cat = "summary";
+        e.durUs = ms * 1000u;
+        e.cycle = cyc.index;
+        e.timeline = false;
+        e.origin = origin;
+        out.push_back(e);
+      }
+      continue;
+    }
+
+    // 3. Logger JAMR_4.4: "[Nms] ... Enviando comando AT: +CMD" / "Comando AT exitoso|falló: +CMD"
+    uint64_t ms;
+    if (!lineMillis(line, ms)) continue;
+    atMaxMs = std::max(atMaxMs, ms);
+    size_t s = line.find("Enviando comando AT: ");
+    if (s != std::string::npos) {
+      pendingCmd = trim(line.substr(s + 21));
+      pendingMs = ms;
+      continue;
+    }
+    bool okLine = line.find("Comando AT exitoso: ") != std::string::npos;
+    bool failLine = line.find("Comando AT fall") != std::string::npos;
+    if ((okLine || failLine) && !pendingCmd.empty() && ms >= pendingMs) {
+      Event e;
+      e.name = "at";
+      e.cat = "at";
+      e.tag = atKey(pendingCmd);
+      e.tsUs = atBase + pendingMs * 1000u;
+      e.durUs = (ms - pendingMs) * 1000u;
+      e.tid = TID_AT;
+      e.ok = okLine;
+      e.origin = origin;
+      out.push_back(e);
+      pendingCmd.clear();
+    }
+  }
+  closeCycle(cyc, out, file + ":" + std::to_string(lineNo));
+  g_textBase = std::max(g_textBase, atBase + atMaxMs * 1000u + WAKE_GAP_US);
+}
+
+// ============================================================
+// SALIDAS
+// ============================================================
+
+static bool writeJson(const std::string& path, const std::vector<Event>& events) {
+  FILE* f = fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    perror(path.c_str());
+    return false;
+  }
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  // Metadatos: nombres de proceso y pista
+  fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"JTRC (FEAT-V23)\"}},\n");
+  fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"thread_name\",\"args\":{\"name\":\"core0 (LTE)\"}},\n");
+  fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"core1 (loop)\"}},\n");
+  fprintf(f, "{\"ph\":\"M\",\"pid\":2,\"name\":\"process_name\",\"args\":{\"name\":\"log de texto\"}},\n");
+  fprintf(f, "{\"ph\":\"M\",\"pid\":2,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"fases [TIMING]\"}},\n");
+  fprintf(f, "{\"ph\":\"M\",\"pid\":2,\"tid\":2,\"name\":\"thread_name\",\"args\":{\"name\":\"comandos AT\"}}");
+
+  for (const Event& e : events) {
+    if (!e.timeline) continue;
+    std::string name = e.tag.empty() ? e.name : e.name + " " + e.tag;
+    fprintf(f, ",\n{\"ph\":\"X\",\"name\":\"%s\",\"cat\":\"%s\",\"pid\":%u,\"tid\":%u,"
+               "\"ts\":%" PRIu64 ",\"dur\":%" PRIu64 ",\"args\":{\"cycle\":%u,\"depth\":%u",
+            jsonEscape(name).c_str(), jsonEscape(e.cat).c_str(), (unsigned)e.src, (unsigned)e.tid,
+            e.tsUs, e.durUs, (unsigned)e.cycle, (unsigned)e.depth);
+    if (!e.ok) fprintf(f, ",\"ok\":false");
+    fprintf(f, ",\"origin\":\"%s\"}}", jsonEscape(e.origin).c_str());
+  }
+  fprintf(f, "\n]}\n");
+  fclose(f);
+  return true;
+}
+
+/** @brief Percentil por rango más cercano sobre un vector ordenado */
+static uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.999999);
+  if (rank < 1) rank = 1;
+  if (rank > sorted.size()) rank = sorted.size();
+  return sorted[rank - 1];
+}
+
+static void printStats(const std::vector<Event>& events) {
+  std::map<std::string, std::vector<uint64_t>> groups;
+  std::map<std::string, unsigned> fails;
+  for (const Event& e : events) {
+    if (e.name == "cycle") continue;
+    groups[statName(e)].push_back(e.durUs);
+    if (!e.ok) fails[statName(e)]++;
+  }
+
+  printf("%-28s %6s %10s %10s %10s %10s %10s %5s\n",
+         "nombre", "n", "min ms", "p50 ms", "p90 ms", "p99 ms", "max ms", "fail");
+  for (auto& g : groups) {
+    std::vector<uint64_t>& v = g.second;
+    std::sort(v.begin(), v.end());
+    printf("%-28s %6zu %10.1f %10.1f %10.1f %10.1f %10.1f %5u\n",
+           g.first.c_str(), v.size(), v.front() / 1000.0,
+           percentile(v, 50) / 1000.0, percentile(v, 90) / 1000.0,
+           percentile(v, 99) / 1000.0, v.back() / 1000.0, fails[g.first]);
+  }
+}
+
+static void printTop(const std::vector<Event>& events, size_t n) {
+  std::vector<const Event*> v;
+  for (const Event& e : events) {
+    if (e.name != "cycle" && e.cat != "summary" && e.cat != "metric") v.push_back(&e);
+  }
+  std::sort(v.begin(), v.end(), [](const Event* a, const Event* b) { return a->durUs > b->durUs; });
+  if (v.size() > n) v.resize(n);
+  printf("\nTop %zu eventos más lentos:\n", v.size());
+  for (const Event* e : v) {
+    printf("  %10.1f ms  %-24s ciclo %-5u %s\n", e->durUs / 1000.0, statName(*e).c_str(),
+           (unsigned)e->cycle, e->origin.c_str());
+  }
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "Uso: %s [-o trace.json] [--stats] [--top N] archivo...\n"
+          "  Entradas: capturas Serial ([TIMING], CYCLE TIMING SUMMARY, logger AT)\n"
+          "            y volcados binarios JTRC (TRACE BIN / BLE TRACE)\n", argv0);
+}
+
+int main(int argc, char** argv) {
+  std::string jsonPath;
+  bool stats = false;
+  size_t top = 0;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++) {
+    std::string a = argv[i];
+    if (a == "-o" && i + 1 < argc) {
+      jsonPath = argv[++i];
+    } else if (a == "--stats") {
+      stats = true;
+    } else if (a == "--top" && i + 1 < argc) {
+      top = (size_t)strtoul(argv[++i], nullptr, 10);
+    } else if (a == "-h" || a == "--help") {
+      usage(argv[0]);
+      return 0;
+    } else if (!a.empty() && a[0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      files.push_back(a);
+    }
+  }
+  if (files.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (jsonPath.empty()) stats = true;
+
+  std::vector<Event> events;
+  std::set<RawRecord> records;
+  for (const std::string& file : files) {
+    std::string data;
+    if (!readFile(file, data)) {
+      perror(file.c_str());
+      return 1;
+    }
+    size_t before = events.size();
+    size_t dumps = scanBinary(data, file, records);
+    scanText(data, file, events);
+    fprintf(stderr, "%s: %zu volcados JTRC, %zu eventos de texto\n",
+            file.c_str(), dumps, events.size() - before);
+  }
+  binaryToEvents(records, events);
+
+  if (events.empty()) {
+    fprintf(stderr, "Sin eventos reconocidos\n");
+    return 1;
+  }
+  if (!jsonPath.empty() && !writeJson(jsonPath, events)) return 1;
+  if (stats) printStats(events);
+  if (top > 0) printTop(events, top);
+  return 0;
+}